@@ -0,0 +1,385 @@
+/**
+ * @file Benchmark.c
+ *
+ * @brief Source code for the Benchmark module.
+ *
+ * This file contains the function definitions for the end-to-end detection latency
+ * benchmark of the Home Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Benchmark.h"
+#include "Timebase.h"
+#include "Ranging.h"
+#include "System_State.h"
+#include "Config.h"
+#include "Supervisor.h"
+
+/**
+ * @brief Phases of a trial.
+ */
+enum Benchmark_Phases
+{
+    BENCHMARK_PHASE_IDLE        = 0,    // No run in progress
+    BENCHMARK_PHASE_ARMING      = 1,    // Waiting for the end of the exit delay
+    BENCHMARK_PHASE_SETTLING    = 2,    // Reporting an empty scene
+    BENCHMARK_PHASE_DETECTING   = 3,    // Waiting for the first actuator output
+    BENCHMARK_PHASE_DISARMING   = 4     // Waiting for the system to be disarmed
+};
+
+/**
+ * @brief Accumulated latencies of one interval.
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t histogram[BENCHMARK_HISTOGRAM_BINS];
+} Benchmark_Entry;
+
+static Benchmark_Entry benchmark_table[BENCHMARK_INTERVAL_COUNT];
+static uint32_t failure_count = 0;
+
+// Run state
+static uint8_t benchmark_phase = BENCHMARK_PHASE_IDLE;
+static uint8_t trials_remaining = 0;
+static uint8_t trials_completed = 0;
+static uint8_t notified_task = TASK_BENCHMARK;
+static uint8_t previous_backend = RANGING_BACKEND_UART;
+static Scheduler_Timer phase_timer;
+
+// Distance reported by the script backend
+static uint16_t scene_distance_mm = BENCHMARK_FAR_DISTANCE_MM;
+
+// Timestamps of the boot stages, kept by Benchmark_Init since the boot starts before it
+static volatile uint32_t boot_time_us[BENCHMARK_BOOT_STAGE_COUNT];
+
+// Timestamps of the stages of the current trial
+static uint64_t stage_time_us[BENCHMARK_STAGE_COUNT];
+static uint8_t stage_mask = 0;
+
+static void Benchmark_Record(uint8_t interval, uint32_t latency_us)
+{
+    Benchmark_Entry *entry = &benchmark_table[interval];
+    uint32_t bits;
+    uint32_t bin;
+
+    entry->count++;
+    entry->total_us += latency_us;
+
+    if (latency_us < entry->min_us)
+    {
+        entry->min_us = latency_us;
+    }
+
+    if (latency_us > entry->max_us)
+    {
+        entry->max_us = latency_us;
+    }
+
+    // Same binning as the profiler: up to 6 bits (below 64 us) is bin 0,
+    // and every 2 more bits is the next bin
+    bits = 32 - __CLZ(latency_us);
+    bin = (bits <= 6) ? 0 : ((bits - 5) / 2);
+    entry->histogram[(bin < BENCHMARK_HISTOGRAM_BINS) ? bin : (BENCHMARK_HISTOGRAM_BINS - 1)]++;
+}
+
+static uint32_t Benchmark_Elapsed_us(uint8_t from_stage, uint8_t to_stage)
+{
+    // A stage that was marked before the previous one (for example, the decision on the
+    // first sample of the object) counts as no delay
+    if (stage_time_us[to_stage] <= stage_time_us[from_stage])
+    {
+        return 0;
+    }
+
+    return (uint32_t)(stage_time_us[to_stage] - stage_time_us[from_stage]);
+}
+
+// Script function of the ranging engine: every channel sees the same scene
+static uint16_t Benchmark_Script(uint8_t channel)
+{
+    return scene_distance_mm;
+}
+
+static void Benchmark_Start_Trial(void)
+{
+    stage_mask = 0;
+    scene_distance_mm = BENCHMARK_FAR_DISTANCE_MM;
+    benchmark_phase = BENCHMARK_PHASE_ARMING;
+
+    Scheduler_Post(TASK_SECURITY, SIGNAL_ARM_REQUEST, 0);
+    Scheduler_Timer_Start(&phase_timer, TASK_BENCHMARK, SIGNAL_BENCH_STEP,
+        Config_Get(CONFIG_PARAM_EXIT_DELAY_MS) + BENCHMARK_STATE_TIMEOUT_MS, 0);
+}
+
+static void Benchmark_Finish_Run(void)
+{
+    benchmark_phase = BENCHMARK_PHASE_IDLE;
+    Scheduler_Timer_Stop(&phase_timer);
+
+    Ranging_Set_Backend(previous_backend);
+    Scheduler_Post(notified_task, SIGNAL_BENCH_DONE, trials_completed);
+}
+
+// Records the latencies of a trial that reached every stage and disarms the system
+static void Benchmark_End_Trial(void)
+{
+    if (stage_mask == ((1 << BENCHMARK_STAGE_COUNT) - 1))
+    {
+        for (uint8_t interval = BENCHMARK_INTERVAL_SENSOR; interval < BENCHMARK_INTERVAL_TOTAL; interval++)
+        {
+            Benchmark_Record(interval, Benchmark_Elapsed_us(interval, interval + 1));
+        }
+
+        Benchmark_Record(BENCHMARK_INTERVAL_TOTAL, Benchmark_Elapsed_us(BENCHMARK_STAGE_STIMULUS, BENCHMARK_STAGE_ACTUATOR));
+        trials_completed++;
+    }
+    else
+    {
+        failure_count++;
+    }
+
+    trials_remaining--;
+    scene_distance_mm = BENCHMARK_FAR_DISTANCE_MM;
+    benchmark_phase = BENCHMARK_PHASE_DISARMING;
+
+    Scheduler_Post(TASK_SECURITY, SIGNAL_DISARM_REQUEST, 0);
+    Scheduler_Timer_Start(&phase_timer, TASK_BENCHMARK, SIGNAL_BENCH_STEP, BENCHMARK_STATE_TIMEOUT_MS, 0);
+}
+
+// Ranging engine subscriber executed in task context for every new sample
+static void Benchmark_Sample_Received(const Range_Sample *sample)
+{
+    if ((benchmark_phase != BENCHMARK_PHASE_DETECTING) || (stage_mask & (1 << BENCHMARK_STAGE_FRAME)))
+    {
+        return;
+    }
+
+    // The sample timestamp is the arrival of its frame, not the time of its task dispatch
+    if (sample->timestamp_us >= stage_time_us[BENCHMARK_STAGE_STIMULUS])
+    {
+        stage_time_us[BENCHMARK_STAGE_FRAME] = sample->timestamp_us;
+        stage_mask |= (1 << BENCHMARK_STAGE_FRAME);
+    }
+}
+
+// System state observer executed in task context for every transition
+static void Benchmark_State_Changed(uint8_t previous_state, uint8_t next_state)
+{
+    if (next_state == SYSTEM_STATE_ARMED)
+    {
+        Benchmark_Mark_Boot(BENCHMARK_BOOT_ARMED);
+    }
+
+    switch (benchmark_phase)
+    {
+        case BENCHMARK_PHASE_ARMING:
+            if (next_state == SYSTEM_STATE_ARMED)
+            {
+                benchmark_phase = BENCHMARK_PHASE_SETTLING;
+                Scheduler_Timer_Start(&phase_timer, TASK_BENCHMARK, SIGNAL_BENCH_STEP, BENCHMARK_SETTLE_MS, 0);
+            }
+            break;
+
+        case BENCHMARK_PHASE_DETECTING:
+            if (previous_state == SYSTEM_STATE_ARMED)
+            {
+                Benchmark_Mark(BENCHMARK_STAGE_TRANSITION);
+            }
+            break;
+
+        case BENCHMARK_PHASE_DISARMING:
+            if (next_state == SYSTEM_STATE_DISARMED)
+            {
+                Scheduler_Timer_Stop(&phase_timer);
+
+                if (trials_remaining > 0)
+                {
+                    Benchmark_Start_Trial();
+                }
+                else
+                {
+                    Benchmark_Finish_Run();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void Benchmark_Init(void)
+{
+    benchmark_phase = BENCHMARK_PHASE_IDLE;
+
+    for (uint8_t interval = 0; interval < BENCHMARK_INTERVAL_COUNT; interval++)
+    {
+        benchmark_table[interval].count = 0;
+    }
+
+    Scheduler_Add_Task(TASK_BENCHMARK, Benchmark_Task);
+
+    if (!Ranging_Subscribe(&Benchmark_Sample_Received))
+    {
+        Supervisor_Registration_Failed(TASK_BENCHMARK);
+    }
+
+    if (!System_State_Add_Observer(&Benchmark_State_Changed))
+    {
+        Supervisor_Registration_Failed(TASK_BENCHMARK);
+    }
+}
+
+uint8_t Benchmark_Start(uint8_t trials, uint8_t notify_task)
+{
+    if ((trials == 0) || (benchmark_phase != BENCHMARK_PHASE_IDLE) || (System_State_Get() != SYSTEM_STATE_DISARMED))
+    {
+        return 0;
+    }
+
+    for (uint8_t interval = 0; interval < BENCHMARK_INTERVAL_COUNT; interval++)
+    {
+        Benchmark_Entry *entry = &benchmark_table[interval];
+
+        entry->count = 0;
+        entry->min_us = 0xFFFFFFFF;
+        entry->max_us = 0;
+        entry->total_us = 0;
+
+        for (uint8_t bin = 0; bin < BENCHMARK_HISTOGRAM_BINS; bin++)
+        {
+            entry->histogram[bin] = 0;
+        }
+    }
+
+    failure_count = 0;
+    trials_remaining = trials;
+    trials_completed = 0;
+    notified_task = notify_task;
+
+    // Replace the sensor with the scripted scene for the whole run
+    previous_backend = Ranging_Get_Backend();
+    Ranging_Set_Script(&Benchmark_Script);
+    Ranging_Set_Backend(RANGING_BACKEND_SCRIPT);
+
+    Benchmark_Start_Trial();
+
+    return 1;
+}
+
+uint8_t Benchmark_Is_Running(void)
+{
+    return (benchmark_phase != BENCHMARK_PHASE_IDLE) ? 1 : 0;
+}
+
+void Benchmark_Mark(uint8_t stage)
+{
+    if ((benchmark_phase != BENCHMARK_PHASE_DETECTING) || (stage >= BENCHMARK_STAGE_COUNT) || (stage_mask & (1 << stage)))
+    {
+        return;
+    }
+
+    stage_time_us[stage] = Timebase_Get_Time_us();
+    stage_mask |= (1 << stage);
+
+    // The trial ends at the first actuator output
+    if (stage == BENCHMARK_STAGE_ACTUATOR)
+    {
+        Benchmark_End_Trial();
+    }
+}
+
+uint8_t Benchmark_Get_Stats(uint8_t interval, Benchmark_Stats *stats)
+{
+    const Benchmark_Entry *entry;
+
+    if (interval >= BENCHMARK_INTERVAL_COUNT)
+    {
+        return 0;
+    }
+
+    entry = &benchmark_table[interval];
+
+    stats->count = entry->count;
+    stats->min_us = (entry->count > 0) ? entry->min_us : 0;
+    stats->max_us = entry->max_us;
+    stats->mean_us = (entry->count > 0) ? (uint32_t)(entry->total_us / entry->count) : 0;
+
+    for (uint8_t bin = 0; bin < BENCHMARK_HISTOGRAM_BINS; bin++)
+    {
+        stats->histogram[bin] = (entry->count > 0) ? entry->histogram[bin] : 0;
+    }
+
+    return 1;
+}
+
+uint32_t Benchmark_Get_Failure_Count(void)
+{
+    return failure_count;
+}
+
+void Benchmark_Mark_Boot(uint8_t stage)
+{
+    if ((stage >= BENCHMARK_BOOT_STAGE_COUNT) || (boot_time_us[stage] != 0))
+    {
+        return;
+    }
+
+    uint64_t time_us = Timebase_Get_Time_us();
+
+    // A stage reached at 0 us is stored as 1 us, since 0 means that it was not reached
+    boot_time_us[stage] = (time_us > 0xFFFFFFFF) ? 0xFFFFFFFF : ((time_us > 0) ? (uint32_t)time_us : 1);
+}
+
+uint32_t Benchmark_Get_Boot_Time_us(uint8_t stage)
+{
+    return (stage < BENCHMARK_BOOT_STAGE_COUNT) ? boot_time_us[stage] : 0;
+}
+
+void Benchmark_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_BENCH_STEP:
+            // Ignore a timer event that belongs to an earlier phase
+            if (Scheduler_Timer_Active(&phase_timer))
+            {
+                break;
+            }
+
+            switch (benchmark_phase)
+            {
+                case BENCHMARK_PHASE_SETTLING:
+                    // Place the object in front of every sensor
+                    scene_distance_mm = BENCHMARK_NEAR_DISTANCE_MM;
+                    benchmark_phase = BENCHMARK_PHASE_DETECTING;
+                    Benchmark_Mark(BENCHMARK_STAGE_STIMULUS);
+                    Scheduler_Timer_Start(&phase_timer, TASK_BENCHMARK, SIGNAL_BENCH_STEP, BENCHMARK_DETECT_TIMEOUT_MS, 0);
+                    break;
+
+                case BENCHMARK_PHASE_ARMING:
+                case BENCHMARK_PHASE_DETECTING:
+                    // The system was not armed or did not react in time
+                    Benchmark_End_Trial();
+                    break;
+
+                case BENCHMARK_PHASE_DISARMING:
+                    // The system could not be disarmed; end the run
+                    trials_remaining = 0;
+                    Benchmark_Finish_Run();
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
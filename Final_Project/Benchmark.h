@@ -0,0 +1,215 @@
+/**
+ * @file Benchmark.h
+ *
+ * @brief Header file for the Benchmark module.
+ *
+ * This file contains the function definitions for the end-to-end detection latency
+ * benchmark of the Home Security System. The benchmark runs scripted trials on the
+ * real firmware path, from the ranging engine to the first actuator output:
+ *
+ * 1. The system is armed and waits for the exit delay to elapse.
+ * 2. The script backend of the ranging engine reports an empty scene (far distance)
+ *    for BENCHMARK_SETTLE_MS, so that every filter starts from a known history.
+ * 3. The stimulus: the script starts reporting an object inside every zone.
+ * 4. The trial ends at the first actuator output (the entry delay warning or the alarm
+ *    LEDs), and the system is disarmed before the next trial.
+ *
+ * Each trial timestamps five stages with the microsecond timebase:
+ *  - STIMULUS: the object is placed in front of the sensor
+ *  - FRAME: the first range sample of the object is received
+ *  - DECISION: the filter of a zone confirms the intrusion
+ *  - TRANSITION: the state machine leaves SYSTEM_STATE_ARMED
+ *  - ACTUATOR: the buzzer or the LEDs are turned on
+ *
+ * The latency of each interval between two stages is accumulated over the trials.
+ * The SENSOR interval only measures the time to the next trigger of the script
+ * backend; the flight time and the reply of the US-100 are not included.
+ *
+ * A trial that does not reach the ACTUATOR stage within BENCHMARK_DETECT_TIMEOUT_MS
+ * of the stimulus is counted as a failure.
+ *
+ * The boot sequence is timestamped as well, in microseconds since Timebase_Init (the first
+ * call of main). Each boot stage is recorded once per reset with Benchmark_Mark_Boot:
+ *  - PROTECTED: the alarm path and the sensor path are running, so the system can be armed
+ *  - RUNNING: every module is initialized and the scheduler dispatches events
+ *  - LCD_READY: the power-on sequence of the LCD has completed in the background
+ *  - ARMED: the system has entered SYSTEM_STATE_ARMED for the first time
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Distance reported by the script before and after the stimulus
+#define BENCHMARK_FAR_DISTANCE_MM       3000
+#define BENCHMARK_NEAR_DISTANCE_MM      100
+
+// Time with an empty scene after the system is armed and before the stimulus
+#define BENCHMARK_SETTLE_MS             500
+
+// Longest time from the stimulus to the first actuator output
+#define BENCHMARK_DETECT_TIMEOUT_MS     2000
+
+// Longest time to wait for the system to be armed (after the exit delay) or disarmed
+#define BENCHMARK_STATE_TIMEOUT_MS      2000
+
+// Number of bins in the latency histogram of each interval
+// Bin 0 holds latencies below 64 us and each next bin covers 4 times the range
+// of the previous one; the last bin holds every latency of 262144 us or more
+#define BENCHMARK_HISTOGRAM_BINS        8
+
+/**
+ * @brief Stages timestamped in each trial.
+ */
+enum Benchmark_Stages
+{
+    BENCHMARK_STAGE_STIMULUS    = 0,    // The script reports the object
+    BENCHMARK_STAGE_FRAME       = 1,    // First sample of the object
+    BENCHMARK_STAGE_DECISION    = 2,    // Intrusion confirmed by a zone filter
+    BENCHMARK_STAGE_TRANSITION  = 3,    // The armed state is left
+    BENCHMARK_STAGE_ACTUATOR    = 4,    // First buzzer or LED output
+    BENCHMARK_STAGE_COUNT
+};
+
+/**
+ * @brief Intervals measured by the benchmark.
+ */
+enum Benchmark_Intervals
+{
+    BENCHMARK_INTERVAL_SENSOR   = 0,    // STIMULUS to FRAME
+    BENCHMARK_INTERVAL_FILTER   = 1,    // FRAME to DECISION
+    BENCHMARK_INTERVAL_STATE    = 2,    // DECISION to TRANSITION
+    BENCHMARK_INTERVAL_OUTPUT   = 3,    // TRANSITION to ACTUATOR
+    BENCHMARK_INTERVAL_TOTAL    = 4,    // STIMULUS to ACTUATOR
+    BENCHMARK_INTERVAL_COUNT
+};
+
+/**
+ * @brief Stages of the boot sequence.
+ */
+enum Benchmark_Boot_Stages
+{
+    BENCHMARK_BOOT_PROTECTED    = 0,    // The alarm and sensor paths are initialized
+    BENCHMARK_BOOT_RUNNING      = 1,    // The scheduler is started
+    BENCHMARK_BOOT_LCD_READY    = 2,    // The LCD is initialized
+    BENCHMARK_BOOT_ARMED        = 3,    // The system is armed
+    BENCHMARK_BOOT_STAGE_COUNT
+};
+
+/**
+ * @brief Latency distribution of one interval.
+ */
+typedef struct
+{
+    uint32_t count;                                 // Number of completed trials
+    uint32_t min_us;                                // Shortest latency
+    uint32_t max_us;                                // Longest latency
+    uint32_t mean_us;                               // Average latency
+    uint32_t histogram[BENCHMARK_HISTOGRAM_BINS];   // Number of trials in each bin
+} Benchmark_Stats;
+
+/**
+ * @brief Registers TASK_BENCHMARK with the scheduler and observes the ranging engine
+ * and the state machine.
+ *
+ * This function must be called after Security_Init.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Benchmark_Init(void);
+
+/**
+ * @brief Clears the results and starts a run of trials.
+ *
+ * The ranging engine is switched to the script backend for the run, and the previous
+ * backend is selected again when the run ends. SIGNAL_BENCH_DONE is posted to the
+ * notified task with the number of completed trials as its parameter.
+ *
+ * @param trials The number of trials (at least 1).
+ *
+ * @param notify_task The task notified when the run ends (see Task_IDs).
+ *
+ * @return uint8_t Returns 1 if the run was started, or 0 if a run is in progress
+ *                 or the system is not disarmed.
+ */
+uint8_t Benchmark_Start(uint8_t trials, uint8_t notify_task);
+
+/**
+ * @brief Indicates whether a run of trials is in progress.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if a run is in progress. Otherwise, it returns 0.
+ */
+uint8_t Benchmark_Is_Running(void);
+
+/**
+ * @brief Timestamps a stage of the current trial.
+ *
+ * Only the first time of each stage is kept, and stages outside of a trial are ignored.
+ * This function must be called from task context.
+ *
+ * @param stage The stage (see Benchmark_Stages).
+ *
+ * @return None
+ */
+void Benchmark_Mark(uint8_t stage);
+
+/**
+ * @brief Copies the latency distribution of an interval.
+ *
+ * @param interval The interval (see Benchmark_Intervals).
+ *
+ * @param stats A pointer to where the distribution is copied.
+ *
+ * @return uint8_t Returns 1 if the interval exists. Otherwise, it returns 0.
+ */
+uint8_t Benchmark_Get_Stats(uint8_t interval, Benchmark_Stats *stats);
+
+/**
+ * @brief Returns the number of trials of the last run that did not complete.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of failed trials.
+ */
+uint32_t Benchmark_Get_Failure_Count(void);
+
+/**
+ * @brief Timestamps a stage of the boot sequence.
+ *
+ * Only the first time of each stage after a reset is kept. This function can be called
+ * before Benchmark_Init and from interrupt handlers.
+ *
+ * @param stage The stage (see Benchmark_Boot_Stages).
+ *
+ * @return None
+ */
+void Benchmark_Mark_Boot(uint8_t stage);
+
+/**
+ * @brief Returns the time of a stage of the boot sequence.
+ *
+ * @param stage The stage (see Benchmark_Boot_Stages).
+ *
+ * @return uint32_t The time of the stage in microseconds since Timebase_Init (saturated),
+ *                  or 0 if the stage has not been reached.
+ */
+uint32_t Benchmark_Get_Boot_Time_us(uint8_t stage);
+
+/**
+ * @brief Event handler of the benchmark task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Benchmark_Task(const Scheduler_Event *event);
+
+#endif
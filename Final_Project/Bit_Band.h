@@ -0,0 +1,40 @@
+/**
+ * @file Bit_Band.h
+ *
+ * @brief Bit-band aliases of the peripheral registers.
+ *
+ * The Cortex-M4 maps every bit of the peripheral region (0x40000000 - 0x400FFFFF) to a word
+ * of the bit-band alias region at 0x42000000. Writing 0 or 1 to the alias word clears or sets
+ * that single bit, and the bus performs the read-modify-write of the register atomically,
+ * so an interrupt can not corrupt the other bits of the register in between.
+ *
+ * GPIO pins should be written through the masked DATA aliases of Pin_Map.h instead, which
+ * need no read-modify-write at all. The bit-band aliases are for the control registers
+ * that have no masked alias, such as PWMENABLE and GPTMCTL.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef BIT_BAND_H
+#define BIT_BAND_H
+
+#include <stdint.h>
+
+// Start of the peripheral region and of its bit-band alias region
+#define BIT_BAND_PERIPHERAL_BASE    0x40000000UL
+#define BIT_BAND_ALIAS_BASE         0x42000000UL
+
+/**
+ * @brief Selects the bit-band alias word of one bit of a peripheral register.
+ *
+ * For example, BIT_BAND(TIMER1->CTL, 0) = 1 sets the TAEN bit of Timer 1 with a single store.
+ *
+ * @param reg The peripheral register (an lvalue, such as PWM0->ENABLE).
+ *
+ * @param bit The bit number in the register (0 to 31).
+ */
+#define BIT_BAND(reg, bit) \
+    (*((volatile uint32_t *)(BIT_BAND_ALIAS_BASE \
+        + (((uintptr_t)&(reg) - BIT_BAND_PERIPHERAL_BASE) * 32) + ((uint32_t)(bit) * 4))))
+
+#endif
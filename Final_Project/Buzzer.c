@@ -14,56 +14,203 @@
  */
  
 #include "Buzzer.h"
+#include "Pin_Map.h"
+#include "Bit_Band.h"
+#include "Clock.h"
 
 // Constant definitions for the buzzer
 const uint8_t BUZZER_OFF 		= 0x00;
 const uint8_t BUZZER_ON			= 0x10;
 
-// Constant definitions for musical notes
-const double C4_NOTE = 261.6;
-const double D4_NOTE = 293.7;
-const double E4_NOTE = 329.6;
-const double F4_NOTE = 349.2;
-const double G4_NOTE = 392.0;
-const double A4_NOTE = 440.0;
-const double B4_NOTE = 493.0;
-const double C5_NOTE = 523.2;
+// Enable bit of the M0PWM6 output (PWM6EN, Bit 6) in the PWMENABLE register.
+// It is written through its bit-band alias, so the sequencer tick and the tasks
+// can start and stop the output without a read-modify-write of PWMENABLE.
+#define BUZZER_PWM_OUTPUT_BIT 6
+#define BUZZER_PWM_OUTPUT_ENABLE BIT_BAND(PWM0->ENABLE, BUZZER_PWM_OUTPUT_BIT)
+
+// Frequencies of the notes in tenths of a Hz, indexed by Buzzer_Notes
+static const uint16_t note_frequency_table[NOTE_COUNT] =
+{
+	0,						// NOTE_REST
+	2616,					// NOTE_C4 (261.6 Hz)
+	2937,					// NOTE_D4 (293.7 Hz)
+	3296,					// NOTE_E4 (329.6 Hz)
+	3492,					// NOTE_F4 (349.2 Hz)
+	3920,					// NOTE_G4 (392.0 Hz)
+	4400,					// NOTE_A4 (440.0 Hz)
+	4939,					// NOTE_B4 (493.9 Hz)
+	5233,					// NOTE_C5 (523.3 Hz)
+	6593,					// NOTE_E5 (659.3 Hz)
+	7840,					// NOTE_G5 (784.0 Hz)
+	10465					// NOTE_C6 (1046.5 Hz)
+};
+
+// Reload values of the PWM generator for each note at the current PWM clock
+static uint16_t note_reload_table[NOTE_COUNT];
+
+// Sequencer state, shared with the Timer 0A interrupt
+static const Buzzer_Step * volatile pattern_steps = 0;
+static volatile uint8_t pattern_step_count = 0;
+static volatile uint8_t pattern_repeat_count = 0;
+static volatile uint8_t pattern_index = 0;
+static volatile uint16_t step_remaining_ms = 0;
+static volatile uint8_t pattern_playing = 0;
+
+// Last note selected with Buzzer_Set_Note
+static uint8_t current_note = NOTE_A4;
+
+static void Buzzer_Start_Step(uint8_t index)
+{
+	pattern_index = index;
+	step_remaining_ms = pattern_steps[index].duration_ms;
+	Buzzer_Set_Note(pattern_steps[index].note);
+}
+
+static void Buzzer_Clock_Changed(uint32_t system_clock_hz)
+{
+	uint32_t pwm_clock_hz = system_clock_hz / CLOCK_PWM_DIVIDER;
+	
+	for (uint8_t note = NOTE_C4; note < NOTE_COUNT; note++)
+	{
+		note_reload_table[note] = BUZZER_RELOAD(pwm_clock_hz, note_frequency_table[note]);
+	}
+	
+	// Retune the note that is playing
+	PWM0->_3_LOAD = note_reload_table[current_note];
+	PWM0->_3_CMPA = note_reload_table[current_note] / 2;
+}
 
 void Buzzer_Init(void)
 {
-	// Enable the clock to Port C
-	SYSCTL -> RCGCGPIO |= 0x04;
+	// Enable the clock to PWM Module 0 by setting the
+	// R0 bit (Bit 0) in the RCGCPWM register
+	SYSCTL->RCGCPWM |= 0x01;
 	
-	// Set PC4 as an output GPIO pin
-	GPIOC->DIR |= 0x10;
+	// Enable the clock to Port C and configure PC4 as a digital pin
+	// with the M0PWM6 alternate function (PMC4 = 4)
+	PIN_ALTERNATE_INIT(PIN_BUZZER);
 	
-	// Configure PC4 to function as a GPIO pin
-	GPIOC->AFSEL &= ~0x10;
+	// The PWM clock divider is selected by Clock_Init
+	// Disable Generator 3 and select the count-down mode
+	PWM0->_3_CTL = 0x00;
 	
-	// Enable digital functionality for PC4
-	GPIOC->DEN |= 0x10;
+	// Drive M0PWMA high when the counter matches the reload value (ACTLOAD = 0x3)
+	// and drive it low when the counter matches the comparator A value while counting down (ACTCMPAD = 0x2)
+	PWM0->_3_GENA = 0x8C;
+	
+	// Compute the reload values of the notes, start with the A4 note, and keep the output disabled
+	current_note = NOTE_A4;
+	Buzzer_Clock_Changed(Clock_Get_Hz());
+	if (!Clock_Subscribe(&Buzzer_Clock_Changed))
+	{
+		// The PWM period is only valid for the current profile
+		Clock_Hold_Profile();
+	}
+	BUZZER_PWM_OUTPUT_ENABLE = 0;
+	
+	// Enable Generator 3
+	PWM0->_3_CTL |= 0x01;
 }
  
 void Buzzer_Output(uint8_t buzzer_value)
 {
 	// Set the output of the buzzer
-	GPIOC->DATA = (GPIOC->DATA & 0xEF) | buzzer_value;
+	if (buzzer_value == BUZZER_OFF)
+	{
+		BUZZER_PWM_OUTPUT_ENABLE = 0;
+	}
+	else
+	{
+		Buzzer_Set_Note(current_note);
+	}
+}
+
+void Buzzer_Set_Note(uint8_t note)
+{
+	if ((note == NOTE_REST) || (note >= NOTE_COUNT))
+	{
+		BUZZER_PWM_OUTPUT_ENABLE = 0;
+		return;
+	}
+	
+	current_note = note;
+	
+	// The new reload value takes effect when the counter reaches zero,
+	// so the tone changes without a glitch
+	PWM0->_3_LOAD = note_reload_table[note];
+	PWM0->_3_CMPA = note_reload_table[note] / 2;
+	BUZZER_PWM_OUTPUT_ENABLE = 1;
+}
+
+void Buzzer_Play_Pattern(const Buzzer_Step *steps, uint8_t step_count, uint8_t repeat_count)
+{
+	if ((steps == 0) || (step_count == 0))
+	{
+		Buzzer_Stop();
+		return;
+	}
+	
+	// Prevent the sequencer from running while the pattern is replaced
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	pattern_steps = steps;
+	pattern_step_count = step_count;
+	pattern_repeat_count = repeat_count;
+	pattern_playing = 1;
+	Buzzer_Start_Step(0);
+	
+	__set_PRIMASK(primask);
+}
+
+void Buzzer_Stop(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	pattern_playing = 0;
+	BUZZER_PWM_OUTPUT_ENABLE = 0;
+	
+	__set_PRIMASK(primask);
+}
+
+uint8_t Buzzer_Is_Playing(void)
+{
+	return pattern_playing;
 }
 
-void Play_Note(double note, unsigned int duration)
+void Buzzer_Sequencer_Tick(void)
 {
-	// Calculate the period of the note in microseconds
-	int period_us = (int) (((double)1/note) * ((double)1000000));
+	if (!pattern_playing)
+	{
+		return;
+	}
+	
+	if (step_remaining_ms > 1)
+	{
+		step_remaining_ms = step_remaining_ms - 1;
+		return;
+	}
 	
-	// Calculate the half period of the note in microseconds
-	int half_period_us = period_us / 2;
+	// Move to the next step, or to the start of the pattern for the next repetition
+	uint8_t next_index = pattern_index + 1;
 	
-	// Generate a square wave for the specified duration
-	for (unsigned int i = 0; i < duration; i++)
+	if (next_index >= pattern_step_count)
 	{
-		Buzzer_Output(BUZZER_ON);
-		SysTick_Delay1us(half_period_us);
-		Buzzer_Output(BUZZER_OFF);
-		SysTick_Delay1us(half_period_us);
+		if (pattern_repeat_count == 1)
+		{
+			pattern_playing = 0;
+			BUZZER_PWM_OUTPUT_ENABLE = 0;
+			return;
+		}
+		
+		if (pattern_repeat_count > 1)
+		{
+			pattern_repeat_count = pattern_repeat_count - 1;
+		}
+		
+		next_index = 0;
 	}
+	
+	Buzzer_Start_Step(next_index);
 }
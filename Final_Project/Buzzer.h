@@ -7,37 +7,70 @@
  * It interfaces with the following:
  *	- DMT-1206 Magnetic Buzzer
  *
+ * The buzzer is driven by the M0PWM6 output (PWM Module 0, Generator 3, PC4) with a 50% duty cycle,
+ * so a tone is generated in hardware without any CPU involvement. The PWM clock is the system clock
+ * divided by 16 (3.125 MHz), and the reload value of each note is computed at compile time.
+ *
+ * A sequencer plays patterns of notes in the background. It is advanced by Buzzer_Sequencer_Tick,
+ * which must be called every 1 ms from the Timer 0A interrupt.
+ *
  * To verify the pinout of the user LED, refer to the Tiva C Series TM4C123G LaunchPad User's Guide
  * Link: https://www.ti.com/lit/pdf/spmu296
  *
+ * @note The reload values of the notes are derived from the PWM clock (see Clock.h),
+ * and they are computed again when the clock profile changes.
+ *
  * @author Aaron Nanas
  */
- 
+
+#ifndef BUZZER_H
+#define BUZZER_H
+
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
 #include "GPIO.h"
 
+// Reload value of the PWM generator for a frequency given in tenths of a Hz
+#define BUZZER_RELOAD(pwm_clock_hz, frequency_x10) ((uint16_t)((((pwm_clock_hz) * 10UL) / (frequency_x10)) - 1))
+
 // Constant definitions for the buzzer
 extern const uint8_t BUZZER_OFF;
 extern const uint8_t BUZZER_ON;
 
-// Constant definitions for musical notes
-extern const double C4_NOTE;
-extern const double D4_NOTE;
-extern const double E4_NOTE;
-extern const double F4_NOTE;
-extern const double G4_NOTE;
-extern const double A4_NOTE;
-extern const double B4_NOTE;
+/**
+ * @brief Musical notes that can be played by the buzzer.
+ */
+enum Buzzer_Notes
+{
+	NOTE_REST	= 0,
+	NOTE_C4		= 1,
+	NOTE_D4		= 2,
+	NOTE_E4		= 3,
+	NOTE_F4		= 4,
+	NOTE_G4		= 5,
+	NOTE_A4		= 6,
+	NOTE_B4		= 7,
+	NOTE_C5		= 8,
+	NOTE_E5		= 9,
+	NOTE_G5		= 10,
+	NOTE_C6		= 11,
+	NOTE_COUNT
+};
 
-extern const double C5_NOTE;
+/**
+ * @brief One step of a buzzer pattern.
+ */
+typedef struct
+{
+	uint8_t note;			// See Buzzer_Notes
+	uint16_t duration_ms;	// Duration of the step in milliseconds
+} Buzzer_Step;
 
 /**
  * @brief Initializes the DMT-1206 Magnetic Buzzer on the EduBase board.
  *
- * This function configures the PC4 pin used by the DMT-1206 Magnetic Buzzer.
- * It enables the clock to Port C, sets PC4 as an output GPIO pin, configures PC4 to function as a GPIO pin,
- * and enables digital functionality for PC4.
+ * This function configures the PC4 pin as the M0PWM6 output and configures
+ * Generator 3 of PWM Module 0 in count-down mode. The buzzer is silent after initialization.
  *
  * @param None
  *
@@ -48,11 +81,8 @@ void Buzzer_Init(void);
 /**
  * @brief Sets the output of the DMT-1206 Magnetic Buzzer.
  *
- * This function sets the output of the buzzer based on the value of the input, buzzer_value.
- * A bitwise AND operation (& 0xEF) is performed to mask Bit 4 of the GPIOC's DATA register
- * to preserve the state of other pins connected to Port C while keeping the buzzer pin unaffected.
- * Then, a bitwise OR operation is performed with buzzer_value to set the buzzer pin to the desired state
- * specified by buzzer_value.
+ * Setting buzzer_value to BUZZER_ON plays the last selected note (A4 after initialization),
+ * and setting it to BUZZER_OFF silences the buzzer.
  *
  * @param buzzer_value An 8-bit unsigned integer that determines the output of the buzzer. To turn off
  *                      the buzzer, set buzzer_value to 0. To turn on the buzzer, set buzzer_value to 0x10.
@@ -62,16 +92,59 @@ void Buzzer_Init(void);
 void Buzzer_Output(uint8_t buzzer_value);
 
 /**
- * @brief Plays a note with the DMT-1206 Magnetic Buzzer.
+ * @brief Plays a note continuously until another note is selected or the buzzer is turned off.
+ *
+ * The function returns immediately. NOTE_REST silences the buzzer.
+ *
+ * @param note The note to play (see Buzzer_Notes).
+ *
+ * @return None
+ */
+void Buzzer_Set_Note(uint8_t note);
+
+/**
+ * @brief Starts playing a pattern of notes in the background.
+ *
+ * The function returns immediately. A pattern that is already playing is replaced.
+ * The steps are read while the pattern plays, so the array must remain valid (for example, const).
+ *
+ * @param steps A pointer to the array of steps.
+ *
+ * @param step_count The number of steps in the array.
+ *
+ * @param repeat_count The number of times the pattern is played, or 0 to repeat it until it is stopped.
+ *
+ * @return None
+ */
+void Buzzer_Play_Pattern(const Buzzer_Step *steps, uint8_t step_count, uint8_t repeat_count);
+
+/**
+ * @brief Stops the current pattern and silences the buzzer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Buzzer_Stop(void);
+
+/**
+ * @brief Indicates whether a pattern is playing.
+ *
+ * @param None
  *
- * This function generates a square wave with the DMT-1206 Magnetic Buzzer to produce a note of the specified frequency and duration.
- * It calculates the period of the note in microseconds, divides it by two to get half period, and then toggles the
- * buzzer output at the half period interval for the specified duration.
+ * @return uint8_t Returns 1 if a pattern is playing. Otherwise, it returns 0.
+ */
+uint8_t Buzzer_Is_Playing(void);
+
+/**
+ * @brief Advances the buzzer sequencer by 1 ms.
  *
- * @param note The frequency of the note to play in Hz.
+ * This function must be called every 1 ms from the Timer 0A interrupt service routine.
  *
- * @param duration The duration of the note in microseconds.
+ * @param None
  *
  * @return None
  */
-void Play_Note(double note, unsigned int duration);
+void Buzzer_Sequencer_Tick(void);
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ * @file Clock.c
+ *
+ * @brief Source code for the Clock driver.
+ *
+ * This file contains the function definitions for the Clock driver.
+ * The RCC2 register is used for the oscillator source and the divisor of the PLL, since
+ * only RCC2 can select the 400 MHz PLL output (DIV400) and the 80 MHz system clock.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Clock.h"
+
+// Fields of the Run-Mode Clock Configuration (RCC) register
+#define RCC_MOSCDIS                 0x00000001      // Main oscillator disable (Bit 0)
+#define RCC_IOSCDIS                 0x00000002      // Precision internal oscillator disable (Bit 1)
+#define RCC_XTAL_MASK               0x000007C0      // Crystal value (Bits 10 to 6)
+#define RCC_XTAL_16MHZ              (0x15 << 6)
+#define RCC_PWMDIV_MASK             0x000E0000      // PWM unit clock divisor (Bits 19 to 17)
+#define RCC_PWMDIV_16               (0x3 << 17)
+#define RCC_USEPWMDIV               0x00100000      // Enable the PWM clock divisor (Bit 20)
+#define RCC_USESYSDIV               0x00400000      // Enable the system clock divider (Bit 22)
+
+// Fields of the Run-Mode Clock Configuration 2 (RCC2) register
+#define RCC2_USERCC2                0x80000000      // Use RCC2 (Bit 31)
+#define RCC2_DIV400                 0x40000000      // Divide the 400 MHz PLL output (Bit 30)
+#define RCC2_SYSDIV_MASK            0x1FC00000      // SYSDIV2 (Bits 28 to 23) and SYSDIV2LSB (Bit 22)
+#define RCC2_SYSDIV_SHIFT           22
+#define RCC2_PWRDN2                 0x00002000      // Power down the PLL (Bit 13)
+#define RCC2_BYPASS2                0x00000800      // Bypass the PLL (Bit 11)
+#define RCC2_OSCSRC2_MASK           0x00000070      // Oscillator source (Bits 6 to 4), 0x0 = main oscillator
+#define RCC2_OSCSRC2_PIOSC          0x00000010      // Precision internal oscillator
+
+// LOCK bit (Bit 0) of the PLL Status (PLLSTAT) register, set while the PLL is powered and locked
+#define SYSCTL_PLLSTAT_LOCK         0x00000001
+
+// Main Oscillator Power-Up Raw Interrupt Status (MOSCPUPRIS, Bit 8) in the RIS and MISC registers
+#define SYSCTL_MOSC_POWER_UP        0x00000100
+
+// Number of polls of the PLL lock status before the main oscillator is used instead
+#define CLOCK_PLL_LOCK_TIMEOUT      100000
+
+// Number of polls of the main oscillator power-up status before the internal oscillator is used instead
+#define CLOCK_MOSC_POWER_UP_TIMEOUT 100000
+
+/**
+ * @brief Configuration of one profile.
+ */
+typedef struct
+{
+    uint32_t system_clock_hz;
+    uint8_t sysdiv;             // Divisor of the 400 MHz PLL output minus 1, or 0 to run from the main oscillator
+} Clock_Profile_Config;
+
+static const Clock_Profile_Config profile_table[CLOCK_PROFILE_COUNT] =
+{
+    [CLOCK_PROFILE_PERFORMANCE] = {80000000, 4},    // 400 MHz / 5
+    [CLOCK_PROFILE_BALANCED]    = {50000000, 7},    // 400 MHz / 8
+    [CLOCK_PROFILE_POWER_SAVE]  = {CLOCK_MAIN_OSC_HZ, 0}
+};
+
+// The system clock runs from a 16 MHz oscillator until Clock_Init is called
+static uint8_t current_profile = CLOCK_PROFILE_POWER_SAVE;
+static uint32_t system_clock_hz = CLOCK_MAIN_OSC_HZ;
+static uint32_t cycles_per_us = CLOCK_MAIN_OSC_HZ / 1000000;
+
+static Clock_Subscriber subscribers[CLOCK_MAX_SUBSCRIBERS];
+static uint8_t subscriber_count = 0;
+
+// Set when a driver could not subscribe, after which the profile no longer changes
+static uint8_t profile_held = 0;
+
+// Enables the main oscillator and returns 1 once the crystal is stable, or returns 0 if it did not start
+static uint8_t Clock_Start_Main_Oscillator(void)
+{
+    // The main oscillator is only disabled until it has been started once
+    if ((SYSCTL->RCC & RCC_MOSCDIS) == 0)
+    {
+        return 1;
+    }
+
+    // Clear the power-up status and enable the main oscillator with the 16 MHz crystal
+    SYSCTL->MISC = SYSCTL_MOSC_POWER_UP;
+    SYSCTL->RCC = (SYSCTL->RCC & ~(RCC_MOSCDIS | RCC_XTAL_MASK)) | RCC_XTAL_16MHZ;
+
+    for (uint32_t poll = 0; (SYSCTL->RIS & SYSCTL_MOSC_POWER_UP) == 0; poll++)
+    {
+        if (poll >= CLOCK_MOSC_POWER_UP_TIMEOUT)
+        {
+            // Disable it again, so that the next profile change tries again
+            SYSCTL->RCC |= RCC_MOSCDIS;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Starts the oscillators of a profile without changing the frequency of the system clock, and returns 1
+// once they are stable, or 0 if the main oscillator did not start or the PLL did not lock
+static uint8_t Clock_Start_Sources(const Clock_Profile_Config *config)
+{
+    if (!Clock_Start_Main_Oscillator())
+    {
+        return 0;
+    }
+
+    if (config->sysdiv == 0)
+    {
+        return 1;
+    }
+
+    if (SYSCTL->RCC2 & RCC2_PWRDN2)
+    {
+        // The PLL is only powered down while its output is bypassed, so selecting the main
+        // oscillator as its source only moves the system clock from the PIOSC to the main
+        // oscillator, which have the same frequency
+        SYSCTL->RCC2 &= ~(RCC2_OSCSRC2_MASK | RCC2_PWRDN2);
+    }
+
+    // Wait for the PLL to lock before it is used as the system clock. The lock status
+    // (unlike the PLLLRIS event, which SystemInit has already consumed) is also set when
+    // the PLL was already powered and locked, since a new divisor does not unlock it.
+    for (uint32_t poll = 0; (SYSCTL->PLLSTAT & SYSCTL_PLLSTAT_LOCK) == 0; poll++)
+    {
+        if (poll >= CLOCK_PLL_LOCK_TIMEOUT)
+        {
+            if (SYSCTL->RCC2 & RCC2_BYPASS2)
+            {
+                SYSCTL->RCC2 |= RCC2_PWRDN2;
+            }
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Switches the system clock to a profile whose oscillators have been started, or to the power-save
+// profile if they did not start. Nothing is waited for, so it can run with interrupts disabled.
+static void Clock_Switch(uint8_t profile, uint8_t started)
+{
+    const Clock_Profile_Config *config = &profile_table[profile];
+
+    // Bypass the PLL while its divisor changes
+    SYSCTL->RCC2 |= RCC2_BYPASS2;
+
+    if (!started || (config->sysdiv == 0))
+    {
+        // Run from the main oscillator undivided, or from the PIOSC (which has the same
+        // frequency) if the crystal did not start, and power down the PLL
+        SYSCTL->RCC &= ~RCC_USESYSDIV;
+        SYSCTL->RCC2 = (SYSCTL->RCC2 & ~RCC2_OSCSRC2_MASK) | RCC2_PWRDN2
+            | ((SYSCTL->RCC & RCC_MOSCDIS) ? RCC2_OSCSRC2_PIOSC : 0);
+        profile = CLOCK_PROFILE_POWER_SAVE;
+    }
+    else
+    {
+        // Select the divisor of the 400 MHz PLL output, then use the locked PLL
+        SYSCTL->RCC2 = (SYSCTL->RCC2 & ~RCC2_SYSDIV_MASK) | RCC2_DIV400 | ((uint32_t)config->sysdiv << RCC2_SYSDIV_SHIFT);
+        SYSCTL->RCC |= RCC_USESYSDIV;
+        SYSCTL->RCC2 &= ~RCC2_BYPASS2;
+    }
+
+    current_profile = profile;
+    system_clock_hz = profile_table[current_profile].system_clock_hz;
+    cycles_per_us = system_clock_hz / 1000000;
+}
+
+void Clock_Init(uint8_t profile)
+{
+    subscriber_count = 0;
+
+    // SystemInit disables the PIOSC (IOSCDIS), which runs the timebase and is the fallback clock
+    SYSCTL->RCC &= ~RCC_IOSCDIS;
+
+    // Both PWM modules are clocked by the system clock divided by 16
+    SYSCTL->RCC = (SYSCTL->RCC & ~RCC_PWMDIV_MASK) | RCC_USEPWMDIV | RCC_PWMDIV_16;
+
+    // Move to RCC2 and run from the PIOSC directly, so that the main oscillator can be
+    // started from a known state
+    SYSCTL->RCC2 |= RCC2_USERCC2 | RCC2_BYPASS2;
+    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~RCC2_OSCSRC2_MASK) | RCC2_OSCSRC2_PIOSC;
+    SYSCTL->RCC = (SYSCTL->RCC & ~(RCC_XTAL_MASK | RCC_USESYSDIV)) | RCC_XTAL_16MHZ;
+
+    profile = (profile < CLOCK_PROFILE_COUNT) ? profile : CLOCK_DEFAULT_PROFILE;
+    Clock_Switch(profile, Clock_Start_Sources(&profile_table[profile]));
+}
+
+uint8_t Clock_Set_Profile(uint8_t profile)
+{
+    if (profile >= CLOCK_PROFILE_COUNT)
+    {
+        return 0;
+    }
+
+    if (profile_held)
+    {
+        return (profile == current_profile) ? 1 : 0;
+    }
+
+    // The oscillators are started with interrupts enabled, since the system clock does not change until the switch
+    uint8_t started = Clock_Start_Sources(&profile_table[profile]);
+
+    // Prevent the interrupts from using a divisor of the previous clock
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    Clock_Switch(profile, started);
+
+    for (uint8_t i = 0; i < subscriber_count; i++)
+    {
+        subscribers[i](system_clock_hz);
+    }
+
+    __set_PRIMASK(primask);
+
+    return started;
+}
+
+void Clock_Hold_Profile(void)
+{
+    profile_held = 1;
+}
+
+uint8_t Clock_Get_Profile(void)
+{
+    return current_profile;
+}
+
+uint32_t Clock_Get_Hz(void)
+{
+    return system_clock_hz;
+}
+
+uint32_t Clock_Get_Cycles_Per_Us(void)
+{
+    return cycles_per_us;
+}
+
+uint32_t Clock_Get_PWM_Hz(void)
+{
+    return system_clock_hz / CLOCK_PWM_DIVIDER;
+}
+
+uint32_t Clock_Get_UART_Divisor(uint32_t baud_rate)
+{
+    // 64 * system clock / (16 * baud rate), rounded to the nearest integer
+    return ((system_clock_hz * 4) + (baud_rate / 2)) / baud_rate;
+}
+
+uint8_t Clock_Subscribe(Clock_Subscriber subscriber)
+{
+    for (uint8_t i = 0; i < subscriber_count; i++)
+    {
+        if (subscribers[i] == subscriber)
+        {
+            return 1;
+        }
+    }
+
+    if ((subscriber == 0) || (subscriber_count >= CLOCK_MAX_SUBSCRIBERS))
+    {
+        return 0;
+    }
+
+    subscribers[subscriber_count] = subscriber;
+    subscriber_count++;
+
+    return 1;
+}
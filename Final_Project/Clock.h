@@ -0,0 +1,170 @@
+/**
+ * @file Clock.h
+ *
+ * @brief Header file for the Clock driver.
+ *
+ * This file contains the function definitions for the clock tree of the Home Security
+ * System. The driver selects the system clock from a small set of profiles:
+ *  - PERFORMANCE: 80 MHz from the PLL (the highest frequency of the TM4C123GH6PM)
+ *  - BALANCED: 50 MHz from the PLL
+ *  - POWER_SAVE: 16 MHz from the main oscillator, with the PLL powered down
+ *
+ * The main oscillator is started the first time a profile is selected, and the clock only
+ * switches to it once its power-up status reports a stable crystal. Until then, the system
+ * runs from the 16 MHz precision internal oscillator (PIOSC). If the crystal does not start,
+ * the system stays on the PIOSC at the frequency of the power-save profile.
+ *
+ * Every driver that depends on the system clock derives its divisors from Clock_Get_Hz
+ * instead of assuming a frequency. A driver that keeps a divisor in a register (a baud
+ * rate, a timer prescaler, or a PWM period) subscribes with Clock_Subscribe and is
+ * called again with the new frequency whenever the profile changes, so a profile can
+ * be switched at runtime without retuning the drivers.
+ *
+ * The PWM clock of both PWM modules is the system clock divided by CLOCK_PWM_DIVIDER.
+ *
+ * @note The timebase (see Timebase.h) runs from the precision internal oscillator, so the
+ * timestamps and the SysTick delays are not affected by a profile change.
+ *
+ * @note Refer to Section 5.3 (Initialization and Configuration) of the TM4C123G
+ * Microcontroller Datasheet for the PLL configuration sequence.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include "TM4C123GH6PM.h"
+
+// Frequency of the main oscillator (crystal) of the LaunchPad
+#define CLOCK_MAIN_OSC_HZ           16000000
+
+// Division of the system clock that feeds the PWM modules
+#define CLOCK_PWM_DIVIDER           16
+
+// Maximum number of functions notified of a profile change (6 are used, the rest is headroom)
+#define CLOCK_MAX_SUBSCRIBERS       10
+
+/**
+ * @brief Clock profiles.
+ */
+enum Clock_Profiles
+{
+    CLOCK_PROFILE_PERFORMANCE   = 0,    // 80 MHz (PLL)
+    CLOCK_PROFILE_BALANCED      = 1,    // 50 MHz (PLL)
+    CLOCK_PROFILE_POWER_SAVE    = 2,    // 16 MHz (main oscillator)
+    CLOCK_PROFILE_COUNT
+};
+
+// Profile selected by Clock_Init in main
+#ifndef CLOCK_DEFAULT_PROFILE
+#define CLOCK_DEFAULT_PROFILE       CLOCK_PROFILE_PERFORMANCE
+#endif
+
+/**
+ * @brief Function notified of a profile change with the new system clock frequency.
+ */
+typedef void (*Clock_Subscriber)(uint32_t system_clock_hz);
+
+/**
+ * @brief Configures the clock tree with a profile.
+ *
+ * This function must be called first in main, before any driver is initialized.
+ * It also selects the PWM clock divider.
+ *
+ * @param profile The profile (see Clock_Profiles).
+ *
+ * @return None
+ */
+void Clock_Init(uint8_t profile);
+
+/**
+ * @brief Switches to another profile and notifies the subscribers.
+ *
+ * The oscillators of the profile are started and the PLL lock is waited for (less than
+ * 1 ms) with interrupts enabled, while the system clock keeps its frequency. Only the
+ * switch itself and the notification of the subscribers run with interrupts disabled.
+ * This function must only be called from task context. A byte that is being
+ * transferred by a UART while its baud rate changes may be received incorrectly.
+ *
+ * @param profile The profile (see Clock_Profiles).
+ *
+ * @return uint8_t Returns 1 if the profile is selected, or 0 if the profile does not exist,
+ *                 the profile is held (see Clock_Hold_Profile), or the main oscillator did
+ *                 not start or the PLL did not lock (the power-save profile is selected then).
+ */
+uint8_t Clock_Set_Profile(uint8_t profile);
+
+/**
+ * @brief Keeps the current profile until the next reset.
+ *
+ * A driver calls this function when Clock_Subscribe fails, so that its divisors stay
+ * valid instead of silently following a profile change.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Hold_Profile(void);
+
+/**
+ * @brief Returns the current profile.
+ *
+ * @param None
+ *
+ * @return uint8_t The current profile (see Clock_Profiles).
+ */
+uint8_t Clock_Get_Profile(void);
+
+/**
+ * @brief Returns the frequency of the system clock.
+ *
+ * @param None
+ *
+ * @return uint32_t The frequency of the system clock in Hz.
+ */
+uint32_t Clock_Get_Hz(void);
+
+/**
+ * @brief Returns the number of system clock cycles per microsecond.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of cycles per microsecond.
+ */
+uint32_t Clock_Get_Cycles_Per_Us(void);
+
+/**
+ * @brief Returns the frequency of the PWM clock.
+ *
+ * @param None
+ *
+ * @return uint32_t The frequency of the PWM clock in Hz.
+ */
+uint32_t Clock_Get_PWM_Hz(void);
+
+/**
+ * @brief Computes the baud rate divisor of a UART that is clocked by the system clock.
+ *
+ * The divisor is the system clock divided by (16 * baud_rate), rounded to 1/64.
+ *
+ * @param baud_rate The baud rate in bits per second.
+ *
+ * @return uint32_t The divisor, with the IBRD value in Bits 21 to 6 and the FBRD value in Bits 5 to 0.
+ */
+uint32_t Clock_Get_UART_Divisor(uint32_t baud_rate);
+
+/**
+ * @brief Registers a function that is notified of every profile change.
+ *
+ * The function is called with interrupts disabled after the new clock is running.
+ * A function that is already registered is not added again.
+ *
+ * @param subscriber The function to notify.
+ *
+ * @return uint8_t Returns 1 if the function is registered, or 0 if the list is full.
+ *                 The caller must then hold the current profile with Clock_Hold_Profile.
+ */
+uint8_t Clock_Subscribe(Clock_Subscriber subscriber);
+
+#endif
@@ -0,0 +1,315 @@
+/**
+ * @file Code_Entry.c
+ *
+ * @brief Source code for the Code_Entry module.
+ *
+ * This file contains the function definitions for the security code entry of the
+ * Home Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Code_Entry.h"
+#include "Timebase.h"
+#include "LCD_Framebuffer.h"
+#include "System_State.h"
+#include "Supervisor.h"
+
+// FNV-1a 64-bit parameters
+#define FNV_OFFSET_BASIS    0xCBF29CE484222325ULL
+#define FNV_PRIME           0x00000100000001B3ULL
+
+// Default code (1-2-3-4), stored as a salt and the matching hash
+static const Code_Entry_Stored_Code default_code =
+{
+    { 0x5A, 0x3C, 0x96, 0xE1, 0x0F, 0x7B, 0xC4, 0x28 },
+    0xB468A0A0CAB67525ULL
+};
+
+static Code_Entry_Stored_Code stored_code;
+
+// Digits entered so far
+static uint8_t entered_digits[CODE_ENTRY_LENGTH];
+static uint8_t entered_count = 0;
+
+// Lockout state
+static uint8_t failed_attempts = 0;
+static uint8_t locked_out = 0;
+
+// Scheduler timers used by code entry
+static Scheduler_Timer entry_timer;
+static Scheduler_Timer lockout_timer;
+
+static uint64_t Code_Entry_Hash(const uint8_t *salt, const uint8_t *digits)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    // Iterate the hash so that each guess costs the same, non-trivial amount of work
+    for (uint32_t round = 0; round < CODE_ENTRY_HASH_ROUNDS; round++)
+    {
+        for (uint8_t i = 0; i < CODE_ENTRY_SALT_LENGTH; i++)
+        {
+            hash = (hash ^ salt[i]) * FNV_PRIME;
+        }
+
+        for (uint8_t i = 0; i < CODE_ENTRY_LENGTH; i++)
+        {
+            hash = (hash ^ digits[i]) * FNV_PRIME;
+        }
+
+        hash = (hash ^ (round & 0xFF)) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static uint8_t Code_Entry_Hashes_Equal(uint64_t hash_a, uint64_t hash_b)
+{
+    // Fold the difference without branches, so the comparison takes the same time for every input
+    uint64_t difference = hash_a ^ hash_b;
+    uint32_t folded = (uint32_t)difference | (uint32_t)(difference >> 32);
+
+    return (uint8_t)(((folded | (0U - folded)) >> 31) ^ 1);
+}
+
+static uint8_t Code_Entry_Button_To_Digit(uint8_t button)
+{
+    switch (button)
+    {
+        case KEYPAD_SW2: return 1;
+        case KEYPAD_SW3: return 2;
+        case KEYPAD_SW4: return 3;
+        case KEYPAD_SW5: return 4;
+        default:         return 0;
+    }
+}
+
+static void Code_Entry_Display_Prompt(void)
+{
+    LCD_Framebuffer_Write_Line(0, "Enter Code:");
+    LCD_Framebuffer_Write_Line(1, "");
+
+    // Only show how many digits have been entered
+    for (uint8_t i = 0; i < entered_count; i++)
+    {
+        LCD_Framebuffer_Write_Char(i, 1, '*');
+    }
+}
+
+static void Code_Entry_Clear_Digits(void)
+{
+    for (uint8_t i = 0; i < CODE_ENTRY_LENGTH; i++)
+    {
+        entered_digits[i] = 0;
+    }
+
+    entered_count = 0;
+    Scheduler_Timer_Stop(&entry_timer);
+}
+
+static uint32_t Code_Entry_Lockout_Duration_ms(void)
+{
+    uint8_t excess_attempts = failed_attempts - CODE_ENTRY_FREE_ATTEMPTS;
+    uint32_t duration_ms = CODE_ENTRY_LOCKOUT_BASE_MS;
+
+    // Double the lockout for every wrong code beyond the free attempts
+    while ((excess_attempts > 0) && (duration_ms < CODE_ENTRY_LOCKOUT_MAX_MS))
+    {
+        duration_ms = duration_ms * 2;
+        excess_attempts--;
+    }
+
+    return (duration_ms > CODE_ENTRY_LOCKOUT_MAX_MS) ? CODE_ENTRY_LOCKOUT_MAX_MS : duration_ms;
+}
+
+static uint32_t Code_Entry_Start_Lockout(void)
+{
+    uint32_t lockout_ms = Code_Entry_Lockout_Duration_ms();
+
+    locked_out = 1;
+    System_State_Post(SYSTEM_EVENT_LOCKOUT);
+    Scheduler_Timer_Start(&lockout_timer, TASK_CODE_ENTRY, SIGNAL_CODE_LOCKOUT_END, lockout_ms, 0);
+
+    return lockout_ms;
+}
+
+static uint8_t Code_Entry_Check(const uint8_t *digits)
+{
+    uint64_t entered_hash = Code_Entry_Hash(stored_code.salt, digits);
+
+    if (Code_Entry_Hashes_Equal(entered_hash, stored_code.hash))
+    {
+        failed_attempts = 0;
+        Supervisor_Save_Failed_Attempts(failed_attempts);
+        return 1;
+    }
+
+    if (failed_attempts < 0xFF)
+    {
+        failed_attempts++;
+    }
+
+    // Save the count before the result is shown, so that a reset cannot clear it
+    Supervisor_Save_Failed_Attempts(failed_attempts);
+
+    if (failed_attempts >= CODE_ENTRY_FREE_ATTEMPTS)
+    {
+        uint32_t lockout_ms = Code_Entry_Start_Lockout();
+
+        // The parameter holds the lockout in seconds
+        Scheduler_Post(TASK_SECURITY, SIGNAL_CODE_REJECTED, (uint16_t)(lockout_ms / 1000));
+    }
+    else
+    {
+        Scheduler_Post(TASK_SECURITY, SIGNAL_CODE_REJECTED, 0);
+    }
+
+    return 0;
+}
+
+static void Code_Entry_Verify(void)
+{
+    uint8_t accepted = Code_Entry_Check(entered_digits);
+
+    Code_Entry_Clear_Digits();
+
+    if (accepted)
+    {
+        Scheduler_Post(TASK_SECURITY, SIGNAL_CODE_ACCEPTED, 0);
+    }
+}
+
+void Code_Entry_Init(void)
+{
+    stored_code = default_code;
+    locked_out = 0;
+    Code_Entry_Clear_Digits();
+
+    Scheduler_Add_Task(TASK_CODE_ENTRY, Code_Entry_Task);
+
+    // A reset or a power cycle does not end the backoff: a count that had reached the
+    // lockout starts the lockout of that count again
+    failed_attempts = Supervisor_Get_Failed_Attempts();
+
+    if (failed_attempts >= CODE_ENTRY_FREE_ATTEMPTS)
+    {
+        Code_Entry_Start_Lockout();
+    }
+}
+
+void Code_Entry_Handle_Button(const Keypad_Event *button_event)
+{
+    uint8_t digit = Code_Entry_Button_To_Digit(button_event->button);
+
+    if ((button_event->type != KEYPAD_EVENT_PRESS) || (digit == 0) || locked_out)
+    {
+        return;
+    }
+
+    entered_digits[entered_count] = digit;
+    entered_count++;
+
+    if (entered_count < CODE_ENTRY_LENGTH)
+    {
+        // Discard the partial code if no digit follows in time
+        Scheduler_Timer_Start(&entry_timer, TASK_CODE_ENTRY, SIGNAL_CODE_TIMEOUT, CODE_ENTRY_TIMEOUT_MS, 0);
+        Code_Entry_Display_Prompt();
+    }
+    else
+    {
+        Code_Entry_Verify();
+    }
+}
+
+void Code_Entry_Cancel(void)
+{
+    Code_Entry_Clear_Digits();
+}
+
+uint8_t Code_Entry_Is_Active(void)
+{
+    return (entered_count > 0) ? 1 : 0;
+}
+
+uint8_t Code_Entry_Is_Locked_Out(void)
+{
+    return locked_out;
+}
+
+uint8_t Code_Entry_Verify_Remote(const uint8_t *digits)
+{
+    if (locked_out)
+    {
+        return CODE_ENTRY_RESULT_LOCKED_OUT;
+    }
+
+    for (uint8_t i = 0; i < CODE_ENTRY_LENGTH; i++)
+    {
+        if ((digits[i] < 1) || (digits[i] > 4))
+        {
+            return CODE_ENTRY_RESULT_INVALID;
+        }
+    }
+
+    return Code_Entry_Check(digits) ? CODE_ENTRY_RESULT_ACCEPTED : CODE_ENTRY_RESULT_REJECTED;
+}
+
+uint8_t Code_Entry_Set_Code(const uint8_t *digits)
+{
+    for (uint8_t i = 0; i < CODE_ENTRY_LENGTH; i++)
+    {
+        if ((digits[i] < 1) || (digits[i] > 4))
+        {
+            return 0;
+        }
+    }
+
+    // Derive a new salt from the previous salt and the time at which the code is changed
+    uint64_t seed = Timebase_Get_Time_us() ^ stored_code.hash;
+
+    for (uint8_t i = 0; i < CODE_ENTRY_SALT_LENGTH; i++)
+    {
+        seed = (seed ^ stored_code.salt[i]) * FNV_PRIME;
+        stored_code.salt[i] = (uint8_t)(seed >> 56);
+    }
+
+    stored_code.hash = Code_Entry_Hash(stored_code.salt, digits);
+
+    return 1;
+}
+
+void Code_Entry_Get_Stored_Code(Code_Entry_Stored_Code *code)
+{
+    *code = stored_code;
+}
+
+void Code_Entry_Load_Stored_Code(const Code_Entry_Stored_Code *code)
+{
+    stored_code = *code;
+}
+
+void Code_Entry_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_CODE_TIMEOUT:
+            // Ignore a timeout that belongs to a code that has already been verified
+            if (Code_Entry_Is_Active() && !Scheduler_Timer_Active(&entry_timer))
+            {
+                Code_Entry_Clear_Digits();
+                Scheduler_Post(TASK_DISPLAY, SIGNAL_DISPLAY_MENU, 0);
+            }
+            break;
+
+        case SIGNAL_CODE_LOCKOUT_END:
+            if (locked_out && !Scheduler_Timer_Active(&lockout_timer))
+            {
+                locked_out = 0;
+                System_State_Post(SYSTEM_EVENT_LOCKOUT_END);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
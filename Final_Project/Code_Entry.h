@@ -0,0 +1,183 @@
+/**
+ * @file Code_Entry.h
+ *
+ * @brief Header file for the Code_Entry module.
+ *
+ * This file contains the function definitions for the security code entry of the
+ * Home Security System. The code is entered with the EduBase push buttons, where
+ * each button is one digit:
+ *  - SW2 = 1, SW3 = 2, SW4 = 3, SW5 = 4
+ *
+ * The code is never stored in clear text. Only a salt and a salted, iterated
+ * FNV-1a hash of the code are stored, and an entered code is verified by comparing
+ * hashes in constant time. Every code has the same length and every verification
+ * performs the same number of hash rounds, so the time taken by a verification does
+ * not depend on how many digits were correct.
+ *
+ * After CODE_ENTRY_FREE_ATTEMPTS consecutive wrong codes, code entry is locked out.
+ * The lockout starts at CODE_ENTRY_LOCKOUT_BASE_MS and doubles with every further
+ * wrong code, up to CODE_ENTRY_LOCKOUT_MAX_MS.
+ * The start and the end of a lockout are posted to the system state machine
+ * (SYSTEM_EVENT_LOCKOUT and SYSTEM_EVENT_LOCKOUT_END). The number of consecutive wrong
+ * codes is saved in the recovery record of the supervisor (see Supervisor.h) and
+ * restored by Code_Entry_Init, which starts the lockout again if it had been reached.
+ *
+ * Code entry runs in task context (TASK_CODE_ENTRY and the caller of
+ * Code_Entry_Handle_Button) and never waits. The result of each code is posted to
+ * the security task as SIGNAL_CODE_ACCEPTED or SIGNAL_CODE_REJECTED.
+ *
+ * A code received from the telemetry link is verified by Code_Entry_Verify_Remote.
+ * It counts toward the lockout like a code entered with the buttons, but an accepted
+ * code is returned to the caller instead of being posted to the security task.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef CODE_ENTRY_H
+#define CODE_ENTRY_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+#include "Keypad.h"
+
+// Number of digits in a security code
+#define CODE_ENTRY_LENGTH           4
+
+// Number of bytes in the salt of the stored code
+#define CODE_ENTRY_SALT_LENGTH      8
+
+// Number of hash rounds used to verify a code
+#define CODE_ENTRY_HASH_ROUNDS      256
+
+// Time after the last digit at which a partial code is discarded
+#define CODE_ENTRY_TIMEOUT_MS       10000
+
+// Number of wrong codes accepted before a lockout
+#define CODE_ENTRY_FREE_ATTEMPTS    3
+
+// Duration of the first lockout and the longest lockout
+#define CODE_ENTRY_LOCKOUT_BASE_MS  5000
+#define CODE_ENTRY_LOCKOUT_MAX_MS   320000
+
+/**
+ * @brief Results of Code_Entry_Verify_Remote.
+ */
+typedef enum
+{
+    CODE_ENTRY_RESULT_ACCEPTED   = 0,   // The code matches the stored code
+    CODE_ENTRY_RESULT_REJECTED   = 1,   // The code is wrong and was counted as a failed attempt
+    CODE_ENTRY_RESULT_LOCKED_OUT = 2,   // Code entry is locked out, the code was not checked
+    CODE_ENTRY_RESULT_INVALID    = 3    // A digit is out of range, the code was not checked
+} Code_Entry_Results;
+
+/**
+ * @brief A stored security code.
+ */
+typedef struct
+{
+    uint8_t salt[CODE_ENTRY_SALT_LENGTH];
+    uint64_t hash;
+} Code_Entry_Stored_Code;
+
+/**
+ * @brief Initializes code entry with the default code and registers TASK_CODE_ENTRY.
+ *
+ * This function must be called after Supervisor_Init, which reads the saved number of wrong codes.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Code_Entry_Init(void);
+
+/**
+ * @brief Handles a button event.
+ *
+ * Each button press adds a digit to the code. The code is verified when
+ * CODE_ENTRY_LENGTH digits have been entered. Presses are ignored during a lockout.
+ *
+ * @param button_event A pointer to the button event.
+ *
+ * @return None
+ */
+void Code_Entry_Handle_Button(const Keypad_Event *button_event);
+
+/**
+ * @brief Discards the digits entered so far.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Code_Entry_Cancel(void);
+
+/**
+ * @brief Indicates whether a code is being entered.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if at least one digit has been entered. Otherwise, it returns 0.
+ */
+uint8_t Code_Entry_Is_Active(void);
+
+/**
+ * @brief Indicates whether code entry is locked out.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 during a lockout. Otherwise, it returns 0.
+ */
+uint8_t Code_Entry_Is_Locked_Out(void);
+
+/**
+ * @brief Verifies a code that was not entered with the buttons.
+ *
+ * A wrong code is counted and posted as SIGNAL_CODE_REJECTED, and can start a lockout,
+ * exactly like a wrong code entered with the buttons. An accepted code resets the count
+ * but is not posted to the security task.
+ *
+ * @param digits A pointer to CODE_ENTRY_LENGTH digits (1 to 4).
+ *
+ * @return uint8_t Returns one of the Code_Entry_Results values.
+ */
+uint8_t Code_Entry_Verify_Remote(const uint8_t *digits);
+
+/**
+ * @brief Replaces the stored code.
+ *
+ * A new salt is derived from the timebase, and only the salt and the hash are kept.
+ *
+ * @param digits A pointer to CODE_ENTRY_LENGTH digits (1 to 4).
+ *
+ * @return uint8_t Returns 1 if the code was changed, or 0 if a digit is out of range.
+ */
+uint8_t Code_Entry_Set_Code(const uint8_t *digits);
+
+/**
+ * @brief Copies the stored code (salt and hash).
+ *
+ * @param stored_code A pointer to where the stored code is copied.
+ *
+ * @return None
+ */
+void Code_Entry_Get_Stored_Code(Code_Entry_Stored_Code *stored_code);
+
+/**
+ * @brief Replaces the stored code with a salt and hash saved earlier.
+ *
+ * @param stored_code A pointer to the stored code.
+ *
+ * @return None
+ */
+void Code_Entry_Load_Stored_Code(const Code_Entry_Stored_Code *stored_code);
+
+/**
+ * @brief Event handler of the code entry task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Code_Entry_Task(const Scheduler_Event *event);
+
+#endif
@@ -0,0 +1,369 @@
+/**
+ * @file Config.c
+ *
+ * @brief Source code for the Config module.
+ *
+ * This file contains the function definitions for the runtime configuration store of
+ * the Home Security System.
+ *
+ * The configuration is kept in a union with the words of a slot, so it is loaded and
+ * saved word by word without packing. A save writes the other slot than the one that
+ * was loaded: the header is written first and the CRC last, so the new slot is only
+ * valid once it is complete.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Config.h"
+#include "EEPROM.h"
+#include "Zone.h"
+#include "Buzzer.h"
+#include "System_State.h"
+
+// Default value and range of a parameter
+typedef struct
+{
+    uint16_t value;
+    uint16_t min;
+    uint16_t max;
+} Config_Param_Info;
+
+static const Config_Param_Info param_table[CONFIG_PARAM_COUNT] =
+{
+    [CONFIG_PARAM_EXIT_DELAY_MS]        = { SYSTEM_STATE_EXIT_DELAY_MS, 1000, 60000 },
+    [CONFIG_PARAM_ENTRY_DELAY_MS]       = { SYSTEM_STATE_ENTRY_DELAY_MS, 1000, 60000 },
+    [CONFIG_PARAM_ALARM_CYCLES]         = { 10, 1, 100 },
+    [CONFIG_PARAM_ALARM_STEP_MS]        = { 250, 50, 2000 },
+    [CONFIG_PARAM_ALARM_MESSAGE_MS]     = { 3000, 1, 10000 },
+    [CONFIG_PARAM_STATUS_MESSAGE_MS]    = { 3000, 500, 10000 },
+    [CONFIG_PARAM_SIREN_HIGH_NOTE]      = { NOTE_A4, NOTE_C4, NOTE_COUNT - 1 },
+    [CONFIG_PARAM_SIREN_LOW_NOTE]       = { NOTE_G4, NOTE_C4, NOTE_COUNT - 1 },
+    [CONFIG_PARAM_RANGE_PERIOD_MS]      = { 200, 0, 1000 }
+};
+
+/**
+ * @brief Contents of a slot between the header and the CRC.
+ */
+typedef struct
+{
+    uint16_t values[CONFIG_PARAM_COUNT];
+    uint8_t filter_mask;                                // Zones with a stored filter configuration (Bit 0 = zone 0)
+    Intrusion_Filter_Config filters[CONFIG_ZONE_COUNT];
+} Config_Data;
+
+#define CONFIG_DATA_WORDS           ((sizeof(Config_Data) + 3) / 4)
+
+// Words of a slot: the header, the configuration, and the CRC
+#define CONFIG_HEADER_WORD          0
+#define CONFIG_CRC_WORD             (CONFIG_DATA_WORDS + 1)
+#define CONFIG_SLOT_WORDS           (CONFIG_DATA_WORDS + 2)
+
+// The slots are the second and the third system blocks (the first one holds the Supervisor record)
+#define CONFIG_SLOT_COUNT           2
+#define CONFIG_SLOT_ADDRESS(slot)   ((EEPROM_SYSTEM_FIRST_BLOCK + 1 + (slot)) * EEPROM_WORDS_PER_BLOCK)
+#define CONFIG_SLOT_NONE            0xFF
+
+_Static_assert(CONFIG_SLOT_WORDS <= EEPROM_WORDS_PER_BLOCK, "A configuration slot must fit in one EEPROM block");
+_Static_assert((1 + CONFIG_SLOT_COUNT) <= EEPROM_SYSTEM_BLOCK_COUNT, "The configuration slots must fit in the system blocks");
+_Static_assert(CONFIG_ZONE_COUNT <= 8, "The filter mask holds 8 zones");
+
+// The configuration in RAM
+static union
+{
+    Config_Data data;
+    uint32_t words[CONFIG_DATA_WORDS];
+} config;
+
+// Slot that holds the saved configuration, and its save sequence
+static uint8_t active_slot = CONFIG_SLOT_NONE;
+static uint8_t active_sequence = 0;
+
+// Background writer state
+static uint32_t save_words[CONFIG_SLOT_WORDS];
+static uint8_t save_slot = 0;
+static uint8_t save_word = 0;
+static uint8_t saving = 0;
+static uint8_t save_again = 0;
+static Scheduler_Timer save_timer;
+static Scheduler_Timer poll_timer;
+
+// CRC-16 (CCITT) of the words of a slot, computed bit by bit since it only runs at boot and before a save
+static uint16_t Config_CRC16(const uint32_t *words, uint8_t word_count)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint8_t i = 0; i < word_count; i++)
+    {
+        for (uint8_t byte = 0; byte < 4; byte++)
+        {
+            crc ^= (uint16_t)(((words[i] >> (byte * 8)) & 0xFF) << 8);
+
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+            }
+        }
+    }
+
+    return crc;
+}
+
+static uint32_t Config_Pack_Header(uint8_t sequence)
+{
+    return ((uint32_t)CONFIG_MAGIC << 16) | ((uint32_t)CONFIG_VERSION << 8) | sequence;
+}
+
+// Reads a slot and returns 1 if it holds a complete configuration of this version
+static uint8_t Config_Read_Slot(uint8_t slot, uint32_t *words)
+{
+    for (uint8_t word = 0; word < CONFIG_SLOT_WORDS; word++)
+    {
+        words[word] = EEPROM_Read_Word(CONFIG_SLOT_ADDRESS(slot) + word);
+    }
+
+    if ((words[CONFIG_HEADER_WORD] >> 8) != (((uint32_t)CONFIG_MAGIC << 8) | CONFIG_VERSION))
+    {
+        return 0;
+    }
+
+    return (words[CONFIG_CRC_WORD] == Config_CRC16(words, CONFIG_CRC_WORD)) ? 1 : 0;
+}
+
+static void Config_Load_Defaults(void)
+{
+    for (uint8_t param = 0; param < CONFIG_PARAM_COUNT; param++)
+    {
+        config.data.values[param] = param_table[param].value;
+    }
+
+    config.data.filter_mask = 0;
+}
+
+// Restarts the save delay, so that the changes made until it expires are saved together
+static void Config_Schedule_Save(void)
+{
+    if (EEPROM_Is_Ready())
+    {
+        Scheduler_Timer_Start(&save_timer, TASK_CONFIG, SIGNAL_CONFIG_SAVE, CONFIG_SAVE_DELAY_MS, 0);
+    }
+}
+
+static uint8_t Config_Matches_Active_Slot(void)
+{
+    if (active_slot == CONFIG_SLOT_NONE)
+    {
+        return 0;
+    }
+
+    for (uint8_t word = 0; word < CONFIG_DATA_WORDS; word++)
+    {
+        if (EEPROM_Read_Word(CONFIG_SLOT_ADDRESS(active_slot) + 1 + word) != config.words[word])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Starts the next word of the slot being saved, or finishes the save
+static void Config_Write_Next(void)
+{
+    if (EEPROM_Is_Busy())
+    {
+        return;
+    }
+
+    while (save_word < CONFIG_SLOT_WORDS)
+    {
+        uint16_t address = CONFIG_SLOT_ADDRESS(save_slot) + save_word;
+
+        // A word that already holds its value is not programmed again
+        if (EEPROM_Read_Word(address) == save_words[save_word])
+        {
+            save_word++;
+            continue;
+        }
+
+        if (EEPROM_Write_Start(address, save_words[save_word]))
+        {
+            save_word++;
+        }
+        return;
+    }
+
+    // The last word has been written
+    saving = 0;
+    active_slot = save_slot;
+    active_sequence = (uint8_t)save_words[CONFIG_HEADER_WORD];
+    Scheduler_Timer_Stop(&poll_timer);
+}
+
+// Takes a snapshot of the configuration and starts writing it to the other slot
+static void Config_Start_Save(void)
+{
+    if (Config_Matches_Active_Slot())
+    {
+        return;
+    }
+
+    save_slot = (active_slot == 0) ? 1 : 0;
+    save_words[CONFIG_HEADER_WORD] = Config_Pack_Header((uint8_t)(active_sequence + 1));
+
+    for (uint8_t word = 0; word < CONFIG_DATA_WORDS; word++)
+    {
+        save_words[1 + word] = config.words[word];
+    }
+
+    save_words[CONFIG_CRC_WORD] = Config_CRC16(save_words, CONFIG_CRC_WORD);
+
+    saving = 1;
+    save_word = 0;
+    Scheduler_Timer_Start(&poll_timer, TASK_CONFIG, SIGNAL_CONFIG_POLL, CONFIG_POLL_PERIOD_MS, CONFIG_POLL_PERIOD_MS);
+    Config_Write_Next();
+}
+
+uint8_t Config_Init(void)
+{
+    uint32_t words[CONFIG_SLOT_WORDS];
+    uint8_t sequences[CONFIG_SLOT_COUNT];
+
+    active_slot = CONFIG_SLOT_NONE;
+    active_sequence = 0;
+    saving = 0;
+    save_again = 0;
+
+    Scheduler_Add_Task(TASK_CONFIG, Config_Task);
+
+    // Erased words are read if the EEPROM is not available
+    for (uint8_t slot = 0; slot < CONFIG_SLOT_COUNT; slot++)
+    {
+        if (!Config_Read_Slot(slot, words))
+        {
+            continue;
+        }
+
+        sequences[slot] = (uint8_t)words[CONFIG_HEADER_WORD];
+
+        // The sequence wraps around, so the newer slot is the one up to 127 saves ahead
+        if ((active_slot == CONFIG_SLOT_NONE) || ((int8_t)(sequences[slot] - sequences[active_slot]) > 0))
+        {
+            active_slot = slot;
+            active_sequence = sequences[slot];
+
+            for (uint8_t word = 0; word < CONFIG_DATA_WORDS; word++)
+            {
+                config.words[word] = words[1 + word];
+            }
+        }
+    }
+
+    if (active_slot == CONFIG_SLOT_NONE)
+    {
+        Config_Load_Defaults();
+        return 0;
+    }
+
+    // A value outside of its range can only come from a layout that was changed without a new version
+    for (uint8_t param = 0; param < CONFIG_PARAM_COUNT; param++)
+    {
+        if ((config.data.values[param] < param_table[param].min) || (config.data.values[param] > param_table[param].max))
+        {
+            config.data.values[param] = param_table[param].value;
+        }
+    }
+
+    return 1;
+}
+
+uint16_t Config_Get(uint8_t param)
+{
+    return (param < CONFIG_PARAM_COUNT) ? config.data.values[param] : 0;
+}
+
+uint8_t Config_Set(uint8_t param, uint16_t value)
+{
+    if ((param >= CONFIG_PARAM_COUNT) || (value < param_table[param].min) || (value > param_table[param].max))
+    {
+        return 0;
+    }
+
+    if (config.data.values[param] != value)
+    {
+        config.data.values[param] = value;
+        Config_Schedule_Save();
+    }
+
+    return 1;
+}
+
+uint8_t Config_Get_Range(uint8_t param, uint16_t *min, uint16_t *max)
+{
+    if (param >= CONFIG_PARAM_COUNT)
+    {
+        return 0;
+    }
+
+    *min = param_table[param].min;
+    *max = param_table[param].max;
+
+    return 1;
+}
+
+uint8_t Config_Get_Filter(uint8_t zone, Intrusion_Filter_Config *filter_config)
+{
+    if ((zone >= CONFIG_ZONE_COUNT) || !(config.data.filter_mask & (1 << zone)))
+    {
+        return 0;
+    }
+
+    *filter_config = config.data.filters[zone];
+
+    return 1;
+}
+
+void Config_Set_Filter(uint8_t zone, const Intrusion_Filter_Config *filter_config)
+{
+    Zone_Set_Filter_Config(zone, filter_config);
+
+    if (zone < CONFIG_ZONE_COUNT)
+    {
+        config.data.filters[zone] = *filter_config;
+        config.data.filter_mask |= (uint8_t)(1 << zone);
+        Config_Schedule_Save();
+    }
+}
+
+void Config_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_CONFIG_SAVE:
+            // The changes made during a save are saved once it is complete
+            if (saving)
+            {
+                save_again = 1;
+            }
+            else
+            {
+                Config_Start_Save();
+            }
+            break;
+
+        case SIGNAL_CONFIG_POLL:
+            if (saving)
+            {
+                Config_Write_Next();
+
+                if (!saving && save_again)
+                {
+                    save_again = 0;
+                    Config_Start_Save();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
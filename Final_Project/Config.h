@@ -0,0 +1,154 @@
+/**
+ * @file Config.h
+ *
+ * @brief Header file for the Config module.
+ *
+ * This file contains the function definitions for the runtime configuration store of
+ * the Home Security System. The timing, alarm, and ranging settings are parameters
+ * identified by Config_Params, and the intrusion thresholds are the filter
+ * configurations of the zones (see Intrusion_Filter.h). Every setting is kept in one
+ * RAM copy, and the modules read it each time it is used, so a change applies
+ * immediately without a rebuild:
+ *  - The exit and entry delays apply the next time the state is entered.
+ *  - The alarm settings apply to the next alarm, and the status message duration to
+ *    the next message.
+ *  - The ranging period applies when the sensors are started again (on arming).
+ *  - A filter configuration applies to the next sample.
+ *
+ * The configuration is stored in two slots of the EEPROM (Blocks 1 and 2), written in
+ * turn, so an interrupted save never destroys the last complete configuration:
+ *  - Word 0: CONFIG_MAGIC (Bits 31:16), CONFIG_VERSION (Bits 15:8), and a save sequence (Bits 7:0)
+ *  - Words 1 to CONFIG_DATA_WORDS: the configuration
+ *  - Last word: CRC-16 (CCITT, initial value 0xFFFF) of the previous words (Bits 15:0)
+ * Config_Init copies the newest valid slot to RAM in one pass. A slot with a bad CRC or
+ * another version is ignored, and the defaults are used when neither slot is valid.
+ *
+ * Changes are saved in one batch CONFIG_SAVE_DELAY_MS after the last one, so a burst of
+ * commands costs a single save. TASK_CONFIG writes the slot one word at a time in the
+ * background and skips the words that already hold their value, so only the header,
+ * the CRC, and the changed words are programmed.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+#include "Intrusion_Filter.h"
+
+// Upper half of the header word of a slot, and the layout version of the configuration
+#define CONFIG_MAGIC                0xC0F1
+#define CONFIG_VERSION              1
+
+// Largest number of zones whose filter configuration is stored
+#define CONFIG_ZONE_COUNT           3
+
+// Time from the last change to the save
+#define CONFIG_SAVE_DELAY_MS        5000
+
+// Period at which the completion of a word write is polled during a save
+#define CONFIG_POLL_PERIOD_MS       1
+
+/**
+ * @brief Parameters of the configuration.
+ */
+enum Config_Params
+{
+    CONFIG_PARAM_EXIT_DELAY_MS      = 0,    // Duration of the exit delay
+    CONFIG_PARAM_ENTRY_DELAY_MS     = 1,    // Duration of the entry delay
+    CONFIG_PARAM_ALARM_CYCLES       = 2,    // Number of siren cycles of an alarm
+    CONFIG_PARAM_ALARM_STEP_MS      = 3,    // Duration of each half of a siren cycle
+    CONFIG_PARAM_ALARM_MESSAGE_MS   = 4,    // Duration of the intruder message before the siren starts
+    CONFIG_PARAM_STATUS_MESSAGE_MS  = 5,    // Duration of a status message on the LCD
+    CONFIG_PARAM_SIREN_HIGH_NOTE    = 6,    // First note of a siren cycle (see Buzzer_Notes)
+    CONFIG_PARAM_SIREN_LOW_NOTE     = 7,    // Second note of a siren cycle (see Buzzer_Notes)
+    CONFIG_PARAM_RANGE_PERIOD_MS    = 8,    // Period of the range measurements (0 = as fast as the sensor replies,
+                                            // the default of 200 ms lets the processor enter deep-sleep mode in between)
+    CONFIG_PARAM_COUNT
+};
+
+/**
+ * @brief Loads the configuration from the EEPROM and registers TASK_CONFIG.
+ *
+ * This function must be called after Event_Log_Init (which initializes the EEPROM)
+ * and before Security_Init, which reads the configuration.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if a stored configuration was loaded, or 0 if the defaults are used.
+ */
+uint8_t Config_Init(void);
+
+/**
+ * @brief Returns the value of a parameter.
+ *
+ * @param param The parameter (see Config_Params).
+ *
+ * @return uint16_t The value of the parameter, or 0 if the parameter does not exist.
+ */
+uint16_t Config_Get(uint8_t param);
+
+/**
+ * @brief Changes the value of a parameter and schedules a save.
+ *
+ * This function must only be called from task context.
+ *
+ * @param param The parameter (see Config_Params).
+ *
+ * @param value The new value.
+ *
+ * @return uint8_t Returns 1 if the value was changed, or 0 if the parameter does not
+ *                 exist or the value is out of its range.
+ */
+uint8_t Config_Set(uint8_t param, uint16_t value);
+
+/**
+ * @brief Copies the range of the values of a parameter.
+ *
+ * @param param The parameter (see Config_Params).
+ *
+ * @param min A pointer to where the smallest value is copied.
+ *
+ * @param max A pointer to where the largest value is copied.
+ *
+ * @return uint8_t Returns 1 if the parameter exists. Otherwise, it returns 0.
+ */
+uint8_t Config_Get_Range(uint8_t param, uint16_t *min, uint16_t *max);
+
+/**
+ * @brief Copies the stored filter configuration of a zone.
+ *
+ * @param zone The index of the zone.
+ *
+ * @param config A pointer to where the filter configuration is copied.
+ *
+ * @return uint8_t Returns 1 if a filter configuration was stored for the zone, or 0 if
+ *                 the zone uses the default thresholds of the zone table.
+ */
+uint8_t Config_Get_Filter(uint8_t zone, Intrusion_Filter_Config *config);
+
+/**
+ * @brief Applies a filter configuration to the sensors of a zone and schedules a save.
+ *
+ * This function must only be called from task context.
+ *
+ * @param zone The index of the zone (less than Zone_Get_Count).
+ *
+ * @param config A pointer to the filter configuration (validated by the caller).
+ *
+ * @return None
+ */
+void Config_Set_Filter(uint8_t zone, const Intrusion_Filter_Config *config);
+
+/**
+ * @brief Event handler of the configuration task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Config_Task(const Scheduler_Event *event);
+
+#endif
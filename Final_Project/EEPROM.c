@@ -0,0 +1,147 @@
+/**
+ * @file EEPROM.c
+ *
+ * @brief Source code for the EEPROM driver.
+ *
+ * This file contains the function definitions for the EEPROM driver.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "EEPROM.h"
+
+// WORKING bit (Bit 0) of the EEDONE register
+#define EEPROM_DONE_WORKING         0x01
+
+// Error bits of the EEDONE register (WRBUSY, NOPERM, WKCOPY, WKERASE)
+#define EEPROM_DONE_ERRORS          0x3C
+
+// PRETRY (Bit 3) and ERETRY (Bit 2) bits of the EESUPP register
+#define EEPROM_SUPP_RETRY_ERRORS    0x0C
+
+static uint8_t eeprom_ready = 0;
+
+// Address of the last word written, whose result is in the EEDONE register
+static uint16_t last_write_address = EEPROM_WORD_COUNT;
+
+static void EEPROM_Wait_Idle(void)
+{
+	while (EEPROM->EEDONE & EEPROM_DONE_WORKING);
+}
+
+static void EEPROM_Select_Word(uint16_t address)
+{
+	EEPROM->EEBLOCK = address / EEPROM_WORDS_PER_BLOCK;
+	EEPROM->EEOFFSET = address % EEPROM_WORDS_PER_BLOCK;
+}
+
+uint8_t EEPROM_Init(void)
+{
+	eeprom_ready = 0;
+	last_write_address = EEPROM_WORD_COUNT;
+	
+	// Enable the clock to the EEPROM module by setting the
+	// R0 bit (Bit 0) in the RCGCEEPROM register
+	SYSCTL->RCGCEEPROM |= 0x01;
+	while ((SYSCTL->PREEPROM & 0x01) == 0);
+	
+	// Wait for the EEPROM module to finish recovering from an interrupted write
+	EEPROM_Wait_Idle();
+	
+	if (EEPROM->EESUPP & EEPROM_SUPP_RETRY_ERRORS)
+	{
+		return 0;
+	}
+	
+	// Reset the EEPROM module so that the recovery result is applied
+	SYSCTL->SREEPROM |= 0x01;
+	SYSCTL->SREEPROM &= ~0x01;
+	while ((SYSCTL->PREEPROM & 0x01) == 0);
+	
+	EEPROM_Wait_Idle();
+	
+	if (EEPROM->EESUPP & EEPROM_SUPP_RETRY_ERRORS)
+	{
+		return 0;
+	}
+	
+	eeprom_ready = 1;
+	
+	return 1;
+}
+
+uint8_t EEPROM_Is_Ready(void)
+{
+	return eeprom_ready;
+}
+
+uint8_t EEPROM_Is_Busy(void)
+{
+	return (EEPROM->EEDONE & EEPROM_DONE_WORKING) ? 1 : 0;
+}
+
+uint32_t EEPROM_Read_Word(uint16_t address)
+{
+	if (!eeprom_ready || (address >= EEPROM_WORD_COUNT))
+	{
+		return EEPROM_ERASED_WORD;
+	}
+	
+	EEPROM_Wait_Idle();
+	EEPROM_Select_Word(address);
+	
+	return EEPROM->EERDWR;
+}
+
+uint8_t EEPROM_Write_Start(uint16_t address, uint32_t data)
+{
+	if (!eeprom_ready || (address >= EEPROM_WORD_COUNT) || EEPROM_Is_Busy())
+	{
+		return 0;
+	}
+	
+	EEPROM_Select_Word(address);
+	
+	// Writing the EERDWR register starts programming the word
+	EEPROM->EERDWR = data;
+	last_write_address = address;
+	
+	return 1;
+}
+
+uint8_t EEPROM_Get_Write_Result(uint16_t address, uint32_t data)
+{
+	if (!eeprom_ready || (address >= EEPROM_WORD_COUNT))
+	{
+		return EEPROM_WRITE_FAILED;
+	}
+	
+	if (EEPROM_Is_Busy())
+	{
+		return EEPROM_WRITE_BUSY;
+	}
+	
+	if ((address == last_write_address) && (EEPROM->EEDONE & EEPROM_DONE_ERRORS))
+	{
+		return EEPROM_WRITE_FAILED;
+	}
+	
+	// The EEPROM is idle, so the word is read without waiting
+	EEPROM_Select_Word(address);
+	
+	return (EEPROM->EERDWR == data) ? EEPROM_WRITE_DONE : EEPROM_WRITE_FAILED;
+}
+
+uint8_t EEPROM_Write_Word(uint16_t address, uint32_t data)
+{
+	EEPROM_Wait_Idle();
+	
+	if (!EEPROM_Write_Start(address, data))
+	{
+		return 0;
+	}
+	
+	EEPROM_Wait_Idle();
+	
+	return (EEPROM->EEDONE & EEPROM_DONE_ERRORS) ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file EEPROM.h
+ *
+ * @brief Header file for the EEPROM driver.
+ *
+ * This file contains the function definitions for the EEPROM driver.
+ * The TM4C123GH6PM has 2 KB of on-chip EEPROM organized as 32 blocks of
+ * 16 words (64 bytes). Words are addressed from 0 to EEPROM_WORD_COUNT - 1,
+ * where word address = (block * 16) + offset.
+ *
+ * A read completes in a few system clock cycles. A write takes much longer
+ * (typically hundreds of microseconds, and longer when the EEPROM has to compact
+ * its copy buffer), so writes are started with EEPROM_Write_Start and their
+ * completion is polled with EEPROM_Is_Busy or EEPROM_Get_Write_Result. The blocking
+ * EEPROM_Write_Word is only meant for initialization code.
+ *
+ * The EEPROM is shared by the following modules (word addresses):
+ *  - Block 0:        Supervisor recovery record (words 0 to 3)
+ *  - Blocks 1 and 2: Config slots
+ *  - Block 3:        reserved for system data
+ *  - Blocks 4 to 31: Event_Log records
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include "TM4C123GH6PM.h"
+
+// Size of the EEPROM
+#define EEPROM_WORDS_PER_BLOCK      16
+#define EEPROM_BLOCK_COUNT          32
+#define EEPROM_WORD_COUNT           (EEPROM_WORDS_PER_BLOCK * EEPROM_BLOCK_COUNT)
+
+// Value of an erased word
+#define EEPROM_ERASED_WORD          0xFFFFFFFF
+
+// Layout of the EEPROM
+#define EEPROM_SYSTEM_FIRST_BLOCK   0
+#define EEPROM_SYSTEM_BLOCK_COUNT   4
+#define EEPROM_LOG_FIRST_BLOCK      4
+#define EEPROM_LOG_BLOCK_COUNT      28
+
+/**
+ * @brief Results of a write started with EEPROM_Write_Start.
+ */
+enum EEPROM_Write_Results
+{
+    EEPROM_WRITE_DONE       = 0,    // The word holds the data
+    EEPROM_WRITE_BUSY       = 1,    // The EEPROM is still programming a word
+    EEPROM_WRITE_FAILED     = 2     // The EEPROM module reported an error, or the word does not hold the data
+};
+
+/**
+ * @brief Enables the EEPROM module and checks that it has recovered from any interrupted write.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the EEPROM is ready, or 0 if the EEPROM module reported an error.
+ */
+uint8_t EEPROM_Init(void);
+
+/**
+ * @brief Indicates whether the EEPROM module was initialized without errors.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the EEPROM is ready. Otherwise, it returns 0.
+ */
+uint8_t EEPROM_Is_Ready(void);
+
+/**
+ * @brief Indicates whether a write is in progress.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 while the EEPROM is programming a word. Otherwise, it returns 0.
+ */
+uint8_t EEPROM_Is_Busy(void);
+
+/**
+ * @brief Reads one word. Waits for a write in progress to finish first.
+ *
+ * @param address The word address (0 to EEPROM_WORD_COUNT - 1).
+ *
+ * @return uint32_t The word, or EEPROM_ERASED_WORD if the address is out of range.
+ */
+uint32_t EEPROM_Read_Word(uint16_t address);
+
+/**
+ * @brief Starts writing one word and returns without waiting for the write to finish.
+ *
+ * The EEPROM must not be busy when this function is called.
+ *
+ * @param address The word address (0 to EEPROM_WORD_COUNT - 1).
+ *
+ * @param data The word to write.
+ *
+ * @return uint8_t Returns 1 if the write was started, or 0 if the EEPROM is busy or the address is out of range.
+ */
+uint8_t EEPROM_Write_Start(uint16_t address, uint32_t data);
+
+/**
+ * @brief Returns the result of a write started with EEPROM_Write_Start, without waiting.
+ *
+ * When the word was the last one written, the error bits of the EEDONE register
+ * (WRBUSY, NOPERM, WKCOPY, WKERASE) are checked. The word is then read back, so a
+ * failed write is also found after another word has been written.
+ *
+ * @param address The word address (0 to EEPROM_WORD_COUNT - 1).
+ *
+ * @param data The word that was written.
+ *
+ * @return uint8_t The result of the write (see EEPROM_Write_Results).
+ */
+uint8_t EEPROM_Get_Write_Result(uint16_t address, uint32_t data);
+
+/**
+ * @brief Writes one word and waits for the write to finish.
+ *
+ * @param address The word address (0 to EEPROM_WORD_COUNT - 1).
+ *
+ * @param data The word to write.
+ *
+ * @return uint8_t Returns 1 if the word was written. Otherwise, it returns 0.
+ */
+uint8_t EEPROM_Write_Word(uint16_t address, uint32_t data);
+
+#endif
@@ -7,14 +7,17 @@
  * It interfaces with the EduBase Board push buttons. The following pins are used:
  *	- SW2 (PD3)
  *	- SW3 (PD2)
+ *	- SW4 (PD1)
+ *	- SW5 (PD0)
  *
- * It configures the pins to trigger interrupts on rising edges. The EduBase Board 
+ * It configures the pins to trigger interrupts on both edges. The EduBase Board 
  * push buttons operate in an active high configuration.
  *
  * @author Aaron Nanas
  */
 
 #include "EduBase_Button_Interrupt.h"
+#include "Profile.h"
 
 // Declare a pointer to the user-defined task
 void (*EduBase_Button_Task)(uint8_t edubase_button_status);
@@ -25,44 +28,39 @@ void EduBase_Button_Interrupt_Init(void(*task)(uint8_t))
 	EduBase_Button_Task = task;
 	
 	// Enable the clock to Port D by setting the R3 bit (Bit 3) in the RCGCGPIO register
-	SYSCTL->RCGCGPIO |= 0x08;
+	SYSCTL->RCGCGPIO |= PIN_CLOCK(PIN_EDUBASE_BUTTONS);
 	
-	// Configure the PD3 and PD2 pins as input by clearing Bits 3 to 2 in the DIR register
-	GPIOD->DIR &= ~0x0C;
+	// Configure the PD3 to PD0 pins as input by clearing Bits 3 to 0 in the DIR register
+	EDUBASE_BUTTON_PORT->DIR &= ~EDUBASE_BUTTON_PINS;
 	
-	// Configure the PD3 and PD2 pins to function as
-	// GPIO pins by clearing Bits 3 to 2 in the AFSEL register
-	GPIOD->AFSEL &= ~0x0C;
+	// Configure the PD3 to PD0 pins to function as
+	// GPIO pins by clearing Bits 3 to 0 in the AFSEL register
+	EDUBASE_BUTTON_PORT->AFSEL &= ~EDUBASE_BUTTON_PINS;
 	
-	// Enable the digital functionality for the PD3 and PD2 pins
-	// by setting Bits 3 to 2 in the DEN register
-	GPIOD->DEN |= 0x0C;
+	// Enable the digital functionality for the PD3 to PD0 pins
+	// by setting Bits 3 to 0 in the DEN register
+	EDUBASE_BUTTON_PORT->DEN |= EDUBASE_BUTTON_PINS;
 	
-	// Enable the weak pull-down resistor for the PD3 and PD2 pins
-	// by setting Bits 3 to 2 in the PDR register
-	GPIOD->PDR |= 0x0C;
+	// Enable the weak pull-down resistor for the PD3 to PD0 pins
+	// by setting Bits 3 to 0 in the PDR register
+	EDUBASE_BUTTON_PORT->PDR |= EDUBASE_BUTTON_PINS;
 	
-	// Configure the PD3 and PD2 pins to detect edges
-	// by clearing Bits 3 to 2 in the IS register
-	GPIOD->IS &= ~0x0C;
+	// Configure the PD3 to PD0 pins to detect edges
+	// by clearing Bits 3 to 0 in the IS register
+	EDUBASE_BUTTON_PORT->IS &= ~EDUBASE_BUTTON_PINS;
 	
-	// Allow the GPIOIEV register to handle interrupt generation
-	// and determine which edge to check for the PD3 and PD2 pins 
-	// by clearing Bits 3 to 2 in the IBE register
-	GPIOD->IBE &= ~0x0C;
+	// Configure the PD3 to PD0 pins to detect both rising and
+	// falling edges by setting Bits 3 to 0 in the IBE register
+	// The GPIOIEV register is ignored for these pins
+	EDUBASE_BUTTON_PORT->IBE |= EDUBASE_BUTTON_PINS;
 	
-	// Configure the PD3 and PD2 pins to detect
-	// rising edges by setting Bits 3 to 2 in the IEV register
-	// Rising edges on the corresponding pins will trigger interrupts
-	GPIOD->IEV |= 0x0C;
+	// Clear any existing interrupt flags on the PD3 to PD0 pins
+	// by setting Bits 3 to 0 in the ICR register
+	EDUBASE_BUTTON_PORT->ICR = EDUBASE_BUTTON_PINS;
 	
-	// Clear any existing interrupt flags on the PD3 and PD2 pins
-	// by setting Bits 3 to 2 in the ICR register
-	GPIOD->ICR |= 0x0C;
-	
-	// Allow the interrupts that are generated by the PD3 and PD2 pins to be 
-	// sent to the interrupt controller by setting Bits 3 to 2 in the IM register
-	GPIOD->IM |= 0x0C;
+	// Allow the interrupts that are generated by the PD3 to PD0 pins to be 
+	// sent to the interrupt controller by setting Bits 3 to 0 in the IM register
+	EDUBASE_BUTTON_PORT->IM |= EDUBASE_BUTTON_PINS;
 	
 	// Clear the INTD field (Bits 31 to 29) of the IPR[0] register (PRI0)
 	NVIC->IPR[0] &= ~0xE0000000;
@@ -74,18 +72,39 @@ void EduBase_Button_Interrupt_Init(void(*task)(uint8_t))
 	NVIC->ISER[0] |= (1 << 3);
 }
 
+void EduBase_Button_Interrupt_Enable(uint8_t button_mask)
+{
+	button_mask = button_mask & EDUBASE_BUTTON_PINS;
+	
+	// Clear the edges that were detected while the interrupts were disabled
+	// and allow the interrupts to be sent to the interrupt controller
+	EDUBASE_BUTTON_PORT->ICR = button_mask;
+	EDUBASE_BUTTON_PORT->IM |= button_mask;
+}
+
+void EduBase_Button_Interrupt_Disable(uint8_t button_mask)
+{
+	EDUBASE_BUTTON_PORT->IM &= ~(button_mask & EDUBASE_BUTTON_PINS);
+}
+
 void GPIOD_Handler(void)
 {
+	PROFILE_BEGIN();
+	
 	// Check if an interrupt has been triggered by any of
-	// the following pins: PD3 and PD2
-	if (GPIOD->MIS & 0x0C)
+	// the following pins: PD3, PD2, PD1, and PD0
+	uint8_t interrupt_status = EDUBASE_BUTTON_PORT->MIS & EDUBASE_BUTTON_PINS;
+	
+	if (interrupt_status)
 	{
+		// Acknowledge the interrupt from the pins and clear it
+		// before the task runs, so that an edge during the task is not lost
+		EDUBASE_BUTTON_PORT->ICR = interrupt_status;
+		
 		// Execute the user-defined function and pass the 
 		// status of the EduBase board push buttons
 		(*EduBase_Button_Task)(Get_EduBase_Button_Status());
-		
-		// Acknowledge the interrupt from any of the following pins
-		// and clear it: PD3 and PD2
-		GPIOD->ICR |= 0x0C;
 	}
+	
+	PROFILE_END(PROFILE_PROBE_GPIOD);
 }
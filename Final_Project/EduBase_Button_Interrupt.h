@@ -7,15 +7,26 @@
  * It interfaces with the EduBase Board Push Buttons. The following pins are used:
  *	- SW2 (PD3)
  *	- SW3 (PD2)
+ *	- SW4 (PD1)
+ *	- SW5 (PD0)
  *
- * It configures the pins to trigger interrupts on rising edges. The EduBase Board 
- * push buttons operate in an active high configuration.
+ * It configures the pins to trigger interrupts on both edges, so that presses and releases
+ * are both detected. The EduBase Board push buttons operate in an active high configuration.
  *
  * @author Aaron Nanas
  */
 
+#ifndef EDUBASE_BUTTON_INTERRUPT_H
+#define EDUBASE_BUTTON_INTERRUPT_H
+
 #include "TM4C123GH6PM.h"
 #include "GPIO.h"
+#include "Pin_Map.h"
+
+// Port and pins of the EduBase push buttons (PD3 to PD0), from the pin map.
+// The interrupt handler is GPIOD_Handler, so the buttons must stay on Port D.
+#define EDUBASE_BUTTON_PORT PIN_PORT(PIN_EDUBASE_BUTTONS)
+#define EDUBASE_BUTTON_PINS PIN_MASK(PIN_EDUBASE_BUTTONS)
 
 // Declare a pointer to the user-defined task
 extern void (*EduBase_Button_Task)(uint8_t edubase_button_status);
@@ -27,8 +38,10 @@ extern void (*EduBase_Button_Task)(uint8_t edubase_button_status);
  * EduBase push buttons connected to the following pins:
  * 	- SW2 (PD3)
  *	- SW3 (PD2)
+ *	- SW4 (PD1)
+ *	- SW5 (PD0)
  *
- * It configures the specified pins (PD3 and PD2) to trigger interrupts on rising edges.
+ * It configures the specified pins (PD3 to PD0) to trigger interrupts on both edges.
  * When an interrupt occurs, the provided task function is executed with the current button status.
  * Interrupt priority is set to 3 for GPIO Port D.
  *
@@ -38,16 +51,38 @@ extern void (*EduBase_Button_Task)(uint8_t edubase_button_status);
  */
 void EduBase_Button_Interrupt_Init(void(*task)(uint8_t));
 
+/**
+ * @brief Enables the interrupts of the selected push buttons.
+ *
+ * Interrupt flags that were set while the interrupts were disabled are cleared first.
+ *
+ * @param button_mask The pins of the push buttons to enable (Bits 3 to 0).
+ *
+ * @return None
+ */
+void EduBase_Button_Interrupt_Enable(uint8_t button_mask);
+
+/**
+ * @brief Disables the interrupts of the selected push buttons.
+ *
+ * @param button_mask The pins of the push buttons to disable (Bits 3 to 0).
+ *
+ * @return None
+ */
+void EduBase_Button_Interrupt_Disable(uint8_t button_mask);
+
 /**
  * @brief The interrupt service routine (ISR) for GPIO Port D.
  *
  * This function is the interrupt service routine (ISR) for GPIO Port D.
- * It checks if an interrupt has been triggered by PD3 or PD2, and if so,
- * it executes the user-defined task function with the current button status.
- * After executing the task function, it acknowledges and clears the interrupt.
+ * It checks if an interrupt has been triggered by any of PD3 to PD0, and if so,
+ * it acknowledges and clears the interrupt and then executes the user-defined
+ * task function with the current button status.
  *
  * @param None
  *
  * @return None
  */
 void GPIOD_Handler(void);
+
+#endif
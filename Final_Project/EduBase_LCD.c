@@ -20,108 +20,70 @@
  */
  
 #include "EduBase_LCD.h"
+#include "LCD_Format.h"
 
 static uint8_t display_control = 0x00;
 static uint8_t display_mode = 0x00;
 
 void EduBase_LCD_Ports_Init(void)
 {
-		// Enable the clock to Port A by setting the 
-    // R0 bit (Bit 0) in the RCGCGPIO register
-    SYSCTL->RCGCGPIO |= 0x01;
+    // Enable the clocks to Port A, Port C, and Port E, configure the data pins (PA5, PA4, PA3,
+    // and PA2), the enable pin (PC6), and the register select pin (PE0) as digital GPIO outputs,
+    // and initialize their outputs to zero
+    PIN_OUTPUT_INIT(PIN_LCD_DATA);
+    PIN_OUTPUT_INIT(PIN_LCD_ENABLE);
+    PIN_OUTPUT_INIT(PIN_LCD_RS);
     
-    // Configure the PA5, PA4, PA3, and PA2 pins as output
-    // by setting Bits 5 to 2 in the DIR register
-    GPIOA->DIR |= 0x3C;
-    
-    // Configure the PA5, PA4, PA3, and PA2 pins to function as
-    // GPIO pins by clearing Bits 5 to 2 in the AFSEL register
-    GPIOA->AFSEL &= ~0x3C;
-    
-    // Enable the digital functionality for the PA5, PA4, PA3, and PA2 pins
-    // by setting Bits 5 to 2 in the DEN register
-    GPIOA->DEN |= 0x3C;
-    
-    // Initialize the output of the PA5, PA4, PA3, and PA2 pins to zero
-    // by clearing Bits 5 to 2 in the DATA register
-    GPIOA->DATA &= ~0x3C;
-    
-    // Enable the clock to Port C by setting the
-    // R2 bit (Bit 2) in the RCGCGPIO register
-    SYSCTL->RCGCGPIO |= 0x04;
-    
-    // Configure the PC6 pin as output by setting Bit 6 in the DIR register
-    GPIOC->DIR |= 0x40;
-    
-    // Configure the PC6 pin to function as a GPIO pin
-    // by clearing Bit 6 in the AFSEL register
-    GPIOC->AFSEL &= ~0x40;
-    
-    // Enable the digital functionality for the PA6 pin
-    // by setting Bit 6 in the DEN register
-    GPIOC->DEN |= 0x40;
-    
-    // Initialize the output of the PC6 pin to zero
-    // by clearing Bit 6 in the DATA register
-    GPIOC->DATA &= ~0x40;
-    
-    // Enable the clock to Port E by setting the
-    // R4 bit (Bit 4) in the RCGCGPIO register
-    SYSCTL->RCGCGPIO |= 0x10;
-    
-    // Configure the PE0 pin as output by setting Bit 0 in the DIR register
-    GPIOE->DIR |= 0x01;
-    
-    // Configure the PE0 pin to function as a GPIO pin
-    // by clearing Bit 0 in the AFSEL register
-    GPIOE->AFSEL &= ~0x01;
-    
-    // Enable the digital functionality for the PE0 pin
-    // by setting Bit 0 in the DEN register
-    GPIOE->DEN |= 0x01;
-    
-    // Initialize the output of the PE0 pin to zero
-    // by clearing Bit 0 in the DATA register
-    GPIOE->DATA &= ~0x01;
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+    // Configure the R/W pin as an output and select the write operation
+    PIN_OUTPUT_INIT(PIN_LCD_RW);
+#endif
 }
 
 void EduBase_LCD_Pulse_Enable(void)
 {
     // Ensure that the output of the PC6 pin is zero before sending a short pulse
-    GPIOC->DATA &= ~0x40;
+    PIN_CLEAR(PIN_LCD_ENABLE);
     SysTick_Delay1us(1);
     
-    // Output a short pulse on the PC6 pin by setting Bit 6
-    // in the DATA register high and clearing it after 1 us.
+    // Output a short pulse on the PC6 pin by setting it high through
+    // its masked alias of the DATA register and clearing it after 1 us.
     // The minimum time for the enable pulse width must be at least greater than 450 ns
     // during a read / write operation (page 49 of HD44780 datasheet)
-    GPIOC->DATA |= 0x40;
+    PIN_SET(PIN_LCD_ENABLE);
     SysTick_Delay1us(1);
-    GPIOC->DATA &= ~0x40;
+    PIN_CLEAR(PIN_LCD_ENABLE);
 }
 
 void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag)
 {
     // Set the upper nibble of the data on the data pins (PA2  PA5)
-    GPIOA->DATA |= (data & 0xF0) >> 2;
+    PIN_WRITE(PIN_LCD_DATA, ((data & 0xF0) >> 4) << PIN_LCD_DATA_SHIFT);
     
     // Set or clear the register select (RS) pin based on the control flag
     // 0 for command and 1 for data
     if (control_flag & 0x01)
     {
-        GPIOE->DATA |= 0x01;
+        PIN_SET(PIN_LCD_RS);
     }
     else
     {
-        GPIOE->DATA &= ~0x01;
+        PIN_CLEAR(PIN_LCD_RS);
     }
     
     // Output a short pulse on the PC6 pin to enable the LCD
     EduBase_LCD_Pulse_Enable();
     
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+    // Clear the LCD data lines (PA2  PA5) and wait for the enable
+    // cycle time (at least 1 us); the busy flag is checked after each byte
+    PIN_CLEAR(PIN_LCD_DATA);
+    SysTick_Delay1us(1);
+#else
     // Clear the LCD data lines (PA2  PA5) and provide a 1 ms delay
-    GPIOA->DATA &= ~0x3C;
+    PIN_CLEAR(PIN_LCD_DATA);
     SysTick_Delay1us(1000);
+#endif
 }
 
 void EduBase_LCD_Send_Command(uint8_t command)
@@ -132,6 +94,10 @@ void EduBase_LCD_Send_Command(uint8_t command)
     // Transmit the lower nibble of the command byte
     EduBase_LCD_Write_4_Bits(command << 0x4, SEND_COMMAND_FLAG);
     
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+    // Wait until the command has been executed
+    EduBase_LCD_Wait_Ready();
+#else
     // Provide a delay based on the transmitted command
     // The first two commands require 1.52 ms execution time
     // while the rest of the commands need 37 us
@@ -143,6 +109,7 @@ void EduBase_LCD_Send_Command(uint8_t command)
     {
         SysTick_Delay1us(37);
     }
+#endif
 }
 
 void EduBase_LCD_Send_Data(uint8_t data)
@@ -152,6 +119,11 @@ void EduBase_LCD_Send_Data(uint8_t data)
     
     // Transmit the lower nibble of the data byte
     EduBase_LCD_Write_4_Bits(data << 0x4, SEND_DATA_FLAG);
+    
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+    // Wait until the data has been written to the DDRAM or CGRAM
+    EduBase_LCD_Wait_Ready();
+#endif
 }
 
 void EduBase_LCD_Init(void)
@@ -175,6 +147,11 @@ void EduBase_LCD_Init(void)
     // Transmit a Function Set command to the LCD to configure it to use 4-bit mode
     EduBase_LCD_Write_4_Bits(FUNCTION_SET | CONFIG_FOUR_BIT_MODE, SEND_COMMAND_FLAG);
     
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+    // The busy flag can be checked once the interface is in 4-bit mode
+    EduBase_LCD_Wait_Ready();
+#endif
+    
     // Configure the LCD to use 5x8 dots and two rows
     EduBase_LCD_Send_Command(FUNCTION_SET | CONFIG_5x8_DOTS | CONFIG_TWO_LINES);
     
@@ -290,24 +267,80 @@ void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buf
 
 void EduBase_LCD_Display_String(char* string)
 {
-    for (unsigned int i = 0; i < strlen(string); i++)
+    // Stop at the null terminator instead of measuring the string on every character
+    while (*string != '\0')
     {
-        EduBase_LCD_Send_Data(string[i]);
+        EduBase_LCD_Send_Data(*string);
+        string++;
     }
 }
 
 void EduBase_LCD_Display_Integer(int value)
 {
-    char integer_buffer[32];
-    sprintf(integer_buffer, "%d", value);
+    char integer_buffer[LCD_FORMAT_BUFFER_SIZE];
+    LCD_Format_Integer(integer_buffer, value, 0, ' ');
     EduBase_LCD_Display_String(integer_buffer);
 }
 
-void EduBase_LCD_Display_Double(double value)
+void EduBase_LCD_Display_Fixed(int32_t value, uint8_t decimals)
+{
+    char fixed_buffer[LCD_FORMAT_BUFFER_SIZE];
+    LCD_Format_Fixed(fixed_buffer, value, decimals);
+    EduBase_LCD_Display_String(fixed_buffer);
+}
+
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+
+static uint8_t EduBase_LCD_Read_4_Bits(void)
+{
+    // Output a high level on the PC6 pin and wait for the data
+    // delay time (at least 360 ns, page 49 of HD44780 datasheet)
+    PIN_SET(PIN_LCD_ENABLE);
+    SysTick_Delay1us(1);
+    
+    // Read the nibble on the data pins (PA2  PA5)
+    uint8_t nibble = PIN_READ(PIN_LCD_DATA) >> PIN_LCD_DATA_SHIFT;
+    
+    PIN_CLEAR(PIN_LCD_ENABLE);
+    SysTick_Delay1us(1);
+    
+    return nibble;
+}
+
+uint8_t EduBase_LCD_Read_Status(void)
 {
-    char double_buffer[32];
-    sprintf(double_buffer, "%.6f", value);
-    EduBase_LCD_Display_String(double_buffer);
+    // Configure the PA5, PA4, PA3, and PA2 pins as inputs
+    PIN_PORT(PIN_LCD_DATA)->DIR &= ~PIN_MASK(PIN_LCD_DATA);
+    
+    // Select the instruction register (RS = 0) and the read operation (R/W = 1)
+    PIN_CLEAR(PIN_LCD_RS);
+    PIN_SET(PIN_LCD_RW);
+    
+    // Read the upper nibble (busy flag and AC6 - AC4) and then the lower nibble (AC3 - AC0)
+    uint8_t status = EduBase_LCD_Read_4_Bits() << 4;
+    status = status | EduBase_LCD_Read_4_Bits();
+    
+    // Select the write operation and configure the data pins as outputs again
+    PIN_CLEAR(PIN_LCD_RW);
+    PIN_PORT(PIN_LCD_DATA)->DIR |= PIN_MASK(PIN_LCD_DATA);
+    
+    return status;
 }
 
+uint8_t EduBase_LCD_Wait_Ready(void)
+{
+    Timer_Handle busy_timeout;
+    Timer_Start(&busy_timeout, EDUBASE_LCD_BUSY_TIMEOUT_US);
+    
+    while (EduBase_LCD_Read_Status() & EDUBASE_LCD_BUSY_FLAG)
+    {
+        if (Timer_Expired(&busy_timeout))
+        {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
 
+#endif
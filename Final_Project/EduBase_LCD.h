@@ -12,6 +12,16 @@
  *  - Data Pin 7      [D7]  (PA5)
  *	- LCD Enable      [E]   (PC6)
  *  - Register Select [RS]  (PE0)
+ *  - Read / Write    [RW]  (PE1, only used when EDUBASE_LCD_BUSY_FLAG_MODE is 1)
+ *
+ * By default, the driver is write-only and waits the worst-case execution time after
+ * each transfer. When EDUBASE_LCD_BUSY_FLAG_MODE is set to 1, the data pins are switched
+ * to inputs after each transfer and the busy flag of the controller is polled instead,
+ * so each transfer finishes as soon as the controller is ready.
+ *
+ * @note The R/W pin of the LCD is tied to ground on the EduBase board. The busy flag mode
+ * requires the R/W pin to be wired to PIN_LCD_RW of Pin_Map.h, and the LCD must drive the data
+ * pins with 3.3 V logic levels (or through a level shifter).
  *
  * @note For more information regarding the LCD, refer to the HD44780 LCD Controller Datasheet.
  * Link: https://www.sparkfun.com/datasheets/LCD/HD44780.pdf
@@ -21,8 +31,18 @@
 
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
-#include <string.h>
-#include <stdio.h>
+#include "Pin_Map.h"
+
+// Set to 1 to poll the busy flag of the LCD instead of waiting fixed delays
+#ifndef EDUBASE_LCD_BUSY_FLAG_MODE
+#define EDUBASE_LCD_BUSY_FLAG_MODE 0
+#endif
+
+// Busy flag (Bit 7) of the value read with EduBase_LCD_Read_Status
+#define EDUBASE_LCD_BUSY_FLAG       0x80
+
+// Maximum time to wait for the busy flag to clear (longer than the 1.52 ms Clear Display command)
+#define EDUBASE_LCD_BUSY_TIMEOUT_US 3000
 
 static uint8_t up_arrow[8] =
 {
@@ -396,7 +416,7 @@ void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buf
  * @brief Displays a string on the LCD.
  *
  * This function displays a null-terminated string on the LCD. The string is iterated 
- * character by character until the end of the string is reached.
+ * character by character until the null terminator is reached.
  *
  * @param string A char pointer that holds the address of a sequence of char values (i.e. string).
  *
@@ -405,7 +425,7 @@ void EduBase_LCD_Create_Custom_Character(uint8_t location, uint8_t character_buf
 void EduBase_LCD_Display_String(char* string);
 
 /**
- * @brief Converts the integer value to string to display it on the LCD using sprintf.
+ * @brief Converts the integer value to string to display it on the LCD using LCD_Format_Integer.
  *
  * @param value An integer that will be converted to string.
  *
@@ -414,10 +434,43 @@ void EduBase_LCD_Display_String(char* string);
 void EduBase_LCD_Display_Integer(int value);
 
 /**
- * @brief Converts the double value to string to display it on the LCD using sprintf.
+ * @brief Converts the fixed-point value to string to display it on the LCD using LCD_Format_Fixed.
+ *
+ * The Cortex-M4F only has a single-precision FPU, so fractional values are passed as
+ * fixed-point numbers instead of doubles (for example, 1234 with 1 decimal is "123.4").
  *
- * @param value A double that will be converted to string.
+ * @param value The fixed-point value, in 10^-decimals units.
+ *
+ * @param decimals The number of digits after the decimal point (0 to LCD_FORMAT_MAX_DECIMALS).
  *
  * @return None
  */
-void EduBase_LCD_Display_Double(double value);
+void EduBase_LCD_Display_Fixed(int32_t value, uint8_t decimals);
+
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+
+/**
+ * @brief Reads the busy flag and the address counter of the LCD.
+ *
+ * This function switches the data pins (PA2 - PA5) to inputs, sets the R/W pin,
+ * and reads the upper and lower nibbles of the status register with two enable pulses.
+ * The data pins are switched back to outputs before the function returns.
+ *
+ * @param None
+ *
+ * @return uint8_t The busy flag (Bit 7) and the address counter (Bits 6 to 0).
+ */
+uint8_t EduBase_LCD_Read_Status(void);
+
+/**
+ * @brief Waits until the LCD is ready to accept a new transfer.
+ *
+ * This function polls the busy flag for at most EDUBASE_LCD_BUSY_TIMEOUT_US.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the LCD is ready, or 0 if the busy flag did not clear in time.
+ */
+uint8_t EduBase_LCD_Wait_Ready(void);
+
+#endif
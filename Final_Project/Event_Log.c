@@ -0,0 +1,354 @@
+/**
+ * @file Event_Log.c
+ *
+ * @brief Source code for the Event_Log module.
+ *
+ * This file contains the function definitions for the persistent event journal of
+ * the Home Security System.
+ *
+ * A sequence number is given to a record when it is appended. A record is dropped,
+ * without using a sequence number, when the RAM buffer is full of pending records,
+ * so the sequence numbers in the EEPROM never have gaps other than the break after
+ * the newest record.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Event_Log.h"
+#include "Timebase.h"
+
+#define EVENT_LOG_CACHE_MASK        (EVENT_LOG_CACHE_SIZE - 1)
+
+// Word address of the first record slot
+#define EVENT_LOG_BASE_ADDRESS      (EEPROM_LOG_FIRST_BLOCK * EEPROM_WORDS_PER_BLOCK)
+
+// Type of an erased slot
+#define EVENT_LOG_TYPE_ERASED       0xFF
+
+// Most recent records, including the records that are waiting to be written
+static Event_Log_Record record_cache[EVENT_LOG_CACHE_SIZE];
+static uint32_t cache_head = 0;
+static uint8_t cache_fill = 0;
+static volatile uint8_t pending_count = 0;
+static uint32_t dropped_count = 0;
+static uint16_t next_sequence = 0;
+
+// Position of the log in the EEPROM
+static uint8_t eeprom_available = 0;
+static uint16_t head_slot = 0;
+static uint16_t stored_count = 0;
+
+// Background writer state: the word of the oldest pending record being written,
+// whether its write has been started, and the number of failed writes of that word
+static uint8_t writing = 0;
+static uint8_t write_word = 0;
+static uint8_t write_started = 0;
+static uint8_t write_retries = 0;
+static Scheduler_Timer commit_timer;
+static Scheduler_Timer poll_timer;
+
+static uint32_t Event_Log_Pack(const Event_Log_Record *record)
+{
+    return ((uint32_t)record->sequence << 16) | ((uint32_t)record->param << 8) | record->type;
+}
+
+static uint8_t Event_Log_Unpack(uint32_t word, Event_Log_Record *record)
+{
+    record->sequence = (uint16_t)(word >> 16);
+    record->param = (uint8_t)(word >> 8);
+    record->type = (uint8_t)word;
+
+    return ((word != EEPROM_ERASED_WORD) && (record->type != EVENT_LOG_TYPE_ERASED)) ? 1 : 0;
+}
+
+static uint16_t Event_Log_Slot_Address(uint16_t slot)
+{
+    return EVENT_LOG_BASE_ADDRESS + (slot * 2);
+}
+
+static uint8_t Event_Log_Read_Slot(uint16_t slot, Event_Log_Record *record)
+{
+    if (!Event_Log_Unpack(EEPROM_Read_Word(Event_Log_Slot_Address(slot) + 1), record))
+    {
+        return 0;
+    }
+
+    record->timestamp_ms = EEPROM_Read_Word(Event_Log_Slot_Address(slot));
+    return 1;
+}
+
+static void Event_Log_Cache_Push(const Event_Log_Record *record)
+{
+    record_cache[cache_head & EVENT_LOG_CACHE_MASK] = *record;
+    cache_head++;
+
+    if (cache_fill < EVENT_LOG_CACHE_SIZE)
+    {
+        cache_fill++;
+    }
+}
+
+// Finds the newest record from the break in the sequence numbers and loads the most recent records
+static void Event_Log_Recover(void)
+{
+    Event_Log_Record record;
+    Event_Log_Record next_record;
+    uint16_t newest_slot = EVENT_LOG_CAPACITY;
+
+    stored_count = 0;
+
+    for (uint16_t slot = 0; slot < EVENT_LOG_CAPACITY; slot++)
+    {
+        if (!Event_Log_Read_Slot(slot, &record))
+        {
+            continue;
+        }
+
+        stored_count++;
+
+        if (newest_slot == EVENT_LOG_CAPACITY)
+        {
+            uint16_t next_slot = (slot + 1) % EVENT_LOG_CAPACITY;
+
+            if (!Event_Log_Read_Slot(next_slot, &next_record) || (next_record.sequence != (uint16_t)(record.sequence + 1)))
+            {
+                newest_slot = slot;
+                next_sequence = record.sequence + 1;
+            }
+        }
+    }
+
+    if (newest_slot == EVENT_LOG_CAPACITY)
+    {
+        // The log is empty
+        head_slot = 0;
+        next_sequence = 0;
+        return;
+    }
+
+    head_slot = (newest_slot + 1) % EVENT_LOG_CAPACITY;
+
+    // Load the most recent records into RAM, oldest first
+    uint16_t load_count = (stored_count < EVENT_LOG_CACHE_SIZE) ? stored_count : EVENT_LOG_CACHE_SIZE;
+
+    for (uint16_t age = load_count; age > 0; age--)
+    {
+        uint16_t slot = (head_slot + EVENT_LOG_CAPACITY - age) % EVENT_LOG_CAPACITY;
+
+        if (Event_Log_Read_Slot(slot, &record))
+        {
+            Event_Log_Cache_Push(&record);
+        }
+    }
+}
+
+void Event_Log_Init(uint8_t reset_cause)
+{
+    cache_head = 0;
+    cache_fill = 0;
+    pending_count = 0;
+    dropped_count = 0;
+    writing = 0;
+
+    eeprom_available = EEPROM_Init();
+
+    if (eeprom_available)
+    {
+        Event_Log_Recover();
+    }
+
+    Scheduler_Add_Task(TASK_EVENT_LOG, Event_Log_Task);
+
+    Event_Log_Append(EVENT_LOG_BOOT, reset_cause);
+}
+
+void Event_Log_Append(uint8_t type, uint8_t param)
+{
+    Event_Log_Record record;
+    uint8_t first_pending = 0;
+
+    record.timestamp_ms = Timebase_Get_Time_ms();
+    record.param = param;
+    record.type = type;
+
+    // Disable interrupts while the RAM buffer is updated since events can be
+    // appended from several interrupt priority levels
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (pending_count >= EVENT_LOG_CACHE_SIZE)
+    {
+        // Every record in RAM is still waiting to be written
+        dropped_count++;
+    }
+    else
+    {
+        record.sequence = next_sequence;
+        next_sequence++;
+
+        Event_Log_Cache_Push(&record);
+
+        first_pending = (pending_count == 0) ? 1 : 0;
+        pending_count++;
+    }
+
+    __set_PRIMASK(primask);
+
+    // Wake up the writer once per batch
+    if (first_pending && eeprom_available)
+    {
+        Scheduler_Post(TASK_EVENT_LOG, SIGNAL_LOG_APPEND, 0);
+    }
+}
+
+uint8_t Event_Log_Get_Recent(uint16_t age, Event_Log_Record *record)
+{
+    if (age < cache_fill)
+    {
+        *record = record_cache[(cache_head - 1 - age) & EVENT_LOG_CACHE_MASK];
+        return 1;
+    }
+
+    if (!eeprom_available || (age >= Event_Log_Get_Count()))
+    {
+        return 0;
+    }
+
+    // The pending records are the newest, and they are all in RAM
+    uint16_t eeprom_age = age - pending_count;
+    uint16_t slot = (head_slot + EVENT_LOG_CAPACITY - 1 - eeprom_age) % EVENT_LOG_CAPACITY;
+
+    return Event_Log_Read_Slot(slot, record);
+}
+
+uint16_t Event_Log_Get_Count(void)
+{
+    uint16_t count = eeprom_available ? (stored_count + pending_count) : cache_fill;
+
+    return (count > EVENT_LOG_CAPACITY) ? EVENT_LOG_CAPACITY : count;
+}
+
+uint8_t Event_Log_Get_Pending_Count(void)
+{
+    return pending_count;
+}
+
+uint32_t Event_Log_Get_Dropped_Count(void)
+{
+    return dropped_count;
+}
+
+// Word write_word of the oldest pending record
+static uint32_t Event_Log_Write_Data(void)
+{
+    const Event_Log_Record *record = &record_cache[(cache_head - pending_count) & EVENT_LOG_CACHE_MASK];
+
+    return (write_word == 0) ? record->timestamp_ms : Event_Log_Pack(record);
+}
+
+// Checks the word being written, then starts the next word of the oldest pending record, or finishes the batch
+static void Event_Log_Write_Next(void)
+{
+    // Word 1 is written last so that the record is only valid once it is complete
+    uint16_t address = Event_Log_Slot_Address(head_slot) + write_word;
+
+    if (write_started)
+    {
+        uint8_t result = EEPROM_Get_Write_Result(address, Event_Log_Write_Data());
+
+        if (result == EEPROM_WRITE_BUSY)
+        {
+            return;
+        }
+
+        write_started = 0;
+
+        if (result == EEPROM_WRITE_FAILED)
+        {
+            write_retries++;
+
+            if (write_retries > EVENT_LOG_WRITE_RETRIES)
+            {
+                // Keep the head and the pending records, and write the batch again later
+                writing = 0;
+                Scheduler_Timer_Stop(&poll_timer);
+                Scheduler_Timer_Start(&commit_timer, TASK_EVENT_LOG, SIGNAL_LOG_COMMIT, EVENT_LOG_COMMIT_DELAY_MS, 0);
+                return;
+            }
+        }
+        else
+        {
+            write_retries = 0;
+            write_word++;
+            address++;
+        }
+    }
+
+    if (write_word == 2)
+    {
+        // Both words of the record have been written
+        head_slot = (head_slot + 1) % EVENT_LOG_CAPACITY;
+        if (stored_count < EVENT_LOG_CAPACITY)
+        {
+            stored_count++;
+        }
+
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        pending_count--;
+        __set_PRIMASK(primask);
+
+        write_word = 0;
+        address = Event_Log_Slot_Address(head_slot);
+    }
+
+    if (pending_count == 0)
+    {
+        writing = 0;
+        Scheduler_Timer_Stop(&poll_timer);
+        return;
+    }
+
+    // A write of another module is still in progress when the write cannot be started,
+    // so it is started at the next poll
+    if (EEPROM_Write_Start(address, Event_Log_Write_Data()))
+    {
+        write_started = 1;
+    }
+}
+
+void Event_Log_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_LOG_APPEND:
+            // Wait for more events so that they are written as one batch
+            if (!writing && !Scheduler_Timer_Active(&commit_timer))
+            {
+                Scheduler_Timer_Start(&commit_timer, TASK_EVENT_LOG, SIGNAL_LOG_COMMIT, EVENT_LOG_COMMIT_DELAY_MS, 0);
+            }
+            break;
+
+        case SIGNAL_LOG_COMMIT:
+            if (!writing)
+            {
+                writing = 1;
+                write_word = 0;
+                write_started = 0;
+                write_retries = 0;
+                Scheduler_Timer_Start(&poll_timer, TASK_EVENT_LOG, SIGNAL_LOG_POLL, EVENT_LOG_POLL_PERIOD_MS, EVENT_LOG_POLL_PERIOD_MS);
+                Event_Log_Write_Next();
+            }
+            break;
+
+        case SIGNAL_LOG_POLL:
+            if (writing)
+            {
+                Event_Log_Write_Next();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file Event_Log.h
+ *
+ * @brief Header file for the Event_Log module.
+ *
+ * This file contains the function definitions for the persistent event journal of
+ * the Home Security System. Events (state changes, intrusions, rejected codes, sensor
+ * faults, and resets) are stored in the on-chip EEPROM so that they survive a reset.
+ *
+ * Each record is 8 bytes (two EEPROM words):
+ *  - Word 0: time of the event in milliseconds since the last reset (Timebase)
+ *  - Word 1: sequence number (Bits 31:16), parameter (Bits 15:8), and type (Bits 7:0)
+ *
+ * The records form an append-only ring over the EEPROM blocks reserved for the log.
+ * Every record is written to the slot after the previous one, so all of the slots
+ * (and blocks) are written equally often. The newest record is found at
+ * initialization from the break in the sequence numbers. Word 1 is written last and
+ * commits the record.
+ *
+ * Event_Log_Append only copies the record into a RAM buffer and returns, so it can
+ * be called from any context, including the alarm path and interrupt handlers. The
+ * records are written to the EEPROM in batches by TASK_EVENT_LOG, which starts one
+ * word at a time and polls the EEPROM between words with a scheduler timer. The writer
+ * never waits for the EEPROM: it checks the result of each word (EEPROM_Get_Write_Result)
+ * and only moves on to the next slot once both words of a record have been written.
+ * A word that fails is written again, and after EVENT_LOG_WRITE_RETRIES more failures
+ * the record stays pending and the batch is written again later.
+ *
+ * The most recent EVENT_LOG_CACHE_SIZE records are also kept in RAM, so they can be
+ * looked up by age without reading the EEPROM.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+#include "EEPROM.h"
+
+// Number of record slots in the EEPROM (8 records per block)
+#define EVENT_LOG_CAPACITY          ((EEPROM_LOG_BLOCK_COUNT * EEPROM_WORDS_PER_BLOCK) / 2)
+
+// Number of most recent records kept in RAM (must be a power of two)
+#define EVENT_LOG_CACHE_SIZE        16
+
+// Time to wait for more events before a batch is written
+#define EVENT_LOG_COMMIT_DELAY_MS   100
+
+// Period at which the EEPROM is polled while a batch is written
+#define EVENT_LOG_POLL_PERIOD_MS    1
+
+// Number of times a failed word is written again before the batch is retried after EVENT_LOG_COMMIT_DELAY_MS
+#define EVENT_LOG_WRITE_RETRIES     2
+
+/**
+ * @brief Types of events.
+ */
+enum Event_Log_Types
+{
+    EVENT_LOG_BOOT          = 0x01,     // The system was reset (parameter: reset cause)
+    EVENT_LOG_STATE         = 0x02,     // The system state changed (parameter: new state)
+    EVENT_LOG_INTRUSION     = 0x03,     // An intrusion was confirmed (parameter: zone)
+    EVENT_LOG_PANIC         = 0x04,     // A panic alarm was requested
+    EVENT_LOG_CODE_REJECTED = 0x05,     // A wrong code was entered (parameter: lockout in seconds, up to 255)
+    EVENT_LOG_SENSOR_FAULT  = 0x06,     // A sensor stopped replying (parameter: zone)
+    EVENT_LOG_WATCHDOG      = 0x07      // The watchdog reset the system (parameter: task that stopped responding)
+};
+
+/**
+ * @brief One event record.
+ */
+typedef struct
+{
+    uint32_t timestamp_ms;      // Time of the event in milliseconds since the reset
+    uint16_t sequence;          // Sequence number of the record
+    uint8_t param;              // Parameter of the event (depends on the type)
+    uint8_t type;               // See Event_Log_Types
+} Event_Log_Record;
+
+/**
+ * @brief Initializes the EEPROM, finds the newest record, and registers TASK_EVENT_LOG.
+ *
+ * A EVENT_LOG_BOOT record is appended. If the EEPROM is not available, the events
+ * are only kept in RAM.
+ *
+ * @param reset_cause The parameter of the EVENT_LOG_BOOT record.
+ *
+ * @return None
+ */
+void Event_Log_Init(uint8_t reset_cause);
+
+/**
+ * @brief Appends an event to the log.
+ *
+ * The event is timestamped and copied to RAM, and this function returns immediately.
+ * It can be called from interrupt handlers.
+ *
+ * @param type The type of the event (see Event_Log_Types).
+ *
+ * @param param The parameter of the event.
+ *
+ * @return None
+ */
+void Event_Log_Append(uint8_t type, uint8_t param);
+
+/**
+ * @brief Copies a recent record.
+ *
+ * Records younger than EVENT_LOG_CACHE_SIZE are copied from RAM. Older records are
+ * read from the EEPROM, which may wait for a write in progress to finish.
+ *
+ * @param age The age of the record (0 = most recent).
+ *
+ * @param record A pointer to where the record is copied.
+ *
+ * @return uint8_t Returns 1 if the record exists. Otherwise, it returns 0.
+ */
+uint8_t Event_Log_Get_Recent(uint16_t age, Event_Log_Record *record);
+
+/**
+ * @brief Returns the number of records that can be looked up.
+ *
+ * @param None
+ *
+ * @return uint16_t The number of records in the log (at most EVENT_LOG_CAPACITY).
+ */
+uint16_t Event_Log_Get_Count(void);
+
+/**
+ * @brief Returns the number of records that have not been written to the EEPROM yet.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of pending records.
+ */
+uint8_t Event_Log_Get_Pending_Count(void);
+
+/**
+ * @brief Returns the number of records that were lost because too many events were pending.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of lost records.
+ */
+uint32_t Event_Log_Get_Dropped_Count(void);
+
+/**
+ * @brief Event handler of the event log task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Event_Log_Task(const Scheduler_Event *event);
+
+#endif
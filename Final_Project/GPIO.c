@@ -16,6 +16,18 @@
  */
 #include "TM4C123GH6PM.h"
 #include "GPIO.h"
+#include "Pin_Map.h"
+#include "Clock.h"
+
+// Period of the RGB LED PWM generators
+#define RGB_LED_PWM_FREQUENCY_HZ	1000
+
+// Reload value of the RGB LED PWM generators at the current PWM clock
+static uint32_t rgb_led_pwm_load = 0;
+
+// Last color and brightness of the RGB LED, restored when the clock profile changes
+static uint8_t rgb_led_pwm_value = 0;
+static uint8_t rgb_led_pwm_brightness = 0;
 
 // Constant definitions for the user LED (RGB) colors
 const uint8_t RGB_LED_OFF 		= 0x00;
@@ -31,82 +43,111 @@ const uint8_t EDUBASE_LED_ALL_ON  = 0x0F; // All LEDs on
 
 void RGB_LED_Init(void)
 {
-	// Enable the clock to Port F
-	SYSCTL->RCGCGPIO |= 0x20;
-
-	// Set PF1, PF2, and PF3 as output GPIO pins
-	GPIOF->DIR |= 0x0E;
-	
-	// Configure PF1, PF2, and PF3 to function as GPIO pins
-	GPIOF->AFSEL &= ~0x0E;
-	
-	// Enable digital functionality for PF1, PF2, and PF3
-	GPIOF->DEN |= 0x0E;
-	
-	// Initialize the output of the RGB LED to zero
-	GPIOF->DATA &= ~0x0E;
+	// Enable the clock to Port F, configure PF1, PF2, and PF3 as
+	// digital GPIO outputs, and initialize the output of the RGB LED to zero
+	PIN_OUTPUT_INIT(PIN_RGB_LED);
 }
 
 void RGB_LED_Output(uint8_t led_value)
 {
-	// Set the output of the RGB LED
-	GPIOF->DATA = (GPIOF->DATA & 0xF1) | led_value;
+	// Set the output of the RGB LED through the masked alias of PF1 - PF3
+	PIN_WRITE(PIN_RGB_LED, led_value);
 }
 
 uint8_t RGB_LED_Status(void)
 {
-	// Assign the value of Port F to a local variable
-	// and only read the values of the following bits: 3, 2, and 1
-	// Then, return the local variable's value
-	uint8_t RGB_LED_Status = GPIOF->DATA & 0x0E;
+	// Read the masked alias of PF1 - PF3, which only returns the values of Bits 3, 2, and 1
+	uint8_t RGB_LED_Status = PIN_READ(PIN_RGB_LED);
 	return RGB_LED_Status;
 }
 
-void EduBase_LEDs_Init(void)
+static void RGB_LED_PWM_Clock_Changed(uint32_t system_clock_hz)
 {
-    // Enable the clock to Port B
-    SYSCTL->RCGCGPIO |= 0x02;
-
-    // Set PB0-PB3 as output GPIO pins
-    GPIOB->DIR |= 0x0F;
+	rgb_led_pwm_load = ((system_clock_hz / CLOCK_PWM_DIVIDER) / RGB_LED_PWM_FREQUENCY_HZ) - 1;
+	
+	PWM1->_2_LOAD = rgb_led_pwm_load;
+	PWM1->_3_LOAD = rgb_led_pwm_load;
+	
+	// Scale the duty cycle to the new period
+	RGB_LED_PWM_Output(rgb_led_pwm_value, rgb_led_pwm_brightness);
+}
 
-    // Configure PB0-PB3 to function as GPIO pins
-    GPIOB->AFSEL &= ~0x0F;
+void RGB_LED_PWM_Init(void)
+{
+	// Enable the clock to PWM Module 1 by setting the
+	// R1 bit (Bit 1) in the RCGCPWM register
+	SYSCTL->RCGCPWM |= 0x02;
+	
+	// Configure PF1, PF2, and PF3 to use the M1PWM5, M1PWM6, and M1PWM7 alternate functions (PMCn = 5)
+	PIN_ALTERNATE_INIT(PIN_RGB_LED_PWM);
+	
+	// The PWM clock divider is selected by Clock_Init and shared with the buzzer on PWM Module 0
+	// Disable Generators 2 and 3 and select the count-down mode
+	PWM1->_2_CTL = 0x00;
+	PWM1->_3_CTL = 0x00;
+	
+	// Drive each output high when the counter matches the reload value (ACTLOAD = 0x3)
+	// and low when the counter matches its comparator while counting down (ACTCMPAD or ACTCMPBD = 0x2)
+	PWM1->_2_GENB = 0x80C;	// M1PWM5 (PF1, red)
+	PWM1->_3_GENA = 0x08C;	// M1PWM6 (PF2, blue)
+	PWM1->_3_GENB = 0x80C;	// M1PWM7 (PF3, green)
+	
+	// Start with a 1 kHz period and the outputs disabled
+	rgb_led_pwm_value = 0;
+	rgb_led_pwm_brightness = 0;
+	RGB_LED_PWM_Clock_Changed(Clock_Get_Hz());
+	if (!Clock_Subscribe(&RGB_LED_PWM_Clock_Changed))
+	{
+		// The PWM period is only valid for the current profile
+		Clock_Hold_Profile();
+	}
+	
+	// Enable Generators 2 and 3
+	PWM1->_2_CTL |= 0x01;
+	PWM1->_3_CTL |= 0x01;
+}
 
-    // Enable digital functionality for PB0-PB3
-    GPIOB->DEN |= 0x0F;
+void RGB_LED_PWM_Output(uint8_t led_value, uint8_t brightness)
+{
+	rgb_led_pwm_value = led_value;
+	rgb_led_pwm_brightness = brightness;
+	
+	// Square the brightness so that equal steps look roughly equally bright
+	uint32_t high_ticks = (rgb_led_pwm_load * brightness * brightness) / (255 * 255);
+	uint32_t compare = rgb_led_pwm_load - high_ticks;
+	
+	// The comparators are updated when the counter reaches zero, so the duty cycle changes without a glitch
+	PWM1->_2_CMPB = compare;
+	PWM1->_3_CMPA = compare;
+	PWM1->_3_CMPB = compare;
+	
+	// The color bits (PF1 - PF3) line up with the PWM5EN - PWM7EN bits (Bits 5 to 7) of the ENABLE register
+	PWM1->ENABLE = (high_ticks > 0) ? ((led_value & 0x0E) << 4) : 0x00;
+}
 
-    // Initialize the output of the EduBase LEDs to zero
-    GPIOB->DATA &= ~0x0F;
+void EduBase_LEDs_Init(void)
+{
+    // Enable the clock to Port B, configure PB0-PB3 as digital
+    // GPIO outputs, and initialize the output of the EduBase LEDs to zero
+    PIN_OUTPUT_INIT(PIN_EDUBASE_LEDS);
 }
 
 
 void EduBase_LEDs_Output(uint8_t led_value)
 {
-    // Set the output of the LEDs (PB0-PB3)
-    GPIOB->DATA = (GPIOB->DATA & 0xF0) | (led_value & 0x0F);
+    // Set the output of the LEDs through the masked alias of PB0-PB3
+    PIN_WRITE(PIN_EDUBASE_LEDS, led_value);
 }
 
 void EduBase_Button_Init(void)
 {
-	// Enable the clock to Port D
-	SYSCTL->RCGCGPIO |= 0x08;
-	
-	// Set PD0, PD1, PD2, and PD3 as input GPIO pins
-	GPIOD->DIR &= ~0x0F;
-	
-	// Configure PD0, PD1, PD2, and PD3 to function as GPIO pins
-	GPIOD->AFSEL &= ~0x0F;
-	
-	// Enable digital functionality for PD0, PD1, PD2, and PD3
-	GPIOD->DEN |= 0x0F;
+	// Enable the clock to Port D and configure PD0, PD1, PD2, and PD3 as digital GPIO inputs
+	PIN_INPUT_INIT(PIN_EDUBASE_BUTTONS);
 }
 
 uint8_t Get_EduBase_Button_Status(void)
 {
-	// Assign the value of Port D to a local variable
-	// and only read the values of the following bits: 3, 2, 1, and 0
-	// Then, return the local variable's value
-	uint8_t button_status = GPIOD->DATA & 0x0F;
+	// Read the masked alias of PD0 - PD3, which only returns the values of Bits 3, 2, 1, and 0
+	uint8_t button_status = PIN_READ(PIN_EDUBASE_BUTTONS);
 	return button_status;
 }
@@ -47,10 +47,8 @@ void RGB_LED_Init(void);
  * @brief The RGB_LED_Output function sets the output of the RGB LED.
  *
  * This function sets the output of the RGB LED based on the value of the input, led_value.
- * A bitwise AND operation (& 0xF1) is performed to mask the Bits 1 to 3 of the GPIOF's DATA register
- * to preserve the state of other pins connected to Port F while keeping the RGB LED pins unaffected.
- * Then, a bitwise OR operation is performed with led_value to set the RGB LED pins to the desired state
- * specified by led_value.
+ * The value is written to the address-masked alias of PF1 - PF3 in the DATA register, so the
+ * other pins of Port F are preserved without a read-modify-write of the register.
  *
  * @param led_value An 8-bit unsigned integer that determines the output of the RGB LED. To turn off
  *                  the RGB LED, set led_value to 0. The following values determine the color of the RGB LED:
@@ -82,6 +80,35 @@ void RGB_LED_Output(uint8_t led_value);
  */
 uint8_t RGB_LED_Status(void);
 
+/**
+ * @brief The RGB_LED_PWM_Init function configures the RGB LED (PF1 - PF3) for brightness control.
+ *
+ * This function configures PF1, PF2, and PF3 as the M1PWM5, M1PWM6, and M1PWM7 outputs of PWM Module 1
+ * (Generators 2 and 3) with a 1 kHz period, derived from the PWM clock and kept when the clock profile
+ * changes (see Clock.h). The RGB LED is off after initialization. Once it has been
+ * called, the RGB LED is controlled with RGB_LED_PWM_Output instead of RGB_LED_Output.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void RGB_LED_PWM_Init(void);
+
+/**
+ * @brief The RGB_LED_PWM_Output function sets the color and the brightness of the RGB LED.
+ *
+ * The selected colors are driven with the same duty cycle. The duty cycle is the square of the brightness,
+ * which approximates the perceived brightness of the LED. The function only writes the PWM registers,
+ * so it can be called from an interrupt service routine.
+ *
+ * @param led_value The colors to turn on, with the same values as RGB_LED_Output (0x02, 0x04, 0x08, or a combination).
+ *
+ * @param brightness The brightness of the LED, from 0 (off) to 255 (fully on).
+ *
+ * @return None
+ */
+void RGB_LED_PWM_Output(uint8_t led_value, uint8_t brightness);
+
 /**
  * @brief The EduBase_LEDs_Init function initializes the EduBase Board LEDs (LED0 - LED3)
  *
@@ -102,10 +129,8 @@ void EduBase_LEDs_Init(void);
  * @brief The EduBase_LEDs_Output function sets the output of the EduBase Board LEDs.
  *
  * This function sets the output of the EduBase Board LEDs based on the value of the input, led_value.
- * A bitwise AND operation (& 0xF0) is performed to mask the lower four bits (Bits 0 to 3) of the GPIOF's DATA register
- * to preserve the state of other pins connected to Port B while keeping the LED pins unaffected.
- * Then, a bitwise OR operation is performed with led_value to set the LED pins to the desired state
- * specified by led_value.
+ * The value is written to the address-masked alias of PB0 - PB3 in the DATA register, so the
+ * other pins of Port B are preserved without a read-modify-write of the register.
  *
  * @param led_value An 8-bit unsigned integer that determines the output of the EduBase Board LEDs.
  *
@@ -130,7 +155,7 @@ void EduBase_Button_Init(void);
  *
  * This function reads the status of the EduBase Board buttons connected to pins PD0, PD1, PD2, and PD3.
  * It indicates whether or not the buttons are pressed and returns the status.
- * A bitwise AND operation (& 0xF) is performed to mask the unused bits in the data register.
+ * The address-masked alias of PD0 - PD3 is read, so the other bits of the data register read as zero.
  *
  * @param None
  *
@@ -0,0 +1,239 @@
+/**
+ * @file Intrusion_Filter.c
+ *
+ * @brief Source code for the Intrusion_Filter module.
+ *
+ * This file contains the function definitions for the streaming intrusion-detection
+ * filter. The per-sample cost is constant: the sorted copy of the median window is
+ * updated by removing the oldest distance and inserting the new one, and the number
+ * of hits in the confirmation window is updated from the bits that enter and leave
+ * the window.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Intrusion_Filter.h"
+
+// Samples further apart than this do not produce a velocity (for example, after a restart)
+#define INTRUSION_FILTER_MAX_VELOCITY_GAP_US    1000000
+
+static uint32_t Intrusion_Filter_Window_Mask(uint8_t window)
+{
+    return (window >= 32) ? 0xFFFFFFFF : ((1UL << window) - 1);
+}
+
+static void Intrusion_Filter_Clamp_Config(Intrusion_Filter_Config *config)
+{
+    if (config->exit_distance_mm < config->enter_distance_mm)
+    {
+        config->exit_distance_mm = config->enter_distance_mm;
+    }
+
+    if (config->ema_shift > 8)
+    {
+        config->ema_shift = 8;
+    }
+
+    if (config->confirm_window == 0)
+    {
+        config->confirm_window = 1;
+    }
+    else if (config->confirm_window > INTRUSION_FILTER_MAX_WINDOW)
+    {
+        config->confirm_window = INTRUSION_FILTER_MAX_WINDOW;
+    }
+
+    if (config->confirm_count == 0)
+    {
+        config->confirm_count = 1;
+    }
+    else if (config->confirm_count > config->confirm_window)
+    {
+        config->confirm_count = config->confirm_window;
+    }
+}
+
+static uint16_t Intrusion_Filter_Update_Median(Intrusion_Filter *filter, uint16_t distance_mm)
+{
+    uint16_t *sorted = filter->median_sorted;
+    uint8_t count = filter->median_fill;
+    uint8_t position;
+
+    if (count == INTRUSION_FILTER_MEDIAN_SIZE)
+    {
+        // Remove the oldest distance from the sorted copy
+        uint16_t oldest = filter->median_window[filter->median_index];
+
+        for (position = 0; position < count - 1; position++)
+        {
+            if (sorted[position] == oldest)
+            {
+                break;
+            }
+        }
+
+        for (; position < count - 1; position++)
+        {
+            sorted[position] = sorted[position + 1];
+        }
+
+        count--;
+    }
+
+    // Insert the new distance in the sorted copy
+    position = count;
+    while ((position > 0) && (sorted[position - 1] > distance_mm))
+    {
+        sorted[position] = sorted[position - 1];
+        position--;
+    }
+    sorted[position] = distance_mm;
+    count++;
+
+    filter->median_window[filter->median_index] = distance_mm;
+    filter->median_index = (filter->median_index + 1) % INTRUSION_FILTER_MEDIAN_SIZE;
+    filter->median_fill = count;
+
+    return sorted[count / 2];
+}
+
+static void Intrusion_Filter_Update_Average(Intrusion_Filter *filter, uint16_t median_mm, uint64_t timestamp_us)
+{
+    int32_t median_q8 = (int32_t)median_mm << 8;
+    uint8_t shift = filter->config.ema_shift;
+
+    if (!filter->primed)
+    {
+        filter->distance_q8 = median_q8;
+        filter->velocity_q8 = 0;
+        filter->last_timestamp_us = timestamp_us;
+        filter->primed = 1;
+        return;
+    }
+
+    int32_t previous_q8 = filter->distance_q8;
+    filter->distance_q8 += (median_q8 - filter->distance_q8) >> shift;
+
+    uint64_t elapsed_us = timestamp_us - filter->last_timestamp_us;
+    filter->last_timestamp_us = timestamp_us;
+
+    if ((elapsed_us == 0) || (elapsed_us > INTRUSION_FILTER_MAX_VELOCITY_GAP_US))
+    {
+        return;
+    }
+
+    // Approach velocity in Q8 mm/s (positive when the distance decreases)
+    int32_t velocity_q8 = (int32_t)(((int64_t)(previous_q8 - filter->distance_q8) * 1000000) / (int64_t)elapsed_us);
+    filter->velocity_q8 += (velocity_q8 - filter->velocity_q8) >> shift;
+}
+
+static uint8_t Intrusion_Filter_Is_Hit(Intrusion_Filter *filter)
+{
+    const Intrusion_Filter_Config *config = &filter->config;
+    uint16_t distance_mm = Intrusion_Filter_Get_Distance(filter);
+    int32_t velocity_mm_s = Intrusion_Filter_Get_Velocity(filter);
+
+    // Hysteresis: enter the zone at the enter distance and leave it above the exit distance
+    if (filter->in_zone)
+    {
+        filter->in_zone = (distance_mm <= config->exit_distance_mm) ? 1 : 0;
+    }
+    else
+    {
+        filter->in_zone = (distance_mm <= config->enter_distance_mm) ? 1 : 0;
+    }
+
+    uint8_t approaching = (config->approach_speed_mm_s > 0)
+        && (distance_mm < config->approach_range_mm)
+        && (velocity_mm_s >= (int32_t)config->approach_speed_mm_s);
+
+    return (filter->in_zone || approaching) ? 1 : 0;
+}
+
+void Intrusion_Filter_Init(Intrusion_Filter *filter, const Intrusion_Filter_Config *config)
+{
+    filter->config = *config;
+    Intrusion_Filter_Clamp_Config(&filter->config);
+    Intrusion_Filter_Reset(filter);
+}
+
+void Intrusion_Filter_Reset(Intrusion_Filter *filter)
+{
+    filter->median_index = 0;
+    filter->median_fill = 0;
+    filter->distance_q8 = 0;
+    filter->velocity_q8 = 0;
+    filter->last_timestamp_us = 0;
+    filter->primed = 0;
+    filter->in_zone = 0;
+    filter->hit_history = 0;
+    filter->hit_count = 0;
+    filter->confirmed = 0;
+}
+
+void Intrusion_Filter_Set_Config(Intrusion_Filter *filter, const Intrusion_Filter_Config *config)
+{
+    uint8_t previous_window = filter->config.confirm_window;
+
+    filter->config = *config;
+    Intrusion_Filter_Clamp_Config(&filter->config);
+
+    if (filter->config.confirm_window != previous_window)
+    {
+        Intrusion_Filter_Reset(filter);
+    }
+}
+
+uint8_t Intrusion_Filter_Update(Intrusion_Filter *filter, const Sensor_Sample *sample)
+{
+    const Intrusion_Filter_Config *config = &filter->config;
+    uint8_t hit = 0;
+
+    if ((sample->status == SENSOR_STATUS_OK) && (sample->type != SENSOR_TYPE_RANGE))
+    {
+        // Motion and an open contact are hits without the distance stages
+        hit = (sample->value != 0) ? 1 : 0;
+    }
+    else if (sample->status == SENSOR_STATUS_OK)
+    {
+        uint16_t median_mm = Intrusion_Filter_Update_Median(filter, sample->value);
+        Intrusion_Filter_Update_Average(filter, median_mm, sample->timestamp_us);
+        hit = Intrusion_Filter_Is_Hit(filter);
+    }
+
+    // Shift the new result into the confirmation window and update the number of hits
+    uint8_t oldest_hit = (filter->hit_history >> (config->confirm_window - 1)) & 0x01;
+    filter->hit_history = ((filter->hit_history << 1) | hit) & Intrusion_Filter_Window_Mask(config->confirm_window);
+    filter->hit_count = filter->hit_count - oldest_hit + hit;
+
+    // Report an intrusion after N hits in the window and clear it after a full window of misses
+    if (!filter->confirmed && (filter->hit_count >= config->confirm_count))
+    {
+        filter->confirmed = 1;
+        return INTRUSION_FILTER_EVENT_DETECTED;
+    }
+
+    if (filter->confirmed && (filter->hit_count == 0))
+    {
+        filter->confirmed = 0;
+        return INTRUSION_FILTER_EVENT_CLEARED;
+    }
+
+    return INTRUSION_FILTER_EVENT_NONE;
+}
+
+uint8_t Intrusion_Filter_Is_Detected(const Intrusion_Filter *filter)
+{
+    return filter->confirmed;
+}
+
+uint16_t Intrusion_Filter_Get_Distance(const Intrusion_Filter *filter)
+{
+    // Round the Q8 value to the nearest millimeter
+    return (uint16_t)((filter->distance_q8 + 128) >> 8);
+}
+
+int32_t Intrusion_Filter_Get_Velocity(const Intrusion_Filter *filter)
+{
+    return filter->velocity_q8 / 256;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file Intrusion_Filter.h
+ *
+ * @brief Header file for the Intrusion_Filter module.
+ *
+ * This file contains the function definitions for the streaming intrusion-detection
+ * filter placed between the sensors and the alarm logic. Each sample of a distance
+ * sensor goes through the following stages:
+ * - A sliding median of the last INTRUSION_FILTER_MEDIAN_SIZE distances, which
+ *   removes single glitch frames.
+ * - An exponential moving average (EMA) of the median in Q8 fixed point.
+ * - An approach velocity computed from the change of the EMA between samples,
+ *   which detects an object that approaches slowly or quickly before it is close.
+ * - Hysteresis bands on the distance, so that an object standing at the threshold
+ *   does not toggle the detection.
+ * - N-of-M confirmation: an intrusion is only reported when N of the last M samples
+ *   were hits.
+ *
+ * A sample of a motion detector or a contact is a hit when its value is not zero, and
+ * only goes through the N-of-M confirmation.
+ *
+ * All stages use constant memory and cost O(1) per sample, so the filter keeps up
+ * with the full rate of the sensor. The thresholds are configured at runtime in
+ * millimeters and millimeters per second.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef INTRUSION_FILTER_H
+#define INTRUSION_FILTER_H
+
+#include "TM4C123GH6PM.h"
+#include "Sensor.h"
+
+// Number of distances in the sliding median window (odd)
+#define INTRUSION_FILTER_MEDIAN_SIZE    5
+
+// Largest confirmation window (one bit per sample)
+#define INTRUSION_FILTER_MAX_WINDOW     32
+
+/**
+ * @brief Events reported by Intrusion_Filter_Update.
+ */
+enum Intrusion_Filter_Events
+{
+    INTRUSION_FILTER_EVENT_NONE     = 0,    // The confirmed state did not change
+    INTRUSION_FILTER_EVENT_DETECTED = 1,    // An intrusion has just been confirmed
+    INTRUSION_FILTER_EVENT_CLEARED  = 2     // A confirmed intrusion has just ended
+};
+
+/**
+ * @brief Runtime configuration of the filter.
+ */
+typedef struct
+{
+    uint16_t enter_distance_mm;     // A distance at or below this value is a hit
+    uint16_t exit_distance_mm;      // After a hit, the distance must rise above this value to stop hitting
+    uint16_t approach_speed_mm_s;   // An approach at or above this speed is a hit (0 = disabled)
+    uint16_t approach_range_mm;     // The approach detector only applies below this distance
+    uint8_t ema_shift;              // EMA weight of a new sample is 1 / 2^ema_shift (0 = no smoothing)
+    uint8_t confirm_count;          // N: number of hits required in the confirmation window
+    uint8_t confirm_window;         // M: number of samples in the confirmation window (1 to 32)
+} Intrusion_Filter_Config;
+
+/**
+ * @brief State of one filter instance.
+ */
+typedef struct
+{
+    Intrusion_Filter_Config config;
+
+    // Sliding median: samples in arrival order and the same samples in sorted order
+    uint16_t median_window[INTRUSION_FILTER_MEDIAN_SIZE];
+    uint16_t median_sorted[INTRUSION_FILTER_MEDIAN_SIZE];
+    uint8_t median_index;
+    uint8_t median_fill;
+
+    // EMA of the median distance and of the approach velocity in Q8 fixed point
+    int32_t distance_q8;
+    int32_t velocity_q8;
+    uint64_t last_timestamp_us;
+    uint8_t primed;
+
+    // Hysteresis and N-of-M confirmation
+    uint8_t in_zone;
+    uint32_t hit_history;
+    uint8_t hit_count;
+    uint8_t confirmed;
+} Intrusion_Filter;
+
+/**
+ * @brief Initializes a filter instance with a configuration.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @param config A pointer to the configuration.
+ *
+ * @return None
+ */
+void Intrusion_Filter_Init(Intrusion_Filter *filter, const Intrusion_Filter_Config *config);
+
+/**
+ * @brief Clears the history of a filter instance and keeps its configuration.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @return None
+ */
+void Intrusion_Filter_Reset(Intrusion_Filter *filter);
+
+/**
+ * @brief Changes the configuration of a filter instance.
+ *
+ * The history is cleared when the confirmation window changes.
+ * Out-of-range values are clamped.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @param config A pointer to the new configuration.
+ *
+ * @return None
+ */
+void Intrusion_Filter_Set_Config(Intrusion_Filter *filter, const Intrusion_Filter_Config *config);
+
+/**
+ * @brief Feeds one sample to a filter instance.
+ *
+ * A sample without a valid value counts as a miss and does not change the
+ * median, the EMA, or the velocity.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @param sample A pointer to the new sample.
+ *
+ * @return uint8_t The event caused by the sample (see Intrusion_Filter_Events).
+ */
+uint8_t Intrusion_Filter_Update(Intrusion_Filter *filter, const Sensor_Sample *sample);
+
+/**
+ * @brief Indicates whether an intrusion is currently confirmed.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @return uint8_t Returns 1 if an intrusion is confirmed. Otherwise, it returns 0.
+ */
+uint8_t Intrusion_Filter_Is_Detected(const Intrusion_Filter *filter);
+
+/**
+ * @brief Returns the filtered (median and EMA) distance.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @return uint16_t The filtered distance in millimeters, or 0 if no valid sample was received.
+ */
+uint16_t Intrusion_Filter_Get_Distance(const Intrusion_Filter *filter);
+
+/**
+ * @brief Returns the filtered approach velocity.
+ *
+ * @param filter A pointer to the filter.
+ *
+ * @return int32_t The approach velocity in millimeters per second (positive when the object approaches).
+ */
+int32_t Intrusion_Filter_Get_Velocity(const Intrusion_Filter *filter);
+
+#endif
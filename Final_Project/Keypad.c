@@ -0,0 +1,183 @@
+/**
+ * @file Keypad.c
+ *
+ * @brief Source code for the Keypad module.
+ *
+ * This file contains the function definitions for the interrupt-driven, debounced
+ * input of the EduBase push buttons.
+ *
+ * The GPIO Port D interrupt (priority 3) and the Timer 0A interrupt (priority 1) share
+ * the debounce state. The GPIO interrupt disables interrupts while it updates the state,
+ * and the Timer 0A interrupt cannot be preempted by it.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Keypad.h"
+#include "EduBase_Button_Interrupt.h"
+#include "Ring_Buffer.h"
+#include "Scheduler.h"
+
+// Event FIFO, written by Keypad_Tick and read by the receiving task
+// Each entry holds the event type in the upper nibble and the button in the lower nibble
+static uint8_t event_storage[KEYPAD_EVENT_FIFO_SIZE];
+static Ring_Buffer event_fifo;
+static uint32_t dropped_count = 0;
+static uint8_t event_task_id = 0;
+
+// Debounced state of the buttons and the remaining debounce time
+static volatile uint8_t stable_buttons = 0;
+static volatile uint8_t debounce_remaining_ms = 0;
+
+// Time for which each pressed button has been held, and the buttons whose long press was reported
+static uint16_t held_ms[4];
+static uint8_t long_press_reported = 0;
+
+static void Keypad_Push_Event(uint8_t button, uint8_t type)
+{
+    if (!Ring_Buffer_Put(&event_fifo, (type << 4) | button))
+    {
+        dropped_count++;
+    }
+}
+
+// Executed from GPIOD_Handler on every edge of a button
+static void Keypad_Edge_Detected(uint8_t button_status)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Ignore the bounces until the buttons have been stable for the debounce interval
+    EduBase_Button_Interrupt_Disable(EDUBASE_BUTTON_PINS);
+    debounce_remaining_ms = KEYPAD_DEBOUNCE_MS;
+
+    __set_PRIMASK(primask);
+}
+
+static void Keypad_Debounce_Done(void)
+{
+    uint8_t sample = Get_EduBase_Button_Status();
+    uint8_t changed = sample ^ stable_buttons;
+    uint8_t posted = 0;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        uint8_t button = 1 << i;
+
+        if (changed & button)
+        {
+            Keypad_Push_Event(button, (sample & button) ? KEYPAD_EVENT_PRESS : KEYPAD_EVENT_RELEASE);
+            held_ms[i] = 0;
+            long_press_reported &= ~button;
+            posted = 1;
+        }
+    }
+
+    stable_buttons = sample;
+
+    EduBase_Button_Interrupt_Enable(EDUBASE_BUTTON_PINS);
+
+    // A change between the sample and enabling the interrupts would not cause an edge
+    if (Get_EduBase_Button_Status() != sample)
+    {
+        EduBase_Button_Interrupt_Disable(EDUBASE_BUTTON_PINS);
+        debounce_remaining_ms = KEYPAD_DEBOUNCE_MS;
+    }
+
+    if (posted)
+    {
+        Scheduler_Post(event_task_id, SIGNAL_BUTTON_EVENT, 0);
+    }
+}
+
+static void Keypad_Update_Long_Press(void)
+{
+    uint8_t posted = 0;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        uint8_t button = 1 << i;
+
+        if ((stable_buttons & button) && !(long_press_reported & button))
+        {
+            held_ms[i]++;
+
+            if (held_ms[i] >= KEYPAD_LONG_PRESS_MS)
+            {
+                Keypad_Push_Event(button, KEYPAD_EVENT_LONG_PRESS);
+                long_press_reported |= button;
+                posted = 1;
+            }
+        }
+    }
+
+    if (posted)
+    {
+        Scheduler_Post(event_task_id, SIGNAL_BUTTON_EVENT, 0);
+    }
+}
+
+void Keypad_Init(uint8_t task_id)
+{
+    event_task_id = task_id;
+    dropped_count = 0;
+    long_press_reported = 0;
+    debounce_remaining_ms = 0;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        held_ms[i] = 0;
+    }
+
+    Ring_Buffer_Init(&event_fifo, event_storage, KEYPAD_EVENT_FIFO_SIZE);
+
+    // Buttons held during initialization are not reported as presses
+    stable_buttons = Get_EduBase_Button_Status();
+    long_press_reported = stable_buttons;
+
+    EduBase_Button_Interrupt_Init(&Keypad_Edge_Detected);
+}
+
+uint8_t Keypad_Get_Event(Keypad_Event *event)
+{
+    uint8_t entry;
+
+    if (!Ring_Buffer_Get(&event_fifo, &entry))
+    {
+        return 0;
+    }
+
+    event->button = entry & 0x0F;
+    event->type = entry >> 4;
+
+    return 1;
+}
+
+uint8_t Keypad_Is_Idle(void)
+{
+    // A held button needs the tick until its long press has been reported
+    return ((debounce_remaining_ms == 0) && ((stable_buttons & ~long_press_reported) == 0)) ? 1 : 0;
+}
+
+uint32_t Keypad_Get_Dropped_Count(void)
+{
+    return dropped_count;
+}
+
+void Keypad_Tick(void)
+{
+    if (debounce_remaining_ms > 0)
+    {
+        debounce_remaining_ms = debounce_remaining_ms - 1;
+
+        if (debounce_remaining_ms == 0)
+        {
+            Keypad_Debounce_Done();
+        }
+    }
+
+    if (stable_buttons & ~long_press_reported)
+    {
+        Keypad_Update_Long_Press();
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file Keypad.h
+ *
+ * @brief Header file for the Keypad module.
+ *
+ * This file contains the function definitions for the interrupt-driven, debounced
+ * input of the EduBase push buttons (SW2 - SW5):
+ * - An edge on any button triggers the GPIO Port D interrupt. The interrupt disables
+ *   the button interrupts and starts a debounce interval.
+ * - Once the interval has elapsed, Keypad_Tick (Timer 0A, 1 ms) samples the buttons,
+ *   reports a press or release for every button that changed, and enables the
+ *   button interrupts again.
+ * - A button held for KEYPAD_LONG_PRESS_MS also reports a long press.
+ *
+ * The events are stored in a lock-free FIFO written only by Keypad_Tick, and a
+ * SIGNAL_BUTTON_EVENT is posted to the receiving task, which drains the FIFO with
+ * Keypad_Get_Event. While no button is bouncing or held, Keypad_Tick returns immediately.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef KEYPAD_H
+#define KEYPAD_H
+
+#include "TM4C123GH6PM.h"
+
+// Time for which the buttons must be stable before a change is reported
+#define KEYPAD_DEBOUNCE_MS      20
+
+// Time for which a button must be held to report a long press
+#define KEYPAD_LONG_PRESS_MS    1000
+
+// Size of the event FIFO (must be a power of two)
+#define KEYPAD_EVENT_FIFO_SIZE  16
+
+/**
+ * @brief Bit masks of the EduBase push buttons, as returned by Get_EduBase_Button_Status.
+ */
+enum Keypad_Buttons
+{
+    KEYPAD_SW5  = 0x01,
+    KEYPAD_SW4  = 0x02,
+    KEYPAD_SW3  = 0x04,
+    KEYPAD_SW2  = 0x08
+};
+
+/**
+ * @brief Types of button events.
+ */
+enum Keypad_Event_Types
+{
+    KEYPAD_EVENT_PRESS      = 1,
+    KEYPAD_EVENT_RELEASE    = 2,
+    KEYPAD_EVENT_LONG_PRESS = 3
+};
+
+/**
+ * @brief A button event.
+ */
+typedef struct
+{
+    uint8_t button;     // See Keypad_Buttons
+    uint8_t type;       // See Keypad_Event_Types
+} Keypad_Event;
+
+/**
+ * @brief Initializes the button interrupts and the event FIFO.
+ *
+ * @param task_id The task that receives SIGNAL_BUTTON_EVENT when new events are available.
+ *
+ * @return None
+ */
+void Keypad_Init(uint8_t task_id);
+
+/**
+ * @brief Removes the oldest event from the event FIFO.
+ *
+ * This function must only be called from task context.
+ *
+ * @param event A pointer to where the event is copied.
+ *
+ * @return uint8_t Returns 1 if an event was removed, or 0 if the FIFO is empty.
+ */
+uint8_t Keypad_Get_Event(Keypad_Event *event);
+
+/**
+ * @brief Indicates whether the keypad needs the 1 ms tick.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if no button is bouncing or held. Otherwise, it returns 0.
+ */
+uint8_t Keypad_Is_Idle(void);
+
+/**
+ * @brief Returns the number of events dropped because the event FIFO was full.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of dropped events.
+ */
+uint32_t Keypad_Get_Dropped_Count(void);
+
+/**
+ * @brief Advances the debounce and long-press timers by 1 ms.
+ *
+ * This function must be called every 1 ms from the Timer 0A interrupt service routine.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Keypad_Tick(void);
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file LCD_Format.c
+ *
+ * @brief Source code for the LCD_Format module.
+ *
+ * This file contains the function definitions for the number formatting routines of the LCD.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "LCD_Format.h"
+
+// Digits of the largest 32-bit magnitude (4294967295)
+#define LCD_FORMAT_MAX_DIGITS       10
+
+// Scale of each number of decimals of LCD_Format_Fixed
+static const uint16_t decimal_scale[LCD_FORMAT_MAX_DECIMALS + 1] = {1, 10, 100, 1000, 10000};
+
+// Writes a magnitude right-aligned in a field, with an optional minus sign, and returns its length
+static uint8_t LCD_Format_Digits(char *buffer, uint32_t magnitude, uint8_t negative, uint8_t width, char pad)
+{
+    char digits[LCD_FORMAT_MAX_DIGITS];
+    uint8_t digit_count = 0;
+    uint8_t length = 0;
+
+    // Convert the digits from the least significant one
+    do
+    {
+        digits[digit_count] = '0' + (magnitude % 10);
+        digit_count++;
+        magnitude = magnitude / 10;
+    } while (magnitude > 0);
+
+    if (width > LCD_FORMAT_MAX_LENGTH)
+    {
+        width = LCD_FORMAT_MAX_LENGTH;
+    }
+
+    uint8_t used = digit_count + negative;
+
+    // The sign goes in front of zero padding and after space padding
+    if (negative && (pad == '0'))
+    {
+        buffer[length++] = '-';
+    }
+
+    for (; used < width; used++)
+    {
+        buffer[length++] = pad;
+    }
+
+    if (negative && (pad != '0'))
+    {
+        buffer[length++] = '-';
+    }
+
+    while (digit_count > 0)
+    {
+        digit_count--;
+        buffer[length++] = digits[digit_count];
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+// Appends a string at the given length of the buffer and returns the new length
+static uint8_t LCD_Format_Append(char *buffer, uint8_t length, const char *string)
+{
+    while ((*string != '\0') && (length < LCD_FORMAT_MAX_LENGTH))
+    {
+        buffer[length++] = *string;
+        string++;
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+uint8_t LCD_Format_Integer(char *buffer, int32_t value, uint8_t width, char pad)
+{
+    uint32_t magnitude = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    return LCD_Format_Digits(buffer, magnitude, (value < 0) ? 1 : 0, width, pad);
+}
+
+uint8_t LCD_Format_Fixed(char *buffer, int32_t value, uint8_t decimals)
+{
+    uint32_t magnitude = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    if (decimals > LCD_FORMAT_MAX_DECIMALS)
+    {
+        decimals = LCD_FORMAT_MAX_DECIMALS;
+    }
+
+    uint32_t scale = decimal_scale[decimals];
+
+    // The sign is kept for values between -1 and 0, such as -0.05
+    uint8_t length = LCD_Format_Digits(buffer, magnitude / scale, (value < 0) ? 1 : 0, 0, ' ');
+
+    if (decimals > 0)
+    {
+        buffer[length++] = '.';
+        length = length + LCD_Format_Digits(&buffer[length], magnitude % scale, 0, decimals, '0');
+    }
+
+    return length;
+}
+
+uint8_t LCD_Format_Distance(char *buffer, uint16_t distance_mm, uint8_t unit)
+{
+    uint8_t length;
+
+    if (unit == LCD_FORMAT_UNIT_CM)
+    {
+        length = LCD_Format_Fixed(buffer, distance_mm, 1);
+        return LCD_Format_Append(buffer, length, " cm");
+    }
+
+    length = LCD_Format_Digits(buffer, distance_mm, 0, 0, ' ');
+    return LCD_Format_Append(buffer, length, " mm");
+}
+
+uint8_t LCD_Format_Time(char *buffer, uint32_t seconds)
+{
+    seconds = seconds % 86400;
+
+    uint8_t hours = seconds / 3600;
+    uint8_t minutes = (seconds / 60) % 60;
+    uint8_t secs = seconds % 60;
+
+    buffer[0] = '0' + (hours / 10);
+    buffer[1] = '0' + (hours % 10);
+    buffer[2] = ':';
+    buffer[3] = '0' + (minutes / 10);
+    buffer[4] = '0' + (minutes % 10);
+    buffer[5] = ':';
+    buffer[6] = '0' + (secs / 10);
+    buffer[7] = '0' + (secs % 10);
+    buffer[8] = '\0';
+
+    return 8;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file LCD_Format.h
+ *
+ * @brief Header file for the LCD_Format module.
+ *
+ * This file contains the function definitions for the number formatting routines of the
+ * LCD. They replace sprintf, which links the stdio and floating-point libraries into the
+ * image and takes thousands of cycles per call. Each routine writes into a buffer of the
+ * caller (at least LCD_FORMAT_BUFFER_SIZE characters, usually on the stack), never uses
+ * the heap, and returns the length of the text so that it can be appended to.
+ *
+ * The digits are produced with a division by the constant 10, which the compiler turns
+ * into a multiplication and a shift, so the cost grows with the number of characters.
+ * Estimated from the instruction counts at 50 MHz:
+ *  - LCD_Format_Integer: about 10 cycles per digit, at most about 150 cycles
+ *  - LCD_Format_Fixed and LCD_Format_Distance: about 200 cycles
+ *  - LCD_Format_Time: about 60 cycles, with no loop
+ *
+ * The formatting calls of the LCD_Framebuffer write functions are measured on the target
+ * by the PROFILE_PROBE_LCD_FORMAT probe (see Profile.h), which reports the actual cycle counts.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef LCD_FORMAT_H
+#define LCD_FORMAT_H
+
+#include <stdint.h>
+
+// Longest text of a formatting routine (one row of the LCD)
+#define LCD_FORMAT_MAX_LENGTH       16
+
+// Size of a buffer that holds the longest text and the null terminator
+#define LCD_FORMAT_BUFFER_SIZE      (LCD_FORMAT_MAX_LENGTH + 1)
+
+// Most digits after the decimal point of LCD_Format_Fixed
+#define LCD_FORMAT_MAX_DECIMALS     4
+
+/**
+ * @brief Units of LCD_Format_Distance.
+ */
+enum LCD_Format_Units
+{
+    LCD_FORMAT_UNIT_MM  = 0,    // Whole millimeters, such as "1234 mm"
+    LCD_FORMAT_UNIT_CM  = 1     // Centimeters with one decimal, such as "123.4 cm"
+};
+
+/**
+ * @brief Formats a signed decimal integer, right-aligned in a field.
+ *
+ * The field is filled with the pad character in front of the number. A minus sign is
+ * placed in front of the padding when the pad character is '0' ("-0042"), and after it
+ * otherwise ("  -42"). A number longer than the field is not truncated.
+ *
+ * @param buffer A pointer to the buffer (at least LCD_FORMAT_BUFFER_SIZE characters).
+ *
+ * @param value The value to format.
+ *
+ * @param width The minimum width of the field (0 for no padding, at most LCD_FORMAT_MAX_LENGTH).
+ *
+ * @param pad The pad character (usually ' ' or '0').
+ *
+ * @return uint8_t The length of the text, without the null terminator.
+ */
+uint8_t LCD_Format_Integer(char *buffer, int32_t value, uint8_t width, char pad);
+
+/**
+ * @brief Formats a fixed-point number with a decimal point.
+ *
+ * The value is a count of 10^-decimals units. For example, 1234 with 1 decimal is
+ * formatted as "123.4", and -5 with 2 decimals as "-0.05".
+ *
+ * @param buffer A pointer to the buffer (at least LCD_FORMAT_BUFFER_SIZE characters).
+ *
+ * @param value The fixed-point value.
+ *
+ * @param decimals The number of digits after the decimal point (0 to LCD_FORMAT_MAX_DECIMALS).
+ *
+ * @return uint8_t The length of the text, without the null terminator.
+ */
+uint8_t LCD_Format_Fixed(char *buffer, int32_t value, uint8_t decimals);
+
+/**
+ * @brief Formats a distance in millimeters with its unit.
+ *
+ * @param buffer A pointer to the buffer (at least LCD_FORMAT_BUFFER_SIZE characters).
+ *
+ * @param distance_mm The distance in millimeters.
+ *
+ * @param unit The unit of the text (see LCD_Format_Units).
+ *
+ * @return uint8_t The length of the text, without the null terminator.
+ */
+uint8_t LCD_Format_Distance(char *buffer, uint16_t distance_mm, uint8_t unit);
+
+/**
+ * @brief Formats a time of day as "HH:MM:SS".
+ *
+ * @param buffer A pointer to the buffer (at least LCD_FORMAT_BUFFER_SIZE characters).
+ *
+ * @param seconds The number of seconds since midnight. Whole days are discarded.
+ *
+ * @return uint8_t The length of the text (8), without the null terminator.
+ */
+uint8_t LCD_Format_Time(char *buffer, uint32_t seconds);
+
+#endif
@@ -0,0 +1,455 @@
+/**
+ * @file LCD_Framebuffer.c
+ *
+ * @brief Source code for the LCD_Framebuffer driver.
+ *
+ * This file contains the function definitions for the LCD_Framebuffer driver.
+ *
+ * Each cell of the framebuffer has one bit in the dirty mask (Bit (row * 16 + col)).
+ * The tasks only set bits and the Timer 1A interrupt only clears them. A cell that is
+ * changed while its previous value is being sent stays dirty and is sent again.
+ *
+ * The initialization sequence is a table of commands with the time that follows each one,
+ * taken from the 4-bit initialization of EduBase_LCD_Init (page 46 of HD44780 datasheet).
+ * The interrupt sends one step per time-out until the table has been sent.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "LCD_Framebuffer.h"
+#include "EduBase_LCD.h"
+#include "Profile.h"
+#include "Bit_Band.h"
+#include "Benchmark.h"
+#include "Clock.h"
+
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+// The busy flag is checked before each byte, so the first check follows shortly after a transfer
+#define LCD_EXECUTION_TIME_US		LCD_BUSY_POLL_US
+#define LCD_CLEAR_EXECUTION_TIME_US	LCD_BUSY_POLL_US
+#else
+// Execution time of a command or data write (37 us) plus the address update time (4 us)
+#define LCD_EXECUTION_TIME_US		41
+
+// Execution time of the Clear Display and Return Home commands
+#define LCD_CLEAR_EXECUTION_TIME_US	1520
+#endif
+
+// Wait after the LCD is powered on, before the first command of the initialization sequence
+#define LCD_POWER_ON_DELAY_US		50000
+
+// Flag of an initialization step that only sends the upper nibble (while in 8-bit mode)
+#define LCD_INIT_NIBBLE				0x01
+
+// Delay used to start the flush from task context
+#define LCD_FLUSH_START_DELAY_US	1
+
+// Interval between two checks of the busy flag in the busy flag mode
+#define LCD_BUSY_POLL_US			5
+
+// Timer 1A has an Interrupt Request (IRQ) number of 21
+#define TIMER1A_IRQ_BIT				(1 << 21)
+
+// Enable bit of Timer 1A (TAEN, Bit 0) in the GPTMCTL register, written through its bit-band
+// alias since the timer is restarted both from the interrupt and from the tasks
+#define LCD_TIMER_ENABLE			BIT_BAND(TIMER1->CTL, 0)
+
+// DDRAM address that does not match any cell
+#define LCD_CURSOR_UNKNOWN			0xFF
+
+/**
+ * @brief One step of the initialization sequence.
+ */
+typedef struct
+{
+	uint8_t command;
+	uint8_t flags;
+	uint16_t delay_us;		// Time to wait after the command
+} LCD_Init_Step;
+
+// Initialization sequence of the LCD, sent after LCD_POWER_ON_DELAY_US
+static const LCD_Init_Step init_sequence[] =
+{
+	// Three Function Set commands for 8-bit mode, then the Function Set for 4-bit mode
+	{FUNCTION_SET | CONFIG_EIGHT_BIT_MODE, LCD_INIT_NIBBLE, 4500},
+	{FUNCTION_SET | CONFIG_EIGHT_BIT_MODE, LCD_INIT_NIBBLE, 4500},
+	{FUNCTION_SET | CONFIG_EIGHT_BIT_MODE, LCD_INIT_NIBBLE, 150},
+	{FUNCTION_SET | CONFIG_FOUR_BIT_MODE, LCD_INIT_NIBBLE, LCD_EXECUTION_TIME_US},
+	
+	// 5x8 dots and two rows, display on with the cursor and blinking off, then clear
+	{FUNCTION_SET | CONFIG_5x8_DOTS | CONFIG_TWO_LINES, 0, LCD_EXECUTION_TIME_US},
+	{DISPLAY_CONTROL | DISPLAY_ON | CURSOR_OFF | CURSOR_BLINK_OFF, 0, LCD_EXECUTION_TIME_US},
+	{RETURN_HOME, 0, LCD_CLEAR_EXECUTION_TIME_US},
+	{CLEAR_DISPLAY, 0, LCD_CLEAR_EXECUTION_TIME_US}
+};
+
+#define LCD_INIT_STEP_COUNT			(sizeof(init_sequence) / sizeof(init_sequence[0]))
+
+// The busy flag can only be read once the interface is in 4-bit mode (after step 3)
+#define LCD_INIT_BUSY_FLAG_STEP		4
+
+// Shadow copy of the LCD and the cells that still have to be sent
+static volatile char framebuffer[LCD_FRAMEBUFFER_ROWS * LCD_FRAMEBUFFER_COLUMNS];
+static volatile uint32_t dirty_mask = 0;
+static volatile uint8_t clear_pending = 0;
+static volatile uint8_t flush_active = 0;
+
+// Next step of the initialization sequence (LCD_INIT_STEP_COUNT once it has been sent)
+static volatile uint8_t init_step = 0;
+static volatile uint8_t init_done = 0;
+
+// Cell index that the DDRAM address counter of the LCD points to
+static uint8_t cursor_index = LCD_CURSOR_UNKNOWN;
+
+static void LCD_Framebuffer_Start_Timer(uint32_t delay_us)
+{
+	// Load the one-shot interval and enable Timer 1A, which counts at the system clock
+	TIMER1->TAILR = (delay_us * Clock_Get_Cycles_Per_Us()) - 1;
+	LCD_TIMER_ENABLE = 1;
+}
+
+static void LCD_Framebuffer_Write_Byte(uint8_t data, uint8_t control_flag)
+{
+	// Set or clear the register select (RS) pin based on the control flag
+	// 0 for command and 1 for data
+	if (control_flag & 0x01)
+	{
+		PIN_SET(PIN_LCD_RS);
+	}
+	else
+	{
+		PIN_CLEAR(PIN_LCD_RS);
+	}
+	
+	// Transmit the upper nibble and then the lower nibble on the data pins (PA2 - PA5).
+	// Each nibble is a single store to the masked alias of the data pins.
+	PIN_WRITE(PIN_LCD_DATA, ((data & 0xF0) >> 4) << PIN_LCD_DATA_SHIFT);
+	EduBase_LCD_Pulse_Enable();
+	
+	PIN_WRITE(PIN_LCD_DATA, (data & 0x0F) << PIN_LCD_DATA_SHIFT);
+	EduBase_LCD_Pulse_Enable();
+	
+	PIN_CLEAR(PIN_LCD_DATA);
+}
+
+static void LCD_Framebuffer_Write_Nibble(uint8_t data)
+{
+	// Transmit only the upper nibble of a command, while the LCD is still in 8-bit mode
+	PIN_CLEAR(PIN_LCD_RS);
+	PIN_WRITE(PIN_LCD_DATA, ((data & 0xF0) >> 4) << PIN_LCD_DATA_SHIFT);
+	EduBase_LCD_Pulse_Enable();
+	
+	PIN_CLEAR(PIN_LCD_DATA);
+}
+
+static void LCD_Framebuffer_Mark_Dirty(uint8_t index)
+{
+	dirty_mask |= (1UL << index);
+}
+
+static void LCD_Framebuffer_Kick(void)
+{
+	// The interrupt clears flush_active only after it has found no dirty cell,
+	// so a cell marked dirty before this check is never missed
+	if (!flush_active && (dirty_mask || clear_pending))
+	{
+		flush_active = 1;
+		LCD_Framebuffer_Start_Timer(LCD_FLUSH_START_DELAY_US);
+	}
+}
+
+static void LCD_Framebuffer_Put(uint8_t index, char character)
+{
+	if (framebuffer[index] != character)
+	{
+		framebuffer[index] = character;
+		LCD_Framebuffer_Mark_Dirty(index);
+	}
+}
+
+// Sends the next byte to the LCD and returns its execution time, or 0 if there is nothing to send
+static uint32_t LCD_Framebuffer_Send_Next(void)
+{
+#if EDUBASE_LCD_BUSY_FLAG_MODE
+	// Check the busy flag again later instead of waiting for the worst-case execution time
+	if ((init_step >= LCD_INIT_BUSY_FLAG_STEP) && (EduBase_LCD_Read_Status() & EDUBASE_LCD_BUSY_FLAG))
+	{
+		return LCD_BUSY_POLL_US;
+	}
+#endif
+	
+	// The initialization sequence is sent before anything else
+	if (init_step < LCD_INIT_STEP_COUNT)
+	{
+		const LCD_Init_Step *step = &init_sequence[init_step];
+		
+		if (step->flags & LCD_INIT_NIBBLE)
+		{
+			LCD_Framebuffer_Write_Nibble(step->command);
+		}
+		else
+		{
+			LCD_Framebuffer_Write_Byte(step->command, SEND_COMMAND_FLAG);
+		}
+		
+		// The sequence ends with Clear Display, which sets the DDRAM address to 0
+		init_step++;
+		cursor_index = 0;
+		return step->delay_us;
+	}
+	
+	if (!init_done)
+	{
+		init_done = 1;
+		Benchmark_Mark_Boot(BENCHMARK_BOOT_LCD_READY);
+	}
+	
+	if (clear_pending)
+	{
+		clear_pending = 0;
+		cursor_index = 0;
+		LCD_Framebuffer_Write_Byte(CLEAR_DISPLAY, SEND_COMMAND_FLAG);
+		return LCD_CLEAR_EXECUTION_TIME_US;
+	}
+	
+	uint32_t pending = dirty_mask;
+	
+	if (pending == 0)
+	{
+		return 0;
+	}
+	
+	// Prefer the cell at the current DDRAM address to avoid a Set DDRAM Address command
+	uint8_t index;
+	
+	if ((cursor_index != LCD_CURSOR_UNKNOWN) && (pending & (1UL << cursor_index)))
+	{
+		index = cursor_index;
+	}
+	else
+	{
+		index = 0;
+		while ((pending & (1UL << index)) == 0)
+		{
+			index++;
+		}
+	}
+	
+	if (index != cursor_index)
+	{
+		uint8_t col = index % LCD_FRAMEBUFFER_COLUMNS;
+		uint8_t row = index / LCD_FRAMEBUFFER_COLUMNS;
+		
+		LCD_Framebuffer_Write_Byte(SET_DDRAM_ADDR | ((row == 0) ? col : (col + 0x40)), SEND_COMMAND_FLAG);
+		cursor_index = index;
+		return LCD_EXECUTION_TIME_US;
+	}
+	
+	// Clear the dirty bit before the character is read so that a newer write is sent again
+	dirty_mask &= ~(1UL << index);
+	LCD_Framebuffer_Write_Byte(framebuffer[index], SEND_DATA_FLAG);
+	
+	// The address counter does not continue from the end of the first row to the second row
+	cursor_index = index + 1;
+	if ((cursor_index % LCD_FRAMEBUFFER_COLUMNS) == 0)
+	{
+		cursor_index = LCD_CURSOR_UNKNOWN;
+	}
+	
+	return LCD_EXECUTION_TIME_US;
+}
+
+void LCD_Framebuffer_Init(void)
+{
+	for (int i = 0; i < (LCD_FRAMEBUFFER_ROWS * LCD_FRAMEBUFFER_COLUMNS); i++)
+	{
+		framebuffer[i] = ' ';
+	}
+	
+	dirty_mask = 0;
+	clear_pending = 0;
+	flush_active = 0;
+	init_step = 0;
+	init_done = 0;
+	cursor_index = LCD_CURSOR_UNKNOWN;
+	
+	// Configure the data, enable, and register select pins of the LCD
+	EduBase_LCD_Ports_Init();
+	
+	// Set the R1 bit (Bit 1) in the RCGCTIMER register
+	// to enable the clock for Timer 1A
+	SYSCTL->RCGCTIMER |= 0x02;
+	
+	// Clear the TAEN bit (Bit 0) of the GPTMCTL register
+	// to disable Timer 1A
+	LCD_TIMER_ENABLE = 0;
+	
+	// Select the 32-bit timer configuration
+	TIMER1->CFG = 0x00;
+	
+	// Set the bits of the TAMR field (Bits 1 to 0) in the GPTMTAMR register
+	// 0x1 = One-Shot Timer Mode
+	TIMER1->TAMR = 0x01;
+	
+	// Clear and enable the Timer 1A time-out interrupt
+	TIMER1->ICR = 0x01;
+	TIMER1->IMR |= 0x01;
+	
+	// Set the priority level to 3 for the Timer 1A interrupt
+	// In the Interrupt 20-23 Priority (PRI5) register,
+	// the INTB field (Bits 15 to 13) corresponds to Interrupt Request (IRQ) 21
+	NVIC->IPR[5] = (NVIC->IPR[5] & 0xFFFF00FF) | (3 << 13);
+	
+	// Enable IRQ 21 for Timer 1A by setting Bit 21 in the ISER[0] register
+	NVIC->ISER[0] |= TIMER1A_IRQ_BIT;
+	
+	// Start the initialization sequence once the LCD has powered up
+	flush_active = 1;
+	LCD_Framebuffer_Start_Timer(LCD_POWER_ON_DELAY_US);
+}
+
+void LCD_Framebuffer_Clear(void)
+{
+	for (uint8_t i = 0; i < (LCD_FRAMEBUFFER_ROWS * LCD_FRAMEBUFFER_COLUMNS); i++)
+	{
+		LCD_Framebuffer_Put(i, ' ');
+	}
+	
+	LCD_Framebuffer_Kick();
+}
+
+void LCD_Framebuffer_Write_Char(uint8_t col, uint8_t row, char character)
+{
+	if ((col < LCD_FRAMEBUFFER_COLUMNS) && (row < LCD_FRAMEBUFFER_ROWS))
+	{
+		LCD_Framebuffer_Put((row * LCD_FRAMEBUFFER_COLUMNS) + col, character);
+		LCD_Framebuffer_Kick();
+	}
+}
+
+uint8_t LCD_Framebuffer_Write_String(uint8_t col, uint8_t row, const char *string)
+{
+	if (row >= LCD_FRAMEBUFFER_ROWS)
+	{
+		return col;
+	}
+	
+	while ((col < LCD_FRAMEBUFFER_COLUMNS) && (*string != '\0'))
+	{
+		LCD_Framebuffer_Put((row * LCD_FRAMEBUFFER_COLUMNS) + col, *string);
+		string++;
+		col++;
+	}
+	
+	LCD_Framebuffer_Kick();
+	
+	return col;
+}
+
+void LCD_Framebuffer_Write_Line(uint8_t row, const char *string)
+{
+	uint8_t col = LCD_Framebuffer_Write_String(0, row, string);
+	
+	if (row >= LCD_FRAMEBUFFER_ROWS)
+	{
+		return;
+	}
+	
+	for (; col < LCD_FRAMEBUFFER_COLUMNS; col++)
+	{
+		LCD_Framebuffer_Put((row * LCD_FRAMEBUFFER_COLUMNS) + col, ' ');
+	}
+	
+	LCD_Framebuffer_Kick();
+}
+
+uint8_t LCD_Framebuffer_Write_Integer(uint8_t col, uint8_t row, int32_t value)
+{
+	return LCD_Framebuffer_Write_Padded(col, row, value, 0, ' ');
+}
+
+uint8_t LCD_Framebuffer_Write_Padded(uint8_t col, uint8_t row, int32_t value, uint8_t width, char pad)
+{
+	char text[LCD_FORMAT_BUFFER_SIZE];
+	
+	PROFILE_BEGIN();
+	LCD_Format_Integer(text, value, width, pad);
+	PROFILE_END(PROFILE_PROBE_LCD_FORMAT);
+	
+	return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+uint8_t LCD_Framebuffer_Write_Distance(uint8_t col, uint8_t row, uint16_t distance_mm, uint8_t unit)
+{
+	char text[LCD_FORMAT_BUFFER_SIZE];
+	
+	PROFILE_BEGIN();
+	LCD_Format_Distance(text, distance_mm, unit);
+	PROFILE_END(PROFILE_PROBE_LCD_FORMAT);
+	
+	return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+uint8_t LCD_Framebuffer_Write_Time(uint8_t col, uint8_t row, uint32_t seconds)
+{
+	char text[LCD_FORMAT_BUFFER_SIZE];
+	
+	PROFILE_BEGIN();
+	LCD_Format_Time(text, seconds);
+	PROFILE_END(PROFILE_PROBE_LCD_FORMAT);
+	
+	return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+void LCD_Framebuffer_Invalidate(void)
+{
+	clear_pending = 1;
+	
+	// After the Clear Display command, every non-blank cell has to be written again
+	for (uint8_t i = 0; i < (LCD_FRAMEBUFFER_ROWS * LCD_FRAMEBUFFER_COLUMNS); i++)
+	{
+		if (framebuffer[i] != ' ')
+		{
+			LCD_Framebuffer_Mark_Dirty(i);
+		}
+	}
+	
+	LCD_Framebuffer_Kick();
+}
+
+uint8_t LCD_Framebuffer_Is_Ready(void)
+{
+	return init_done;
+}
+
+uint8_t LCD_Framebuffer_Is_Idle(void)
+{
+	return ((dirty_mask == 0) && !clear_pending && !flush_active) ? 1 : 0;
+}
+
+void TIMER1A_Handler(void)
+{
+	PROFILE_BEGIN();
+	
+	// Check if the Timer 1A time-out interrupt has occurred
+	// by reading the TATOMIS bit (Bit 0) in the GPTMMIS register
+	if (TIMER1->MIS & 0x01)
+	{
+		// Acknowledge the Timer 1A interrupt and clear it
+		// by setting the TATOCINT bit (Bit 0) in the GPTMICR register
+		TIMER1->ICR = 0x01;
+		
+		uint32_t delay_us = LCD_Framebuffer_Send_Next();
+		
+		if (delay_us > 0)
+		{
+			LCD_Framebuffer_Start_Timer(delay_us);
+		}
+		else
+		{
+			flush_active = 0;
+		}
+	}
+	
+	PROFILE_END(PROFILE_PROBE_TIMER1A);
+}
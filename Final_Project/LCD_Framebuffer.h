@@ -0,0 +1,226 @@
+/**
+ * @file LCD_Framebuffer.h
+ *
+ * @brief Header file for the LCD_Framebuffer driver.
+ *
+ * This file contains the function definitions for the LCD_Framebuffer driver.
+ * It keeps a 16x2 shadow copy of the EduBase Board LCD in RAM. The write functions
+ * only update the shadow copy and mark the changed cells as dirty, so they return
+ * within microseconds. The dirty cells are sent to the HD44780 controller in the
+ * background by the Timer 1A interrupt, one byte per interrupt:
+ *  - A Set DDRAM Address command is only sent when the next dirty cell does not
+ *    follow the cell that was written last.
+ *  - Each byte is followed by the execution time given in the HD44780 datasheet
+ *    (37 us, or 1.52 ms for Clear Display) instead of waiting 1 ms per nibble.
+ *
+ * When EDUBASE_LCD_BUSY_FLAG_MODE is enabled, the interrupt polls the busy flag every 5 us
+ * instead, so the flush adapts to the actual execution time of the controller.
+ *
+ * Timer 1A runs in one-shot mode and is only started while there are dirty cells.
+ *
+ * The power-on initialization sequence of the LCD (about 60 ms, mostly waiting) is sent
+ * by the same interrupt before the first cell, so the rest of the system starts while
+ * the LCD is still powering up. The framebuffer can be written right away; the cells
+ * are sent once the sequence has completed.
+ *
+ * @note Once the framebuffer is initialized, the LCD must only be written through
+ * this driver. The EduBase_LCD functions would bypass the shadow copy, and
+ * EduBase_LCD_Init must not be called since this driver initializes the LCD.
+ *
+ * @note The execution times are converted to Timer 1A counts with the current system clock
+ * (see Clock.h) each time the timer is started.
+ *
+ * @note For more information regarding the LCD, refer to the HD44780 LCD Controller Datasheet.
+ * Link: https://www.sparkfun.com/datasheets/LCD/HD44780.pdf
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef LCD_FRAMEBUFFER_H
+#define LCD_FRAMEBUFFER_H
+
+#include "TM4C123GH6PM.h"
+#include "LCD_Format.h"
+
+// Dimensions of the EduBase Board LCD
+#define LCD_FRAMEBUFFER_COLUMNS	16
+#define LCD_FRAMEBUFFER_ROWS	2
+
+/**
+ * @brief Initializes the shadow framebuffer and the Timer 1A flush interrupt, and starts
+ * the initialization sequence of the LCD in the background.
+ *
+ * The function returns immediately. The LCD pins are configured here, and the sequence
+ * ends with a Clear Display command, so the shadow copy starts out blank. The priority
+ * level of the Timer 1A interrupt is set to 3.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LCD_Framebuffer_Init(void);
+
+/**
+ * @brief Fills the framebuffer with spaces.
+ *
+ * Only the cells that are not already blank are sent to the LCD, which is
+ * faster than the Clear Display command.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LCD_Framebuffer_Clear(void);
+
+/**
+ * @brief Writes a character to the framebuffer.
+ *
+ * @param col The column of the character (0 to 15).
+ *
+ * @param row The row of the character (0 or 1).
+ *
+ * @param character The character to write.
+ *
+ * @return None
+ */
+void LCD_Framebuffer_Write_Char(uint8_t col, uint8_t row, char character);
+
+/**
+ * @brief Writes a string to the framebuffer.
+ *
+ * The string is clipped at the end of the row.
+ *
+ * @param col The column of the first character (0 to 15).
+ *
+ * @param row The row of the string (0 or 1).
+ *
+ * @param string A pointer to the null-terminated string.
+ *
+ * @return uint8_t The column that follows the last character written.
+ */
+uint8_t LCD_Framebuffer_Write_String(uint8_t col, uint8_t row, const char *string);
+
+/**
+ * @brief Replaces a whole row of the framebuffer with a string.
+ *
+ * The rest of the row after the string is filled with spaces.
+ *
+ * @param row The row to write (0 or 1).
+ *
+ * @param string A pointer to the null-terminated string.
+ *
+ * @return None
+ */
+void LCD_Framebuffer_Write_Line(uint8_t row, const char *string);
+
+/**
+ * @brief Writes a signed decimal integer to the framebuffer.
+ *
+ * The number is clipped at the end of the row.
+ *
+ * @param col The column of the first digit or sign (0 to 15).
+ *
+ * @param row The row of the number (0 or 1).
+ *
+ * @param value The value to write.
+ *
+ * @return uint8_t The column that follows the last character written.
+ */
+uint8_t LCD_Framebuffer_Write_Integer(uint8_t col, uint8_t row, int32_t value);
+
+/**
+ * @brief Writes a signed decimal integer right-aligned in a field of the framebuffer.
+ *
+ * The field is filled with the pad character in front of the number (see LCD_Format_Integer),
+ * so a value that changes length does not leave stale digits behind. The text is clipped at
+ * the end of the row.
+ *
+ * @param col The column of the field (0 to 15).
+ *
+ * @param row The row of the field (0 or 1).
+ *
+ * @param value The value to write.
+ *
+ * @param width The width of the field.
+ *
+ * @param pad The pad character (usually ' ' or '0').
+ *
+ * @return uint8_t The column that follows the last character written.
+ */
+uint8_t LCD_Framebuffer_Write_Padded(uint8_t col, uint8_t row, int32_t value, uint8_t width, char pad);
+
+/**
+ * @brief Writes a distance with its unit to the framebuffer, such as "123.4 cm".
+ *
+ * The text is clipped at the end of the row.
+ *
+ * @param col The column of the first digit (0 to 15).
+ *
+ * @param row The row of the distance (0 or 1).
+ *
+ * @param distance_mm The distance in millimeters.
+ *
+ * @param unit The unit of the text (see LCD_Format_Units).
+ *
+ * @return uint8_t The column that follows the last character written.
+ */
+uint8_t LCD_Framebuffer_Write_Distance(uint8_t col, uint8_t row, uint16_t distance_mm, uint8_t unit);
+
+/**
+ * @brief Writes a time of day to the framebuffer as "HH:MM:SS".
+ *
+ * The text is clipped at the end of the row.
+ *
+ * @param col The column of the first digit (0 to 15).
+ *
+ * @param row The row of the time (0 or 1).
+ *
+ * @param seconds The number of seconds since midnight.
+ *
+ * @return uint8_t The column that follows the last character written.
+ */
+uint8_t LCD_Framebuffer_Write_Time(uint8_t col, uint8_t row, uint32_t seconds);
+
+/**
+ * @brief Sends the Clear Display command and rewrites every non-blank cell.
+ *
+ * This function is used to recover the LCD contents when they may no longer
+ * match the shadow copy (for example, after the LCD was written directly).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LCD_Framebuffer_Invalidate(void);
+
+/**
+ * @brief Indicates whether the initialization sequence of the LCD has completed.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the LCD is initialized. Otherwise, it returns 0.
+ */
+uint8_t LCD_Framebuffer_Is_Ready(void);
+
+/**
+ * @brief Indicates whether every change has been sent to the LCD.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if no cell is waiting to be sent. Otherwise, it returns 0.
+ */
+uint8_t LCD_Framebuffer_Is_Idle(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for Timer 1A.
+ *
+ * This function sends the next initialization command, command, or dirty cell to the LCD and restarts
+ * Timer 1A with the execution time of the byte that was sent.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void TIMER1A_Handler(void);
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file LED_Pattern.c
+ *
+ * @brief Source code for the LED pattern engine.
+ *
+ * The pattern state is shared with the Timer 0A interrupt, so it is only replaced
+ * with interrupts disabled.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "TM4C123GH6PM.h"
+#include "LED_Pattern.h"
+#include "GPIO.h"
+
+// Pattern state, shared with the Timer 0A interrupt
+static const LED_Step * volatile pattern_steps = 0;
+static volatile uint8_t pattern_step_count = 0;
+static volatile uint8_t pattern_repeat_count = 0;
+static volatile uint8_t pattern_playing = 0;
+static volatile uint8_t pattern_index = 0;
+static volatile uint16_t step_remaining_ms = 0;
+
+// Brightness of the RGB LED at the start of the current step and right now, and its color
+static uint8_t step_start_brightness = 0;
+static volatile uint8_t current_brightness = 0;
+static volatile uint8_t current_color = LED_COLOR_OFF;
+
+// Steps of the status code shown by LED_Pattern_Show_Code (one on and one off step per blink)
+static LED_Step code_steps[LED_PATTERN_MAX_CODE * 2];
+
+static void LED_Pattern_Output(uint8_t leds, uint8_t color, uint8_t brightness)
+{
+    current_brightness = brightness;
+    current_color = color;
+    EduBase_LEDs_Output(leds);
+    RGB_LED_PWM_Output(color, brightness);
+}
+
+static void LED_Pattern_Start_Step(uint8_t index)
+{
+    const LED_Step *step = &pattern_steps[index];
+
+    pattern_index = index;
+    step_remaining_ms = (step->duration_ms > 0) ? step->duration_ms : 1;
+    step_start_brightness = current_brightness;
+
+    // A ramp step starts from the brightness reached by the previous step
+    LED_Pattern_Output(step->leds, step->color, (step->flags & LED_STEP_RAMP) ? current_brightness : step->brightness);
+}
+
+// Must be called with interrupts disabled
+static void LED_Pattern_Start(const LED_Step *steps, uint8_t step_count, uint8_t repeat_count)
+{
+    pattern_steps = steps;
+    pattern_step_count = step_count;
+    pattern_repeat_count = repeat_count;
+    pattern_playing = 1;
+    LED_Pattern_Start_Step(0);
+}
+
+void LED_Pattern_Init(void)
+{
+    pattern_playing = 0;
+    current_brightness = 0;
+
+    RGB_LED_PWM_Init();
+    LED_Pattern_Output(0x00, LED_COLOR_OFF, 0);
+}
+
+void LED_Pattern_Play(const LED_Step *steps, uint8_t step_count, uint8_t repeat_count)
+{
+    if ((steps == 0) || (step_count == 0))
+    {
+        LED_Pattern_Stop();
+        return;
+    }
+
+    // Prevent the engine from running while the pattern is replaced
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    LED_Pattern_Start(steps, step_count, repeat_count);
+
+    __set_PRIMASK(primask);
+}
+
+void LED_Pattern_Show_Code(uint8_t color, uint8_t code)
+{
+    if (code == 0)
+    {
+        LED_Pattern_Stop();
+        return;
+    }
+
+    if (code > LED_PATTERN_MAX_CODE)
+    {
+        code = LED_PATTERN_MAX_CODE;
+    }
+
+    // The steps may be in use by the engine, so they are rewritten with interrupts disabled
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t blink = 0; blink < code; blink++)
+    {
+        LED_Step *on_step = &code_steps[blink * 2];
+        LED_Step *off_step = &code_steps[(blink * 2) + 1];
+
+        on_step->leds = code;
+        on_step->color = color;
+        on_step->brightness = 255;
+        on_step->flags = 0;
+        on_step->duration_ms = LED_PATTERN_CODE_ON_MS;
+
+        off_step->leds = code;
+        off_step->color = LED_COLOR_OFF;
+        off_step->brightness = 0;
+        off_step->flags = 0;
+        off_step->duration_ms = ((blink + 1) < code) ? LED_PATTERN_CODE_OFF_MS : LED_PATTERN_CODE_PAUSE_MS;
+    }
+
+    LED_Pattern_Start(code_steps, code * 2, 0);
+
+    __set_PRIMASK(primask);
+}
+
+void LED_Pattern_Stop(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    pattern_playing = 0;
+    LED_Pattern_Output(0x00, LED_COLOR_OFF, 0);
+
+    __set_PRIMASK(primask);
+}
+
+uint8_t LED_Pattern_Is_Playing(void)
+{
+    return pattern_playing;
+}
+
+uint8_t LED_Pattern_Is_RGB_Lit(void)
+{
+    return ((current_color != LED_COLOR_OFF) && (current_brightness > 0)) ? 1 : 0;
+}
+
+uint32_t LED_Pattern_Get_Idle_Ticks(void)
+{
+    if (!pattern_playing)
+    {
+        return 0xFFFFFFFF;
+    }
+
+    const LED_Step *step = &pattern_steps[pattern_index];
+    uint32_t idle_ticks = step_remaining_ms;
+
+    // A ramp changes the brightness by one level every duration / |delta| ms
+    if (step->flags & LED_STEP_RAMP)
+    {
+        int32_t delta = (int32_t)step->brightness - (int32_t)step_start_brightness;
+        uint32_t level_ms = (delta != 0) ? (step->duration_ms / (uint32_t)((delta > 0) ? delta : -delta)) : idle_ticks;
+
+        if (level_ms < idle_ticks)
+        {
+            idle_ticks = level_ms;
+        }
+    }
+
+    return (idle_ticks > 0) ? idle_ticks : 1;
+}
+
+void LED_Pattern_Tick(void)
+{
+    if (!pattern_playing)
+    {
+        return;
+    }
+
+    const LED_Step *step = &pattern_steps[pattern_index];
+
+    if (step->flags & LED_STEP_RAMP)
+    {
+        // Move the brightness towards the target of the step in proportion to the elapsed time
+        uint16_t duration_ms = (step->duration_ms > 0) ? step->duration_ms : 1;
+        int32_t elapsed_ms = duration_ms - step_remaining_ms + 1;
+        int32_t delta = (int32_t)step->brightness - (int32_t)step_start_brightness;
+
+        current_brightness = (uint8_t)(step_start_brightness + ((delta * elapsed_ms) / duration_ms));
+        RGB_LED_PWM_Output(step->color, current_brightness);
+    }
+
+    if (step_remaining_ms > 1)
+    {
+        step_remaining_ms = step_remaining_ms - 1;
+        return;
+    }
+
+    // Move to the next step, or to the start of the pattern for the next repetition
+    uint8_t next_index = pattern_index + 1;
+
+    if (next_index >= pattern_step_count)
+    {
+        if (pattern_repeat_count == 1)
+        {
+            pattern_playing = 0;
+            LED_Pattern_Output(0x00, LED_COLOR_OFF, 0);
+            return;
+        }
+
+        if (pattern_repeat_count > 1)
+        {
+            pattern_repeat_count = pattern_repeat_count - 1;
+        }
+
+        next_index = 0;
+    }
+
+    LED_Pattern_Start_Step(next_index);
+}
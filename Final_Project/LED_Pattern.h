@@ -0,0 +1,151 @@
+/**
+ * @file LED_Pattern.h
+ *
+ * @brief Header file for the LED pattern engine.
+ *
+ * The engine plays patterns on the EduBase Board LEDs (LED0 - LED3) and on the LaunchPad
+ * RGB LED in the background. A pattern is a table of steps. Each step sets the EduBase LEDs
+ * and the color and brightness of the RGB LED for a duration. A ramp step changes the
+ * brightness linearly from the previous step to its own, so two ramp steps make one breath
+ * of the RGB LED. Blink and chase patterns are tables of plain steps.
+ *
+ * The RGB LED is driven by PWM Module 1, so its brightness is set in hardware. The engine is
+ * advanced by LED_Pattern_Tick, which must be called every 1 ms from the Timer 0A interrupt,
+ * so a pattern takes no time from the tasks while it plays.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <stdint.h>
+
+// Colors of the RGB LED, with the values of RGB_LED_Output (PF1 - PF3)
+#define LED_COLOR_OFF               0x00
+#define LED_COLOR_RED               0x02
+#define LED_COLOR_BLUE              0x04
+#define LED_COLOR_GREEN             0x08
+#define LED_COLOR_YELLOW            (LED_COLOR_RED | LED_COLOR_GREEN)
+
+// Step flags
+#define LED_STEP_RAMP               0x01    // Ramp the brightness from the previous step over the duration
+
+// Highest status code shown by LED_Pattern_Show_Code
+#define LED_PATTERN_MAX_CODE        8
+
+// Timing of LED_Pattern_Show_Code
+#define LED_PATTERN_CODE_ON_MS      200
+#define LED_PATTERN_CODE_OFF_MS     300
+#define LED_PATTERN_CODE_PAUSE_MS   1500
+
+/**
+ * @brief One step of an LED pattern.
+ */
+typedef struct
+{
+    uint8_t leds;           // EduBase LEDs that are on (Bit 0 = LED0 to Bit 3 = LED3)
+    uint8_t color;          // Color of the RGB LED (LED_COLOR_*)
+    uint8_t brightness;     // Brightness of the RGB LED (0 to 255), reached at the end of a ramp step
+    uint8_t flags;          // LED_STEP_* flags
+    uint16_t duration_ms;   // Duration of the step in milliseconds (at least 1)
+} LED_Step;
+
+/**
+ * @brief Initializes the LED pattern engine.
+ *
+ * Configures the RGB LED for PWM brightness control. The EduBase LEDs must already be
+ * initialized with EduBase_LEDs_Init. Both are off after initialization.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Pattern_Init(void);
+
+/**
+ * @brief Starts playing a pattern in the background.
+ *
+ * The function returns immediately and the first step is shown right away. A pattern that
+ * is already playing is replaced. The steps are read while the pattern plays, so the array
+ * must remain valid (for example, const).
+ *
+ * @param steps A pointer to the array of steps.
+ *
+ * @param step_count The number of steps in the array.
+ *
+ * @param repeat_count The number of times the pattern is played, or 0 to repeat it until it is stopped.
+ *
+ * @return None
+ */
+void LED_Pattern_Play(const LED_Step *steps, uint8_t step_count, uint8_t repeat_count);
+
+/**
+ * @brief Repeats a status code until another pattern is played or the engine is stopped.
+ *
+ * The RGB LED blinks code times in the given color, followed by a pause, and the EduBase
+ * LEDs show the code in binary. Codes above LED_PATTERN_MAX_CODE are shown as LED_PATTERN_MAX_CODE.
+ *
+ * @param color The color of the RGB LED (LED_COLOR_*).
+ *
+ * @param code The status code, from 1 to LED_PATTERN_MAX_CODE.
+ *
+ * @return None
+ */
+void LED_Pattern_Show_Code(uint8_t color, uint8_t code);
+
+/**
+ * @brief Stops the current pattern and turns off the EduBase LEDs and the RGB LED.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Pattern_Stop(void);
+
+/**
+ * @brief Indicates whether a pattern is playing.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if a pattern is playing. Otherwise, it returns 0.
+ */
+uint8_t LED_Pattern_Is_Playing(void);
+
+/**
+ * @brief Indicates whether the RGB LED is lit.
+ *
+ * PWM Module 1 only has to be clocked while the RGB LED is lit. The EduBase LEDs are
+ * driven by GPIO outputs, which keep their level in every power mode.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the RGB LED is lit. Otherwise, it returns 0.
+ */
+uint8_t LED_Pattern_Is_RGB_Lit(void);
+
+/**
+ * @brief Returns the number of ticks until the output of the pattern changes.
+ *
+ * The ticks before that only count down the current step, so they can be delivered
+ * late and together (see Power.h).
+ *
+ * @param None
+ *
+ * @return uint32_t The number of calls of LED_Pattern_Tick before the output changes,
+ *                  or 0xFFFFFFFF if no pattern is playing.
+ */
+uint32_t LED_Pattern_Get_Idle_Ticks(void);
+
+/**
+ * @brief Advances the LED pattern engine by 1 ms.
+ *
+ * This function must be called every 1 ms from the Timer 0A interrupt service routine.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Pattern_Tick(void);
+
+#endif
@@ -0,0 +1,252 @@
+/**
+ * @file Pin_Map.h
+ *
+ * @brief Pin map of the Home Security System.
+ *
+ * Every pin used by the drivers is assigned in this file. A pin is a tuple of its port letter,
+ * its pin mask, and its PCTL function (0 for a GPIO pin):
+ *
+ *     #define PIN_LCD_ENABLE      C, 0x40, 0      // PC6
+ *
+ * The accessor macros below resolve the port, the clock gate bit, the mask, and the PCTL
+ * fields of a pin at compile time, so the drivers do not contain port addresses or masks.
+ * Each tuple can be overridden with a compiler define to retarget a board variant.
+ *
+ * PIN_DATA selects the address-masked alias of the DATA register: only the pins of the mask
+ * are read or written, so a pin update is a single store without a read-modify-write.
+ * PIN_SET, PIN_CLEAR, and PIN_WRITE are built on it. They never touch the other pins of the
+ * port, so drivers that share a port (such as the LCD enable and the buzzer on Port C) can
+ * update their pins from different interrupts without a critical section.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef PIN_MAP_H
+#define PIN_MAP_H
+
+#include <stdint.h>
+#include "TM4C123GH6PM.h"
+
+// LaunchPad user LED (RGB): PF1 (red), PF2 (blue), PF3 (green)
+#ifndef PIN_RGB_LED
+#define PIN_RGB_LED             F, 0x0E, 0
+#endif
+
+// The same pins with the M1PWM5 - M1PWM7 function, used by the LED pattern engine
+#ifndef PIN_RGB_LED_PWM
+#define PIN_RGB_LED_PWM         F, 0x0E, 5
+#endif
+
+// EduBase Board LEDs (LED0 - LED3): PB0 - PB3
+#ifndef PIN_EDUBASE_LEDS
+#define PIN_EDUBASE_LEDS        B, 0x0F, 0
+#endif
+
+// EduBase Board push buttons (SW2 - SW5): PD0 - PD3
+#ifndef PIN_EDUBASE_BUTTONS
+#define PIN_EDUBASE_BUTTONS     D, 0x0F, 0
+#endif
+
+// EduBase Board LCD: data D4 - D7 (PA2 - PA5), enable (PC6), register select (PE0)
+#ifndef PIN_LCD_DATA
+#define PIN_LCD_DATA            A, 0x3C, 0
+#endif
+
+// Pin number of D4, the data pins are consecutive
+#ifndef PIN_LCD_DATA_SHIFT
+#define PIN_LCD_DATA_SHIFT      2
+#endif
+
+#ifndef PIN_LCD_ENABLE
+#define PIN_LCD_ENABLE          C, 0x40, 0
+#endif
+
+#ifndef PIN_LCD_RS
+#define PIN_LCD_RS              E, 0x01, 0
+#endif
+
+// LCD read / write (PE1), only wired when EDUBASE_LCD_BUSY_FLAG_MODE is 1
+#ifndef PIN_LCD_RW
+#define PIN_LCD_RW              E, 0x02, 0
+#endif
+
+// Buzzer: PC4 (M0PWM6)
+#ifndef PIN_BUZZER
+#define PIN_BUZZER              C, 0x10, 4
+#endif
+
+// UART0 to the USB debug port: PA0 (U0RX) and PA1 (U0TX)
+#ifndef PIN_UART0
+#define PIN_UART0               A, 0x03, 1
+#endif
+
+// UART1 to the US-100 in serial mode: PC5 and PC7
+#ifndef PIN_UART1
+#define PIN_UART1               C, 0xA0, 2
+#endif
+
+// US-100 sensors in trigger/echo mode. The echo pins are wide timer capture inputs (function 7).
+// Channel 0 is wired to the UART1 pins, which it uses while the echo backend is selected.
+#ifndef PIN_US100_TRIGGER_0
+#define PIN_US100_TRIGGER_0     C, 0x80, 0
+#endif
+
+#ifndef PIN_US100_ECHO_0
+#define PIN_US100_ECHO_0        C, 0x20, 7      // WT0CCP1
+#endif
+
+#ifndef PIN_US100_TRIGGER_1
+#define PIN_US100_TRIGGER_1     E, 0x04, 0
+#endif
+
+#ifndef PIN_US100_ECHO_1
+#define PIN_US100_ECHO_1        D, 0x40, 7      // WT5CCP0
+#endif
+
+#ifndef PIN_US100_TRIGGER_2
+#define PIN_US100_TRIGGER_2     E, 0x08, 0
+#endif
+
+#ifndef PIN_US100_ECHO_2
+#define PIN_US100_ECHO_2        D, 0x80, 7      // WT5CCP1
+#endif
+
+// PIR motion detector output (active high), on Port E for the GPIOE_Handler edge interrupt: PE4
+#ifndef PIN_MOTION_0
+#define PIN_MOTION_0            E, 0x10, 0
+#endif
+
+// Door reed switch to ground (normally closed, reads high when the door opens): PE5
+#ifndef PIN_CONTACT_0
+#define PIN_CONTACT_0           E, 0x20, 0
+#endif
+
+// Pins that are owned by a single driver at all times. The pins of a port must not overlap.
+#define PIN_MAP_TABLE(X, arg) \
+    X(PIN_RGB_LED, arg) \
+    X(PIN_EDUBASE_LEDS, arg) \
+    X(PIN_EDUBASE_BUTTONS, arg) \
+    X(PIN_LCD_DATA, arg) \
+    X(PIN_LCD_ENABLE, arg) \
+    X(PIN_LCD_RS, arg) \
+    X(PIN_LCD_RW, arg) \
+    X(PIN_BUZZER, arg) \
+    X(PIN_UART0, arg) \
+    X(PIN_UART1, arg) \
+    X(PIN_US100_TRIGGER_1, arg) \
+    X(PIN_US100_ECHO_1, arg) \
+    X(PIN_US100_TRIGGER_2, arg) \
+    X(PIN_US100_ECHO_2, arg) \
+    X(PIN_MOTION_0, arg) \
+    X(PIN_CONTACT_0, arg)
+
+// Gate bits of the GPIO ports in the RCGCGPIO register
+#define PIN_CLOCK_A             0x01
+#define PIN_CLOCK_B             0x02
+#define PIN_CLOCK_C             0x04
+#define PIN_CLOCK_D             0x08
+#define PIN_CLOCK_E             0x10
+#define PIN_CLOCK_F             0x20
+
+// The accessors take a pin tuple, either by name or already expanded (from PIN_MAP_TABLE)
+#define PIN_PORT(...)           PIN_PORT_(__VA_ARGS__)
+#define PIN_CLOCK(...)          PIN_CLOCK_(__VA_ARGS__)
+#define PIN_MASK(...)           PIN_MASK_(__VA_ARGS__)
+#define PIN_FUNCTION(...)       PIN_FUNCTION_(__VA_ARGS__)
+#define PIN_DATA(...)           PIN_DATA_(__VA_ARGS__)
+
+#define PIN_PORT_(port, mask, function)         (GPIO##port)
+#define PIN_CLOCK_(port, mask, function)        (PIN_CLOCK_##port)
+#define PIN_MASK_(port, mask, function)         (mask)
+#define PIN_FUNCTION_(port, mask, function)     (function)
+
+// The masked alias of the DATA register is at the port address plus the mask shifted left by 2
+#define PIN_DATA_(port, mask, function) \
+    (*((volatile uint32_t *)((uintptr_t)(GPIO##port) + ((uint32_t)(mask) << 2))))
+
+/**
+ * @brief Drives every pin of a tuple high with a single store.
+ */
+#define PIN_SET(...)            (PIN_DATA(__VA_ARGS__) = PIN_MASK(__VA_ARGS__))
+
+/**
+ * @brief Drives every pin of a tuple low with a single store.
+ */
+#define PIN_CLEAR(...)          (PIN_DATA(__VA_ARGS__) = 0)
+
+/**
+ * @brief Drives the pins of a tuple to the matching bits of value with a single store.
+ *
+ * The bits of value outside of the mask of the tuple are ignored by the hardware.
+ */
+#define PIN_WRITE(pin, value)   (PIN_DATA(pin) = (value))
+
+/**
+ * @brief Reads the pins of a tuple, the other bits read as zero.
+ */
+#define PIN_READ(...)           ((uint8_t)PIN_DATA(__VA_ARGS__))
+
+// One bit in every 4-bit PCTL field of a pin of the mask
+#define PIN_MAP_PCTL_FIELDS(mask) \
+    ((((mask) & 0x01) ? 0x00000001UL : 0) | (((mask) & 0x02) ? 0x00000010UL : 0) | \
+     (((mask) & 0x04) ? 0x00000100UL : 0) | (((mask) & 0x08) ? 0x00001000UL : 0) | \
+     (((mask) & 0x10) ? 0x00010000UL : 0) | (((mask) & 0x20) ? 0x00100000UL : 0) | \
+     (((mask) & 0x40) ? 0x01000000UL : 0) | (((mask) & 0x80) ? 0x10000000UL : 0))
+
+#define PIN_PCTL_MASK(...)      (PIN_MAP_PCTL_FIELDS(PIN_MASK(__VA_ARGS__)) * 0xFUL)
+#define PIN_PCTL_VALUE(...)     (PIN_MAP_PCTL_FIELDS(PIN_MASK(__VA_ARGS__)) * PIN_FUNCTION(__VA_ARGS__))
+
+/**
+ * @brief Configures the pins of a tuple as GPIO outputs and drives them low.
+ */
+#define PIN_OUTPUT_INIT(...) \
+    do \
+    { \
+        SYSCTL->RCGCGPIO |= PIN_CLOCK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->DIR |= PIN_MASK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->AFSEL &= ~PIN_MASK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->DEN |= PIN_MASK(__VA_ARGS__); \
+        PIN_CLEAR(__VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Configures the pins of a tuple as GPIO inputs.
+ */
+#define PIN_INPUT_INIT(...) \
+    do \
+    { \
+        SYSCTL->RCGCGPIO |= PIN_CLOCK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->DIR &= ~PIN_MASK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->AFSEL &= ~PIN_MASK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->DEN |= PIN_MASK(__VA_ARGS__); \
+    } while (0)
+
+/**
+ * @brief Selects the PCTL function of a tuple on its pins, leaving the other pins of the port unchanged.
+ */
+#define PIN_ALTERNATE_INIT(...) \
+    do \
+    { \
+        SYSCTL->RCGCGPIO |= PIN_CLOCK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->AFSEL |= PIN_MASK(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->PCTL = (PIN_PORT(__VA_ARGS__)->PCTL & ~PIN_PCTL_MASK(__VA_ARGS__)) \
+            | PIN_PCTL_VALUE(__VA_ARGS__); \
+        PIN_PORT(__VA_ARGS__)->DEN |= PIN_MASK(__VA_ARGS__); \
+    } while (0)
+
+// Pins of a tuple on the port with the given gate bit, summed and combined
+#define PIN_MAP_SUM_ON_PORT(pin, clock)     + ((PIN_CLOCK(pin) == (clock)) ? PIN_MASK(pin) : 0)
+#define PIN_MAP_OR_ON_PORT(pin, clock)      | ((PIN_CLOCK(pin) == (clock)) ? PIN_MASK(pin) : 0)
+
+// The sum of the masks of a port only equals their combination when no pin is assigned twice
+#define PIN_MAP_PORT_IS_FREE(clock) \
+    ((0 PIN_MAP_TABLE(PIN_MAP_SUM_ON_PORT, clock)) == (0 PIN_MAP_TABLE(PIN_MAP_OR_ON_PORT, clock)))
+
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_A), "A pin of Port A is assigned twice in the pin map");
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_B), "A pin of Port B is assigned twice in the pin map");
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_C), "A pin of Port C is assigned twice in the pin map");
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_D), "A pin of Port D is assigned twice in the pin map");
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_E), "A pin of Port E is assigned twice in the pin map");
+_Static_assert(PIN_MAP_PORT_IS_FREE(PIN_CLOCK_F), "A pin of Port F is assigned twice in the pin map");
+
+#endif
@@ -0,0 +1,344 @@
+/**
+ * @file Power.c
+ *
+ * @brief Source code for the Power manager.
+ *
+ * This file contains the function definitions for the idle and power manager.
+ *
+ * When the Automatic Clock Gating (ACG) bit of the RCC register is set, the SCGCx registers
+ * select the peripherals clocked in sleep mode and the DCGCx registers select the
+ * peripherals clocked in deep-sleep mode. Otherwise, the RCGCx registers are used in every mode.
+ *
+ * @note Timer 0A stays clocked in deep-sleep mode, where it runs from the deep-sleep clock
+ * (PIOSC / 16 = 1 MHz). Its prescaler is set for that clock just before WFI and set back
+ * right after the wake-up, so only the few cycles in between are counted at the wrong rate.
+ * The timebase counts PIOSC / 4, and the PIOSC is the deep-sleep clock source, so the time
+ * spent in deep-sleep mode is measured like the time spent in sleep mode.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Power.h"
+#include "Timebase.h"
+#include "Scheduler.h"
+#include "Buzzer.h"
+#include "LED_Pattern.h"
+#include "LCD_Framebuffer.h"
+#include "Ranging.h"
+#include "UART1.h"
+#include "UART0.h"
+#include "Keypad.h"
+#include "Supervisor.h"
+#include "System_State.h"
+#include "Clock.h"
+#include "Timer_0A_Interrupt.h"
+
+// Automatic Clock Gating (ACG, Bit 27) in the RCC register
+#define SYSCTL_RCC_ACG              0x08000000
+
+// SLEEPDEEP bit (Bit 2) in the System Control (SCR) register
+#define SCB_SCR_SLEEPDEEP           0x04
+
+// Deep-sleep clock: PIOSC (DSOSCSRC = 0x1, Bits 6 to 4) divided by 16 (DSDIVORIDE = 0xF, Bits 28 to 23)
+#define POWER_DEEP_SLEEP_CLOCK      ((0x0F << 23) | (0x1 << 4))
+#define POWER_DEEP_SLEEP_CLOCK_HZ   1000000
+
+// C_DEBUGEN bit (Bit 0) in the Debug Halting Control and Status (DHCSR) register
+#define COREDEBUG_DHCSR_C_DEBUGEN   0x01
+
+// Peripheral clocks that are kept in sleep mode
+static uint32_t sleep_wd_clocks = 0;
+static uint32_t sleep_gpio_clocks = 0;
+static uint32_t sleep_timer_clocks = 0;
+static uint32_t sleep_wtimer_clocks = 0;
+static uint32_t sleep_uart_clocks = 0;
+static uint32_t sleep_pwm_clocks = 0;
+static uint32_t sleep_dma_clocks = 0;
+static uint32_t sleep_eeprom_clocks = 0;
+
+static uint8_t deep_sleep_vetoes = 0;
+
+// Time spent in each mode, and the charge used since Power_Init (in microampere-microseconds)
+// until the last wake-up
+static uint64_t mode_time_us[POWER_MODE_COUNT];
+static uint64_t power_start_time_us = 0;
+static uint64_t last_wakeup_time_us = 0;
+static uint64_t charge_ua_us = 0;
+static uint32_t wakeup_count = 0;
+
+// Profile that was selected before the system was armed
+static uint8_t unarmed_profile = CLOCK_DEFAULT_PROFILE;
+
+static const uint32_t run_current_ua[CLOCK_PROFILE_COUNT] =
+{
+    [CLOCK_PROFILE_PERFORMANCE] = POWER_RUN_80MHZ_CURRENT_UA,
+    [CLOCK_PROFILE_BALANCED]    = POWER_RUN_50MHZ_CURRENT_UA,
+    [CLOCK_PROFILE_POWER_SAVE]  = POWER_RUN_16MHZ_CURRENT_UA
+};
+
+static const uint32_t sleep_current_ua[CLOCK_PROFILE_COUNT] =
+{
+    [CLOCK_PROFILE_PERFORMANCE] = POWER_SLEEP_80MHZ_CURRENT_UA,
+    [CLOCK_PROFILE_BALANCED]    = POWER_SLEEP_50MHZ_CURRENT_UA,
+    [CLOCK_PROFILE_POWER_SAVE]  = POWER_SLEEP_16MHZ_CURRENT_UA
+};
+
+static uint32_t Power_Get_Mode_Current(uint8_t mode)
+{
+    switch (mode)
+    {
+        case POWER_MODE_RUN:    return run_current_ua[Clock_Get_Profile()];
+        case POWER_MODE_SLEEP:  return sleep_current_ua[Clock_Get_Profile()];
+        default:                return POWER_DEEP_SLEEP_CURRENT_UA;
+    }
+}
+
+// Number of ticks that can be delivered together at the end of the sleep
+static uint32_t Power_Get_Idle_Ticks(void)
+{
+    uint32_t idle_ticks = TIMER_0A_MAX_INTERVAL_MS;
+    uint32_t deadlines[3];
+
+    // The buzzer sequencer and the button debouncing act on every tick
+    if (Buzzer_Is_Playing() || !Keypad_Is_Idle())
+    {
+        return 1;
+    }
+
+    deadlines[0] = Scheduler_Get_Idle_Ticks();
+    deadlines[1] = Supervisor_Get_Idle_Ticks();
+    deadlines[2] = LED_Pattern_Get_Idle_Ticks();
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (deadlines[i] < idle_ticks)
+        {
+            idle_ticks = deadlines[i];
+        }
+    }
+
+    return idle_ticks;
+}
+
+// Selects the power-save profile while armed, and the previous profile again afterwards
+static void Power_State_Changed(uint8_t previous_state, uint8_t next_state)
+{
+    if (next_state == SYSTEM_STATE_ARMED)
+    {
+        unarmed_profile = Clock_Get_Profile();
+        Clock_Set_Profile(CLOCK_PROFILE_POWER_SAVE);
+    }
+    else if (previous_state == SYSTEM_STATE_ARMED)
+    {
+        Clock_Set_Profile(unarmed_profile);
+    }
+}
+
+static uint8_t Power_Deep_Sleep_Allowed(void)
+{
+    // Every peripheral except the GPIO ports and Timer 0A stops in deep-sleep mode, so the buzzer,
+    // the RGB LED, the LCD flush, a range measurement, the telemetry link, and the button debouncing
+    // must all be idle. The ranging engine may wait for its next trigger, since the tick keeps the
+    // scheduler timers running. A PLL has to lock again after every wake-up, so deadlines are only
+    // kept in deep-sleep mode with the power-save profile.
+    return (deep_sleep_vetoes == 0)
+        && ((Scheduler_Get_Active_Timer_Count() == 0) || (Clock_Get_Profile() == CLOCK_PROFILE_POWER_SAVE))
+        && !Buzzer_Is_Playing()
+        && !LED_Pattern_Is_RGB_Lit()
+        && LCD_Framebuffer_Is_Idle()
+        && !Ranging_Is_Measuring()
+        && (UART1_Available() == 0)
+        && UART0_Is_Transmit_Idle()
+        && Keypad_Is_Idle();
+}
+
+static void Power_Configure_Sleep_Clocks(void)
+{
+    SYSCTL->SCGCWD = sleep_wd_clocks;
+    SYSCTL->SCGCGPIO = sleep_gpio_clocks;
+    SYSCTL->SCGCUART = sleep_uart_clocks;
+    SYSCTL->SCGCWTIMER = sleep_wtimer_clocks;
+    SYSCTL->SCGCDMA = sleep_dma_clocks;
+    SYSCTL->SCGCEEPROM = sleep_eeprom_clocks;
+    
+    // Stop PWM Module 0 while the buzzer is silent and PWM Module 1 while the RGB LED is off
+    SYSCTL->SCGCPWM = sleep_pwm_clocks & ~(Buzzer_Is_Playing() ? 0x00 : 0x01) & ~(LED_Pattern_Is_RGB_Lit() ? 0x00 : 0x02);
+    
+    // Timer 1A only has to run while the LCD is being updated
+    SYSCTL->SCGCTIMER = LCD_Framebuffer_Is_Idle() ? (sleep_timer_clocks & ~0x02) : sleep_timer_clocks;
+}
+
+void Power_Init(void)
+{
+    for (int i = 0; i < POWER_MODE_COUNT; i++)
+    {
+        mode_time_us[i] = 0;
+    }
+    
+    wakeup_count = 0;
+    deep_sleep_vetoes = 0;
+    charge_ua_us = 0;
+    power_start_time_us = Timebase_Get_Time_us();
+    last_wakeup_time_us = power_start_time_us;
+    
+    Power_Update_Clock_Gating();
+    
+    // Only keep the GPIO ports and Timer 0A clocked in deep-sleep mode, so that the buttons
+    // and the tick can wake the processor
+    // The watchdog stops, and every wake-up of the tick lets the supervisor feed it again
+    SYSCTL->DCGCWD = 0;
+    SYSCTL->DCGCGPIO = sleep_gpio_clocks;
+    SYSCTL->DCGCTIMER = sleep_timer_clocks & 0x01;
+    SYSCTL->DCGCWTIMER = 0;
+    SYSCTL->DCGCUART = 0;
+    SYSCTL->DCGCPWM = 0;
+    SYSCTL->DCGCDMA = 0;
+    SYSCTL->DCGCEEPROM = 0;
+    
+    // Run from the PIOSC divided by 16 (1 MHz) in deep-sleep mode
+    SYSCTL->DSLPCLKCFG = POWER_DEEP_SLEEP_CLOCK;
+    
+    // Use the SCGCx and DCGCx registers in the sleep and deep-sleep modes
+    SYSCTL->RCC |= SYSCTL_RCC_ACG;
+    
+    // Sleep whenever the scheduler has nothing to do
+    Scheduler_Set_Idle_Task(&Power_Idle);
+
+    if (!System_State_Add_Observer(&Power_State_Changed))
+    {
+        Supervisor_Registration_Failed(TASK_NONE);
+    }
+
+    // The armed state may have been resumed before the observer is added
+    if (System_State_Get() == SYSTEM_STATE_ARMED)
+    {
+        Power_State_Changed(SYSTEM_STATE_DISARMED, SYSTEM_STATE_ARMED);
+    }
+}
+
+void Power_Update_Clock_Gating(void)
+{
+    sleep_wd_clocks = SYSCTL->RCGCWD;
+    sleep_gpio_clocks = SYSCTL->RCGCGPIO;
+    sleep_timer_clocks = SYSCTL->RCGCTIMER;
+    sleep_wtimer_clocks = SYSCTL->RCGCWTIMER;
+    sleep_uart_clocks = SYSCTL->RCGCUART;
+    sleep_pwm_clocks = SYSCTL->RCGCPWM;
+    sleep_dma_clocks = SYSCTL->RCGCDMA;
+    sleep_eeprom_clocks = SYSCTL->RCGCEEPROM;
+}
+
+void Power_Idle(void)
+{
+    // With interrupts disabled, an interrupt that becomes pending still ends WFI
+    // but is only handled after the re-check below, so no event is missed
+    __disable_irq();
+    
+    if (!Scheduler_Is_Idle())
+    {
+        __enable_irq();
+        return;
+    }
+    
+    uint8_t mode = POWER_MODE_SLEEP;
+    
+    if ((CoreDebug->DHCSR & COREDEBUG_DHCSR_C_DEBUGEN) == 0)
+    {
+        deep_sleep_vetoes &= ~POWER_VETO_DEBUG;
+    }
+    else
+    {
+        deep_sleep_vetoes |= POWER_VETO_DEBUG;
+    }
+    
+    if (Power_Deep_Sleep_Allowed())
+    {
+        mode = POWER_MODE_DEEP_SLEEP;
+        SCB->SCR |= SCB_SCR_SLEEPDEEP;
+    }
+    else
+    {
+        Power_Configure_Sleep_Clocks();
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP;
+    }
+    
+    // Skip the ticks in which nothing happens
+    uint32_t idle_ticks = Power_Get_Idle_Ticks();
+    
+    if (idle_ticks > 1)
+    {
+        Timer_0A_Interrupt_Set_Interval(idle_ticks);
+    }
+    
+    uint64_t sleep_start_us = Timebase_Get_Time_us();
+    
+    charge_ua_us += (sleep_start_us - last_wakeup_time_us) * Power_Get_Mode_Current(POWER_MODE_RUN);
+    
+    // Changing the interval executes a tick that was pending, which may give the scheduler work
+    if (Scheduler_Is_Idle())
+    {
+        // Keep the 1 MHz count of Timer 0A while the deep-sleep clock drives it
+        if (mode == POWER_MODE_DEEP_SLEEP)
+        {
+            Timer_0A_Interrupt_Set_Clock(POWER_DEEP_SLEEP_CLOCK_HZ);
+        }
+        
+        __DSB();
+        __WFI();
+        
+        if (mode == POWER_MODE_DEEP_SLEEP)
+        {
+            Timer_0A_Interrupt_Set_Clock(Clock_Get_Hz());
+        }
+    }
+    
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP;
+    
+    // Count the ticks that have elapsed and tick every 1 ms again until the next sleep
+    if (idle_ticks > 1)
+    {
+        Timer_0A_Interrupt_Set_Interval(1);
+    }
+    
+    last_wakeup_time_us = Timebase_Get_Time_us();
+    mode_time_us[mode] += last_wakeup_time_us - sleep_start_us;
+    charge_ua_us += (last_wakeup_time_us - sleep_start_us) * Power_Get_Mode_Current(mode);
+    wakeup_count++;
+    
+    // Handle the interrupt that woke up the processor
+    __enable_irq();
+}
+
+void Power_Set_Deep_Sleep_Veto(uint8_t source, uint8_t veto)
+{
+    if (veto)
+    {
+        deep_sleep_vetoes |= source;
+    }
+    else
+    {
+        deep_sleep_vetoes &= ~source;
+    }
+}
+
+void Power_Get_Report(Power_Report *report)
+{
+    uint64_t time_us = Timebase_Get_Time_us();
+    uint64_t total_us = time_us - power_start_time_us;
+    uint64_t idle_us = mode_time_us[POWER_MODE_SLEEP] + mode_time_us[POWER_MODE_DEEP_SLEEP];
+    
+    // The time since the last wake-up has been spent in run mode
+    uint64_t charge = charge_ua_us + ((time_us - last_wakeup_time_us) * Power_Get_Mode_Current(POWER_MODE_RUN));
+    
+    report->time_us[POWER_MODE_RUN] = (total_us > idle_us) ? (total_us - idle_us) : 0;
+    report->time_us[POWER_MODE_SLEEP] = mode_time_us[POWER_MODE_SLEEP];
+    report->time_us[POWER_MODE_DEEP_SLEEP] = mode_time_us[POWER_MODE_DEEP_SLEEP];
+    report->wakeup_count = wakeup_count;
+    
+    for (int i = 0; i < POWER_MODE_COUNT; i++)
+    {
+        report->current_ua[i] = Power_Get_Mode_Current(i);
+    }
+    
+    report->average_current_ua = (total_us > 0) ? (uint32_t)(charge / total_us) : Power_Get_Mode_Current(POWER_MODE_RUN);
+}
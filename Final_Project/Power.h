@@ -0,0 +1,144 @@
+/**
+ * @file Power.h
+ *
+ * @brief Header file for the Power manager.
+ *
+ * This file contains the function definitions for the idle and power manager of the
+ * Home Security System. The manager is registered as the idle task of the scheduler
+ * and puts the processor to sleep whenever no event is waiting to be dispatched:
+ * - Sleep mode gates the processor clock. The peripherals (including the watchdog) keep running, and any enabled
+ *   interrupt (Timer 0A tick, UART1, Wide Timer 0B, Timer 1A, GPIO buttons) wakes the processor.
+ *   The clocks of peripherals that are not needed while asleep are gated (for example,
+ *   PWM Module 0 when the buzzer is silent).
+ * - Deep-sleep mode also stops the PLL and the clocks of every peripheral except the GPIO
+ *   ports and Timer 0A, which then runs from the deep-sleep clock (PIOSC / 16). It is used
+ *   when nothing needs the other peripherals: no tone, no lit RGB LED, no LCD flush, no
+ *   range measurement, and no telemetry transmission. While the system is armed, the ranging
+ *   engine is in this state between two measurements (see CONFIG_PARAM_RANGE_PERIOD_MS),
+ *   so the processor stays in deep-sleep mode until the tick of the next trigger or a button press.
+ *
+ * The Timer 0A tick is tickless in both sleep modes: when the buzzer and the keypad are idle,
+ * the interval of Timer 0A is stretched up to the first deadline of the scheduler
+ * timers, the supervisor check, and the LED pattern (at most TIMER_0A_MAX_INTERVAL_MS),
+ * so the processor is not woken up every 1 ms. An earlier interrupt ends the interval,
+ * and the ticks that have elapsed are counted then.
+ *
+ * While the system is armed (SYSTEM_STATE_ARMED), only the sensors and the LED pattern
+ * run, so the power-save clock profile (16 MHz, PLL off) is selected, and the previous
+ * profile is selected again when the system leaves the armed state.
+ *
+ * The time spent in each mode is measured with the timebase, and an estimate of the
+ * average current is computed from the current budget of each mode and clock profile.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include "TM4C123GH6PM.h"
+
+// Estimated supply current of the TM4C123GH6PM in each mode and clock profile in microamperes
+// (typical values from the datasheet, excluding the EduBase board and the sensor). Sleep mode
+// keeps the clock source running: the PLL at 80 MHz and 50 MHz, and only the main oscillator at 16 MHz.
+#define POWER_RUN_80MHZ_CURRENT_UA    45000
+#define POWER_SLEEP_80MHZ_CURRENT_UA  17000
+#define POWER_RUN_50MHZ_CURRENT_UA    32000
+#define POWER_SLEEP_50MHZ_CURRENT_UA  12000
+#define POWER_RUN_16MHZ_CURRENT_UA    12000
+#define POWER_SLEEP_16MHZ_CURRENT_UA  5000
+#define POWER_DEEP_SLEEP_CURRENT_UA   1000
+
+/**
+ * @brief Power modes used by the power manager.
+ */
+enum Power_Modes
+{
+    POWER_MODE_RUN          = 0,
+    POWER_MODE_SLEEP        = 1,
+    POWER_MODE_DEEP_SLEEP   = 2,
+    POWER_MODE_COUNT
+};
+
+/**
+ * @brief Sources that can prevent deep-sleep mode.
+ *
+ * The manager also checks the buzzer, the RGB LED, the LCD flush, the ranging engine, UART1, and the keypad by itself.
+ */
+enum Power_Veto_Sources
+{
+    POWER_VETO_USER         = 0x01,     // Set with Power_Set_Deep_Sleep_Veto for debugging
+    POWER_VETO_DEBUG        = 0x02      // A debugger cannot stay connected in deep-sleep mode
+};
+
+/**
+ * @brief Current budget report.
+ */
+typedef struct
+{
+    uint64_t time_us[POWER_MODE_COUNT];     // Time spent in each mode since Power_Init
+    uint32_t current_ua[POWER_MODE_COUNT];  // Current budget of each mode at the current clock profile
+    uint32_t wakeup_count;                  // Number of times the processor was woken up
+    uint32_t average_current_ua;            // Time-weighted average of the current budgets of the modes and profiles used
+} Power_Report;
+
+/**
+ * @brief Initializes the power manager.
+ *
+ * This function must be called after every peripheral has been initialized.
+ * It enables the automatic clock gating (ACG) of the sleep and deep-sleep modes,
+ * registers Power_Idle as the idle task of the scheduler, and observes the state
+ * machine to select the clock profile of the armed state.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Init(void);
+
+/**
+ * @brief Records the peripherals that are enabled in run mode as the peripherals kept in sleep mode.
+ *
+ * This function must be called again after a peripheral is enabled at runtime.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Update_Clock_Gating(void);
+
+/**
+ * @brief Puts the processor to sleep until the next interrupt.
+ *
+ * Interrupts are disabled while the scheduler is checked, so an interrupt that
+ * posts an event just before the processor goes to sleep still wakes it up.
+ * The function returns immediately if the scheduler has work to do. In both sleep modes,
+ * the Timer 0A interval is stretched to the next deadline and set back to 1 ms on wake-up.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Power_Idle(void);
+
+/**
+ * @brief Sets or clears a veto against deep-sleep mode.
+ *
+ * @param source The source of the veto (see Power_Veto_Sources).
+ *
+ * @param veto 1 to prevent deep-sleep mode, or 0 to allow it.
+ *
+ * @return None
+ */
+void Power_Set_Deep_Sleep_Veto(uint8_t source, uint8_t veto);
+
+/**
+ * @brief Fills a current budget report.
+ *
+ * @param report A pointer to the report to fill.
+ *
+ * @return None
+ */
+void Power_Get_Report(Power_Report *report);
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file Profile.c
+ *
+ * @brief Source code for the Profile module.
+ *
+ * This file contains the function definitions for the cycle-accurate profiler of the
+ * Home Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Profile.h"
+#include "Timebase.h"
+#include "Clock.h"
+
+// TRCENA bit (Bit 24) in the Debug Exception and Monitor Control (DEMCR) register
+#define COREDEBUG_DEMCR_TRCENA      0x01000000
+
+// CYCCNTENA bit (Bit 0) in the DWT Control (CTRL) register
+#define DWT_CTRL_CYCCNTENA          0x01
+
+/**
+ * @brief Accumulated samples of one probe.
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t histogram[PROFILE_HISTOGRAM_BINS];
+} Profile_Entry;
+
+static Profile_Entry profile_table[PROFILE_PROBE_COUNT];
+
+// Start of the measurement of the CPU time
+static uint64_t profile_start_time_us = 0;
+
+static void Profile_Clear(void)
+{
+    for (uint8_t probe = 0; probe < PROFILE_PROBE_COUNT; probe++)
+    {
+        Profile_Entry *entry = &profile_table[probe];
+
+        entry->count = 0;
+        entry->min_cycles = 0xFFFFFFFF;
+        entry->max_cycles = 0;
+        entry->total_cycles = 0;
+
+        for (uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+        {
+            entry->histogram[bin] = 0;
+        }
+    }
+
+    profile_start_time_us = Timebase_Get_Time_us();
+}
+
+void Profile_Init(void)
+{
+#if PROFILE_ENABLE
+    // Enable the DWT unit, then clear and start its cycle counter
+    CoreDebug->DEMCR |= COREDEBUG_DEMCR_TRCENA;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+
+    Profile_Clear();
+}
+
+void Profile_Record(uint8_t probe, uint32_t cycles)
+{
+    Profile_Entry *entry = &profile_table[probe];
+    uint32_t bits;
+    uint32_t bin;
+
+    entry->count++;
+    entry->total_cycles += cycles;
+
+    if (cycles < entry->min_cycles)
+    {
+        entry->min_cycles = cycles;
+    }
+
+    if (cycles > entry->max_cycles)
+    {
+        entry->max_cycles = cycles;
+    }
+
+    // The bin is found from the number of significant bits of the duration:
+    // up to 6 bits (below 64 cycles) is bin 0, and every 2 more bits is the next bin
+    bits = 32 - __CLZ(cycles);
+    bin = (bits <= 6) ? 0 : ((bits - 5) / 2);
+    entry->histogram[(bin < PROFILE_HISTOGRAM_BINS) ? bin : (PROFILE_HISTOGRAM_BINS - 1)]++;
+}
+
+uint8_t Profile_Get_Stats(uint8_t probe, Profile_Stats *stats)
+{
+    Profile_Entry entry;
+    uint64_t window_cycles;
+
+    if (probe >= PROFILE_PROBE_COUNT)
+    {
+        return 0;
+    }
+
+    // Copy the entry with interrupts disabled so that a sample is not recorded halfway through the copy
+    __disable_irq();
+    entry = profile_table[probe];
+    __enable_irq();
+
+    // A probe without samples reports zeroed statistics
+    if (entry.count == 0)
+    {
+        stats->count = 0;
+        stats->min_cycles = 0;
+        stats->max_cycles = 0;
+        stats->mean_cycles = 0;
+        stats->load = 0;
+
+        for (uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+        {
+            stats->histogram[bin] = 0;
+        }
+
+        return 1;
+    }
+
+    window_cycles = (Timebase_Get_Time_us() - profile_start_time_us) * Clock_Get_Cycles_Per_Us();
+
+    stats->count = entry.count;
+    stats->min_cycles = entry.min_cycles;
+    stats->max_cycles = entry.max_cycles;
+    stats->mean_cycles = (uint32_t)(entry.total_cycles / entry.count);
+    stats->load = (window_cycles > 0) ? (uint16_t)((entry.total_cycles * 10000) / window_cycles) : 0;
+
+    for (uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+    {
+        stats->histogram[bin] = entry.histogram[bin];
+    }
+
+    return 1;
+}
+
+void Profile_Reset(void)
+{
+    __disable_irq();
+    Profile_Clear();
+    __enable_irq();
+}
@@ -0,0 +1,141 @@
+/**
+ * @file Profile.h
+ *
+ * @brief Header file for the Profile module.
+ *
+ * This file contains the function definitions for the cycle-accurate profiler of the
+ * Home Security System. The profiler uses the cycle counter (CYCCNT) of the Data
+ * Watchpoint and Trace (DWT) unit of the Cortex-M4, which counts system clock cycles
+ * (12.5 ns at 80 MHz). The CPU shares are computed with the current system clock
+ * (see Clock.h), so they are only exact when the clock profile did not change since
+ * Profile_Reset.
+ *
+ * A probe is a section of code measured between PROFILE_BEGIN and PROFILE_END:
+ *
+ *     void UART1_Handler(void)
+ *     {
+ *         PROFILE_BEGIN();
+ *         ...
+ *         PROFILE_END(PROFILE_PROBE_UART1);
+ *     }
+ *
+ * For each probe, the profiler keeps the number of samples, the minimum, maximum, and
+ * total number of cycles, a histogram of the durations, and the share of the CPU time
+ * spent in the probe. The interrupt probes include the time of the interrupts that
+ * preempted them, and the task probes include the time of the interrupts handled
+ * while the task ran.
+ *
+ * Set PROFILE_ENABLE to 0 to remove the probes: the macros then compile to nothing
+ * and the statistics are always empty.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Set to 0 to compile the probes out
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 1
+#endif
+
+// Number of bins in the histogram of each probe
+// Bin 0 holds durations below 64 cycles and each next bin covers 4 times the range
+// of the previous one; the last bin holds every duration of 262144 cycles or more
+#define PROFILE_HISTOGRAM_BINS      8
+
+/**
+ * @brief Probe identifiers.
+ *
+ * Every task has a probe, measured around its handler by the scheduler.
+ */
+enum Profile_Probes
+{
+    PROFILE_PROBE_SYSTICK       = 0,    // SysTick_Handler (Timebase rollover)
+    PROFILE_PROBE_GPIOD         = 1,    // GPIOD_Handler (buttons)
+    PROFILE_PROBE_TIMER0A       = 2,    // TIMER0A_Handler (1 ms system tick)
+    PROFILE_PROBE_UART1         = 3,    // UART1_Handler (US-100 link)
+    PROFILE_PROBE_UART0         = 4,    // UART0_Handler (telemetry link)
+    PROFILE_PROBE_TIMER1A       = 5,    // TIMER1A_Handler (LCD flush)
+    PROFILE_PROBE_ECHO          = 6,    // Wide timer capture handlers (US-100 echo)
+    PROFILE_PROBE_LCD_FORMAT    = 7,    // Number formatting of the LCD_Framebuffer write functions
+    PROFILE_PROBE_TASK_FIRST    = 8,    // Probe of task 0; task n uses PROFILE_PROBE_TASK_FIRST + n
+    PROFILE_PROBE_COUNT         = PROFILE_PROBE_TASK_FIRST + TASK_COUNT
+};
+
+/**
+ * @brief Statistics of one probe.
+ */
+typedef struct
+{
+    uint32_t count;                                 // Number of samples
+    uint32_t min_cycles;                            // Shortest sample
+    uint32_t max_cycles;                            // Longest sample
+    uint32_t mean_cycles;                           // Average sample
+    uint16_t load;                                  // Share of the CPU time in 0.01 %
+    uint32_t histogram[PROFILE_HISTOGRAM_BINS];     // Number of samples in each bin
+} Profile_Stats;
+
+#if PROFILE_ENABLE
+
+// Starts the measurement of a probe. A block can hold one measurement at a time.
+#define PROFILE_BEGIN()             uint32_t profile_start_cycles = DWT->CYCCNT
+
+// Ends the measurement of a probe and records its duration
+#define PROFILE_END(probe)          Profile_Record((probe), DWT->CYCCNT - profile_start_cycles)
+
+#else
+
+#define PROFILE_BEGIN()             do { } while (0)
+#define PROFILE_END(probe)          do { } while (0)
+
+#endif
+
+/**
+ * @brief Enables the DWT cycle counter and clears the statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profile_Init(void);
+
+/**
+ * @brief Records one sample of a probe.
+ *
+ * This function is called by PROFILE_END and can be called from interrupt handlers.
+ * Each probe must only be recorded from one context.
+ *
+ * @param probe The probe (see Profile_Probes).
+ *
+ * @param cycles The duration of the sample in cycles.
+ *
+ * @return None
+ */
+void Profile_Record(uint8_t probe, uint32_t cycles);
+
+/**
+ * @brief Copies the statistics of a probe.
+ *
+ * @param probe The probe (see Profile_Probes).
+ *
+ * @param stats A pointer to where the statistics are copied.
+ *
+ * @return uint8_t Returns 1 if the probe exists, or 0 if it does not. The statistics of
+ *                 a probe without samples are all zero.
+ */
+uint8_t Profile_Get_Stats(uint8_t probe, Profile_Stats *stats);
+
+/**
+ * @brief Clears the statistics of every probe and restarts the measurement of the CPU time.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profile_Reset(void);
+
+#endif
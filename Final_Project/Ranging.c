@@ -0,0 +1,541 @@
+/**
+ * @file Ranging.c
+ *
+ * @brief Source code for the Ranging engine.
+ *
+ * This file contains the function definitions for the asynchronous ranging engine
+ * of the US-100 Ultrasonic Distance Sensor.
+ *
+ * The UART1 receive task runs in the UART1 interrupt. It only timestamps a complete
+ * reply frame and posts SIGNAL_RANGE_FRAME, so each sample costs one interrupt and
+ * one short task dispatch. All triggers are issued from the ranging task, which keeps
+ * the task as the only producer of the UART1 transmit ring buffer and the only
+ * consumer of the UART1 receive ring buffer.
+ *
+ * With the echo backend, the wide timer capture interrupts play the same role: they
+ * only store the captured echo width and post SIGNAL_RANGE_FRAME. Only the channel
+ * that was triggered last is accepted.
+ *
+ * With the script backend, the trigger itself stores the distance of the script
+ * function and posts SIGNAL_RANGE_FRAME, so every sample goes through the same path
+ * as a sensor reply.
+ *
+ * @note For more information regarding the US-100 Ultrasonic Sensor, refer to its datasheet.
+ * Link: https://www.elecrow.com/download/US-100.pdf
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Ranging.h"
+#include "UART1.h"
+#include "Timebase.h"
+#include "Supervisor.h"
+
+#define READ_DISTANCE           0x55 // Command to read distance from US-100
+#define READ_TEMPERATURE        0x50 // Command to read temperature from US-100 (one-byte reply)
+#define RANGING_FRAME_LENGTH    2    // The reply is the high byte followed by the low byte
+
+#define RANGING_HISTORY_MASK    (RANGING_HISTORY_SIZE - 1)
+
+// Sample ring buffer, written only by the ranging task
+static Range_Sample sample_history[RANGING_HISTORY_SIZE];
+static uint32_t sample_count = 0;
+static uint32_t timeout_count = 0;
+
+// Number of samples at the last check of the supervisor
+static uint32_t checked_sample_count = 0;
+
+// Subscribers notified of every new sample
+static Ranging_Subscriber subscribers[RANGING_MAX_SUBSCRIBERS];
+static uint8_t subscriber_count = 0;
+
+// Ranging state
+static uint8_t ranging_backend = RANGING_BACKEND_UART;
+static uint8_t ranging_mode = RANGING_MODE_CONTINUOUS;
+static uint8_t ranging_running = 0;
+static uint8_t channel_mask = 0x01;
+static uint8_t current_channel = 0;
+static volatile uint8_t measurement_pending = 0;
+static volatile uint8_t frame_event_pending = 0;
+static volatile uint64_t frame_timestamp_us = 0;
+static volatile uint32_t frame_echo_ticks = 0;
+static uint16_t frame_script_distance_mm = 0;
+static Ranging_Script ranging_script = 0;
+static volatile uint8_t single_read_active = 0;
+static Timer_Handle reply_deadline;
+
+// Scheduler timers used by the ranging task
+static Scheduler_Timer trigger_timer;
+static Scheduler_Timer reply_timer;
+
+// Executed from UART1_Handler when new bytes have been received
+static void Ranging_Receive_Task(void)
+{
+    if (measurement_pending && !frame_event_pending && (UART1_Available() >= RANGING_FRAME_LENGTH))
+    {
+        // A frame is seen when the receive line has been idle after its last byte
+        frame_timestamp_us = Timebase_Get_Time_us() - UART1_Get_Receive_Timeout_us();
+        frame_event_pending = 1;
+        Scheduler_Post(TASK_RANGING, SIGNAL_RANGE_FRAME, 0);
+    }
+}
+
+// Executed from the capture interrupt of a channel when the falling edge of the echo pulse has been captured
+static void Ranging_Echo_Task(uint8_t channel, uint32_t echo_ticks)
+{
+    // Ignore a late echo from a channel that is no longer being measured
+    if (channel != current_channel)
+    {
+        return;
+    }
+
+    if (single_read_active)
+    {
+        frame_echo_ticks = echo_ticks;
+        frame_event_pending = 1;
+    }
+    else if (measurement_pending && !frame_event_pending)
+    {
+        frame_timestamp_us = Timebase_Get_Time_us();
+        frame_echo_ticks = echo_ticks;
+        frame_event_pending = 1;
+        Scheduler_Post(TASK_RANGING, SIGNAL_RANGE_FRAME, 0);
+    }
+}
+
+static uint8_t Ranging_Decode_Frame(const uint8_t *frame, uint16_t *distance_mm)
+{
+    // Combine the bytes to form the distance value
+    uint16_t distance = (frame[0] << 8) | frame[1];
+
+    if ((distance == 0) || (distance > RANGING_MAX_DISTANCE_MM))
+    {
+        *distance_mm = 0;
+        return RANGE_STATUS_NO_ECHO;
+    }
+
+    *distance_mm = distance;
+    return RANGE_STATUS_OK;
+}
+
+static uint8_t Ranging_Decode_Echo(uint32_t echo_ticks, uint16_t *distance_mm)
+{
+    // The width is converted with the current system clock before it is checked
+    uint32_t distance_tenths_mm = US100_Echo_Ticks_To_Distance(echo_ticks);
+
+    // The US-100 holds the echo pin high for a long time when no echo is received
+    if ((echo_ticks == 0) || (distance_tenths_mm > (RANGING_MAX_DISTANCE_MM * 10UL)))
+    {
+        *distance_mm = 0;
+        return RANGE_STATUS_NO_ECHO;
+    }
+
+    // Round the distance from tenths of a millimeter to millimeters
+    *distance_mm = (uint16_t)((distance_tenths_mm + 5) / 10);
+    return RANGE_STATUS_OK;
+}
+
+static uint8_t Ranging_Decode_Script(uint16_t script_distance_mm, uint16_t *distance_mm)
+{
+    if ((script_distance_mm == 0) || (script_distance_mm > RANGING_MAX_DISTANCE_MM))
+    {
+        *distance_mm = 0;
+        return RANGE_STATUS_NO_ECHO;
+    }
+
+    *distance_mm = script_distance_mm;
+    return RANGE_STATUS_OK;
+}
+
+static uint8_t Ranging_Get_Available_Channels(void)
+{
+    return (ranging_backend != RANGING_BACKEND_UART) ? (uint8_t)((1 << RANGING_MAX_CHANNELS) - 1) : 0x01;
+}
+
+// Returns the next enabled channel after the given channel in round-robin order
+static uint8_t Ranging_Next_Channel(uint8_t channel)
+{
+    for (uint8_t i = 1; i <= RANGING_MAX_CHANNELS; i++)
+    {
+        uint8_t next_channel = (channel + i) % RANGING_MAX_CHANNELS;
+
+        if (channel_mask & (1 << next_channel))
+        {
+            return next_channel;
+        }
+    }
+
+    return channel;
+}
+
+static void Ranging_Send_Trigger(void)
+{
+    if (ranging_backend == RANGING_BACKEND_ECHO)
+    {
+        US100_Echo_Trigger(current_channel);
+    }
+    else if (ranging_backend == RANGING_BACKEND_SCRIPT)
+    {
+        // The reply of the script is available immediately
+        frame_script_distance_mm = (ranging_script != 0) ? (*ranging_script)(current_channel) : 0;
+        frame_timestamp_us = Timebase_Get_Time_us();
+        frame_event_pending = 1;
+
+        if (measurement_pending)
+        {
+            Scheduler_Post(TASK_RANGING, SIGNAL_RANGE_FRAME, 0);
+        }
+    }
+    else
+    {
+        // Discard stale bytes so that a dropped byte cannot misalign the next reply
+        UART1_Flush_Input();
+
+        // Send the "read distance" command (0x55)
+        UART1_Write_Byte(READ_DISTANCE);
+    }
+}
+
+static void Ranging_Trigger(void)
+{
+    frame_event_pending = 0;
+    measurement_pending = 1;
+
+    // Send the trigger and start the reply timeout
+    // A scheduler timer can expire up to one tick early since the trigger is sent between
+    // two ticks, so the timer runs one more tick than the deadline it checks
+    Ranging_Send_Trigger();
+    Timer_Start(&reply_deadline, RANGING_REPLY_TIMEOUT_MS * 1000);
+    Scheduler_Timer_Start(&reply_timer, TASK_RANGING, SIGNAL_RANGE_TIMEOUT, RANGING_REPLY_TIMEOUT_MS + SCHEDULER_TICK_MS, 0);
+}
+
+static void Ranging_Record_Sample(uint64_t timestamp_us, uint32_t echo_ticks, uint16_t distance_mm, uint8_t status)
+{
+    Range_Sample *sample = &sample_history[sample_count & RANGING_HISTORY_MASK];
+
+    sample->timestamp_us = timestamp_us;
+    sample->sequence = sample_count;
+    sample->echo_ticks = echo_ticks;
+    sample->distance_mm = distance_mm;
+    sample->channel = current_channel;
+    sample->status = status;
+
+    sample_count++;
+
+    for (uint8_t i = 0; i < subscriber_count; i++)
+    {
+        (*subscribers[i])(sample);
+    }
+}
+
+static void Ranging_Continue(void)
+{
+    // The next trigger, in either mode, measures the next channel
+    current_channel = Ranging_Next_Channel(current_channel);
+
+    if (ranging_running && (ranging_mode == RANGING_MODE_CONTINUOUS))
+    {
+        if (ranging_backend == RANGING_BACKEND_ECHO)
+        {
+            // Let the residual echoes decay before the next burst on any channel
+            Scheduler_Timer_Start(&trigger_timer, TASK_RANGING, SIGNAL_RANGE_TRIGGER, RANGING_ECHO_HOLDOFF_MS, 0);
+        }
+        else if (ranging_backend == RANGING_BACKEND_SCRIPT)
+        {
+            // Pace the script like a sensor so that the ranging task does not take every dispatch
+            Scheduler_Timer_Start(&trigger_timer, TASK_RANGING, SIGNAL_RANGE_TRIGGER, RANGING_SCRIPT_PERIOD_MS, 0);
+        }
+        else
+        {
+            Ranging_Trigger();
+        }
+    }
+}
+
+void Ranging_Init(void)
+{
+    ranging_running = 0;
+    measurement_pending = 0;
+    ranging_backend = RANGING_BACKEND_UART;
+
+#if RANGING_AUTO_BAUD
+    // Find the baud rate of the sensor with the temperature command, which is answered
+    // with a single byte without a measurement
+    static const uint8_t probe = READ_TEMPERATURE;
+    UART1_Auto_Baud(&probe, 1, 1, RANGING_PROBE_RESPONSE_US);
+#endif
+
+    UART1_Set_Receive_Task(&Ranging_Receive_Task);
+    Scheduler_Add_Task(TASK_RANGING, Ranging_Task);
+    Supervisor_Monitor(TASK_RANGING);
+}
+
+void Ranging_Set_Backend(uint8_t backend)
+{
+    Ranging_Stop();
+
+    if (backend == RANGING_BACKEND_ECHO)
+    {
+        // The US100_Echo driver is initialized for the enabled channels below
+        ranging_backend = RANGING_BACKEND_ECHO;
+    }
+    else if (backend == RANGING_BACKEND_SCRIPT)
+    {
+        // Release the PC5 and PC7 pins of the echo backend; UART1 is left idle
+        US100_Echo_Disable();
+        ranging_backend = RANGING_BACKEND_SCRIPT;
+    }
+    else
+    {
+        // Return the PC5 and PC7 pins to UART1
+        US100_Echo_Disable();
+        UART1_Init();
+        UART1_Set_Receive_Task(&Ranging_Receive_Task);
+        ranging_backend = RANGING_BACKEND_UART;
+    }
+
+    // Keep the enabled channels that the new backend supports
+    Ranging_Set_Channels(channel_mask);
+}
+
+void Ranging_Set_Script(Ranging_Script script)
+{
+    ranging_script = script;
+}
+
+uint8_t Ranging_Get_Backend(void)
+{
+    return ranging_backend;
+}
+
+uint8_t Ranging_Set_Channels(uint8_t mask)
+{
+    Ranging_Stop();
+
+    channel_mask = mask & Ranging_Get_Available_Channels();
+
+    if (channel_mask == 0)
+    {
+        channel_mask = 0x01;
+    }
+
+    if (ranging_backend == RANGING_BACKEND_ECHO)
+    {
+        US100_Echo_Init(&Ranging_Echo_Task, channel_mask);
+    }
+
+    // Start with the lowest enabled channel
+    current_channel = Ranging_Next_Channel(RANGING_MAX_CHANNELS - 1);
+
+    return channel_mask;
+}
+
+uint8_t Ranging_Get_Channels(void)
+{
+    return channel_mask;
+}
+
+uint8_t Ranging_Read_Single(Range_Sample *sample)
+{
+    uint8_t frame[RANGING_FRAME_LENGTH];
+    uint16_t distance_mm = 0;
+    uint32_t echo_ticks = 0;
+    uint8_t status = RANGE_STATUS_TIMEOUT;
+
+    current_channel = Ranging_Next_Channel(RANGING_MAX_CHANNELS - 1);
+
+    if (ranging_backend == RANGING_BACKEND_ECHO)
+    {
+        Timer_Handle deadline;
+
+        frame_event_pending = 0;
+        single_read_active = 1;
+
+        Ranging_Send_Trigger();
+        Timer_Start(&deadline, RANGING_REPLY_TIMEOUT_MS * 1000);
+
+        while (!frame_event_pending && !Timer_Expired(&deadline));
+
+        single_read_active = 0;
+
+        if (frame_event_pending)
+        {
+            echo_ticks = frame_echo_ticks;
+            status = Ranging_Decode_Echo(echo_ticks, &distance_mm);
+        }
+    }
+    else if (ranging_backend == RANGING_BACKEND_SCRIPT)
+    {
+        Ranging_Send_Trigger();
+        status = Ranging_Decode_Script(frame_script_distance_mm, &distance_mm);
+    }
+    else
+    {
+        Ranging_Send_Trigger();
+
+        if (UART1_Read_Timeout(frame, RANGING_FRAME_LENGTH, RANGING_REPLY_TIMEOUT_MS * 1000) == RANGING_FRAME_LENGTH)
+        {
+            status = Ranging_Decode_Frame(frame, &distance_mm);
+        }
+    }
+
+    sample->timestamp_us = Timebase_Get_Time_us();
+    sample->sequence = sample_count;
+    sample->echo_ticks = echo_ticks;
+    sample->distance_mm = distance_mm;
+    sample->channel = current_channel;
+    sample->status = status;
+
+    return (status == RANGE_STATUS_OK) ? 1 : 0;
+}
+
+void Ranging_Start(uint8_t mode, uint32_t period_ms)
+{
+    ranging_mode = mode;
+    ranging_running = 1;
+
+    if (mode == RANGING_MODE_FIXED_RATE)
+    {
+        Scheduler_Timer_Start(&trigger_timer, TASK_RANGING, SIGNAL_RANGE_TRIGGER, period_ms, period_ms);
+    }
+
+    if (!measurement_pending)
+    {
+        Ranging_Trigger();
+    }
+}
+
+void Ranging_Stop(void)
+{
+    ranging_running = 0;
+    measurement_pending = 0;
+    Scheduler_Timer_Stop(&trigger_timer);
+    Scheduler_Timer_Stop(&reply_timer);
+}
+
+uint8_t Ranging_Is_Running(void)
+{
+    return ranging_running;
+}
+
+uint8_t Ranging_Is_Measuring(void)
+{
+    return measurement_pending;
+}
+
+uint8_t Ranging_Subscribe(Ranging_Subscriber subscriber)
+{
+    if (subscriber_count >= RANGING_MAX_SUBSCRIBERS)
+    {
+        return 0;
+    }
+
+    subscribers[subscriber_count] = subscriber;
+    subscriber_count++;
+
+    return 1;
+}
+
+uint8_t Ranging_Get_Latest(Range_Sample *sample)
+{
+    return Ranging_Get_History(0, sample);
+}
+
+uint8_t Ranging_Get_History(uint8_t age, Range_Sample *sample)
+{
+    if ((age >= RANGING_HISTORY_SIZE) || (age >= sample_count))
+    {
+        return 0;
+    }
+
+    *sample = sample_history[(sample_count - 1 - age) & RANGING_HISTORY_MASK];
+
+    return 1;
+}
+
+uint32_t Ranging_Get_Sample_Count(void)
+{
+    return sample_count;
+}
+
+uint32_t Ranging_Get_Timeout_Count(void)
+{
+    return timeout_count;
+}
+
+void Ranging_Task(const Scheduler_Event *event)
+{
+    uint8_t frame[RANGING_FRAME_LENGTH];
+    uint16_t distance_mm;
+    uint8_t status;
+
+    switch (event->signal)
+    {
+        case SIGNAL_RANGE_FRAME:
+            if (!measurement_pending || !frame_event_pending)
+            {
+                break;
+            }
+
+            if (ranging_backend == RANGING_BACKEND_ECHO)
+            {
+                status = Ranging_Decode_Echo(frame_echo_ticks, &distance_mm);
+            }
+            else if (ranging_backend == RANGING_BACKEND_SCRIPT)
+            {
+                status = Ranging_Decode_Script(frame_script_distance_mm, &distance_mm);
+            }
+            else
+            {
+                if (UART1_Read(frame, RANGING_FRAME_LENGTH) < RANGING_FRAME_LENGTH)
+                {
+                    break;
+                }
+
+                status = Ranging_Decode_Frame(frame, &distance_mm);
+            }
+
+            measurement_pending = 0;
+            Scheduler_Timer_Stop(&reply_timer);
+
+            Ranging_Record_Sample(frame_timestamp_us,
+                (ranging_backend == RANGING_BACKEND_ECHO) ? frame_echo_ticks : 0, distance_mm, status);
+
+            Ranging_Continue();
+            break;
+
+        case SIGNAL_RANGE_TIMEOUT:
+            // Ignore a timeout event that belongs to an earlier trigger
+            if (!measurement_pending || !Timer_Expired(&reply_deadline))
+            {
+                break;
+            }
+
+            measurement_pending = 0;
+            timeout_count++;
+            Ranging_Record_Sample(Timebase_Get_Time_us(), 0, 0, RANGE_STATUS_TIMEOUT);
+            Ranging_Continue();
+            break;
+
+        case SIGNAL_RANGE_TRIGGER:
+            // Skip a fixed-rate trigger while the previous measurement is still in progress
+            if (ranging_running && !measurement_pending)
+            {
+                Ranging_Trigger();
+            }
+            break;
+
+        case SIGNAL_SUPERVISOR_PING:
+            // In continuous mode, the engine is only alive while it records samples. A sensor
+            // that does not reply still records a timeout sample, so only a stuck engine misses.
+            if (!ranging_running || (ranging_mode != RANGING_MODE_CONTINUOUS) || (sample_count != checked_sample_count))
+            {
+                Supervisor_Check_In(TASK_RANGING);
+            }
+            checked_sample_count = sample_count;
+            break;
+
+        default:
+            break;
+    }
+}
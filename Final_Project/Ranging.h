@@ -0,0 +1,316 @@
+/**
+ * @file Ranging.h
+ *
+ * @brief Header file for the Ranging engine.
+ *
+ * This file contains the function definitions for the asynchronous ranging engine
+ * of the US-100 Ultrasonic Distance Sensor. The engine runs as a scheduler task
+ * (TASK_RANGING) and never waits for the sensor:
+ * - A trigger command (0x55) is queued on UART1 and a reply timeout is started.
+ * - The two-byte reply is stored in memory by the uDMA controller. When the receive
+ *   line goes idle after the reply, the UART1 receive task timestamps the frame
+ *   and posts one event to the ranging task.
+ * - The ranging task stores the sample in a sample ring buffer, notifies the
+ *   subscribers, and issues the next trigger.
+ *
+ * In continuous mode, the next trigger is issued as soon as the previous frame has
+ * arrived. In fixed-rate mode, triggers are issued by a periodic scheduler timer.
+ *
+ * Several sensors (channels) can be measured by the echo backend. Only one channel is
+ * triggered at a time and the channels are visited in round-robin order, so the burst
+ * of one sensor cannot be received as the echo of another. The next channel is
+ * triggered as soon as the holdoff after the previous echo has elapsed, which keeps
+ * the total sample rate at the rate of a single sensor: with N channels, each channel
+ * is sampled 1/N as often.
+ *
+ * Two backends are supported:
+ * - RANGING_BACKEND_UART: the serial mode of the US-100 (UART1 driver). Each reading
+ *   costs about 3 ms of wire time at 9600 baud, plus about 3 ms until the receive
+ *   timeout marks the end of the reply, and has a resolution of 1 mm. The baud rate of
+ *   the sensor is detected by Ranging_Init (see UART1_Auto_Baud), so a faster serial
+ *   sensor with the same protocol shortens both delays. Only channel 0 is available.
+ * - RANGING_BACKEND_ECHO: the trigger/echo mode of the US-100 (US100_Echo driver).
+ *   The echo width is captured by a wide timer in hardware with a resolution of one clock cycle,
+ *   and the CPU only handles the trigger pulse and two edge interrupts per reading.
+ *   Up to US100_ECHO_CHANNEL_COUNT channels are available.
+ * - RANGING_BACKEND_SCRIPT: no sensor. Each trigger returns the distance given by a
+ *   script function (see Ranging_Set_Script) as soon as it is issued, and triggers are
+ *   issued every RANGING_SCRIPT_PERIOD_MS in continuous mode. It is used by the
+ *   Benchmark module to replay a scene with a known timing. All channels are available.
+ *
+ * @note For more information regarding the US-100 Ultrasonic Sensor, refer to its datasheet.
+ * Link: https://www.elecrow.com/download/US-100.pdf
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef RANGING_H
+#define RANGING_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+#include "US100_Echo.h"
+
+// Number of samples kept in the sample ring buffer (must be a power of two)
+#define RANGING_HISTORY_SIZE        16
+
+// Maximum number of subscribers notified of new samples (3 are used, the rest is headroom)
+#define RANGING_MAX_SUBSCRIBERS     5
+
+// Maximum time to wait for the reply of the US-100 (longest echo is about 30 ms)
+#define RANGING_REPLY_TIMEOUT_MS    50
+
+// Set to 0 to keep the UART1 baud rate instead of probing the sensor in Ranging_Init
+#ifndef RANGING_AUTO_BAUD
+#define RANGING_AUTO_BAUD 1
+#endif
+
+// Longest time from the temperature command to the start of its reply during the baud rate probe
+#define RANGING_PROBE_RESPONSE_US   2000
+
+// Largest distance reported by the US-100 that is considered a valid echo
+#define RANGING_MAX_DISTANCE_MM     4500
+
+// Minimum time between the end of an echo and the next trigger in echo mode,
+// which lets the residual echoes of the previous burst decay before any sensor fires again
+#define RANGING_ECHO_HOLDOFF_MS     10
+
+// Time between two triggers of the script backend in continuous mode
+#define RANGING_SCRIPT_PERIOD_MS    10
+
+// Number of channels supported by the ranging engine
+#define RANGING_MAX_CHANNELS        US100_ECHO_CHANNEL_COUNT
+
+/**
+ * @brief Backends of the ranging engine.
+ */
+enum Ranging_Backends
+{
+    RANGING_BACKEND_UART = 0,       // US-100 serial mode on UART1
+    RANGING_BACKEND_ECHO = 1,       // US-100 trigger/echo mode on the wide timer captures
+    RANGING_BACKEND_SCRIPT = 2      // Distances returned by the script function
+};
+
+/**
+ * @brief Trigger modes of the ranging engine.
+ */
+enum Ranging_Modes
+{
+    RANGING_MODE_CONTINUOUS = 0,    // Trigger again as soon as a frame arrives
+    RANGING_MODE_FIXED_RATE = 1     // Trigger on a periodic scheduler timer
+};
+
+/**
+ * @brief Status of a range sample.
+ */
+enum Ranging_Sample_Status
+{
+    RANGE_STATUS_OK             = 0,    // Valid distance
+    RANGE_STATUS_NO_ECHO        = 1,    // The sensor replied, but no echo was detected in range
+    RANGE_STATUS_TIMEOUT        = 2     // The sensor did not reply
+};
+
+/**
+ * @brief A timestamped range sample.
+ */
+typedef struct
+{
+    uint64_t timestamp_us;      // Time at which the reply frame was received
+    uint32_t sequence;          // Sequence number of the sample
+    uint32_t echo_ticks;        // Captured echo width in system clock counts (echo backend only, otherwise 0)
+    uint16_t distance_mm;       // Measured distance in millimeters (0 if not valid)
+    uint8_t channel;            // Channel (sensor) of the sample
+    uint8_t status;             // See Ranging_Sample_Status
+} Range_Sample;
+
+/**
+ * @brief Subscriber callback executed in task context for every new sample.
+ */
+typedef void (*Ranging_Subscriber)(const Range_Sample *sample);
+
+/**
+ * @brief Script function of the script backend, executed in task context for every trigger.
+ *
+ * Returns the distance of the channel in millimeters, or 0 for no echo.
+ */
+typedef uint16_t (*Ranging_Script)(uint8_t channel);
+
+/**
+ * @brief Initializes the ranging engine and registers TASK_RANGING with the scheduler.
+ *
+ * UART1 must be initialized before this function is called. When RANGING_AUTO_BAUD is set,
+ * this function detects the baud rate of the sensor, which waits for about 6 ms at 9600
+ * baud, or about 25 ms when no sensor answers.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Ranging_Init(void);
+
+/**
+ * @brief Selects the backend used for the following measurements.
+ *
+ * Ranging is stopped before the backend is changed. Selecting the echo backend
+ * initializes the US100_Echo driver for the enabled channels, and selecting the UART
+ * backend initializes UART1 again since both backends share the PC5 and PC7 pins.
+ * The mode jumper of the US-100 must match the selected backend. The script backend
+ * releases the pins of the echo backend and leaves UART1 idle.
+ *
+ * @param backend The backend to use (see Ranging_Backends).
+ *
+ * @return None
+ */
+void Ranging_Set_Backend(uint8_t backend);
+
+/**
+ * @brief Sets the function that returns the distances of the script backend.
+ *
+ * @param script A pointer to the script function, or 0 to report no echo on every channel.
+ *
+ * @return None
+ */
+void Ranging_Set_Script(Ranging_Script script);
+
+/**
+ * @brief Returns the backend currently used by the ranging engine.
+ *
+ * @param None
+ *
+ * @return uint8_t The current backend (see Ranging_Backends).
+ */
+uint8_t Ranging_Get_Backend(void);
+
+/**
+ * @brief Selects the channels measured by the ranging engine.
+ *
+ * Ranging is stopped before the channels are changed. Channels that the current
+ * backend does not support are removed from the mask.
+ *
+ * @param channel_mask The channels to measure (Bit n = channel n).
+ *
+ * @return uint8_t The channels that will be measured.
+ */
+uint8_t Ranging_Set_Channels(uint8_t channel_mask);
+
+/**
+ * @brief Returns the channels measured by the ranging engine.
+ *
+ * @param None
+ *
+ * @return uint8_t The enabled channels (Bit n = channel n).
+ */
+uint8_t Ranging_Get_Channels(void);
+
+/**
+ * @brief Takes one measurement on the lowest enabled channel and waits for its result.
+ *
+ * This function must only be called while the ranging engine is stopped. It waits
+ * at most RANGING_REPLY_TIMEOUT_MS for the result. The sample is not recorded in the
+ * sample ring buffer and the subscribers are not notified.
+ *
+ * @param sample A pointer to where the sample is copied.
+ *
+ * @return uint8_t Returns 1 if a valid distance was measured. Otherwise, it returns 0.
+ */
+uint8_t Ranging_Read_Single(Range_Sample *sample);
+
+/**
+ * @brief Starts continuous or fixed-rate ranging.
+ *
+ * @param mode The trigger mode (see Ranging_Modes).
+ *
+ * @param period_ms The trigger period in fixed-rate mode, shared by all channels.
+ *                  Ignored in continuous mode.
+ *
+ * @return None
+ */
+void Ranging_Start(uint8_t mode, uint32_t period_ms);
+
+/**
+ * @brief Stops ranging. A measurement in progress is discarded.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Ranging_Stop(void);
+
+/**
+ * @brief Indicates whether the ranging engine is running.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if ranging is running. Otherwise, it returns 0.
+ */
+uint8_t Ranging_Is_Running(void);
+
+/**
+ * @brief Indicates whether a measurement is in progress.
+ *
+ * Between two measurements, the engine only waits for a scheduler timer, so the
+ * sensor interface (UART1 or the wide timer captures) does not have to be clocked.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 from the trigger until the reply or the reply timeout. Otherwise, it returns 0.
+ */
+uint8_t Ranging_Is_Measuring(void);
+
+/**
+ * @brief Registers a subscriber that is notified of every new sample.
+ *
+ * @param subscriber A pointer to the subscriber callback.
+ *
+ * @return uint8_t Returns 1 if the subscriber was added, or 0 if the subscriber table is full.
+ */
+uint8_t Ranging_Subscribe(Ranging_Subscriber subscriber);
+
+/**
+ * @brief Copies the most recent sample.
+ *
+ * @param sample A pointer to where the sample is copied.
+ *
+ * @return uint8_t Returns 1 if a sample is available, or 0 if no sample has been taken yet.
+ */
+uint8_t Ranging_Get_Latest(Range_Sample *sample);
+
+/**
+ * @brief Copies an older sample from the sample ring buffer.
+ *
+ * @param age The age of the sample (0 = most recent, up to RANGING_HISTORY_SIZE - 1).
+ *
+ * @param sample A pointer to where the sample is copied.
+ *
+ * @return uint8_t Returns 1 if the sample is available. Otherwise, it returns 0.
+ */
+uint8_t Ranging_Get_History(uint8_t age, Range_Sample *sample);
+
+/**
+ * @brief Returns the number of samples taken since initialization.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of samples, including timeouts.
+ */
+uint32_t Ranging_Get_Sample_Count(void);
+
+/**
+ * @brief Returns the number of triggers that did not receive a reply.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of reply timeouts.
+ */
+uint32_t Ranging_Get_Timeout_Count(void);
+
+/**
+ * @brief Event handler of the ranging task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Ranging_Task(const Scheduler_Event *event);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file Ring_Buffer.c
+ *
+ * @brief Source code for the Ring_Buffer module.
+ *
+ * This file contains the function definitions for a lock-free byte ring buffer
+ * with a single producer and a single consumer (SPSC).
+ *
+ * The data byte is always written before the head index is advanced, and read
+ * before the tail index is advanced. Both the storage and the indices are volatile,
+ * so the compiler keeps these accesses in order.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Ring_Buffer.h"
+
+void Ring_Buffer_Init(Ring_Buffer *ring_buffer, uint8_t *storage, uint16_t size)
+{
+	ring_buffer->storage = storage;
+	ring_buffer->mask = size - 1;
+	ring_buffer->head = 0;
+	ring_buffer->tail = 0;
+}
+
+uint8_t Ring_Buffer_Put(Ring_Buffer *ring_buffer, uint8_t data)
+{
+	uint16_t head = ring_buffer->head;
+	uint16_t next_head = (head + 1) & ring_buffer->mask;
+	
+	// The ring buffer is full if advancing the head would reach the tail
+	if (next_head == ring_buffer->tail)
+	{
+		return 0;
+	}
+	
+	ring_buffer->storage[head] = data;
+	ring_buffer->head = next_head;
+	
+	return 1;
+}
+
+uint8_t Ring_Buffer_Get(Ring_Buffer *ring_buffer, uint8_t *data)
+{
+	uint16_t tail = ring_buffer->tail;
+	
+	// The ring buffer is empty if the tail has reached the head
+	if (tail == ring_buffer->head)
+	{
+		return 0;
+	}
+	
+	*data = ring_buffer->storage[tail];
+	ring_buffer->tail = (tail + 1) & ring_buffer->mask;
+	
+	return 1;
+}
+
+uint8_t Ring_Buffer_Peek(const Ring_Buffer *ring_buffer, uint16_t offset, uint8_t *data)
+{
+	if (offset >= Ring_Buffer_Count(ring_buffer))
+	{
+		return 0;
+	}
+	
+	*data = ring_buffer->storage[(ring_buffer->tail + offset) & ring_buffer->mask];
+	
+	return 1;
+}
+
+uint16_t Ring_Buffer_Count(const Ring_Buffer *ring_buffer)
+{
+	return (ring_buffer->head - ring_buffer->tail) & ring_buffer->mask;
+}
+
+uint16_t Ring_Buffer_Free(const Ring_Buffer *ring_buffer)
+{
+	return ring_buffer->mask - Ring_Buffer_Count(ring_buffer);
+}
+
+void Ring_Buffer_Flush(Ring_Buffer *ring_buffer)
+{
+	ring_buffer->tail = ring_buffer->head;
+}
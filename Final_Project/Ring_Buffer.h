@@ -0,0 +1,108 @@
+/**
+ * @file Ring_Buffer.h
+ *
+ * @brief Header file for the Ring_Buffer module.
+ *
+ * This file contains the function definitions for a lock-free byte ring buffer
+ * with a single producer and a single consumer (SPSC). The producer only writes
+ * the head index and the consumer only writes the tail index, so one side can run
+ * in an interrupt service routine and the other in a task without disabling interrupts.
+ *
+ * The size of the storage array must be a power of two. One entry is kept free to
+ * distinguish a full buffer from an empty one, so a buffer holds (size - 1) bytes.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Ring buffer control structure.
+ */
+typedef struct
+{
+	volatile uint8_t *storage;
+	uint16_t mask;
+	volatile uint16_t head;
+	volatile uint16_t tail;
+} Ring_Buffer;
+
+/**
+ * @brief Initializes a ring buffer with the given storage array.
+ *
+ * @param ring_buffer A pointer to the ring buffer to initialize.
+ *
+ * @param storage A pointer to the storage array.
+ *
+ * @param size The size of the storage array in bytes (must be a power of two).
+ *
+ * @return None
+ */
+void Ring_Buffer_Init(Ring_Buffer *ring_buffer, uint8_t *storage, uint16_t size);
+
+/**
+ * @brief Adds a byte to the ring buffer. Only called by the producer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data The byte to add.
+ *
+ * @return uint8_t Returns 1 if the byte was added, or 0 if the ring buffer is full.
+ */
+uint8_t Ring_Buffer_Put(Ring_Buffer *ring_buffer, uint8_t data);
+
+/**
+ * @brief Removes a byte from the ring buffer. Only called by the consumer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data A pointer to where the removed byte is stored.
+ *
+ * @return uint8_t Returns 1 if a byte was removed, or 0 if the ring buffer is empty.
+ */
+uint8_t Ring_Buffer_Get(Ring_Buffer *ring_buffer, uint8_t *data);
+
+/**
+ * @brief Reads a byte without removing it. Only called by the consumer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param offset The position of the byte relative to the oldest byte (0 = oldest).
+ *
+ * @param data A pointer to where the byte is stored.
+ *
+ * @return uint8_t Returns 1 if the byte exists, or 0 if fewer than (offset + 1) bytes are stored.
+ */
+uint8_t Ring_Buffer_Peek(const Ring_Buffer *ring_buffer, uint16_t offset, uint8_t *data);
+
+/**
+ * @brief Returns the number of bytes stored in the ring buffer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @return uint16_t The number of bytes stored.
+ */
+uint16_t Ring_Buffer_Count(const Ring_Buffer *ring_buffer);
+
+/**
+ * @brief Returns the number of bytes that can still be added to the ring buffer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @return uint16_t The number of free bytes.
+ */
+uint16_t Ring_Buffer_Free(const Ring_Buffer *ring_buffer);
+
+/**
+ * @brief Discards all bytes stored in the ring buffer. Only called by the consumer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @return None
+ */
+void Ring_Buffer_Flush(Ring_Buffer *ring_buffer);
+
+#endif
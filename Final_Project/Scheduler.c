@@ -0,0 +1,293 @@
+/**
+ * @file Scheduler.c
+ *
+ * @brief Source code for the cooperative Scheduler.
+ *
+ * This file contains the function definitions for the cooperative, run-to-completion
+ * task scheduler used by the Home Security System.
+ *
+ * The Timer 0A interrupt only increments a tick counter. Expired timers are found
+ * in task context by walking one slot of the timer wheel per tick, so the cost of
+ * a tick does not depend on the total number of running timers. A timer that expires
+ * more than one revolution of the wheel in the future stays in its slot until its
+ * expiry tick matches.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Scheduler.h"
+#include "Profile.h"
+
+#define SCHEDULER_EVENT_QUEUE_MASK  (SCHEDULER_EVENT_QUEUE_SIZE - 1)
+#define SCHEDULER_TIMER_WHEEL_MASK  (SCHEDULER_TIMER_WHEEL_SIZE - 1)
+
+// Task handlers indexed by task identifier
+static Scheduler_Task_Handler task_handlers[TASK_COUNT];
+
+// Event queue written by tasks and interrupts, read by Scheduler_Run_Once
+static Scheduler_Event event_queue[SCHEDULER_EVENT_QUEUE_SIZE];
+static volatile uint8_t event_queue_head = 0;
+static volatile uint8_t event_queue_tail = 0;
+
+// Ticks counted by the Timer 0A interrupt and ticks already processed by the timer wheel
+static volatile uint32_t tick_count = 0;
+static uint32_t processed_ticks = 0;
+
+// Timer wheel slots, each holding a singly-linked list of timers
+static Scheduler_Timer *timer_wheel[SCHEDULER_TIMER_WHEEL_SIZE];
+static uint8_t active_timer_count = 0;
+
+// Task whose handler is running, read by interrupt service routines
+static volatile uint8_t current_task = TASK_NONE;
+
+// Task executed when there is no event to dispatch
+static void (*idle_task)(void) = 0;
+
+static void Scheduler_Insert_Timer(Scheduler_Timer *timer)
+{
+    uint32_t slot = timer->expiry_tick & SCHEDULER_TIMER_WHEEL_MASK;
+    timer->next = timer_wheel[slot];
+    timer_wheel[slot] = timer;
+}
+
+static void Scheduler_Remove_Timer(Scheduler_Timer *timer)
+{
+    Scheduler_Timer **link = &timer_wheel[timer->expiry_tick & SCHEDULER_TIMER_WHEEL_MASK];
+
+    while (*link != 0)
+    {
+        if (*link == timer)
+        {
+            *link = timer->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+
+    timer->next = 0;
+}
+
+static void Scheduler_Process_Timer_Slot(uint32_t tick)
+{
+    uint32_t slot = tick & SCHEDULER_TIMER_WHEEL_MASK;
+
+    // Detach the slot so that timers restarted into the same slot are not visited twice
+    Scheduler_Timer *timer = timer_wheel[slot];
+    timer_wheel[slot] = 0;
+
+    while (timer != 0)
+    {
+        Scheduler_Timer *next_timer = timer->next;
+
+        if (timer->expiry_tick == tick)
+        {
+            Scheduler_Post(timer->task_id, timer->signal, 0);
+
+            if (timer->period_ms > 0)
+            {
+                timer->expiry_tick = tick + timer->period_ms;
+                Scheduler_Insert_Timer(timer);
+            }
+            else
+            {
+                timer->active = 0;
+                timer->next = 0;
+                active_timer_count--;
+            }
+        }
+        else
+        {
+            // The timer expires in a later revolution of the wheel
+            Scheduler_Insert_Timer(timer);
+        }
+
+        timer = next_timer;
+    }
+}
+
+void Scheduler_Init(void)
+{
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        task_handlers[i] = 0;
+    }
+
+    for (int i = 0; i < SCHEDULER_TIMER_WHEEL_SIZE; i++)
+    {
+        timer_wheel[i] = 0;
+    }
+
+    event_queue_head = 0;
+    event_queue_tail = 0;
+    tick_count = 0;
+    processed_ticks = 0;
+    active_timer_count = 0;
+    current_task = TASK_NONE;
+}
+
+void Scheduler_Set_Idle_Task(void (*task)(void))
+{
+    idle_task = task;
+}
+
+void Scheduler_Add_Task(uint8_t task_id, Scheduler_Task_Handler handler)
+{
+    if (task_id < TASK_COUNT)
+    {
+        task_handlers[task_id] = handler;
+        Scheduler_Post(task_id, SIGNAL_INIT, 0);
+    }
+}
+
+uint8_t Scheduler_Post(uint8_t task_id, uint8_t signal, uint16_t param)
+{
+    uint8_t queued = 0;
+
+    // Disable interrupts while the queue is updated since events can be
+    // posted from several interrupt priority levels
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint8_t next_head = (event_queue_head + 1) & SCHEDULER_EVENT_QUEUE_MASK;
+
+    if (next_head != event_queue_tail)
+    {
+        event_queue[event_queue_head].task_id = task_id;
+        event_queue[event_queue_head].signal = signal;
+        event_queue[event_queue_head].param = param;
+        event_queue_head = next_head;
+        queued = 1;
+    }
+
+    __set_PRIMASK(primask);
+
+    return queued;
+}
+
+void Scheduler_Timer_Start(Scheduler_Timer *timer, uint8_t task_id, uint8_t signal, uint32_t delay_ms, uint32_t period_ms)
+{
+    if (timer->active)
+    {
+        Scheduler_Remove_Timer(timer);
+    }
+    else
+    {
+        active_timer_count++;
+    }
+
+    // A timer always expires on a future tick
+    if (delay_ms == 0)
+    {
+        delay_ms = 1;
+    }
+
+    timer->task_id = task_id;
+    timer->signal = signal;
+    timer->period_ms = period_ms;
+    timer->expiry_tick = processed_ticks + (delay_ms / SCHEDULER_TICK_MS);
+    timer->active = 1;
+
+    Scheduler_Insert_Timer(timer);
+}
+
+void Scheduler_Timer_Stop(Scheduler_Timer *timer)
+{
+    if (timer->active)
+    {
+        Scheduler_Remove_Timer(timer);
+        timer->active = 0;
+        active_timer_count--;
+    }
+}
+
+uint8_t Scheduler_Timer_Active(const Scheduler_Timer *timer)
+{
+    return timer->active;
+}
+
+uint8_t Scheduler_Get_Active_Timer_Count(void)
+{
+    return active_timer_count;
+}
+
+uint32_t Scheduler_Get_Idle_Ticks(void)
+{
+    uint32_t idle_ticks = SCHEDULER_NO_DEADLINE;
+
+    // Every processed tick has been seen by the wheel, so each timer expires after processed_ticks
+    for (int slot = 0; slot < SCHEDULER_TIMER_WHEEL_SIZE; slot++)
+    {
+        for (Scheduler_Timer *timer = timer_wheel[slot]; timer != 0; timer = timer->next)
+        {
+            uint32_t ticks = timer->expiry_tick - processed_ticks;
+
+            if (ticks < idle_ticks)
+            {
+                idle_ticks = ticks;
+            }
+        }
+    }
+
+    return idle_ticks;
+}
+
+uint8_t Scheduler_Is_Idle(void)
+{
+    return ((event_queue_tail == event_queue_head) && (processed_ticks == tick_count)) ? 1 : 0;
+}
+
+uint32_t Scheduler_Get_Ticks(void)
+{
+    return processed_ticks;
+}
+
+uint8_t Scheduler_Get_Current_Task(void)
+{
+    return current_task;
+}
+
+void Scheduler_Tick(void)
+{
+    tick_count = tick_count + 1;
+}
+
+uint8_t Scheduler_Run_Once(void)
+{
+    // Process the timer wheel for every tick counted since the last call
+    while (processed_ticks != tick_count)
+    {
+        processed_ticks = processed_ticks + 1;
+        Scheduler_Process_Timer_Slot(processed_ticks);
+    }
+
+    // The scheduler is the only reader of the event queue
+    if (event_queue_tail == event_queue_head)
+    {
+        return 0;
+    }
+
+    Scheduler_Event event = event_queue[event_queue_tail];
+    event_queue_tail = (event_queue_tail + 1) & SCHEDULER_EVENT_QUEUE_MASK;
+
+    if ((event.task_id < TASK_COUNT) && (task_handlers[event.task_id] != 0))
+    {
+        current_task = event.task_id;
+        PROFILE_BEGIN();
+        (*task_handlers[event.task_id])(&event);
+        PROFILE_END(PROFILE_PROBE_TASK_FIRST + event.task_id);
+        current_task = TASK_NONE;
+    }
+
+    return 1;
+}
+
+void Scheduler_Run(void)
+{
+    while (1)
+    {
+        if (!Scheduler_Run_Once() && (idle_task != 0))
+        {
+            (*idle_task)();
+        }
+    }
+}
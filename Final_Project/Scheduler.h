@@ -0,0 +1,321 @@
+/**
+ * @file Scheduler.h
+ *
+ * @brief Header file for the cooperative Scheduler.
+ *
+ * This file contains the function definitions for the cooperative, run-to-completion
+ * task scheduler used by the Home Security System. It provides:
+ * - A fixed table of tasks, each with an event handler.
+ * - An event queue that can be posted to from both tasks and interrupt service routines.
+ * - Software timers kept in a timer wheel that is advanced by the Timer 0A tick (1 ms).
+ *
+ * Task handlers must run to completion and return quickly. Work that has to wait
+ * is split into states and resumed by a timer or by another event.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "TM4C123GH6PM.h"
+
+// Scheduler tick period in milliseconds (Timer 0A interrupt)
+#define SCHEDULER_TICK_MS               1
+
+// Size of the event queue (must be a power of two)
+#define SCHEDULER_EVENT_QUEUE_SIZE      32
+
+// Number of slots in the timer wheel (must be a power of two)
+#define SCHEDULER_TIMER_WHEEL_SIZE      32
+
+/**
+ * @brief Task identifiers.
+ *
+ * Each task has one handler. Events and timers are addressed to a task by its identifier.
+ */
+enum Task_IDs
+{
+    TASK_MENU           = 0,
+    TASK_SECURITY       = 1,
+    TASK_SENSOR         = 2,
+    TASK_ALARM          = 3,
+    TASK_DISPLAY        = 4,
+    TASK_RANGING        = 5,
+    TASK_CODE_ENTRY     = 6,
+    TASK_SYSTEM_STATE   = 7,
+    TASK_EVENT_LOG      = 8,
+    TASK_TELEMETRY      = 9,
+    TASK_BENCHMARK      = 10,
+    TASK_SUPERVISOR     = 11,
+    TASK_CONFIG         = 12,
+    TASK_COUNT
+};
+
+// Returned instead of a task identifier when no task applies
+#define TASK_NONE                       0xFF
+
+// Returned by Scheduler_Get_Idle_Ticks when no timer is running
+#define SCHEDULER_NO_DEADLINE           0xFFFFFFFF
+
+/**
+ * @brief Event signals delivered to task handlers.
+ */
+enum Event_Signals
+{
+    SIGNAL_INIT             = 0x00,
+    SIGNAL_BUTTON_EVENT     = 0x01,
+    SIGNAL_ARM_REQUEST      = 0x02,
+    SIGNAL_DISARM_REQUEST   = 0x03,
+    SIGNAL_PANIC_REQUEST    = 0x04,
+    SIGNAL_INTRUSION        = 0x05,
+    SIGNAL_SENSOR_START     = 0x06,
+    SIGNAL_SENSOR_STOP      = 0x07,
+    SIGNAL_RANGE_FRAME      = 0x08,
+    SIGNAL_ALARM_START      = 0x09,
+    SIGNAL_ALARM_STOP       = 0x0A,
+    SIGNAL_ALARM_STEP       = 0x0B,
+    SIGNAL_ALARM_DONE       = 0x0C,
+    SIGNAL_DISPLAY_MENU     = 0x0D,
+    SIGNAL_DISPLAY_TIMEOUT  = 0x0E,
+    SIGNAL_RANGE_TRIGGER    = 0x0F,
+    SIGNAL_RANGE_TIMEOUT    = 0x10,
+    SIGNAL_CODE_TIMEOUT     = 0x11,
+    SIGNAL_CODE_LOCKOUT_END = 0x12,
+    SIGNAL_CODE_ACCEPTED    = 0x13,
+    SIGNAL_CODE_REJECTED    = 0x14,
+    SIGNAL_STATE_EVENT      = 0x15,
+    SIGNAL_STATE_TIMEOUT    = 0x16,
+    SIGNAL_LOG_APPEND       = 0x17,
+    SIGNAL_LOG_COMMIT       = 0x18,
+    SIGNAL_LOG_POLL         = 0x19,
+    SIGNAL_TELEMETRY_RX     = 0x1A,
+    SIGNAL_TELEMETRY_STATUS = 0x1B,
+    SIGNAL_TELEMETRY_DUMP   = 0x1C,
+    SIGNAL_BENCH_STEP       = 0x1D,
+    SIGNAL_BENCH_DONE       = 0x1E,
+    SIGNAL_SENSOR_POLL      = 0x1F,
+    SIGNAL_SENSOR_EDGE      = 0x20,
+    SIGNAL_SUPERVISOR_CHECK = 0x21,
+    SIGNAL_SUPERVISOR_PING  = 0x22,
+    SIGNAL_STATE_RESTORE    = 0x23,
+    SIGNAL_CONFIG_SAVE      = 0x24,
+    SIGNAL_CONFIG_POLL      = 0x25
+};
+
+/**
+ * @brief An event delivered to a task handler.
+ *
+ * The param field carries a small signal-specific value (for example, a distance).
+ */
+typedef struct
+{
+    uint8_t task_id;
+    uint8_t signal;
+    uint16_t param;
+} Scheduler_Event;
+
+/**
+ * @brief Event handler of a task.
+ */
+typedef void (*Scheduler_Task_Handler)(const Scheduler_Event *event);
+
+/**
+ * @brief Software timer kept in the timer wheel.
+ *
+ * Timers are declared statically by the module that owns them. When a timer expires,
+ * an event with the timer's signal is posted to the timer's task. A timer with a
+ * non-zero period is automatically restarted.
+ */
+typedef struct Scheduler_Timer
+{
+    struct Scheduler_Timer *next;
+    uint32_t expiry_tick;
+    uint32_t period_ms;
+    uint8_t task_id;
+    uint8_t signal;
+    uint8_t active;
+} Scheduler_Timer;
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * This function clears the task table, the event queue, and the timer wheel.
+ * It must be called before any task is added or any event is posted.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Init(void);
+
+/**
+ * @brief Registers the task executed by Scheduler_Run when there is no event to dispatch.
+ *
+ * The idle task is typically used to put the processor to sleep. It must check
+ * Scheduler_Is_Idle with interrupts disabled before it waits for an interrupt.
+ *
+ * @param task A pointer to the idle task, or 0 to busy-wait.
+ *
+ * @return None
+ */
+void Scheduler_Set_Idle_Task(void (*task)(void));
+
+/**
+ * @brief Registers the handler of a task.
+ *
+ * A SIGNAL_INIT event is posted to the task after it is added.
+ *
+ * @param task_id The identifier of the task (see Task_IDs).
+ *
+ * @param handler A pointer to the event handler of the task.
+ *
+ * @return None
+ */
+void Scheduler_Add_Task(uint8_t task_id, Scheduler_Task_Handler handler);
+
+/**
+ * @brief Posts an event to a task.
+ *
+ * This function can be called from tasks and from interrupt service routines.
+ * The event is handled the next time the scheduler dispatches events.
+ *
+ * @param task_id The identifier of the receiving task.
+ *
+ * @param signal The signal of the event (see Event_Signals).
+ *
+ * @param param A signal-specific parameter.
+ *
+ * @return uint8_t Returns 1 if the event was queued, or 0 if the event queue is full.
+ */
+uint8_t Scheduler_Post(uint8_t task_id, uint8_t signal, uint16_t param);
+
+/**
+ * @brief Starts a software timer.
+ *
+ * If the timer is already running, it is restarted with the new delay and period.
+ * This function must only be called from task context.
+ *
+ * @param timer A pointer to the timer to start.
+ *
+ * @param task_id The identifier of the task that receives the timer event.
+ *
+ * @param signal The signal of the timer event.
+ *
+ * @param delay_ms The delay before the first expiry in milliseconds (minimum 1 ms).
+ *
+ * @param period_ms The period of the timer in milliseconds, or 0 for a one-shot timer.
+ *
+ * @return None
+ */
+void Scheduler_Timer_Start(Scheduler_Timer *timer, uint8_t task_id, uint8_t signal, uint32_t delay_ms, uint32_t period_ms);
+
+/**
+ * @brief Stops a software timer.
+ *
+ * The timer does not post any new event after this function returns. An event that
+ * was already queued may still be delivered, so handlers should check their own state.
+ * This function must only be called from task context.
+ *
+ * @param timer A pointer to the timer to stop.
+ *
+ * @return None
+ */
+void Scheduler_Timer_Stop(Scheduler_Timer *timer);
+
+/**
+ * @brief Checks if a software timer is running.
+ *
+ * @param timer A pointer to the timer.
+ *
+ * @return uint8_t Returns 1 if the timer is running. Otherwise, it returns 0.
+ */
+uint8_t Scheduler_Timer_Active(const Scheduler_Timer *timer);
+
+/**
+ * @brief Returns the number of software timers that are running.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of running timers.
+ */
+uint8_t Scheduler_Get_Active_Timer_Count(void);
+
+/**
+ * @brief Returns the number of ticks until the first running timer expires.
+ *
+ * The idle task uses it to skip the ticks in which no timer expires (see Power.h).
+ * It must be called from the idle task while Scheduler_Is_Idle returns 1.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of ticks, or SCHEDULER_NO_DEADLINE if no timer is running.
+ */
+uint32_t Scheduler_Get_Idle_Ticks(void);
+
+/**
+ * @brief Indicates whether the scheduler has nothing to do.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the event queue is empty and every tick has been processed. Otherwise, it returns 0.
+ */
+uint8_t Scheduler_Is_Idle(void);
+
+/**
+ * @brief Returns the number of scheduler ticks since the scheduler was started.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of ticks (1 ms each).
+ */
+uint32_t Scheduler_Get_Ticks(void);
+
+/**
+ * @brief Returns the task whose handler is running.
+ *
+ * This function can be called from interrupt service routines, for example to find
+ * the task that an interrupt has preempted.
+ *
+ * @param None
+ *
+ * @return uint8_t The identifier of the running task, or TASK_NONE between dispatches.
+ */
+uint8_t Scheduler_Get_Current_Task(void);
+
+/**
+ * @brief Advances the scheduler by one tick.
+ *
+ * This function is called from the Timer 0A interrupt service routine (System_Tick in main.c)
+ * every 1 ms. It only counts the tick; expired timers
+ * are processed from Scheduler_Run.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Tick(void);
+
+/**
+ * @brief Processes pending ticks and dispatches one event.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if an event was dispatched, or 0 if the scheduler was idle.
+ */
+uint8_t Scheduler_Run_Once(void);
+
+/**
+ * @brief Runs the scheduler forever.
+ *
+ * This function never returns. It repeatedly processes expired timers and
+ * dispatches queued events to the task handlers. When there is no event to
+ * dispatch, the idle task is executed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Run(void);
+
+#endif
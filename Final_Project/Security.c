@@ -5,11 +5,16 @@
  *
  * This file contains the primary logic for the security system, including:
  * - Monitoring the armed/disarmed state.
- * - Interfacing with the US-100 Ultrasonic Distance Sensor to detect intrusions.
+ * - Checking the samples of the sensors of each zone (see Sensor.h) for intrusions.
  * - Triggering alerts through LEDs, the buzzer, and the LCD.
+ * - Showing the state of the system with LED patterns played in the background.
  *
  * The system continuously monitors for intrusions while armed and activates 
- * an alert if an object is detected within a predefined distance threshold.
+ * an alert if an object is detected within the distance threshold of its zone (see Config.h).
+ *
+ * Each part of the system runs as a cooperative task on the Scheduler. None of
+ * the task handlers block: waiting is done with scheduler timers, so button
+ * presses and sensor readings are still handled while an alarm is running.
  *
  * Key features:
  * - User interaction via buttons to arm/disarm the system.
@@ -24,147 +29,586 @@
 
 #include "TM4C123GH6PM.h"
 #include "Buzzer.h"
-#include "SysTick_Delay.h"
-#include "EduBase_LCD.h"
-#include "Timer_0A_Interrupt.h"
+#include "LED_Pattern.h"
+#include "LCD_Framebuffer.h"
 #include "GPIO.h"
 #include "stdio.h"
 #include "Security.h"
-#include "UART1.h"
-
-// Global state variables
-static uint8_t system_armed = 0; // 0 = Disarmed, 1 = Armed
-static uint8_t alert_active = 0; // 0 = No alert, 1 = Alert triggered
+#include "Scheduler.h"
+#include "Ranging.h"
+#include "Sensor.h"
+#include "Zone.h"
+#include "Event_Log.h"
+#include "Code_Entry.h"
+#include "System_State.h"
+#include "Supervisor.h"
+#include "Benchmark.h"
+#include "Config.h"
 
 // Constants for the buzzer state
 extern const uint8_t BUZZER_OFF;
 extern const uint8_t BUZZER_ON;
 
+// Buzzer patterns played in the background by the buzzer sequencer
+// One siren cycle lasts two alarm steps, matching the LED pattern
+// The notes and the durations are set from the configuration when the siren starts
+static Buzzer_Step siren_pattern[] =
+{
+    { NOTE_A4, 115 }, { NOTE_REST, 135 },
+    { NOTE_G4, 130 }, { NOTE_REST, 120 }
+};
+
+static const Buzzer_Step arm_chirp_pattern[] =
+{
+    { NOTE_C5, 60 }, { NOTE_REST, 40 }, { NOTE_G5, 60 }
+};
+
+static const Buzzer_Step disarm_chirp_pattern[] =
+{
+    { NOTE_G5, 60 }, { NOTE_REST, 40 }, { NOTE_C5, 60 }
+};
+
+// Repeated once per second during the entry delay
+static const Buzzer_Step entry_warning_pattern[] =
+{
+    { NOTE_C6, 80 }, { NOTE_REST, 920 }
+};
+
+#define PATTERN_LENGTH(pattern) ((uint8_t)(sizeof(pattern) / sizeof((pattern)[0])))
+
+// Share of an alarm step during which each note of the siren sounds (in 1/250)
+#define SIREN_HIGH_NOTE_SHARE       115
+#define SIREN_LOW_NOTE_SHARE        130
+
+// LED patterns played in the background by the LED pattern engine
+// Exit delay: chase across the EduBase LEDs with the RGB LED blue
+static const LED_Step exit_delay_led_pattern[] =
+{
+    { 0x01, LED_COLOR_BLUE, 255, 0, 125 }, { 0x02, LED_COLOR_BLUE, 255, 0, 125 },
+    { 0x04, LED_COLOR_BLUE, 255, 0, 125 }, { 0x08, LED_COLOR_BLUE, 255, 0, 125 }
+};
+
+// Armed: short breath of the RGB LED in red, every 3 seconds
+// The RGB LED is off for most of the pattern, so the processor can stay in deep-sleep mode (see Power.h)
+static const LED_Step armed_led_pattern[] =
+{
+    { 0x00, LED_COLOR_RED, 160, LED_STEP_RAMP, 80 },
+    { 0x00, LED_COLOR_RED, 0, LED_STEP_RAMP, 80 },
+    { 0x00, LED_COLOR_OFF, 0, 0, 2840 }
+};
+
+// Entry delay: the EduBase LEDs blink with the warning beep and the RGB LED stays red
+static const LED_Step entry_delay_led_pattern[] =
+{
+    { 0x0F, LED_COLOR_RED, 255, 0, 80 }, { 0x00, LED_COLOR_RED, 255, 0, 920 }
+};
+
+// Alarm: every LED flashes with the siren, two alarm steps per cycle (set from the configuration)
+static LED_Step alarm_led_pattern[] =
+{
+    { 0x0F, LED_COLOR_RED, 255, 0, 250 }, { 0x00, LED_COLOR_BLUE, 255, 0, 250 }
+};
+
+// Color of the status code of a sensor fault (the code is the zone number plus one)
+#define SENSOR_FAULT_LED_COLOR      LED_COLOR_YELLOW
+
+// Backend used to read the US-100 (RANGING_BACKEND_UART or RANGING_BACKEND_ECHO)
+// The mode jumper of the US-100 must be installed for the UART backend and removed for the echo backend
+#define SENSOR_BACKEND              RANGING_BACKEND_UART
+
+// Scheduler timers used by the security tasks
+static Scheduler_Timer alarm_timer;
+static Scheduler_Timer display_timer;
+
+// Set once the siren and the LED pattern of the alarm are playing
+static uint8_t alarm_sounding = 0;
+
+// Set when the US-100 did not reply to the last command of Get_Distance
+static uint8_t sensor_fault = 0;
+
+// Zone of the intrusion that started the entry delay (ZONE_NONE for a panic alarm)
+static uint8_t intrusion_zone = ZONE_NONE;
+
+// Zone whose sensor fault is shown by the LEDs while armed (ZONE_NONE if there is none)
+static uint8_t fault_led_zone = ZONE_NONE;
+
+static void Disarmed_Entry(uint8_t previous_state);
+static void Exit_Delay_Entry(uint8_t previous_state);
+static void Armed_Entry(uint8_t previous_state);
+static void Entry_Delay_Entry(uint8_t previous_state);
+static void Entry_Delay_Exit(uint8_t next_state);
+static void Alarm_Entry(uint8_t previous_state);
+static void Alarm_Exit(uint8_t next_state);
+static void Security_State_Changed(uint8_t previous_state, uint8_t next_state);
+static void Security_Restore_State(void);
+
+// Entry and exit actions of the system states
+static const System_State_Actions state_actions[SYSTEM_STATE_COUNT] =
+{
+    [SYSTEM_STATE_DISARMED]     = { Disarmed_Entry, 0 },
+    [SYSTEM_STATE_EXIT_DELAY]   = { Exit_Delay_Entry, 0 },
+    [SYSTEM_STATE_ARMED]        = { Armed_Entry, 0 },
+    [SYSTEM_STATE_ENTRY_DELAY]  = { Entry_Delay_Entry, Entry_Delay_Exit },
+    [SYSTEM_STATE_ALARM]        = { Alarm_Entry, Alarm_Exit },
+    [SYSTEM_STATE_LOCKOUT]      = { 0, 0 }
+};
+
+void Security_Init(void)
+{
+    System_State_Init(state_actions);
+
+    Scheduler_Add_Task(TASK_SECURITY, Security_Task);
+    Scheduler_Add_Task(TASK_ALARM, Alarm_Task);
+    Scheduler_Add_Task(TASK_DISPLAY, Display_Task);
+    Supervisor_Monitor(TASK_SECURITY);
+    Supervisor_Monitor(TASK_ALARM);
+
+    // Bring up the ranging engine, then the sensors of the zones, and receive every new sample
+    Ranging_Init();
+    Ranging_Set_Backend(SENSOR_BACKEND);
+    Zone_Init();
+    if (!Sensor_Subscribe(&Sensor_Sample_Received))
+    {
+        Supervisor_Registration_Failed(TASK_SECURITY);
+    }
+
+    // Save every state, and resume the state from before a reset so that a reset does not disarm the system
+    if (!System_State_Add_Observer(&Security_State_Changed))
+    {
+        Supervisor_Registration_Failed(TASK_SECURITY);
+    }
+
+    Security_Restore_State();
+}
+
 /**
- * @brief Monitors the system while it is armed and triggers an alert if necessary.
+ * @brief Saves each new state in the recovery record of the supervisor.
  *
- * Continuously checks the distance from the sensor. If the distance falls within 
- * the intrusion limit, it triggers the alert sequence. Returns to the main menu 
- * if the system is disarmed.
+ * @param previous_state The state that was left.
+ * @param next_state The state that is entered.
  */
-void System_Armed(void)
+static void Security_State_Changed(uint8_t previous_state, uint8_t next_state)
 {
-    alert_active = 0;
+    uint8_t zone = ((next_state == SYSTEM_STATE_ENTRY_DELAY) || (next_state == SYSTEM_STATE_ALARM)) ? intrusion_zone : ZONE_NONE;
 
-    while (system_armed && !alert_active)
-    {
-        // Get the distance from the sensor
-        uint16_t distance = Get_Distance();
+    Supervisor_Save_State(next_state, zone);
+}
 
-        // Check if the object is within the threshold
-        if (distance > 0 && distance <= 50) // Threshold of 50 cm
-        {
-            alert_active = 1;
-            Intruder_Alert(); // Trigger the alert
-        }
+/**
+ * @brief Enters the armed state that was saved before the last reset again.
+ *
+ * A lockout is not restored, since the lockout timer of the code entry does not survive the reset.
+ */
+static void Security_Restore_State(void)
+{
+    uint8_t state;
+    uint8_t zone;
 
-        // Add a delay to stabilize sensor readings
-        SysTick_Delay1ms(100);
+    if (!Supervisor_Get_Saved_State(&state, &zone))
+    {
+        return;
     }
 
-    if (!system_armed)
+    if ((state == SYSTEM_STATE_DISARMED) || (state == SYSTEM_STATE_LOCKOUT) || (state >= SYSTEM_STATE_COUNT))
     {
-        Display_Main_Menu(); // Return to the main menu when disarmed
+        return;
+    }
+
+    intrusion_zone = zone;
+    System_State_Restore(state);
+}
+
+/**
+ * @brief Forwards requests and sensor events to the system state machine.
+ *
+ * The state machine decides what each event does in the current state. Only the
+ * result of a rejected code is handled here, since it does not change the state.
+ */
+void Security_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_ARM_REQUEST:
+            System_State_Post(SYSTEM_EVENT_ARM);
+            break;
+
+        case SIGNAL_DISARM_REQUEST:
+            System_State_Post(SYSTEM_EVENT_DISARM);
+            break;
+
+        case SIGNAL_CODE_ACCEPTED:
+            System_State_Post(SYSTEM_EVENT_CODE_VALID);             // Arms when disarmed and disarms otherwise
+            break;
+
+        case SIGNAL_INTRUSION:
+            // The parameter holds the zone of the intrusion
+            if (System_State_Get() == SYSTEM_STATE_ARMED) {
+                intrusion_zone = (uint8_t)event->param;
+                Event_Log_Append(EVENT_LOG_INTRUSION, intrusion_zone);
+            }
+            System_State_Post(SYSTEM_EVENT_INTRUSION);
+            break;
+
+        case SIGNAL_PANIC_REQUEST:
+            Event_Log_Append(EVENT_LOG_PANIC, 0);
+            System_State_Post(SYSTEM_EVENT_PANIC);
+            break;
+
+        case SIGNAL_ALARM_DONE:
+            System_State_Post(SYSTEM_EVENT_ALARM_DONE);
+            break;
+
+        case SIGNAL_SUPERVISOR_PING:
+            Supervisor_Check_In(TASK_SECURITY);
+            break;
+
+        case SIGNAL_CODE_REJECTED:
+            Event_Log_Append(EVENT_LOG_CODE_REJECTED, (event->param > 0xFF) ? 0xFF : (uint8_t)event->param);
+            if (System_State_Get() != SYSTEM_STATE_ALARM) {
+                if (event->param > 0) {
+                    uint8_t col;
+                    Display_Status("Locked Out");                   // Display the lockout message
+                    col = LCD_Framebuffer_Write_String(0, 1, "Wait ");
+                    col = LCD_Framebuffer_Write_Integer(col, 1, event->param);
+                    LCD_Framebuffer_Write_String(col, 1, " s");     // Display the lockout in seconds
+                } else {
+                    Display_Status("Wrong Code");                   // Display wrong code message
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Stops the sensor and any alarm in progress when the system is disarmed.
+ *
+ * @param previous_state The state that was left.
+ */
+static void Disarmed_Entry(uint8_t previous_state)
+{
+    Scheduler_Post(TASK_SENSOR, SIGNAL_SENSOR_STOP, 0);
+    LED_Pattern_Stop();
+
+    if (previous_state == SYSTEM_STATE_LOCKOUT) {
+        Display_Main_Menu();                                        // Code entry is available again
+        return;
+    }
+
+    if (previous_state != SYSTEM_STATE_ALARM) {
+        Buzzer_Play_Pattern(disarm_chirp_pattern, PATTERN_LENGTH(disarm_chirp_pattern), 1);
+    }
+
+    Display_Status("System Disarmed");                              // Display disarmed message
+}
+
+/**
+ * @brief Gives the user SYSTEM_STATE_EXIT_DELAY_MS to leave after arming.
+ *
+ * @param previous_state The state that was left.
+ */
+static void Exit_Delay_Entry(uint8_t previous_state)
+{
+    Buzzer_Play_Pattern(arm_chirp_pattern, PATTERN_LENGTH(arm_chirp_pattern), 1);
+    LED_Pattern_Play(exit_delay_led_pattern, PATTERN_LENGTH(exit_delay_led_pattern), 0);
+    Display_Status("Exit Delay");                                   // Display exit delay message
+}
+
+/**
+ * @brief Starts scanning for intrusions once the exit delay has elapsed.
+ *
+ * @param previous_state The state that was left.
+ */
+static void Armed_Entry(uint8_t previous_state)
+{
+    // Do not carry samples over from the previous time the system was armed
+    Zone_Reset();
+    Scheduler_Post(TASK_SENSOR, SIGNAL_SENSOR_START, 0);
+    fault_led_zone = ZONE_NONE;
+    LED_Pattern_Play(armed_led_pattern, PATTERN_LENGTH(armed_led_pattern), 0);
+    Display_Status("System Armed");                                 // Display armed message
+}
+
+/**
+ * @brief Gives the user SYSTEM_STATE_ENTRY_DELAY_MS to enter the code after an intrusion.
+ *
+ * @param previous_state The state that was left.
+ */
+static void Entry_Delay_Entry(uint8_t previous_state)
+{
+    Buzzer_Play_Pattern(entry_warning_pattern, PATTERN_LENGTH(entry_warning_pattern), 0);
+    LED_Pattern_Play(entry_delay_led_pattern, PATTERN_LENGTH(entry_delay_led_pattern), 0);
+    Benchmark_Mark(BENCHMARK_STAGE_ACTUATOR);                       // The first output after an intrusion
+    Display_Status("Entry Delay");                                  // Display entry delay message
+    LCD_Framebuffer_Write_Line(1, Zone_Get_Name(intrusion_zone));   // Display the zone of the intrusion
+}
+
+/**
+ * @brief Stops the entry delay warning.
+ *
+ * @param next_state The state that is entered.
+ */
+static void Entry_Delay_Exit(uint8_t next_state)
+{
+    Buzzer_Stop();
+    LED_Pattern_Stop();
+}
+
+/**
+ * @brief Starts the intruder alert.
+ *
+ * @param previous_state The state that was left.
+ */
+static void Alarm_Entry(uint8_t previous_state)
+{
+    // Only an alarm that follows the entry delay belongs to a zone
+    if (previous_state != SYSTEM_STATE_ENTRY_DELAY) {
+        intrusion_zone = ZONE_NONE;
     }
+
+    Intruder_Alert();
+}
+
+/**
+ * @brief Silences the alarm in progress.
+ *
+ * @param next_state The state that is entered.
+ */
+static void Alarm_Exit(uint8_t next_state)
+{
+    Scheduler_Post(TASK_ALARM, SIGNAL_ALARM_STOP, 0);
 }
 
-#define READ_DISTANCE 0x55 // Command to read distance from US-100
+/**
+ * @brief Checks each new sensor sample for an intrusion.
+ *
+ * Each sample is passed through the intrusion filter of its sensor and the fusion of
+ * its zone. When the zone confirms an intrusion, an intrusion event is posted to the
+ * security task with the zone. A sensor that stops replying is reported on the LCD
+ * with the name of its zone.
+ *
+ * @param sample A pointer to the new sample.
+ */
+void Sensor_Sample_Received(const Sensor_Sample *sample)
+{
+    // Samples are only checked while the system is armed and no intrusion is pending
+    if (System_State_Get() != SYSTEM_STATE_ARMED)
+    {
+        return;
+    }
+
+    uint8_t zone;
+
+    switch (Zone_Update(sample, &zone))
+    {
+        case ZONE_EVENT_DETECTED:
+            // The sensors of the zone confirm an object within the threshold, approaching it, or moving
+            Benchmark_Mark(BENCHMARK_STAGE_DECISION);
+            Scheduler_Post(TASK_SECURITY, SIGNAL_INTRUSION, zone);
+            break;
+
+        case ZONE_EVENT_FAULT:
+            // Report a sensor that stopped responding instead of waiting for it
+            Event_Log_Append(EVENT_LOG_SENSOR_FAULT, zone);
+            fault_led_zone = zone;
+            LED_Pattern_Show_Code(SENSOR_FAULT_LED_COLOR, zone + 1);
+            Display_Status("Sensor Error");
+            LCD_Framebuffer_Write_Line(1, Zone_Get_Name(zone));
+            break;
+
+        default:
+            break;
+    }
+
+    // Return to the armed pattern once the faulty sensor replies again
+    if ((fault_led_zone != ZONE_NONE) && !Zone_Has_Fault(fault_led_zone))
+    {
+        fault_led_zone = ZONE_NONE;
+        LED_Pattern_Play(armed_led_pattern, PATTERN_LENGTH(armed_led_pattern), 0);
+    }
+}
 
 /**
  * @brief Retrieves the distance measured by the US-100 sensor.
  *
- * Sends a command to the US-100 sensor and reads the response, which includes
- * the high and low bytes of the distance measurement.
+ * While the ranging engine is running, the most recent sample is returned without
+ * waiting. Otherwise, one measurement is taken with the selected backend (SENSOR_BACKEND)
+ * and its result is awaited for at most RANGING_REPLY_TIMEOUT_MS. If the sensor does
+ * not reply in time, the sensor fault flag is set and 0 is returned.
  *
- * @return uint16_t The measured distance in millimeters.
+ * @return uint16_t The measured distance in millimeters, or 0 if no reading is available.
  */
 uint16_t Get_Distance(void)
 {
-    // Send the "read distance" command (0x55)
-    UART1_Output_Character(READ_DISTANCE);
+    Range_Sample sample;
 
-    // Receive the high and low bytes from the sensor
-    uint8_t high_byte = UART1_Input_Character();
-    uint8_t low_byte = UART1_Input_Character();
+    // The ranging engine owns the sensor while it is running
+    if (Ranging_Is_Running())
+    {
+        if (Ranging_Get_Latest(&sample) && (sample.status == RANGE_STATUS_OK))
+        {
+            return sample.distance_mm;
+        }
 
-    // Combine the bytes to form the distance value
-    uint16_t distance = (high_byte << 8) | low_byte;
+        return 0;
+    }
 
-    // Return the calculated distance
-    return distance;
+    Ranging_Read_Single(&sample);
+
+    sensor_fault = (sample.status == RANGE_STATUS_TIMEOUT) ? 1 : 0;
+
+    // Return the measured distance
+    return sample.distance_mm;
+}
+
+uint8_t Sensor_Fault_Detected(void)
+{
+    return sensor_fault;
 }
 
 /**
  * @brief Displays the main menu on the LCD.
  *
- * Shows the options to arm or disarm the system on the EduBase LCD.
+ * Prompts for the security code and shows whether it arms or disarms the system.
  */
 void Display_Main_Menu(void)
 {
-    // Clear the LCD before displaying new content
-    EduBase_LCD_Clear_Display();
-    
-    // Display "Arm System" on the first row
-    EduBase_LCD_Set_Cursor(0, 0);
-    EduBase_LCD_Display_String("Arm System");
+    // A pending status message timeout is no longer needed
+    Scheduler_Timer_Stop(&display_timer);
 
-    // Display "Disarm System" on the second row
-    EduBase_LCD_Set_Cursor(0, 1);
-    EduBase_LCD_Display_String("Disarm System");
+    // Display the action that the next valid code performs
+    LCD_Framebuffer_Write_Line(0, "Enter Code to");
+    LCD_Framebuffer_Write_Line(1, System_State_Is_Armed() ? "Disarm System" : "Arm System");
 }
 
 /**
- * @brief Triggers the intruder alert sequence.
+ * @brief Starts the intruder alert sequence.
  *
- * Activates the LEDs, sounds the buzzer, and displays a warning message on the LCD.
- * Resets the system state after the alert sequence ends.
+ * Displays a warning message on the LCD and starts the alarm task, which
+ * flashes the LEDs and sounds the buzzer in the background.
  */
 void Intruder_Alert(void)
 {
-    // Display the alert message
-    EduBase_LCD_Clear_Display();
-    EduBase_LCD_Set_Cursor(0, 0);
-    EduBase_LCD_Display_String("Intruder");
-    EduBase_LCD_Set_Cursor(0, 1);
-    EduBase_LCD_Display_String("Detected");
-    SysTick_Delay1ms(3000); // Display message for 3 seconds
+    // The alarm message replaces any status message
+    Scheduler_Timer_Stop(&display_timer);
+    Scheduler_Post(TASK_ALARM, SIGNAL_ALARM_START, 0);
+}
+
+// Flashes the LEDs and plays the siren in the background for the whole alarm sequence
+static void Alarm_Start_Sounding(void)
+{
+    uint16_t step_ms = Config_Get(CONFIG_PARAM_ALARM_STEP_MS);
+    uint8_t cycles = (uint8_t)Config_Get(CONFIG_PARAM_ALARM_CYCLES);
+
+    alarm_led_pattern[0].duration_ms = step_ms;
+    alarm_led_pattern[1].duration_ms = step_ms;
+
+    siren_pattern[0].note = (uint8_t)Config_Get(CONFIG_PARAM_SIREN_HIGH_NOTE);
+    siren_pattern[0].duration_ms = (uint16_t)(((uint32_t)step_ms * SIREN_HIGH_NOTE_SHARE) / 250);
+    siren_pattern[1].duration_ms = step_ms - siren_pattern[0].duration_ms;
+    siren_pattern[2].note = (uint8_t)Config_Get(CONFIG_PARAM_SIREN_LOW_NOTE);
+    siren_pattern[2].duration_ms = (uint16_t)(((uint32_t)step_ms * SIREN_LOW_NOTE_SHARE) / 250);
+    siren_pattern[3].duration_ms = step_ms - siren_pattern[2].duration_ms;
 
-    // Flash LEDs and sound buzzer
-    for (int i = 0; i < 10; i++) // Flash for 10 cycles
+    LED_Pattern_Play(alarm_led_pattern, PATTERN_LENGTH(alarm_led_pattern), cycles);
+    Buzzer_Play_Pattern(siren_pattern, PATTERN_LENGTH(siren_pattern), cycles);
+    Scheduler_Timer_Start(&alarm_timer, TASK_ALARM, SIGNAL_ALARM_STEP, (uint32_t)cycles * 2 * step_ms, 0);
+}
+
+/**
+ * @brief Runs the alarm pattern.
+ *
+ * Displays the alert message for CONFIG_PARAM_ALARM_MESSAGE_MS, then flashes the LEDs
+ * and alternates the buzzer tones for CONFIG_PARAM_ALARM_CYCLES cycles. The LED pattern
+ * engine and the buzzer sequencer play both in the background, and the alarm timer ends
+ * the sequence.
+ */
+void Alarm_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
     {
-        EduBase_LEDs_Output(EDUBASE_LED_ALL_ON); // Turn all LEDs on
-        Play_Note(A4_NOTE, 50);                  // Sound alert tone
-        SysTick_Delay1ms(250);
+        case SIGNAL_ALARM_START:
+            // Display the alert message
+            LCD_Framebuffer_Write_Line(0, "Intruder");
+            LCD_Framebuffer_Write_Line(1, (intrusion_zone != ZONE_NONE) ? Zone_Get_Name(intrusion_zone) : "Detected");
 
-        EduBase_LEDs_Output(EDUBASE_LED_ALL_OFF); // Turn all LEDs off
-        Play_Note(G4_NOTE, 50);                  // Sound alternate tone
-        SysTick_Delay1ms(250);
-    }
+            // Display the message before the siren starts
+            alarm_sounding = 0;
+            LED_Pattern_Stop();
+            Scheduler_Timer_Start(&alarm_timer, TASK_ALARM, SIGNAL_ALARM_STEP, Config_Get(CONFIG_PARAM_ALARM_MESSAGE_MS), 0);
+            break;
+
+        case SIGNAL_ALARM_STEP:
+            if ((System_State_Get() != SYSTEM_STATE_ALARM) || Scheduler_Timer_Active(&alarm_timer))
+            {
+                break;
+            }
+
+            if (!alarm_sounding)
+            {
+                Alarm_Start_Sounding();
+                Benchmark_Mark(BENCHMARK_STAGE_ACTUATOR);
+                alarm_sounding = 1;
+            }
+            else
+            {
+                // The alarm sequence is complete
+                LED_Pattern_Stop();                       // Turn off LEDs
+                Buzzer_Stop();                            // Turn off buzzer
+                Scheduler_Post(TASK_SECURITY, SIGNAL_ALARM_DONE, 0);
+            }
+            break;
+
+        case SIGNAL_ALARM_STOP:
+            Scheduler_Timer_Stop(&alarm_timer);
+            LED_Pattern_Stop();                           // Turn off LEDs
+            Buzzer_Stop();                                // Turn off buzzer
+            break;
+
+        case SIGNAL_SUPERVISOR_PING:
+            Supervisor_Check_In(TASK_ALARM);
+            break;
 
-    // Reset alert state and return to main menu
-    alert_active = 0;                     // Reset alert flag
-    system_armed = 0;                     // Disarm the system
-    EduBase_LEDs_Output(EDUBASE_LED_ALL_OFF); // Turn off LEDs
-    Buzzer_Output(BUZZER_OFF);            // Turn off buzzer
-    Display_Main_Menu();                  // Return to the main menu
+        default:
+            break;
+    }
 }
 
 /**
  * @brief Displays a custom status message on the LCD.
  *
- * Clears the LCD and displays the provided message for 3 seconds.
+ * Clears the LCD and displays the provided message. The display task returns
+ * to the main menu after CONFIG_PARAM_STATUS_MESSAGE_MS.
  *
  * @param message A pointer to the string containing the message to display.
  */
 void Display_Status(const char *message)
 {
-    EduBase_LCD_Clear_Display();
-    EduBase_LCD_Set_Cursor(0, 0);
-    EduBase_LCD_Display_String(message);
-    SysTick_Delay1ms(3000); // Delay to show the message for 3 seconds
+    LCD_Framebuffer_Write_Line(0, message);
+    LCD_Framebuffer_Write_Line(1, "");
+    Scheduler_Timer_Start(&display_timer, TASK_DISPLAY, SIGNAL_DISPLAY_TIMEOUT, Config_Get(CONFIG_PARAM_STATUS_MESSAGE_MS), 0);
+}
+
+/**
+ * @brief Updates the LCD in response to display events.
+ *
+ * The main menu is not drawn while the alarm owns the LCD or a code is being entered.
+ */
+void Display_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_DISPLAY_TIMEOUT:
+        case SIGNAL_DISPLAY_MENU:
+            if ((System_State_Get() != SYSTEM_STATE_ALARM) && !Code_Entry_Is_Active())
+            {
+                Display_Main_Menu();
+            }
+            break;
+
+        default:
+            break;
+    }
 }
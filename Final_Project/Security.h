@@ -4,7 +4,20 @@
  * @brief Header file for the Security driver.
  *
  * This file contains the function definitions for the Security driver, 
- * which manages the system's armed state and intrusion detection.
+ * which manages intrusion detection and the actions of the system states.
+ * The state itself is kept by the System_State module.
+ *
+ * The security logic runs as three cooperative tasks on the Scheduler:
+ * - TASK_SECURITY: Forwarding of requests and sensor events to the state machine
+ * - TASK_ALARM:    Alarm pattern (LEDs and buzzer)
+ * - TASK_DISPLAY:  Status message timeouts and main menu updates on the LCD
+ *
+ * The sensors of the zones are started and stopped through the sensor task
+ * (TASK_SENSOR, see Sensor.h) as the system is armed and disarmed.
+ *
+ * The security and alarm tasks are monitored by the supervisor (see Supervisor.h).
+ * Every state is saved in its recovery record, and an armed state saved before a reset
+ * is entered again at initialization, so a reset does not disarm the system.
  *
  * @author Adrian Solorzano 
  */
@@ -12,22 +25,73 @@
 #include "TM4C123GH6PM.h"
 #include "stdio.h"
 #include "UART1.h"
+#include "Scheduler.h"
+#include "Ranging.h"
+#include "Sensor.h"
+#include "Zone.h"
 
 /**
- * @brief Activates the system's armed state and continuously checks for intrusions.
+ * @brief Registers the security tasks with the scheduler.
  *
- * This function activates the security system. If an intrusion is detected 
- * based on the sensor's input, an alert is triggered.
+ * This function initializes the system state machine with the security actions,
+ * adds the security, alarm, and display tasks to the scheduler, and initializes
+ * the zones and their sensors. It must be called after Scheduler_Init and Supervisor_Init.
  *
  * @param None
  * @return None
  */
-void System_Armed(void);
+void Security_Init(void);
+
+/**
+ * @brief Event handler of the security task.
+ *
+ * Forwards arm, disarm, and panic requests, the results of code entry, and intrusion
+ * events from the sensor task to the system state machine. An accepted code disarms
+ * the system (and silences an alarm) when it is armed, and arms it otherwise.
+ *
+ * @param event A pointer to the event to handle.
+ * @return None
+ */
+void Security_Task(const Scheduler_Event *event);
+
+/**
+ * @brief Sensor subscriber that checks each new sample for an intrusion.
+ *
+ * An intrusion is reported to the security task when the sensors of a zone confirm it
+ * (see Zone.h) while the system is in SYSTEM_STATE_ARMED. The thresholds of each zone
+ * are changed with Zone_Set_Filter_Config.
+ *
+ * @param sample A pointer to the new sample.
+ * @return None
+ */
+void Sensor_Sample_Received(const Sensor_Sample *sample);
+
+/**
+ * @brief Event handler of the alarm task.
+ *
+ * Runs the alarm pattern (flashing LEDs) one step at a time. The siren is played
+ * in the background by the buzzer sequencer.
+ *
+ * @param event A pointer to the event to handle.
+ * @return None
+ */
+void Alarm_Task(const Scheduler_Event *event);
+
+/**
+ * @brief Event handler of the display task.
+ *
+ * Returns the LCD to the main menu when a status message times out.
+ *
+ * @param event A pointer to the event to handle.
+ * @return None
+ */
+void Display_Task(const Scheduler_Event *event);
 
 /**
- * @brief Triggers the alert mechanism during an intrusion.
+ * @brief Starts the alert mechanism during an intrusion.
  *
- * This function activates visual and audio signals to alert the user of an intrusion.
+ * This function displays the intruder message and starts the alarm task.
+ * It returns immediately; the visual and audio signals run in the background.
  *
  * @param None
  * @return None
@@ -37,7 +101,8 @@ void Intruder_Alert(void);
 /**
  * @brief Displays the main menu on the output interface.
  *
- * This function clears the current interface and displays the main menu options.
+ * This function clears the current interface and prompts for the security code,
+ * showing whether the code arms or disarms the system.
  *
  * @param None
  * @return None
@@ -48,7 +113,8 @@ void Display_Main_Menu(void);
  * @brief Displays a custom status message on the output interface.
  *
  * This function displays a given status message, which can be used to show 
- * the system state or specific alerts.
+ * the system state or specific alerts. The main menu is displayed again after CONFIG_PARAM_STATUS_MESSAGE_MS (see Config.h).
+ * The function returns immediately.
  *
  * @param message A string containing the message to display.
  * @return None
@@ -59,9 +125,19 @@ void Display_Status(const char *message);
  * @brief Retrieves the current distance from the ultrasonic sensor.
  *
  * This function communicates with the US-100 sensor to get the current distance 
- * in millimeters.
+ * in millimeters using either the UART or the echo backend of the ranging engine.
+ * While the ranging engine is running, the most recent sample is returned
+ * immediately. Otherwise, it waits at most 50 ms for the reply of the sensor.
+ *
+ * @param None
+ * @return uint16_t The measured distance in millimeters, or 0 if the sensor did not reply.
+ */
+uint16_t Get_Distance(void);
+
+/**
+ * @brief Indicates whether the ultrasonic sensor failed to reply to the last command.
  *
  * @param None
- * @return uint16_t The measured distance in millimeters.
+ * @return uint8_t Returns 1 if the last call to Get_Distance timed out. Otherwise, it returns 0.
  */
-uint16_t Get_Distance(void);
\ No newline at end of file
+uint8_t Sensor_Fault_Detected(void);
@@ -0,0 +1,354 @@
+/**
+ * @file Sensor.c
+ *
+ * @brief Source code for the Sensor module.
+ *
+ * This file contains the function definitions for the sensor backends. The sensor task
+ * is the only writer of the sample ring buffer: the interrupts of the drivers only store
+ * their reading with its time in the next slot of a small queue and post
+ * SIGNAL_SENSOR_EDGE, whose parameter holds the index of the slot. Every reading keeps
+ * its own time, even when the same sensor posts again before the task runs.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Sensor.h"
+#include "Timebase.h"
+#include "Supervisor.h"
+
+#define SENSOR_HISTORY_MASK     (SENSOR_HISTORY_SIZE - 1)
+
+// Number of readings posted from interrupts that can wait for the sensor task (power of 2)
+#define SENSOR_POST_QUEUE_SIZE  8
+#define SENSOR_POST_QUEUE_MASK  (SENSOR_POST_QUEUE_SIZE - 1)
+
+_Static_assert((SENSOR_POST_QUEUE_SIZE & SENSOR_POST_QUEUE_MASK) == 0, "SENSOR_POST_QUEUE_SIZE must be a power of 2");
+
+/**
+ * @brief A reading posted from an interrupt.
+ */
+typedef struct
+{
+    uint64_t timestamp_us;
+    uint8_t sensor;
+    uint8_t value;
+} Sensor_Posted_Reading;
+
+// Sensor table and the sensors that are supported by their drivers
+static const Sensor_Config *sensor_table = 0;
+static uint8_t sensor_count = 0;
+static uint8_t sensor_enabled[SENSOR_MAX_COUNT];
+
+// Sample ring buffer, written only by Sensor_Report
+static Sensor_Sample sample_history[SENSOR_HISTORY_SIZE];
+static uint32_t sample_count = 0;
+
+// Subscribers notified of every new sample
+static Sensor_Subscriber subscribers[SENSOR_MAX_SUBSCRIBERS];
+static uint8_t subscriber_count = 0;
+
+// Readings posted from interrupts, and the slot of the next one
+// A slot is only reused after SENSOR_POST_QUEUE_SIZE further readings
+static Sensor_Posted_Reading posted_readings[SENSOR_POST_QUEUE_SIZE];
+static uint8_t posted_head = 0;
+
+// Set while the drivers are started
+static uint8_t sensors_running = 0;
+
+// Periodic scheduler timer of the poll functions
+static Scheduler_Timer poll_timer;
+
+// Returns the index of the sensor of a driver channel, or SENSOR_NONE
+static uint8_t Sensor_Find(const Sensor_Driver *driver, uint8_t channel)
+{
+    for (uint8_t sensor = 0; sensor < sensor_count; sensor++)
+    {
+        if ((sensor_table[sensor].driver == driver) && (sensor_table[sensor].channel == channel))
+        {
+            return sensor;
+        }
+    }
+
+    return SENSOR_NONE;
+}
+
+// Indicates whether a sensor is the first enabled sensor of its driver, so that each driver is visited once
+static uint8_t Sensor_Is_First_Of_Driver(uint8_t sensor)
+{
+    if (!sensor_enabled[sensor])
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < sensor; i++)
+    {
+        if (sensor_enabled[i] && (sensor_table[i].driver == sensor_table[sensor].driver))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void Sensor_Start(void)
+{
+    uint8_t has_poll = 0;
+
+    // The drivers are started again even while running, since the ranging engine can be
+    // stopped by a change of its backend
+    sensors_running = 1;
+
+    for (uint8_t sensor = 0; sensor < sensor_count; sensor++)
+    {
+        if (Sensor_Is_First_Of_Driver(sensor))
+        {
+            const Sensor_Driver *driver = sensor_table[sensor].driver;
+
+            if (driver->start != 0)
+            {
+                (*driver->start)();
+            }
+
+            if (driver->poll != 0)
+            {
+                has_poll = 1;
+            }
+        }
+    }
+
+    if (has_poll)
+    {
+        Scheduler_Timer_Start(&poll_timer, TASK_SENSOR, SIGNAL_SENSOR_POLL, SENSOR_POLL_PERIOD_MS, SENSOR_POLL_PERIOD_MS);
+    }
+}
+
+static void Sensor_Stop(void)
+{
+    sensors_running = 0;
+    Scheduler_Timer_Stop(&poll_timer);
+
+    for (uint8_t sensor = 0; sensor < sensor_count; sensor++)
+    {
+        if (Sensor_Is_First_Of_Driver(sensor) && (sensor_table[sensor].driver->stop != 0))
+        {
+            (*sensor_table[sensor].driver->stop)();
+        }
+    }
+}
+
+static void Sensor_Poll(void)
+{
+    for (uint8_t sensor = 0; sensor < sensor_count; sensor++)
+    {
+        if (Sensor_Is_First_Of_Driver(sensor) && (sensor_table[sensor].driver->poll != 0))
+        {
+            (*sensor_table[sensor].driver->poll)();
+        }
+    }
+}
+
+// Reports a reading posted from an interrupt
+static void Sensor_Report_Posted(uint8_t slot)
+{
+    Sensor_Posted_Reading reading;
+
+    __disable_irq();
+    reading = posted_readings[slot & SENSOR_POST_QUEUE_MASK];
+    __enable_irq();
+
+    if (reading.sensor >= sensor_count)
+    {
+        return;
+    }
+
+    Sensor_Report(sensor_table[reading.sensor].driver, sensor_table[reading.sensor].channel, reading.value, SENSOR_STATUS_OK, reading.timestamp_us);
+}
+
+void Sensor_Init(const Sensor_Config *table, uint8_t count)
+{
+    sensor_table = table;
+    sensor_count = (count < SENSOR_MAX_COUNT) ? count : SENSOR_MAX_COUNT;
+    sample_count = 0;
+    subscriber_count = 0;
+    sensors_running = 0;
+
+    for (uint8_t sensor = 0; sensor < SENSOR_MAX_COUNT; sensor++)
+    {
+        sensor_enabled[sensor] = 0;
+    }
+
+    posted_head = 0;
+
+    // Initialize each driver once with the channels of all its sensors
+    for (uint8_t sensor = 0; sensor < sensor_count; sensor++)
+    {
+        const Sensor_Driver *driver = sensor_table[sensor].driver;
+        uint8_t channel_mask = 0;
+        uint8_t first = 1;
+
+        for (uint8_t i = 0; i < sensor_count; i++)
+        {
+            if (sensor_table[i].driver == driver)
+            {
+                first = first && (i >= sensor);
+                channel_mask |= (uint8_t)(1 << sensor_table[i].channel);
+            }
+        }
+
+        if (!first)
+        {
+            continue;
+        }
+
+        channel_mask = (*driver->init)(channel_mask);
+
+        for (uint8_t i = sensor; i < sensor_count; i++)
+        {
+            if ((sensor_table[i].driver == driver) && (channel_mask & (1 << sensor_table[i].channel)))
+            {
+                sensor_enabled[i] = 1;
+            }
+        }
+    }
+
+    Scheduler_Add_Task(TASK_SENSOR, Sensor_Task);
+    Supervisor_Monitor(TASK_SENSOR);
+}
+
+/**
+ * @brief Starts and stops the drivers as the system is armed and disarmed.
+ *
+ * The readings that the interrupts posted are reported from here, so every subscriber
+ * runs in task context.
+ */
+void Sensor_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_SENSOR_START:
+            Sensor_Start();
+            break;
+
+        case SIGNAL_SENSOR_STOP:
+            Sensor_Stop();
+            break;
+
+        case SIGNAL_SENSOR_POLL:
+            if (sensors_running)
+            {
+                Sensor_Poll();
+            }
+            break;
+
+        case SIGNAL_SENSOR_EDGE:
+            if (sensors_running)
+            {
+                Sensor_Report_Posted((uint8_t)event->param);
+            }
+            break;
+
+        case SIGNAL_SUPERVISOR_PING:
+            Supervisor_Check_In(TASK_SENSOR);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void Sensor_Report(const Sensor_Driver *driver, uint8_t channel, uint16_t value, uint8_t status, uint64_t timestamp_us)
+{
+    uint8_t sensor = Sensor_Find(driver, channel);
+
+    if ((sensor == SENSOR_NONE) || !sensor_enabled[sensor])
+    {
+        return;
+    }
+
+    Sensor_Sample *sample = &sample_history[sample_count & SENSOR_HISTORY_MASK];
+
+    sample->timestamp_us = timestamp_us;
+    sample->sequence = sample_count;
+    sample->value = value;
+    sample->sensor = sensor;
+    sample->type = driver->type;
+    sample->status = status;
+
+    sample_count++;
+
+    for (uint8_t i = 0; i < subscriber_count; i++)
+    {
+        (*subscribers[i])(sample);
+    }
+}
+
+void Sensor_Post_From_ISR(const Sensor_Driver *driver, uint8_t channel, uint8_t value)
+{
+    uint8_t sensor = Sensor_Find(driver, channel);
+
+    if (sensor == SENSOR_NONE)
+    {
+        return;
+    }
+
+    // The interrupts of several drivers may post, so the slot is claimed with interrupts disabled
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint8_t slot = posted_head;
+    posted_head = (posted_head + 1) & SENSOR_POST_QUEUE_MASK;
+
+    posted_readings[slot].timestamp_us = Timebase_Get_Time_us();
+    posted_readings[slot].sensor = sensor;
+    posted_readings[slot].value = value;
+
+    __set_PRIMASK(primask);
+
+    Scheduler_Post(TASK_SENSOR, SIGNAL_SENSOR_EDGE, slot);
+}
+
+uint8_t Sensor_Subscribe(Sensor_Subscriber subscriber)
+{
+    if ((subscriber == 0) || (subscriber_count >= SENSOR_MAX_SUBSCRIBERS))
+    {
+        return 0;
+    }
+
+    subscribers[subscriber_count] = subscriber;
+    subscriber_count++;
+
+    return 1;
+}
+
+uint8_t Sensor_Get_Count(void)
+{
+    return sensor_count;
+}
+
+const Sensor_Config *Sensor_Get_Config(uint8_t sensor)
+{
+    return (sensor < sensor_count) ? &sensor_table[sensor] : 0;
+}
+
+uint8_t Sensor_Is_Enabled(uint8_t sensor)
+{
+    return (sensor < sensor_count) ? sensor_enabled[sensor] : 0;
+}
+
+uint8_t Sensor_Get_Latest(Sensor_Sample *sample)
+{
+    if (sample_count == 0)
+    {
+        return 0;
+    }
+
+    *sample = sample_history[(sample_count - 1) & SENSOR_HISTORY_MASK];
+
+    return 1;
+}
+
+uint32_t Sensor_Get_Sample_Count(void)
+{
+    return sample_count;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file Sensor.h
+ *
+ * @brief Header file for the Sensor module.
+ *
+ * This file contains the function definitions for the sensor backends of the Home
+ * Security System. Every type of sensor is a driver with the same interface
+ * (Sensor_Driver): it is initialized for the channels that are wired, started when the
+ * system is armed, stopped when it is disarmed, and either polled by the sensor task or
+ * driven by its own interrupts. Each reading is reported in the common sample format
+ * (Sensor_Sample), so the zones, the intrusion filters, and the fusion stage do not
+ * depend on the type of the sensor.
+ *
+ * The sensors are listed in a table of the Zone module (see Zone.c), one entry per wired
+ * sensor with its driver, channel, and zone. Adding a type of sensor is one driver and
+ * one table entry; none of the drivers waits for its sensor:
+ * - A driver that receives its readings in task context (such as the ranging engine)
+ *   calls Sensor_Report.
+ * - A driver with an interrupt calls Sensor_Post_From_ISR, which timestamps the
+ *   reading and reports it from the sensor task (TASK_SENSOR).
+ * - A driver with a poll function is polled every SENSOR_POLL_PERIOD_MS while the
+ *   sensors are running.
+ *
+ * The last SENSOR_HISTORY_SIZE samples of all the sensors are kept in one sample ring buffer.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Largest number of sensors in the sensor table
+#define SENSOR_MAX_COUNT            8
+
+// Number of samples kept in the sample ring buffer (must be a power of two)
+#define SENSOR_HISTORY_SIZE         16
+
+// Maximum number of subscribers notified of new samples (1 is used, the rest is headroom)
+#define SENSOR_MAX_SUBSCRIBERS      4
+
+// Period of the poll functions while the sensors are running
+#define SENSOR_POLL_PERIOD_MS       10
+
+// Returned instead of a sensor index when no sensor applies
+#define SENSOR_NONE                 0xFF
+
+/**
+ * @brief Types of sensors.
+ */
+enum Sensor_Types
+{
+    SENSOR_TYPE_RANGE   = 0,    // Distance sensor, the value is the distance in millimeters
+    SENSOR_TYPE_MOTION  = 1,    // Motion detector, the value is 1 while motion is detected
+    SENSOR_TYPE_CONTACT = 2     // Door or window contact, the value is 1 while it is open
+};
+
+/**
+ * @brief Status of a sample. The statuses of the ranging engine (Range_Status) have the same values.
+ */
+enum Sensor_Status
+{
+    SENSOR_STATUS_OK        = 0,    // Valid value
+    SENSOR_STATUS_NO_TARGET = 1,    // The sensor replied, but nothing was detected in range
+    SENSOR_STATUS_TIMEOUT   = 2     // The sensor did not reply
+};
+
+/**
+ * @brief A timestamped reading of one sensor.
+ */
+typedef struct
+{
+    uint64_t timestamp_us;      // Time of the reading (see Timebase_Get_Time_us)
+    uint32_t sequence;          // Number of samples of all the sensors before this one
+    uint16_t value;             // Reading, in the unit of the sensor type (see Sensor_Types)
+    uint8_t sensor;             // Index of the sensor in the sensor table
+    uint8_t type;               // Type of the sensor (see Sensor_Types)
+    uint8_t status;             // See Sensor_Status
+} Sensor_Sample;
+
+/**
+ * @brief Interface of a sensor driver.
+ *
+ * Every function applies to all the channels of the driver. Only init is required.
+ */
+typedef struct
+{
+    uint8_t type;                           // Type of the sensors of the driver (see Sensor_Types)
+    uint8_t (*init)(uint8_t channel_mask);  // Prepares the channels and returns the mask of the supported ones
+    void (*start)(void);                    // Starts reporting samples
+    void (*stop)(void);                     // Stops reporting samples
+    void (*poll)(void);                     // Executed from the sensor task every SENSOR_POLL_PERIOD_MS, or 0
+} Sensor_Driver;
+
+/**
+ * @brief Static description of one sensor.
+ */
+typedef struct
+{
+    const Sensor_Driver *driver;    // Driver of the sensor
+    uint8_t channel;                // Channel of the sensor in its driver (0 to 7)
+    uint8_t zone;                   // Zone watched by the sensor (see Zone.h)
+} Sensor_Config;
+
+/**
+ * @brief Function notified of every new sample, executed in task context.
+ */
+typedef void (*Sensor_Subscriber)(const Sensor_Sample *sample);
+
+/**
+ * @brief Initializes the drivers of a sensor table and registers TASK_SENSOR with the scheduler.
+ *
+ * The init function of each driver is executed once with the channels of all its sensors.
+ * A sensor whose channel is not supported by its driver is disabled.
+ *
+ * @param table A pointer to the sensor table, which must stay valid.
+ *
+ * @param count The number of sensors in the table (at most SENSOR_MAX_COUNT).
+ *
+ * @return None
+ */
+void Sensor_Init(const Sensor_Config *table, uint8_t count);
+
+/**
+ * @brief Event handler of the sensor task.
+ *
+ * Starts the drivers on SIGNAL_SENSOR_START and stops them on SIGNAL_SENSOR_STOP,
+ * executes the poll functions, and reports the readings posted from interrupts.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Sensor_Task(const Scheduler_Event *event);
+
+/**
+ * @brief Reports a reading of a sensor, in task context.
+ *
+ * The sample is stored in the sample ring buffer and passed to every subscriber before
+ * this function returns. A reading of a channel that is not in the sensor table is ignored.
+ *
+ * @param driver A pointer to the driver of the sensor.
+ *
+ * @param channel The channel of the sensor.
+ *
+ * @param value The reading (see Sensor_Types).
+ *
+ * @param status The status of the reading (see Sensor_Status).
+ *
+ * @param timestamp_us The time of the reading.
+ *
+ * @return None
+ */
+void Sensor_Report(const Sensor_Driver *driver, uint8_t channel, uint16_t value, uint8_t status, uint64_t timestamp_us);
+
+/**
+ * @brief Reports a reading of a sensor from an interrupt.
+ *
+ * The reading is timestamped and posted to the sensor task, which reports it with
+ * SENSOR_STATUS_OK and its own time, even when the same sensor posts again before
+ * the task runs.
+ *
+ * @param driver A pointer to the driver of the sensor.
+ *
+ * @param channel The channel of the sensor.
+ *
+ * @param value The reading (0 to 255).
+ *
+ * @return None
+ */
+void Sensor_Post_From_ISR(const Sensor_Driver *driver, uint8_t channel, uint8_t value);
+
+/**
+ * @brief Registers a function that is notified of every new sample.
+ *
+ * @param subscriber The function to notify.
+ *
+ * @return uint8_t Returns 1 if the function is registered, or 0 if the list is full.
+ */
+uint8_t Sensor_Subscribe(Sensor_Subscriber subscriber);
+
+/**
+ * @brief Returns the number of sensors in the sensor table.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of sensors.
+ */
+uint8_t Sensor_Get_Count(void);
+
+/**
+ * @brief Returns the description of a sensor.
+ *
+ * @param sensor The index of the sensor.
+ *
+ * @return const Sensor_Config* A pointer to the description, or 0 if the index is out of range.
+ */
+const Sensor_Config *Sensor_Get_Config(uint8_t sensor);
+
+/**
+ * @brief Indicates whether a sensor is supported by its driver.
+ *
+ * @param sensor The index of the sensor.
+ *
+ * @return uint8_t Returns 1 if the sensor reports samples. Otherwise, it returns 0.
+ */
+uint8_t Sensor_Is_Enabled(uint8_t sensor);
+
+/**
+ * @brief Copies the most recent sample of all the sensors.
+ *
+ * @param sample A pointer to where the sample is copied.
+ *
+ * @return uint8_t Returns 1 if a sample is available, or 0 if no sample was reported yet.
+ */
+uint8_t Sensor_Get_Latest(Sensor_Sample *sample);
+
+/**
+ * @brief Returns the number of samples reported since initialization.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of samples.
+ */
+uint32_t Sensor_Get_Sample_Count(void);
+
+#endif
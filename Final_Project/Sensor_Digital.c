@@ -0,0 +1,194 @@
+/**
+ * @file Sensor_Digital.c
+ *
+ * @brief Source code for the Sensor_Digital driver.
+ *
+ * This file contains the function definitions for the sensor drivers of the PIR motion
+ * detectors and the reed switches.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Sensor_Digital.h"
+#include "Timebase.h"
+#include "Pin_Map.h"
+
+_Static_assert(PIN_CLOCK(PIN_MOTION_0) == PIN_CLOCK_E, "The PIR motion detector must be on Port E (GPIOE_Handler)");
+
+// GPIO Port E has an Interrupt Request (IRQ) number of 4
+#define SENSOR_MOTION_IRQ_BIT   (1 << 4)
+
+// Debounced level of the motion detector, whether an edge is being debounced (its
+// interrupt is then masked), and the time of the last edge (written by GPIOE_Handler)
+static uint8_t motion_level = 0;
+static volatile uint8_t motion_debouncing = 0;
+static volatile uint64_t motion_edge_us = 0;
+
+// Debounced level of the reed switch and the number of polls that read the other level
+static uint8_t contact_level = 0;
+static uint8_t contact_change_polls = 0;
+
+static uint8_t Sensor_Motion_Read(void)
+{
+    return (PIN_READ(PIN_MOTION_0) != 0) ? 1 : 0;
+}
+
+static uint8_t Sensor_Contact_Read(void)
+{
+    return (PIN_READ(PIN_CONTACT_0) != 0) ? 1 : 0;
+}
+
+static uint8_t Sensor_Motion_Init(uint8_t channel_mask)
+{
+    channel_mask &= (1 << SENSOR_MOTION_CHANNEL_COUNT) - 1;
+
+    if (channel_mask == 0)
+    {
+        return 0;
+    }
+
+    // Configure the pin as an input with the weak pull-down resistor,
+    // so that a disconnected detector reads as no motion
+    PIN_INPUT_INIT(PIN_MOTION_0);
+    PIN_PORT(PIN_MOTION_0)->PDR |= PIN_MASK(PIN_MOTION_0);
+
+    // Detect both edges (IS cleared, IBE set), with the interrupt masked until the driver is started
+    PIN_PORT(PIN_MOTION_0)->IM &= ~PIN_MASK(PIN_MOTION_0);
+    PIN_PORT(PIN_MOTION_0)->IS &= ~PIN_MASK(PIN_MOTION_0);
+    PIN_PORT(PIN_MOTION_0)->IBE |= PIN_MASK(PIN_MOTION_0);
+    PIN_PORT(PIN_MOTION_0)->ICR = PIN_MASK(PIN_MOTION_0);
+
+    // Set the priority level to 3 for the GPIO Port E interrupt, the level of the buttons
+    // In the Interrupt 4-7 Priority (PRI1) register,
+    // the INTA field (Bits 7 to 5) corresponds to Interrupt Request (IRQ) 4
+    NVIC->IPR[1] = (NVIC->IPR[1] & 0xFFFFFF00) | (3 << 5);
+    NVIC->ISER[0] = SENSOR_MOTION_IRQ_BIT;
+
+    return channel_mask;
+}
+
+static void Sensor_Motion_Start(void)
+{
+    // Report the level at the start, then every debounced change
+    motion_debouncing = 0;
+    motion_level = Sensor_Motion_Read();
+    PIN_PORT(PIN_MOTION_0)->ICR = PIN_MASK(PIN_MOTION_0);
+    PIN_PORT(PIN_MOTION_0)->IM |= PIN_MASK(PIN_MOTION_0);
+    Sensor_Report(&Sensor_Motion_Driver, 0, motion_level, SENSOR_STATUS_OK, Timebase_Get_Time_us());
+}
+
+static void Sensor_Motion_Stop(void)
+{
+    PIN_PORT(PIN_MOTION_0)->IM &= ~PIN_MASK(PIN_MOTION_0);
+    motion_debouncing = 0;
+}
+
+static void Sensor_Motion_Poll(void)
+{
+    uint64_t time_us = Timebase_Get_Time_us();
+
+    // The interrupt is masked while debouncing, so GPIOE_Handler does not change the state here
+    if (!motion_debouncing)
+    {
+        return;
+    }
+
+    // The Raw Interrupt Status (RIS) bit is still set by a masked edge:
+    // the debounce time starts again from the last edge
+    if (PIN_PORT(PIN_MOTION_0)->RIS & PIN_MASK(PIN_MOTION_0))
+    {
+        PIN_PORT(PIN_MOTION_0)->ICR = PIN_MASK(PIN_MOTION_0);
+        motion_edge_us = time_us;
+        return;
+    }
+
+    if ((time_us - motion_edge_us) < ((uint64_t)SENSOR_MOTION_DEBOUNCE_MS * 1000))
+    {
+        return;
+    }
+
+    // The level has been stable for SENSOR_MOTION_DEBOUNCE_MS, and a pulse shorter than that is ignored
+    if (Sensor_Motion_Read() != motion_level)
+    {
+        motion_level ^= 1;
+        Sensor_Report(&Sensor_Motion_Driver, 0, motion_level, SENSOR_STATUS_OK, motion_edge_us);
+    }
+
+    motion_debouncing = 0;
+    PIN_PORT(PIN_MOTION_0)->IM |= PIN_MASK(PIN_MOTION_0);
+}
+
+static uint8_t Sensor_Contact_Init(uint8_t channel_mask)
+{
+    channel_mask &= (1 << SENSOR_CONTACT_CHANNEL_COUNT) - 1;
+
+    if (channel_mask == 0)
+    {
+        return 0;
+    }
+
+    // Configure the pin as an input with the weak pull-up resistor, so that an open
+    // switch (and a cut wire) reads high
+    PIN_INPUT_INIT(PIN_CONTACT_0);
+    PIN_PORT(PIN_CONTACT_0)->PUR |= PIN_MASK(PIN_CONTACT_0);
+
+    return channel_mask;
+}
+
+static void Sensor_Contact_Start(void)
+{
+    contact_level = Sensor_Contact_Read();
+    contact_change_polls = 0;
+    Sensor_Report(&Sensor_Contact_Driver, 0, contact_level, SENSOR_STATUS_OK, Timebase_Get_Time_us());
+}
+
+static void Sensor_Contact_Poll(void)
+{
+    if (Sensor_Contact_Read() == contact_level)
+    {
+        contact_change_polls = 0;
+        return;
+    }
+
+    // Report the new level once it has been read for SENSOR_CONTACT_DEBOUNCE_POLLS polls in a row
+    contact_change_polls++;
+
+    if (contact_change_polls >= SENSOR_CONTACT_DEBOUNCE_POLLS)
+    {
+        contact_level ^= 1;
+        contact_change_polls = 0;
+        Sensor_Report(&Sensor_Contact_Driver, 0, contact_level, SENSOR_STATUS_OK, Timebase_Get_Time_us());
+    }
+}
+
+const Sensor_Driver Sensor_Motion_Driver =
+{
+    .type = SENSOR_TYPE_MOTION,
+    .init = Sensor_Motion_Init,
+    .start = Sensor_Motion_Start,
+    .stop = Sensor_Motion_Stop,
+    .poll = Sensor_Motion_Poll
+};
+
+const Sensor_Driver Sensor_Contact_Driver =
+{
+    .type = SENSOR_TYPE_CONTACT,
+    .init = Sensor_Contact_Init,
+    .start = Sensor_Contact_Start,
+    .stop = 0,
+    .poll = Sensor_Contact_Poll
+};
+
+void GPIOE_Handler(void)
+{
+    uint8_t interrupt_status = PIN_PORT(PIN_MOTION_0)->MIS & PIN_MASK(PIN_MOTION_0);
+
+    if (interrupt_status)
+    {
+        // Mask the interrupt until the level is stable, and let Sensor_Motion_Poll check it
+        PIN_PORT(PIN_MOTION_0)->IM &= ~PIN_MASK(PIN_MOTION_0);
+        PIN_PORT(PIN_MOTION_0)->ICR = interrupt_status;
+        motion_edge_us = Timebase_Get_Time_us();
+        motion_debouncing = 1;
+    }
+}
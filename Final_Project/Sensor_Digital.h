@@ -0,0 +1,62 @@
+/**
+ * @file Sensor_Digital.h
+ *
+ * @brief Header file for the Sensor_Digital driver.
+ *
+ * This file contains the sensor drivers of the sensors with a digital output:
+ * - Sensor_Motion_Driver: PIR motion detectors (PIN_MOTION_0). The output is high while
+ *   motion is detected and stays high for the hold time of the detector. Both edges
+ *   cause a GPIO Port E interrupt, which masks itself and starts a debounce: the sensor
+ *   task reports the new level once no edge has been seen for SENSOR_MOTION_DEBOUNCE_MS,
+ *   so a glitch shorter than that never reaches the zone.
+ * - Sensor_Contact_Driver: door and window reed switches (PIN_CONTACT_0), which close
+ *   to ground while the door is shut and read high through a pull-up when it opens. The
+ *   switch is polled by the sensor task and a new level is reported once it has been
+ *   stable for SENSOR_CONTACT_DEBOUNCE_POLLS polls, so the contact bounce never reaches
+ *   the zone.
+ *
+ * Both drivers report the current level when they are started, and a SENSOR_STATUS_OK
+ * sample with the value 1 (motion or open) or 0 on every change.
+ *
+ * @note A PIR motion detector needs up to one minute after power-up before its output is valid.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SENSOR_DIGITAL_H
+#define SENSOR_DIGITAL_H
+
+#include "Sensor.h"
+
+// Number of channels of each driver
+#define SENSOR_MOTION_CHANNEL_COUNT     1
+#define SENSOR_CONTACT_CHANNEL_COUNT    1
+
+// Time for which the motion detector output must be stable before a change is reported
+#define SENSOR_MOTION_DEBOUNCE_MS       50
+
+// Number of consecutive polls with the same level before a reed switch change is reported
+#define SENSOR_CONTACT_DEBOUNCE_POLLS   3
+
+/**
+ * @brief Sensor driver of the PIR motion detectors.
+ */
+extern const Sensor_Driver Sensor_Motion_Driver;
+
+/**
+ * @brief Sensor driver of the door and window reed switches.
+ */
+extern const Sensor_Driver Sensor_Contact_Driver;
+
+/**
+ * @brief The interrupt service routine (ISR) for GPIO Port E.
+ *
+ * This function starts the debounce of the PIR motion detector on both edges.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void GPIOE_Handler(void);
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file Sensor_Range.c
+ *
+ * @brief Source code for the Sensor_Range driver.
+ *
+ * This file contains the function definitions for the sensor driver of the ranging engine.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Sensor_Range.h"
+#include "Config.h"
+#include "Supervisor.h"
+
+_Static_assert(((int)RANGE_STATUS_OK == (int)SENSOR_STATUS_OK) && ((int)RANGE_STATUS_NO_ECHO == (int)SENSOR_STATUS_NO_TARGET)
+    && ((int)RANGE_STATUS_TIMEOUT == (int)SENSOR_STATUS_TIMEOUT), "The range statuses must match the sensor statuses");
+
+// Ranging engine subscriber executed in task context for every new sample
+static void Sensor_Range_Sample_Received(const Range_Sample *sample)
+{
+    // The range statuses have the same values as the sensor statuses
+    Sensor_Report(&Sensor_Range_Driver, sample->channel, sample->distance_mm, sample->status, sample->timestamp_us);
+}
+
+static uint8_t Sensor_Range_Init(uint8_t channel_mask)
+{
+    if (!Ranging_Subscribe(&Sensor_Range_Sample_Received))
+    {
+        Supervisor_Registration_Failed(TASK_RANGING);
+    }
+
+    // Only the channels supported by the backend are measured
+    return Ranging_Set_Channels(channel_mask);
+}
+
+static void Sensor_Range_Start(void)
+{
+    uint16_t period_ms = Config_Get(CONFIG_PARAM_RANGE_PERIOD_MS);
+
+    // The period is read at every start, so a change applies the next time the system is armed
+    Ranging_Start((period_ms > 0) ? RANGING_MODE_FIXED_RATE : RANGING_MODE_CONTINUOUS, period_ms);
+}
+
+static void Sensor_Range_Stop(void)
+{
+    Ranging_Stop();
+}
+
+const Sensor_Driver Sensor_Range_Driver =
+{
+    .type = SENSOR_TYPE_RANGE,
+    .init = Sensor_Range_Init,
+    .start = Sensor_Range_Start,
+    .stop = Sensor_Range_Stop,
+    .poll = 0
+};
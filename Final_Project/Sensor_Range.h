@@ -0,0 +1,28 @@
+/**
+ * @file Sensor_Range.h
+ *
+ * @brief Header file for the Sensor_Range driver.
+ *
+ * This file contains the sensor driver of the US-100 Ultrasonic Distance Sensors.
+ * The driver is a thin layer over the ranging engine (see Ranging.h): its channels are
+ * the channels of the ranging engine, it starts continuous ranging when the sensors are
+ * started, and it reports every range sample as a SENSOR_TYPE_RANGE sample with the
+ * distance in millimeters.
+ *
+ * The ranging backend must be selected before the sensor table is initialized.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SENSOR_RANGE_H
+#define SENSOR_RANGE_H
+
+#include "Sensor.h"
+#include "Ranging.h"
+
+/**
+ * @brief Sensor driver of the ranging engine.
+ */
+extern const Sensor_Driver Sensor_Range_Driver;
+
+#endif
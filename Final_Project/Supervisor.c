@@ -0,0 +1,337 @@
+/**
+ * @file Supervisor.c
+ *
+ * @brief Source code for the Supervisor module.
+ *
+ * This file contains the function definitions for the liveness supervisor of the Home
+ * Security System.
+ *
+ * The words of the recovery record are also kept in RAM. A word that changes is marked
+ * pending and written when the EEPROM is not busy, so the writes never wait for the
+ * event log. Once a fault has been recorded, nothing more is written before the reset.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Supervisor.h"
+#include "Watchdog.h"
+#include "EEPROM.h"
+#include "Event_Log.h"
+#include "Timebase.h"
+
+// Every task has one bit in the masks of the monitored and alive tasks
+_Static_assert(TASK_COUNT <= 16, "The task masks hold 16 tasks");
+
+// Word address of the recovery record and the offsets of its words
+#define SUPERVISOR_RECORD_ADDRESS   (EEPROM_SYSTEM_FIRST_BLOCK * EEPROM_WORDS_PER_BLOCK)
+#define SUPERVISOR_STATE_WORD       0
+#define SUPERVISOR_FAULT_WORD       1
+#define SUPERVISOR_RESTORE_WORD     2
+#define SUPERVISOR_ATTEMPTS_WORD    3
+#define SUPERVISOR_RECORD_WORDS     4
+
+// Upper byte of a valid record word
+#define SUPERVISOR_RECORD_MAGIC     0xA5
+
+// Recovery record, and the words that have not been written to the EEPROM yet
+static uint32_t record_words[SUPERVISOR_RECORD_WORDS];
+static uint8_t pending_words = 0;
+
+static Supervisor_Reset_Record reset_record;
+static uint8_t restore_allowed = 0;
+
+// Tasks that must answer every check and tasks that answered since the last check
+static uint16_t monitored_tasks = 0;
+static uint16_t alive_tasks = 0;
+static uint8_t missed_checks = 0;
+
+// Set once a fault is recorded, after which the watchdog is no longer fed
+static volatile uint8_t fault_latched = 0;
+
+// Ticks since the last check was posted, and set until TASK_SUPERVISOR handles it
+static uint32_t check_ticks = 0;
+static volatile uint8_t check_pending = 0;
+
+static uint32_t Supervisor_Pack(uint16_t payload)
+{
+    return ((uint32_t)SUPERVISOR_RECORD_MAGIC << 24) | payload;
+}
+
+static uint8_t Supervisor_Unpack(uint8_t word, uint16_t *payload)
+{
+    uint32_t data = record_words[word];
+
+    if ((data == EEPROM_ERASED_WORD) || ((data >> 24) != SUPERVISOR_RECORD_MAGIC))
+    {
+        return 0;
+    }
+
+    *payload = (uint16_t)data;
+
+    return 1;
+}
+
+static void Supervisor_Set_Word(uint8_t word, uint32_t data)
+{
+    if (record_words[word] != data)
+    {
+        record_words[word] = data;
+        pending_words |= (uint8_t)(1 << word);
+    }
+}
+
+// Starts the write of the first pending word when the EEPROM is not busy
+static void Supervisor_Write_Pending(void)
+{
+    if (!EEPROM_Is_Ready())
+    {
+        // The record is only kept in RAM
+        pending_words = 0;
+        return;
+    }
+
+    if ((pending_words == 0) || fault_latched || EEPROM_Is_Busy())
+    {
+        return;
+    }
+
+    for (uint8_t word = 0; word < SUPERVISOR_RECORD_WORDS; word++)
+    {
+        if (pending_words & (1 << word))
+        {
+            if (EEPROM_Write_Start(SUPERVISOR_RECORD_ADDRESS + word, record_words[word]))
+            {
+                pending_words &= (uint8_t)~(1 << word);
+            }
+            return;
+        }
+    }
+}
+
+// Writes the fault before the reset and stops feeding the watchdog
+static void Supervisor_Record_Fault(uint8_t fault, uint8_t task_id)
+{
+    fault_latched = 1;
+
+    record_words[SUPERVISOR_FAULT_WORD] = Supervisor_Pack((uint16_t)(((uint16_t)task_id << 8) | fault));
+    EEPROM_Write_Word(SUPERVISOR_RECORD_ADDRESS + SUPERVISOR_FAULT_WORD, record_words[SUPERVISOR_FAULT_WORD]);
+}
+
+// Executed from the watchdog interrupt when the watchdog has not been fed for SUPERVISOR_STALL_TIMEOUT_MS
+static void Supervisor_Stalled(void)
+{
+    // A fault found by a check has already been recorded
+    if (!fault_latched)
+    {
+        Supervisor_Record_Fault(SUPERVISOR_FAULT_STALL, Scheduler_Get_Current_Task());
+    }
+}
+
+static uint8_t Supervisor_First_Task(uint16_t task_mask)
+{
+    for (uint8_t task_id = 0; task_id < TASK_COUNT; task_id++)
+    {
+        if (task_mask & (1 << task_id))
+        {
+            return task_id;
+        }
+    }
+
+    return TASK_NONE;
+}
+
+static void Supervisor_Check(void)
+{
+    if (fault_latched)
+    {
+        return;
+    }
+
+    if ((alive_tasks & monitored_tasks) == monitored_tasks)
+    {
+        Watchdog_Feed();
+        missed_checks = 0;
+    }
+    else
+    {
+        missed_checks++;
+
+        if (missed_checks >= SUPERVISOR_MISSED_CHECK_LIMIT)
+        {
+            Supervisor_Record_Fault(SUPERVISOR_FAULT_CHECK_IN, Supervisor_First_Task(monitored_tasks & ~alive_tasks));
+            return;
+        }
+    }
+
+    // Each task answers in its own handler, after the events that were queued before the ping
+    alive_tasks = 0;
+
+    for (uint8_t task_id = 0; task_id < TASK_COUNT; task_id++)
+    {
+        if (monitored_tasks & (1 << task_id))
+        {
+            Scheduler_Post(task_id, SIGNAL_SUPERVISOR_PING, 0);
+        }
+    }
+
+    // The system has recovered from the last watchdog reset
+    if ((reset_record.restore_count > 0) && (Timebase_Get_Time_ms() >= SUPERVISOR_STABLE_MS))
+    {
+        reset_record.restore_count = 0;
+        Supervisor_Set_Word(SUPERVISOR_RESTORE_WORD, Supervisor_Pack(0));
+    }
+}
+
+void Supervisor_Init(uint8_t reset_cause)
+{
+    uint16_t payload;
+
+    monitored_tasks = 0;
+    alive_tasks = 0;
+    missed_checks = 0;
+    fault_latched = 0;
+    check_ticks = 0;
+    check_pending = 0;
+    pending_words = 0;
+
+    // Erased words are read if the EEPROM is not available
+    for (uint8_t word = 0; word < SUPERVISOR_RECORD_WORDS; word++)
+    {
+        record_words[word] = EEPROM_Read_Word(SUPERVISOR_RECORD_ADDRESS + word);
+    }
+
+    reset_record.cause = reset_cause;
+    reset_record.fault = SUPERVISOR_FAULT_NONE;
+    reset_record.task = TASK_NONE;
+    reset_record.restore_count = Supervisor_Unpack(SUPERVISOR_RESTORE_WORD, &payload) ? payload : 0;
+
+    if (reset_cause & WATCHDOG_RESET_WATCHDOG_0)
+    {
+        if (Supervisor_Unpack(SUPERVISOR_FAULT_WORD, &payload))
+        {
+            reset_record.fault = (uint8_t)payload;
+            reset_record.task = (uint8_t)(payload >> 8);
+        }
+        else
+        {
+            reset_record.fault = SUPERVISOR_FAULT_UNKNOWN;
+        }
+
+        if (reset_record.restore_count < 0xFFFF)
+        {
+            reset_record.restore_count++;
+        }
+
+        Supervisor_Set_Word(SUPERVISOR_RESTORE_WORD, Supervisor_Pack(reset_record.restore_count));
+        Event_Log_Append(EVENT_LOG_WATCHDOG, reset_record.task);
+    }
+
+    // A recorded fault only describes the reset that follows it
+    Supervisor_Set_Word(SUPERVISOR_FAULT_WORD, EEPROM_ERASED_WORD);
+
+    restore_allowed = (SUPERVISOR_RESTORE_STATE && (reset_record.restore_count <= SUPERVISOR_MAX_RESTORES)) ? 1 : 0;
+
+    Scheduler_Add_Task(TASK_SUPERVISOR, Supervisor_Task);
+    Watchdog_Init(SUPERVISOR_STALL_TIMEOUT_MS, &Supervisor_Stalled);
+}
+
+void Supervisor_Monitor(uint8_t task_id)
+{
+    if (task_id < TASK_COUNT)
+    {
+        monitored_tasks |= (uint16_t)(1 << task_id);
+        alive_tasks |= (uint16_t)(1 << task_id);
+    }
+}
+
+void Supervisor_Registration_Failed(uint8_t task_id)
+{
+    // Only the first fault is kept
+    if (!fault_latched)
+    {
+        Supervisor_Record_Fault(SUPERVISOR_FAULT_CALLBACK, task_id);
+    }
+}
+
+void Supervisor_Check_In(uint8_t task_id)
+{
+    if (task_id < TASK_COUNT)
+    {
+        alive_tasks |= (uint16_t)(1 << task_id);
+    }
+}
+
+void Supervisor_Tick(void)
+{
+    check_ticks++;
+
+    // A check that cannot be queued is posted again at the next tick
+    if ((check_ticks >= SUPERVISOR_CHECK_PERIOD_MS) && !check_pending)
+    {
+        check_pending = Scheduler_Post(TASK_SUPERVISOR, SIGNAL_SUPERVISOR_CHECK, 0);
+
+        if (check_pending)
+        {
+            check_ticks = 0;
+        }
+    }
+}
+
+uint32_t Supervisor_Get_Idle_Ticks(void)
+{
+    return (check_ticks < SUPERVISOR_CHECK_PERIOD_MS) ? (SUPERVISOR_CHECK_PERIOD_MS - check_ticks) : 1;
+}
+
+void Supervisor_Save_State(uint8_t state, uint8_t zone)
+{
+    Supervisor_Set_Word(SUPERVISOR_STATE_WORD, Supervisor_Pack((uint16_t)(((uint16_t)zone << 8) | state)));
+    Supervisor_Write_Pending();
+}
+
+uint8_t Supervisor_Get_Saved_State(uint8_t *state, uint8_t *zone)
+{
+    uint16_t payload;
+
+    if (!restore_allowed || !Supervisor_Unpack(SUPERVISOR_STATE_WORD, &payload))
+    {
+        return 0;
+    }
+
+    *state = (uint8_t)payload;
+    *zone = (uint8_t)(payload >> 8);
+
+    return 1;
+}
+
+void Supervisor_Get_Reset_Record(Supervisor_Reset_Record *record)
+{
+    *record = reset_record;
+}
+
+void Supervisor_Save_Failed_Attempts(uint8_t failed_attempts)
+{
+    Supervisor_Set_Word(SUPERVISOR_ATTEMPTS_WORD, Supervisor_Pack(failed_attempts));
+    Supervisor_Write_Pending();
+}
+
+uint8_t Supervisor_Get_Failed_Attempts(void)
+{
+    uint16_t payload;
+
+    return Supervisor_Unpack(SUPERVISOR_ATTEMPTS_WORD, &payload) ? (uint8_t)payload : 0;
+}
+
+void Supervisor_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_SUPERVISOR_CHECK:
+            check_pending = 0;
+            Supervisor_Check();
+            Supervisor_Write_Pending();
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,228 @@
+/**
+ * @file Supervisor.h
+ *
+ * @brief Header file for the Supervisor module.
+ *
+ * This file contains the function definitions for the liveness supervisor of the Home
+ * Security System. The supervisor only feeds the hardware watchdog (see Watchdog.h)
+ * while every critical task is alive, and it keeps a recovery record in the EEPROM so
+ * that the system resumes in the state it was in before a reset instead of disarmed.
+ *
+ * Every SUPERVISOR_CHECK_PERIOD_MS, TASK_SUPERVISOR sends SIGNAL_SUPERVISOR_PING to each
+ * monitored task, and the task answers from its handler with Supervisor_Check_In. A task
+ * may add its own condition before it answers (for example, the ranging engine only
+ * answers while it keeps recording samples). The watchdog is fed when every monitored
+ * task has answered since the previous check:
+ * - When a task misses SUPERVISOR_MISSED_CHECK_LIMIT checks in a row, the fault is
+ *   recorded and the watchdog is no longer fed, so it resets the processor.
+ * - When a handler never returns, the supervisor itself cannot run. The watchdog
+ *   interrupt then records the task that was running, and the processor is reset
+ *   SUPERVISOR_STALL_TIMEOUT_MS later.
+ * - When a module cannot register a callback at startup because a table is full, the
+ *   fault is recorded with Supervisor_Registration_Failed and the processor is reset
+ *   the same way, so that a missing callback is visible in the event log.
+ *
+ * The checks are started from the 1 ms tick (Supervisor_Tick) instead of a scheduler
+ * timer, so that the supervisor does not keep a scheduler timer running. The watchdog
+ * stops in deep-sleep mode, and the tick wakes the processor for every check.
+ *
+ * The recovery record is kept in the first system block of the EEPROM:
+ *  - Word 0: last state of the system (Bits 7:0) and its zone (Bits 15:8), saved on every transition
+ *  - Word 1: fault that led to the last watchdog reset (Bits 7:0) and the task at fault (Bits 15:8)
+ *  - Word 2: number of consecutive watchdog resets (Bits 15:0)
+ *  - Word 3: number of consecutive wrong security codes (Bits 7:0), saved by code entry
+ * Bits 31:24 of each word hold SUPERVISOR_RECORD_MAGIC, so an erased word is not mistaken for a record.
+ * The words are written one at a time in the background, except the fault, which is
+ * written before the reset.
+ *
+ * The saved state is not restored after more than SUPERVISOR_MAX_RESTORES consecutive
+ * watchdog resets, so a fault in one state cannot reset the system forever. The count
+ * is cleared once the system has run for SUPERVISOR_STABLE_MS.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Period of the liveness checks
+#define SUPERVISOR_CHECK_PERIOD_MS      100
+
+// Number of checks in a row that a task may miss before the watchdog is no longer fed
+#define SUPERVISOR_MISSED_CHECK_LIMIT   3
+
+// Time from the last feed to the watchdog interrupt, and from the interrupt to the reset
+// (must be longer than SUPERVISOR_CHECK_PERIOD_MS * SUPERVISOR_MISSED_CHECK_LIMIT)
+#define SUPERVISOR_STALL_TIMEOUT_MS     500
+
+// Number of consecutive watchdog resets after which the saved state is no longer restored
+#define SUPERVISOR_MAX_RESTORES         3
+
+// Time after a reset from which the consecutive watchdog resets are counted again from zero
+#define SUPERVISOR_STABLE_MS            60000
+
+// Restore the saved state after a reset (0 = always start disarmed)
+#ifndef SUPERVISOR_RESTORE_STATE
+#define SUPERVISOR_RESTORE_STATE        1
+#endif
+
+_Static_assert(SUPERVISOR_STALL_TIMEOUT_MS > (SUPERVISOR_CHECK_PERIOD_MS * SUPERVISOR_MISSED_CHECK_LIMIT),
+    "The watchdog must not time out before a missed check-in is detected");
+
+/**
+ * @brief Faults that lead to a watchdog reset.
+ */
+enum Supervisor_Faults
+{
+    SUPERVISOR_FAULT_NONE       = 0,    // The last reset was not caused by the watchdog
+    SUPERVISOR_FAULT_CHECK_IN   = 1,    // A monitored task stopped answering the checks
+    SUPERVISOR_FAULT_STALL      = 2,    // A handler or an interrupt did not return
+    SUPERVISOR_FAULT_UNKNOWN    = 3,    // The watchdog reset the processor before the fault was recorded
+    SUPERVISOR_FAULT_CALLBACK   = 4     // A callback could not be registered (an observer or subscriber table is full)
+};
+
+/**
+ * @brief Description of the last reset.
+ */
+typedef struct
+{
+    uint8_t cause;              // Causes of the reset (see Watchdog_Reset_Causes)
+    uint8_t fault;              // See Supervisor_Faults
+    uint8_t task;               // Task at fault, or TASK_NONE
+    uint16_t restore_count;     // Number of consecutive watchdog resets
+} Supervisor_Reset_Record;
+
+/**
+ * @brief Reads the recovery record, registers TASK_SUPERVISOR, and starts the watchdog.
+ *
+ * A watchdog reset is recorded in the event log with the task at fault. This function
+ * must be called after Event_Log_Init (which initializes the EEPROM) and before the
+ * monitored tasks are added.
+ *
+ * @param reset_cause The causes of the reset (see Watchdog_Read_Reset_Cause).
+ *
+ * @return None
+ */
+void Supervisor_Init(uint8_t reset_cause);
+
+/**
+ * @brief Adds a task to the tasks that must answer every check.
+ *
+ * @param task_id The identifier of the task (see Task_IDs).
+ *
+ * @return None
+ */
+void Supervisor_Monitor(uint8_t task_id);
+
+/**
+ * @brief Records that a callback could not be registered and stops feeding the watchdog.
+ *
+ * The watchdog resets the processor at the next check. This function must be called
+ * after Supervisor_Init.
+ *
+ * @param task_id The task of the module that could not register, or TASK_NONE.
+ *
+ * @return None
+ */
+void Supervisor_Registration_Failed(uint8_t task_id);
+
+/**
+ * @brief Reports that a task is alive, in response to SIGNAL_SUPERVISOR_PING.
+ *
+ * @param task_id The identifier of the task.
+ *
+ * @return None
+ */
+void Supervisor_Check_In(uint8_t task_id);
+
+/**
+ * @brief Starts a check every SUPERVISOR_CHECK_PERIOD_MS.
+ *
+ * This function is called from the Timer 0A interrupt service routine (System_Tick in main.c)
+ * every 1 ms. A check is only posted once the previous one has been handled.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Supervisor_Tick(void);
+
+/**
+ * @brief Returns the number of ticks until the next check is posted.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of calls of Supervisor_Tick before the next check.
+ */
+uint32_t Supervisor_Get_Idle_Ticks(void);
+
+/**
+ * @brief Saves the state of the system in the recovery record.
+ *
+ * The state is written to the EEPROM in the background, and only when it changes.
+ *
+ * @param state The state of the system (see System_States).
+ *
+ * @param zone The zone of the intrusion in that state, or ZONE_NONE.
+ *
+ * @return None
+ */
+void Supervisor_Save_State(uint8_t state, uint8_t zone);
+
+/**
+ * @brief Copies the state that was saved before the last reset.
+ *
+ * @param state A pointer to where the state is copied.
+ *
+ * @param zone A pointer to where the zone is copied.
+ *
+ * @return uint8_t Returns 1 if the state is to be restored, or 0 if no state was saved,
+ *                 restoring is disabled, or the watchdog reset the system too many times in a row.
+ */
+uint8_t Supervisor_Get_Saved_State(uint8_t *state, uint8_t *zone);
+
+/**
+ * @brief Copies the description of the last reset.
+ *
+ * @param record A pointer to where the description is copied.
+ *
+ * @return None
+ */
+void Supervisor_Get_Reset_Record(Supervisor_Reset_Record *record);
+
+/**
+ * @brief Saves the number of consecutive wrong security codes in the recovery record.
+ *
+ * The count is written to the EEPROM in the background, and only when it changes.
+ *
+ * @param failed_attempts The number of consecutive wrong codes.
+ *
+ * @return None
+ */
+void Supervisor_Save_Failed_Attempts(uint8_t failed_attempts);
+
+/**
+ * @brief Returns the number of consecutive wrong security codes saved before the last reset.
+ *
+ * Unlike the state, the count is restored after any number of watchdog resets, so that
+ * a reset never ends a lockout early.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of consecutive wrong codes, or 0 if none was saved.
+ */
+uint8_t Supervisor_Get_Failed_Attempts(void);
+
+/**
+ * @brief Event handler of the supervisor task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Supervisor_Task(const Scheduler_Event *event);
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file System_State.c
+ *
+ * @brief Source code for the System_State module.
+ *
+ * This file contains the function definitions for the state machine of the Home
+ * Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "System_State.h"
+#include "Event_Log.h"
+#include "Supervisor.h"
+#include "Config.h"
+
+/**
+ * @brief One transition of the state machine.
+ */
+typedef struct
+{
+    uint8_t state;
+    uint8_t event;
+    uint8_t next_state;
+} System_State_Transition;
+
+// Every transition of the system. An event without a row for the current state is ignored.
+static const System_State_Transition transition_table[] =
+{
+    { SYSTEM_STATE_DISARMED,    SYSTEM_EVENT_ARM,           SYSTEM_STATE_EXIT_DELAY },
+    { SYSTEM_STATE_DISARMED,    SYSTEM_EVENT_CODE_VALID,    SYSTEM_STATE_EXIT_DELAY },
+    { SYSTEM_STATE_DISARMED,    SYSTEM_EVENT_PANIC,         SYSTEM_STATE_ALARM },
+    { SYSTEM_STATE_DISARMED,    SYSTEM_EVENT_LOCKOUT,       SYSTEM_STATE_LOCKOUT },
+
+    { SYSTEM_STATE_EXIT_DELAY,  SYSTEM_EVENT_TIMEOUT,       SYSTEM_STATE_ARMED },
+    { SYSTEM_STATE_EXIT_DELAY,  SYSTEM_EVENT_DISARM,        SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_EXIT_DELAY,  SYSTEM_EVENT_CODE_VALID,    SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_EXIT_DELAY,  SYSTEM_EVENT_PANIC,         SYSTEM_STATE_ALARM },
+
+    { SYSTEM_STATE_ARMED,       SYSTEM_EVENT_INTRUSION,     SYSTEM_STATE_ENTRY_DELAY },
+    { SYSTEM_STATE_ARMED,       SYSTEM_EVENT_DISARM,        SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ARMED,       SYSTEM_EVENT_CODE_VALID,    SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ARMED,       SYSTEM_EVENT_PANIC,         SYSTEM_STATE_ALARM },
+
+    { SYSTEM_STATE_ENTRY_DELAY, SYSTEM_EVENT_TIMEOUT,       SYSTEM_STATE_ALARM },
+    { SYSTEM_STATE_ENTRY_DELAY, SYSTEM_EVENT_DISARM,        SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ENTRY_DELAY, SYSTEM_EVENT_CODE_VALID,    SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ENTRY_DELAY, SYSTEM_EVENT_PANIC,         SYSTEM_STATE_ALARM },
+    { SYSTEM_STATE_ENTRY_DELAY, SYSTEM_EVENT_LOCKOUT,       SYSTEM_STATE_ALARM },   // The code was guessed during the entry delay
+
+    { SYSTEM_STATE_ALARM,       SYSTEM_EVENT_ALARM_DONE,    SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ALARM,       SYSTEM_EVENT_DISARM,        SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_ALARM,       SYSTEM_EVENT_CODE_VALID,    SYSTEM_STATE_DISARMED },
+
+    { SYSTEM_STATE_LOCKOUT,     SYSTEM_EVENT_LOCKOUT_END,   SYSTEM_STATE_DISARMED },
+    { SYSTEM_STATE_LOCKOUT,     SYSTEM_EVENT_PANIC,         SYSTEM_STATE_ALARM }
+};
+
+#define TRANSITION_COUNT (sizeof(transition_table) / sizeof(transition_table[0]))
+
+// Parameter that holds the duration of each state before SYSTEM_EVENT_TIMEOUT is delivered
+// (CONFIG_PARAM_COUNT = no timeout)
+static const uint8_t state_timeout_param[SYSTEM_STATE_COUNT] =
+{
+    [SYSTEM_STATE_DISARMED]     = CONFIG_PARAM_COUNT,
+    [SYSTEM_STATE_EXIT_DELAY]   = CONFIG_PARAM_EXIT_DELAY_MS,
+    [SYSTEM_STATE_ARMED]        = CONFIG_PARAM_COUNT,
+    [SYSTEM_STATE_ENTRY_DELAY]  = CONFIG_PARAM_ENTRY_DELAY_MS,
+    [SYSTEM_STATE_ALARM]        = CONFIG_PARAM_COUNT,
+    [SYSTEM_STATE_LOCKOUT]      = CONFIG_PARAM_COUNT
+};
+
+static const char *const state_names[SYSTEM_STATE_COUNT] =
+{
+    [SYSTEM_STATE_DISARMED]     = "Disarmed",
+    [SYSTEM_STATE_EXIT_DELAY]   = "Exit Delay",
+    [SYSTEM_STATE_ARMED]        = "Armed",
+    [SYSTEM_STATE_ENTRY_DELAY]  = "Entry Delay",
+    [SYSTEM_STATE_ALARM]        = "Alarm",
+    [SYSTEM_STATE_LOCKOUT]      = "Lockout"
+};
+
+// The state is written by TASK_SYSTEM_STATE only and read from any context
+static volatile uint8_t current_state = SYSTEM_STATE_DISARMED;
+
+static const System_State_Actions *state_actions = 0;
+
+static Scheduler_Timer state_timer;
+
+static System_State_Observer state_observers[SYSTEM_STATE_MAX_OBSERVERS];
+static uint8_t observer_count = 0;
+
+static void System_State_Enter(uint8_t next_state)
+{
+    uint8_t previous_state = current_state;
+
+    Scheduler_Timer_Stop(&state_timer);
+
+    if (state_actions[previous_state].exit != 0)
+    {
+        state_actions[previous_state].exit(next_state);
+    }
+
+    current_state = next_state;
+    Event_Log_Append(EVENT_LOG_STATE, next_state);
+
+    for (uint8_t i = 0; i < observer_count; i++)
+    {
+        (*state_observers[i])(previous_state, next_state);
+    }
+
+    // The duration is read on every entry, so a change applies the next time the state is entered
+    if (state_timeout_param[next_state] < CONFIG_PARAM_COUNT)
+    {
+        Scheduler_Timer_Start(&state_timer, TASK_SYSTEM_STATE, SIGNAL_STATE_TIMEOUT, Config_Get(state_timeout_param[next_state]), 0);
+    }
+
+    if (state_actions[next_state].entry != 0)
+    {
+        state_actions[next_state].entry(previous_state);
+    }
+}
+
+static void System_State_Dispatch(uint8_t event)
+{
+    for (uint8_t i = 0; i < TRANSITION_COUNT; i++)
+    {
+        if ((transition_table[i].state == current_state) && (transition_table[i].event == event))
+        {
+            System_State_Enter(transition_table[i].next_state);
+            return;
+        }
+    }
+}
+
+void System_State_Init(const System_State_Actions *actions)
+{
+    state_actions = actions;
+    current_state = SYSTEM_STATE_DISARMED;
+    Scheduler_Timer_Stop(&state_timer);
+
+    Scheduler_Add_Task(TASK_SYSTEM_STATE, System_State_Task);
+    Supervisor_Monitor(TASK_SYSTEM_STATE);
+}
+
+uint8_t System_State_Add_Observer(System_State_Observer observer)
+{
+    if (observer_count >= SYSTEM_STATE_MAX_OBSERVERS)
+    {
+        return 0;
+    }
+
+    state_observers[observer_count] = observer;
+    observer_count++;
+
+    return 1;
+}
+
+uint8_t System_State_Post(uint8_t event)
+{
+    // Scheduler_Post disables interrupts while the event queue is updated
+    return Scheduler_Post(TASK_SYSTEM_STATE, SIGNAL_STATE_EVENT, event);
+}
+
+uint8_t System_State_Restore(uint8_t state)
+{
+    return Scheduler_Post(TASK_SYSTEM_STATE, SIGNAL_STATE_RESTORE, state);
+}
+
+uint8_t System_State_Get(void)
+{
+    return current_state;
+}
+
+uint8_t System_State_Is_Armed(void)
+{
+    uint8_t state = current_state;
+
+    return ((state != SYSTEM_STATE_DISARMED) && (state != SYSTEM_STATE_LOCKOUT)) ? 1 : 0;
+}
+
+const char *System_State_Get_Name(uint8_t state)
+{
+    return (state < SYSTEM_STATE_COUNT) ? state_names[state] : "Unknown";
+}
+
+void System_State_Task(const Scheduler_Event *event)
+{
+    switch (event->signal)
+    {
+        case SIGNAL_STATE_EVENT:
+            if (event->param < SYSTEM_EVENT_COUNT)
+            {
+                System_State_Dispatch((uint8_t)event->param);
+            }
+            break;
+
+        case SIGNAL_STATE_TIMEOUT:
+            // Ignore the timeout of a state that has been left or entered again since the timer expired
+            if (!Scheduler_Timer_Active(&state_timer))
+            {
+                System_State_Dispatch(SYSTEM_EVENT_TIMEOUT);
+            }
+            break;
+
+        case SIGNAL_STATE_RESTORE:
+            if ((current_state == SYSTEM_STATE_DISARMED) && (event->param < SYSTEM_STATE_COUNT)
+                && (event->param != SYSTEM_STATE_DISARMED))
+            {
+                System_State_Enter((uint8_t)event->param);
+            }
+            break;
+
+        case SIGNAL_SUPERVISOR_PING:
+            Supervisor_Check_In(TASK_SYSTEM_STATE);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file System_State.h
+ *
+ * @brief Header file for the System_State module.
+ *
+ * This file contains the function definitions for the state machine of the Home
+ * Security System. It is the only place where the state of the system is kept:
+ * every other module calls System_State_Get instead of keeping its own copy.
+ *
+ * The state machine is table-driven. Each transition is one row of a constant table
+ * (current state, event, next state). When a transition is taken, the exit action of
+ * the current state and the entry action of the next state are called. The actions
+ * are supplied by the caller of System_State_Init, so this module only knows about
+ * states and events. Every transition is recorded in the event log.
+ *
+ * The exit and entry delays are timed with a scheduler timer. When the timer of a
+ * state expires, SYSTEM_EVENT_TIMEOUT is delivered to the state machine.
+ *
+ * Events are posted with System_State_Post, which is safe to call from interrupt
+ * handlers. The events are handled by TASK_SYSTEM_STATE in the order they were posted.
+ *
+ * After a reset, the state from before the reset can be entered again directly with
+ * System_State_Restore, without going through the transitions that led to it.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SYSTEM_STATE_H
+#define SYSTEM_STATE_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Default time to leave the house after arming and to enter the code after an intrusion
+// (changed at runtime with CONFIG_PARAM_EXIT_DELAY_MS and CONFIG_PARAM_ENTRY_DELAY_MS, see Config.h)
+#define SYSTEM_STATE_EXIT_DELAY_MS      10000
+#define SYSTEM_STATE_ENTRY_DELAY_MS     10000
+
+// Maximum number of functions notified of the state transitions (4 are used, the rest is headroom)
+#define SYSTEM_STATE_MAX_OBSERVERS      6
+
+/**
+ * @brief States of the system.
+ */
+enum System_States
+{
+    SYSTEM_STATE_DISARMED       = 0,    // The sensor is off
+    SYSTEM_STATE_EXIT_DELAY     = 1,    // Armed, waiting for the user to leave
+    SYSTEM_STATE_ARMED          = 2,    // The sensor is monitored for intrusions
+    SYSTEM_STATE_ENTRY_DELAY    = 3,    // An intrusion was detected, waiting for the code
+    SYSTEM_STATE_ALARM          = 4,    // The alarm is sounding
+    SYSTEM_STATE_LOCKOUT        = 5,    // Disarmed, and code entry is locked out
+    SYSTEM_STATE_COUNT
+};
+
+/**
+ * @brief Events that cause transitions between states.
+ */
+enum System_Events
+{
+    SYSTEM_EVENT_ARM            = 0,    // Arm request
+    SYSTEM_EVENT_DISARM         = 1,    // Disarm request
+    SYSTEM_EVENT_CODE_VALID     = 2,    // A valid code was entered (toggles arming)
+    SYSTEM_EVENT_PANIC          = 3,    // Panic request
+    SYSTEM_EVENT_INTRUSION      = 4,    // An intrusion was confirmed by the sensor
+    SYSTEM_EVENT_TIMEOUT        = 5,    // The duration of the current state has elapsed
+    SYSTEM_EVENT_ALARM_DONE     = 6,    // The alarm sequence has finished
+    SYSTEM_EVENT_LOCKOUT        = 7,    // Code entry has been locked out
+    SYSTEM_EVENT_LOCKOUT_END    = 8,    // Code entry lockout has ended
+    SYSTEM_EVENT_COUNT
+};
+
+/**
+ * @brief Entry and exit actions of one state.
+ *
+ * The entry action receives the previous state and the exit action receives the next
+ * state. Either action may be 0.
+ */
+typedef struct
+{
+    void (*entry)(uint8_t previous_state);
+    void (*exit)(uint8_t next_state);
+} System_State_Actions;
+
+/**
+ * @brief Observer executed in task context for every state transition.
+ */
+typedef void (*System_State_Observer)(uint8_t previous_state, uint8_t next_state);
+
+/**
+ * @brief Initializes the state machine in SYSTEM_STATE_DISARMED and registers TASK_SYSTEM_STATE.
+ *
+ * The entry action of the initial state is not called.
+ *
+ * @param actions A pointer to an array of SYSTEM_STATE_COUNT actions, indexed by state.
+ *
+ * @return None
+ */
+void System_State_Init(const System_State_Actions *actions);
+
+/**
+ * @brief Adds a function notified of every state transition.
+ *
+ * The observers are called in task context after the exit action of the previous state
+ * and before the entry action of the next state.
+ *
+ * @param observer A pointer to the function.
+ *
+ * @return uint8_t Returns 1 if the observer was added, or 0 if SYSTEM_STATE_MAX_OBSERVERS observers have been added.
+ */
+uint8_t System_State_Add_Observer(System_State_Observer observer);
+
+/**
+ * @brief Posts an event to the state machine.
+ *
+ * This function can be called from interrupt handlers.
+ *
+ * @param event The event to post (see System_Events).
+ *
+ * @return uint8_t Returns 1 if the event was queued, or 0 if the event queue is full.
+ */
+uint8_t System_State_Post(uint8_t event);
+
+/**
+ * @brief Enters a state directly from SYSTEM_STATE_DISARMED, to resume the state from before a reset.
+ *
+ * The state is entered by TASK_SYSTEM_STATE like any other transition: the entry action
+ * is called with SYSTEM_STATE_DISARMED as the previous state, the observers are notified,
+ * and the duration of the state starts again. Nothing happens if an event has changed the
+ * state before the task runs.
+ *
+ * @param state The state to enter (see System_States).
+ *
+ * @return uint8_t Returns 1 if the request was queued, or 0 if the event queue is full.
+ */
+uint8_t System_State_Restore(uint8_t state);
+
+/**
+ * @brief Returns the current state.
+ *
+ * @param None
+ *
+ * @return uint8_t The current state (see System_States).
+ */
+uint8_t System_State_Get(void);
+
+/**
+ * @brief Indicates whether the system is armed.
+ *
+ * The system is armed in every state between arming and disarming, including the
+ * exit delay, the entry delay, and the alarm.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the system is armed. Otherwise, it returns 0.
+ */
+uint8_t System_State_Is_Armed(void);
+
+/**
+ * @brief Returns the name of a state.
+ *
+ * @param state The state (see System_States).
+ *
+ * @return const char* The name of the state, or "Unknown" if the state is out of range.
+ */
+const char *System_State_Get_Name(uint8_t state);
+
+/**
+ * @brief Event handler of the state machine task.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void System_State_Task(const Scheduler_Event *event);
+
+#endif
@@ -0,0 +1,794 @@
+/**
+ * @file Telemetry.c
+ *
+ * @brief Source code for the Telemetry module.
+ *
+ * This file contains the function definitions for the binary telemetry and command
+ * link of the Home Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Telemetry.h"
+#include "UART0.h"
+#include "UART1.h"
+#include "Timebase.h"
+#include "Ranging.h"
+#include "Zone.h"
+#include "System_State.h"
+#include "Event_Log.h"
+#include "Keypad.h"
+#include "Power.h"
+#include "Profile.h"
+#include "Benchmark.h"
+#include "Clock.h"
+#include "Config.h"
+#include "Code_Entry.h"
+#include "Supervisor.h"
+
+// Length of the CRC-16 at the end of a packet
+#define TELEMETRY_CRC_SIZE          2
+
+// Length of the payload of a FILTER frame and a SET_FILTER command
+#define TELEMETRY_FILTER_SIZE       12
+
+// CRC-16 (CCITT, polynomial 0x1021) of each byte value, most significant bit first
+static const uint16_t crc16_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+static uint8_t stream_mask = 0;
+static Scheduler_Timer status_timer;
+
+// Set by the first valid frame from the host
+static uint8_t host_connected = 0;
+static Scheduler_Timer dump_timer;
+
+// Number of log records left in the dump in progress
+static uint16_t dump_remaining = 0;
+
+// Frame being received (COBS-encoded, without the delimiter)
+static uint8_t rx_frame[TELEMETRY_MAX_FRAME_SIZE];
+static uint8_t rx_length = 0;
+static uint8_t rx_overflow = 0;
+
+// Set by the UART0 receive task until TASK_TELEMETRY handles the new bytes
+static volatile uint8_t rx_event_pending = 0;
+
+static uint32_t frames_sent = 0;
+static uint32_t frames_dropped = 0;
+static uint32_t frames_rejected = 0;
+
+static void Telemetry_Put_U16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void Telemetry_Put_U32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t Telemetry_Get_U16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+// Encodes a packet with COBS and returns the length of the encoded packet (without the delimiter)
+static uint16_t Telemetry_COBS_Encode(const uint8_t *input, uint16_t length, uint8_t *output)
+{
+    uint16_t code_index = 0;
+    uint16_t output_index = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        if (input[i] == 0)
+        {
+            output[code_index] = code;
+            code_index = output_index++;
+            code = 1;
+        }
+        else
+        {
+            output[output_index++] = input[i];
+            code++;
+
+            // A block holds at most 254 non-zero bytes
+            if (code == 0xFF)
+            {
+                output[code_index] = code;
+                code_index = output_index++;
+                code = 1;
+            }
+        }
+    }
+
+    output[code_index] = code;
+
+    return output_index;
+}
+
+// Decodes a COBS-encoded packet and returns its length, or 0 if the encoding is invalid
+static uint16_t Telemetry_COBS_Decode(const uint8_t *input, uint16_t length, uint8_t *output)
+{
+    uint16_t input_index = 0;
+    uint16_t output_index = 0;
+
+    while (input_index < length)
+    {
+        uint8_t code = input[input_index++];
+
+        if ((code == 0) || ((input_index + code - 1) > length))
+        {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            output[output_index++] = input[input_index++];
+        }
+
+        // Every block except a full one and the last one ends with a zero byte
+        if ((code < 0xFF) && (input_index < length))
+        {
+            output[output_index++] = 0;
+        }
+    }
+
+    return output_index;
+}
+
+static void Telemetry_Send_Ack(uint8_t command, uint8_t result)
+{
+    uint8_t payload[2] = { command, result };
+
+    Telemetry_Send(TELEMETRY_FRAME_ACK, payload, sizeof(payload));
+}
+
+static void Telemetry_Send_Status(void)
+{
+    uint8_t payload[39];
+
+    Telemetry_Put_U32(&payload[0], Timebase_Get_Time_ms());
+    payload[4] = System_State_Get();
+    Telemetry_Put_U32(&payload[5], Ranging_Get_Sample_Count());
+    Telemetry_Put_U32(&payload[9], Ranging_Get_Timeout_Count());
+    Telemetry_Put_U32(&payload[13], frames_sent);
+    Telemetry_Put_U32(&payload[17], frames_dropped);
+    Telemetry_Put_U32(&payload[21], UART0_Get_Error_Count() + frames_rejected);
+    Telemetry_Put_U16(&payload[25], Event_Log_Get_Count());
+    Telemetry_Put_U32(&payload[27], Event_Log_Get_Dropped_Count());
+    Telemetry_Put_U32(&payload[31], Keypad_Get_Dropped_Count());
+    Telemetry_Put_U32(&payload[35], UART1_Get_Error_Count());
+
+    Telemetry_Send(TELEMETRY_FRAME_STATUS, payload, sizeof(payload));
+}
+
+static void Telemetry_Send_Filter(uint8_t zone)
+{
+    Intrusion_Filter_Config config;
+    uint8_t payload[TELEMETRY_FILTER_SIZE];
+
+    Zone_Get_Filter_Config(zone, &config);
+
+    payload[0] = zone;
+    Telemetry_Put_U16(&payload[1], config.enter_distance_mm);
+    Telemetry_Put_U16(&payload[3], config.exit_distance_mm);
+    Telemetry_Put_U16(&payload[5], config.approach_speed_mm_s);
+    Telemetry_Put_U16(&payload[7], config.approach_range_mm);
+    payload[9] = config.ema_shift;
+    payload[10] = config.confirm_count;
+    payload[11] = config.confirm_window;
+
+    Telemetry_Send(TELEMETRY_FRAME_FILTER, payload, sizeof(payload));
+}
+
+static uint8_t Telemetry_Send_Profile(uint8_t probe)
+{
+    Profile_Stats stats;
+    Power_Report report;
+    uint64_t total_us;
+    uint8_t payload[37];
+
+    if (!Profile_Get_Stats(probe, &stats))
+    {
+        return TELEMETRY_RESULT_BAD_ARGUMENT;
+    }
+
+    // The CPU load is the share of the time spent outside of the sleep modes
+    Power_Get_Report(&report);
+    total_us = report.time_us[POWER_MODE_RUN] + report.time_us[POWER_MODE_SLEEP] + report.time_us[POWER_MODE_DEEP_SLEEP];
+
+    payload[0] = probe;
+    Telemetry_Put_U32(&payload[1], stats.count);
+    Telemetry_Put_U32(&payload[5], stats.min_cycles);
+    Telemetry_Put_U32(&payload[9], stats.max_cycles);
+    Telemetry_Put_U32(&payload[13], stats.mean_cycles);
+    Telemetry_Put_U16(&payload[17], stats.load);
+    Telemetry_Put_U16(&payload[19], (total_us > 0) ? (uint16_t)((report.time_us[POWER_MODE_RUN] * 10000) / total_us) : 10000);
+
+    for (uint8_t bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++)
+    {
+        Telemetry_Put_U16(&payload[21 + (bin * 2)], (stats.histogram[bin] > 0xFFFF) ? 0xFFFF : (uint16_t)stats.histogram[bin]);
+    }
+
+    Telemetry_Send(TELEMETRY_FRAME_PROFILE, payload, sizeof(payload));
+
+    return TELEMETRY_RESULT_OK;
+}
+
+static uint8_t Telemetry_Send_Bench(uint8_t interval)
+{
+    Benchmark_Stats stats;
+    uint32_t failures = Benchmark_Get_Failure_Count();
+    uint8_t payload[33];
+
+    if (!Benchmark_Get_Stats(interval, &stats))
+    {
+        return TELEMETRY_RESULT_BAD_ARGUMENT;
+    }
+
+    payload[0] = interval;
+    Telemetry_Put_U16(&payload[1], (stats.count > 0xFFFF) ? 0xFFFF : (uint16_t)stats.count);
+    Telemetry_Put_U16(&payload[3], (failures > 0xFFFF) ? 0xFFFF : (uint16_t)failures);
+    Telemetry_Put_U32(&payload[5], stats.min_us);
+    Telemetry_Put_U32(&payload[9], stats.max_us);
+    Telemetry_Put_U32(&payload[13], stats.mean_us);
+
+    for (uint8_t bin = 0; bin < BENCHMARK_HISTOGRAM_BINS; bin++)
+    {
+        Telemetry_Put_U16(&payload[17 + (bin * 2)], (stats.histogram[bin] > 0xFFFF) ? 0xFFFF : (uint16_t)stats.histogram[bin]);
+    }
+
+    Telemetry_Send(TELEMETRY_FRAME_BENCH, payload, sizeof(payload));
+
+    return TELEMETRY_RESULT_OK;
+}
+
+static void Telemetry_Send_Boot(void)
+{
+    uint8_t payload[BENCHMARK_BOOT_STAGE_COUNT * 4];
+
+    for (uint8_t stage = 0; stage < BENCHMARK_BOOT_STAGE_COUNT; stage++)
+    {
+        Telemetry_Put_U32(&payload[stage * 4], Benchmark_Get_Boot_Time_us(stage));
+    }
+
+    Telemetry_Send(TELEMETRY_FRAME_BOOT, payload, sizeof(payload));
+}
+
+static uint8_t Telemetry_Disarm(const uint8_t *payload)
+{
+    switch (Code_Entry_Verify_Remote(payload))
+    {
+        case CODE_ENTRY_RESULT_ACCEPTED:
+            return Scheduler_Post(TASK_SECURITY, SIGNAL_DISARM_REQUEST, 0) ? TELEMETRY_RESULT_OK : TELEMETRY_RESULT_BUSY;
+
+        case CODE_ENTRY_RESULT_INVALID:
+            return TELEMETRY_RESULT_BAD_ARGUMENT;
+
+        default:
+            return TELEMETRY_RESULT_REJECTED;
+    }
+}
+
+static uint8_t Telemetry_Set_Filter(const uint8_t *payload)
+{
+    Intrusion_Filter_Config config;
+    uint8_t zone = payload[0];
+
+    if (zone >= Zone_Get_Count())
+    {
+        return TELEMETRY_RESULT_BAD_ARGUMENT;
+    }
+
+    config.enter_distance_mm = Telemetry_Get_U16(&payload[1]);
+    config.exit_distance_mm = Telemetry_Get_U16(&payload[3]);
+    config.approach_speed_mm_s = Telemetry_Get_U16(&payload[5]);
+    config.approach_range_mm = Telemetry_Get_U16(&payload[7]);
+    config.ema_shift = payload[9];
+    config.confirm_count = payload[10];
+    config.confirm_window = payload[11];
+
+    if ((config.exit_distance_mm < config.enter_distance_mm) || (config.ema_shift > 8)
+        || (config.confirm_window == 0) || (config.confirm_window > 32)
+        || (config.confirm_count == 0) || (config.confirm_count > config.confirm_window))
+    {
+        return TELEMETRY_RESULT_BAD_ARGUMENT;
+    }
+
+    Config_Set_Filter(zone, &config);
+
+    return TELEMETRY_RESULT_OK;
+}
+
+static uint8_t Telemetry_Send_Config(uint8_t param)
+{
+    uint16_t min;
+    uint16_t max;
+    uint8_t payload[7];
+
+    if (!Config_Get_Range(param, &min, &max))
+    {
+        return TELEMETRY_RESULT_BAD_ARGUMENT;
+    }
+
+    payload[0] = param;
+    Telemetry_Put_U16(&payload[1], Config_Get(param));
+    Telemetry_Put_U16(&payload[3], min);
+    Telemetry_Put_U16(&payload[5], max);
+
+    Telemetry_Send(TELEMETRY_FRAME_CONFIG, payload, sizeof(payload));
+
+    return TELEMETRY_RESULT_OK;
+}
+
+// Sends log records, oldest first, until the dump is complete or the transmit buffer is full
+static void Telemetry_Continue_Dump(void)
+{
+    Event_Log_Record record;
+    uint8_t payload[8];
+
+    while (dump_remaining > 0)
+    {
+        if (UART0_Transmit_Free() < TELEMETRY_MAX_FRAME_SIZE)
+        {
+            // Try again once the uDMA controller has sent some of the queued frames
+            Scheduler_Timer_Start(&dump_timer, TASK_TELEMETRY, SIGNAL_TELEMETRY_DUMP, TELEMETRY_DUMP_RETRY_MS, 0);
+            return;
+        }
+
+        dump_remaining--;
+
+        if (Event_Log_Get_Recent(dump_remaining, &record))
+        {
+            Telemetry_Put_U16(&payload[0], record.sequence);
+            Telemetry_Put_U32(&payload[2], record.timestamp_ms);
+            payload[6] = record.type;
+            payload[7] = record.param;
+
+            Telemetry_Send(TELEMETRY_FRAME_LOG_RECORD, payload, sizeof(payload));
+        }
+    }
+}
+
+static void Telemetry_Execute(const uint8_t *packet, uint8_t length)
+{
+    uint8_t command = packet[0];
+    const uint8_t *payload = &packet[1];
+    uint8_t payload_length = length - 1;
+    uint8_t result = TELEMETRY_RESULT_OK;
+
+    switch (command)
+    {
+        case TELEMETRY_COMMAND_ARM:
+            if (payload_length != 0)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else if (!Scheduler_Post(TASK_SECURITY, SIGNAL_ARM_REQUEST, 0))
+            {
+                result = TELEMETRY_RESULT_BUSY;
+            }
+            break;
+
+        case TELEMETRY_COMMAND_DISARM:
+            result = (payload_length == CODE_ENTRY_LENGTH) ? Telemetry_Disarm(payload) : TELEMETRY_RESULT_BAD_LENGTH;
+            break;
+
+        case TELEMETRY_COMMAND_SET_FILTER:
+            result = (payload_length == TELEMETRY_FILTER_SIZE) ? Telemetry_Set_Filter(payload) : TELEMETRY_RESULT_BAD_LENGTH;
+            break;
+
+        case TELEMETRY_COMMAND_GET_FILTER:
+            if (payload_length != 1)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else if (payload[0] >= Zone_Get_Count())
+            {
+                result = TELEMETRY_RESULT_BAD_ARGUMENT;
+            }
+            else
+            {
+                Telemetry_Send_Filter(payload[0]);
+            }
+            break;
+
+        case TELEMETRY_COMMAND_DUMP_LOG:
+            if (payload_length != 2)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else
+            {
+                uint16_t count = Telemetry_Get_U16(payload);
+                dump_remaining = (count < Event_Log_Get_Count()) ? count : Event_Log_Get_Count();
+            }
+            break;
+
+        case TELEMETRY_COMMAND_GET_STATUS:
+            if (payload_length != 0)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else
+            {
+                Telemetry_Send_Status();
+            }
+            break;
+
+        case TELEMETRY_COMMAND_SET_STREAM:
+            if (payload_length != 1)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else
+            {
+                Telemetry_Set_Streams(payload[0]);
+            }
+            break;
+
+        case TELEMETRY_COMMAND_GET_PROFILE:
+            result = (payload_length == 1) ? Telemetry_Send_Profile(payload[0]) : TELEMETRY_RESULT_BAD_LENGTH;
+            break;
+
+        case TELEMETRY_COMMAND_RESET_PROFILE:
+            if (payload_length != 0)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else
+            {
+                Profile_Reset();
+            }
+            break;
+
+        case TELEMETRY_COMMAND_BENCH_START:
+            if (payload_length != 1)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else if (payload[0] == 0)
+            {
+                result = TELEMETRY_RESULT_BAD_ARGUMENT;
+            }
+            else if (!Benchmark_Start(payload[0], TASK_TELEMETRY))
+            {
+                result = TELEMETRY_RESULT_BUSY;
+            }
+            break;
+
+        case TELEMETRY_COMMAND_BENCH_GET:
+            result = (payload_length == 1) ? Telemetry_Send_Bench(payload[0]) : TELEMETRY_RESULT_BAD_LENGTH;
+            break;
+
+        case TELEMETRY_COMMAND_BOOT_GET:
+            if (payload_length != 0)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else
+            {
+                Telemetry_Send_Boot();
+            }
+            break;
+
+        case TELEMETRY_COMMAND_SET_CLOCK:
+            if (payload_length != 1)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else if (payload[0] >= CLOCK_PROFILE_COUNT)
+            {
+                result = TELEMETRY_RESULT_BAD_ARGUMENT;
+            }
+            else if (Clock_Set_Profile(payload[0]) == 0)
+            {
+                result = TELEMETRY_RESULT_BUSY;
+            }
+            break;
+
+        case TELEMETRY_COMMAND_GET_CONFIG:
+            result = (payload_length == 1) ? Telemetry_Send_Config(payload[0]) : TELEMETRY_RESULT_BAD_LENGTH;
+            break;
+
+        case TELEMETRY_COMMAND_SET_CONFIG:
+            if (payload_length != 3)
+            {
+                result = TELEMETRY_RESULT_BAD_LENGTH;
+            }
+            else if (!Config_Set(payload[0], Telemetry_Get_U16(&payload[1])))
+            {
+                result = TELEMETRY_RESULT_BAD_ARGUMENT;
+            }
+            break;
+
+        default:
+            result = TELEMETRY_RESULT_UNKNOWN;
+            break;
+    }
+
+    Telemetry_Send_Ack(command, result);
+
+    if ((command == TELEMETRY_COMMAND_DUMP_LOG) && (result == TELEMETRY_RESULT_OK))
+    {
+        Scheduler_Timer_Stop(&dump_timer);
+        Telemetry_Continue_Dump();
+    }
+}
+
+static void Telemetry_Process_Frame(void)
+{
+    uint8_t packet[TELEMETRY_MAX_FRAME_SIZE];
+    uint16_t length = Telemetry_COBS_Decode(rx_frame, rx_length, packet);
+
+    // A packet holds at least the command and the CRC-16
+    if ((length < (1 + TELEMETRY_CRC_SIZE)) || (length > TELEMETRY_MAX_PACKET_SIZE))
+    {
+        frames_rejected++;
+        return;
+    }
+
+    length -= TELEMETRY_CRC_SIZE;
+
+    if (Telemetry_CRC16(0xFFFF, packet, length) != Telemetry_Get_U16(&packet[length]))
+    {
+        frames_rejected++;
+        return;
+    }
+
+    // The status stream only starts once a host is known to be listening, and the
+    // command can still select other streams
+    if (!host_connected)
+    {
+        host_connected = 1;
+        Telemetry_Set_Streams(stream_mask | TELEMETRY_STREAM_STATUS);
+    }
+
+    Telemetry_Execute(packet, (uint8_t)length);
+}
+
+// Executed from UART0_Handler when new bytes have been received
+static void Telemetry_Receive_Task(void)
+{
+    // Post one event for all of the bytes received before the task runs
+    if (!rx_event_pending)
+    {
+        rx_event_pending = 1;
+        Scheduler_Post(TASK_TELEMETRY, SIGNAL_TELEMETRY_RX, 0);
+    }
+}
+
+// Ranging engine subscriber executed in task context for every new sample
+static void Telemetry_Sample_Received(const Range_Sample *sample)
+{
+    uint8_t payload[16];
+
+    if (!(stream_mask & TELEMETRY_STREAM_SAMPLES))
+    {
+        return;
+    }
+
+    Telemetry_Put_U32(&payload[0], sample->sequence);
+    Telemetry_Put_U32(&payload[4], (uint32_t)sample->timestamp_us);
+    Telemetry_Put_U32(&payload[8], sample->echo_ticks);
+    Telemetry_Put_U16(&payload[12], sample->distance_mm);
+    payload[14] = sample->channel;
+    payload[15] = sample->status;
+
+    Telemetry_Send(TELEMETRY_FRAME_SAMPLE, payload, sizeof(payload));
+}
+
+// System state observer executed in task context for every transition
+static void Telemetry_State_Changed(uint8_t previous_state, uint8_t next_state)
+{
+    uint8_t payload[6];
+
+    Telemetry_Put_U32(&payload[0], Timebase_Get_Time_ms());
+    payload[4] = previous_state;
+    payload[5] = next_state;
+
+    Telemetry_Send(TELEMETRY_FRAME_STATE, payload, sizeof(payload));
+}
+
+void Telemetry_Init(void)
+{
+    frames_sent = 0;
+    frames_dropped = 0;
+    frames_rejected = 0;
+    rx_length = 0;
+    rx_overflow = 0;
+    rx_event_pending = 0;
+    dump_remaining = 0;
+    host_connected = 0;
+
+    UART0_Init();
+    UART0_Set_Receive_Task(&Telemetry_Receive_Task);
+
+    Scheduler_Add_Task(TASK_TELEMETRY, Telemetry_Task);
+
+    if (!Ranging_Subscribe(&Telemetry_Sample_Received))
+    {
+        Supervisor_Registration_Failed(TASK_TELEMETRY);
+    }
+
+    if (!System_State_Add_Observer(&Telemetry_State_Changed))
+    {
+        Supervisor_Registration_Failed(TASK_TELEMETRY);
+    }
+
+    Telemetry_Set_Streams(TELEMETRY_STREAM_SAMPLES);
+}
+
+void Telemetry_Set_Streams(uint8_t mask)
+{
+    stream_mask = mask;
+
+    if (stream_mask & TELEMETRY_STREAM_STATUS)
+    {
+        if (!Scheduler_Timer_Active(&status_timer))
+        {
+            Scheduler_Timer_Start(&status_timer, TASK_TELEMETRY, SIGNAL_TELEMETRY_STATUS, TELEMETRY_STATUS_PERIOD_MS, TELEMETRY_STATUS_PERIOD_MS);
+        }
+    }
+    else
+    {
+        Scheduler_Timer_Stop(&status_timer);
+    }
+}
+
+uint8_t Telemetry_Send(uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    uint8_t packet[TELEMETRY_MAX_PACKET_SIZE];
+    uint8_t frame[TELEMETRY_MAX_FRAME_SIZE];
+    uint16_t packet_length = 1 + length;
+    uint16_t frame_length;
+    uint16_t crc;
+
+    if (packet_length > (TELEMETRY_MAX_PACKET_SIZE - TELEMETRY_CRC_SIZE))
+    {
+        frames_dropped++;
+        return 0;
+    }
+
+    packet[0] = type;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        packet[1 + i] = payload[i];
+    }
+
+    crc = Telemetry_CRC16(0xFFFF, packet, packet_length);
+    Telemetry_Put_U16(&packet[packet_length], crc);
+    packet_length += TELEMETRY_CRC_SIZE;
+
+    frame_length = Telemetry_COBS_Encode(packet, packet_length, frame);
+    frame[frame_length++] = 0x00;
+
+    if (!UART0_Write(frame, frame_length))
+    {
+        frames_dropped++;
+        return 0;
+    }
+
+    frames_sent++;
+
+    return 1;
+}
+
+uint32_t Telemetry_Get_Dropped_Count(void)
+{
+    return frames_dropped;
+}
+
+uint16_t Telemetry_CRC16(uint16_t crc, const uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(uint8_t)((crc >> 8) ^ data[i])]);
+    }
+
+    return crc;
+}
+
+void Telemetry_Task(const Scheduler_Event *event)
+{
+    uint8_t data;
+
+    switch (event->signal)
+    {
+        case SIGNAL_TELEMETRY_RX:
+            // Clear the flag first so that bytes received from now on post a new event
+            rx_event_pending = 0;
+
+            while (UART0_Read_Byte(&data))
+            {
+                if (data == 0x00)
+                {
+                    // The delimiter ends the frame; a frame that overflowed is discarded
+                    if (rx_overflow)
+                    {
+                        frames_rejected++;
+                    }
+                    else if (rx_length > 0)
+                    {
+                        Telemetry_Process_Frame();
+                    }
+
+                    rx_length = 0;
+                    rx_overflow = 0;
+                }
+                else if (rx_length < sizeof(rx_frame))
+                {
+                    rx_frame[rx_length++] = data;
+                }
+                else
+                {
+                    rx_overflow = 1;
+                }
+            }
+            break;
+
+        case SIGNAL_TELEMETRY_STATUS:
+            if (stream_mask & TELEMETRY_STREAM_STATUS)
+            {
+                Telemetry_Send_Status();
+            }
+            break;
+
+        case SIGNAL_TELEMETRY_DUMP:
+            if (!Scheduler_Timer_Active(&dump_timer))
+            {
+                Telemetry_Continue_Dump();
+            }
+            break;
+
+        case SIGNAL_BENCH_DONE:
+            // The five frames fit in the transmit buffer of UART0
+            for (uint8_t interval = 0; interval < BENCHMARK_INTERVAL_COUNT; interval++)
+            {
+                Telemetry_Send_Bench(interval);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
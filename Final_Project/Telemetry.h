@@ -0,0 +1,239 @@
+/**
+ * @file Telemetry.h
+ *
+ * @brief Header file for the Telemetry module.
+ *
+ * This file contains the function definitions for the binary telemetry and command
+ * link of the Home Security System. The link runs on UART0 (the virtual COM port of
+ * the debugger) and streams range samples, state transitions, and status counters
+ * to a host computer, and accepts arm, disarm, and configuration commands.
+ *
+ * Every frame is a packet encoded with Consistent Overhead Byte Stuffing (COBS)
+ * followed by a 0x00 delimiter:
+ *
+ *     COBS(type, payload..., CRC-16 low byte, CRC-16 high byte), 0x00
+ *
+ * The CRC-16 is the CCITT polynomial (0x1021) with an initial value of 0xFFFF,
+ * computed over the type and the payload. Multi-byte fields are little-endian.
+ * A frame with a bad CRC is discarded without a reply.
+ *
+ * Device to host:
+ *  - SAMPLE (0x01): sequence u32, timestamp_us u32 (low 32 bits), echo_ticks u32,
+ *                   distance_mm u16, channel u8, status u8
+ *  - STATE (0x02): timestamp_ms u32, previous state u8, state u8
+ *  - STATUS (0x03): timestamp_ms u32, state u8, ranging samples u32, ranging timeouts u32,
+ *                   frames sent u32, frames dropped u32, link receive errors u32,
+ *                   log records u16, log records dropped u32, button events dropped u32,
+ *                   US-100 receive errors u32
+ *  - ACK (0x04): command u8, result u8 (see Telemetry_Results)
+ *  - FILTER (0x05): zone u8, enter_distance_mm u16, exit_distance_mm u16,
+ *                   approach_speed_mm_s u16, approach_range_mm u16, ema_shift u8,
+ *                   confirm_count u8, confirm_window u8
+ *  - LOG_RECORD (0x06): sequence u16, timestamp_ms u32, type u8, param u8
+ *  - PROFILE (0x07): probe u8, count u32, min_cycles u32, max_cycles u32, mean_cycles u32,
+ *                    probe load u16 (0.01 %), CPU load u16 (0.01 %), histogram 8 x u16
+ *                    (saturated at 65535)
+ *  - BENCH (0x08): interval u8, trials u16, failed trials u16, min_us u32, max_us u32,
+ *                  mean_us u32, histogram 8 x u16 (saturated at 65535)
+ *  - BOOT (0x09): protected_us u32, running_us u32, lcd_ready_us u32, armed_us u32
+ *                 (see Benchmark_Boot_Stages, 0 for a stage that has not been reached)
+ *  - CONFIG (0x0A): param u8, value u16, min u16, max u16 (see Config_Params)
+ *
+ * Host to device (each command is answered with an ACK):
+ *  - ARM (0x81): no payload
+ *  - DISARM (0x82): code CODE_ENTRY_LENGTH x u8 (digits 1 to 4). The code is verified
+ *    like a code entered with the buttons (see Code_Entry.h): a wrong code counts toward
+ *    the lockout and is answered with REJECTED, and so is any code during a lockout.
+ *  - SET_FILTER (0x83): the payload of a FILTER frame. The thresholds are saved in the
+ *    configuration (see Config.h) and kept across resets.
+ *  - GET_FILTER (0x84): zone u8, answered with a FILTER frame before the ACK
+ *  - DUMP_LOG (0x85): count u16, answered with up to count LOG_RECORD frames (oldest first)
+ *    after the ACK. The records are sent as space frees up in the transmit buffer.
+ *  - GET_STATUS (0x86): no payload, answered with a STATUS frame before the ACK
+ *  - SET_STREAM (0x87): mask u8 (see Telemetry_Streams). The sample stream is enabled
+ *    at reset, and the status stream once the first valid frame has been received.
+ *  - GET_PROFILE (0x88): probe u8 (see Profile_Probes), answered with a PROFILE frame
+ *    before the ACK. A probe without samples is answered with a zeroed PROFILE frame, and
+ *    a probe that does not exist with BAD_ARGUMENT.
+ *  - RESET_PROFILE (0x89): no payload
+ *  - BENCH_START (0x8A): trials u8, starts a run of latency trials (see Benchmark.h).
+ *    The system must be disarmed, otherwise the command is answered with BUSY. When the
+ *    run ends, one BENCH frame is sent for every interval (see Benchmark_Intervals).
+ *  - BENCH_GET (0x8B): interval u8, answered with a BENCH frame before the ACK
+ *  - BOOT_GET (0x8C): no payload, answered with a BOOT frame before the ACK
+ *  - SET_CLOCK (0x8D): profile u8 (see Clock_Profiles), switches the system clock. The
+ *    ACK is sent at the new clock. A profile whose oscillator did not start or whose PLL
+ *    did not lock is answered with BUSY and the power-save profile is used instead. A held
+ *    profile (see Clock_Hold_Profile) is also answered with BUSY. While the system is
+ *    armed, the power manager selects the power-save profile (see Power.h).
+ *  - GET_CONFIG (0x8E): param u8, answered with a CONFIG frame before the ACK
+ *  - SET_CONFIG (0x8F): param u8, value u16. The value applies immediately and is saved
+ *    CONFIG_SAVE_DELAY_MS after the last change. A value outside of the range of the
+ *    parameter is answered with BAD_ARGUMENT.
+ *
+ * Frames are only queued on the transmit buffer of UART0, which is drained by the
+ * uDMA controller, so the link never waits for the host. A frame that does not fit
+ * is dropped and counted.
+ *
+ * @note The link arms without the security code. It is meant for a host that is
+ * physically connected to the board.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "TM4C123GH6PM.h"
+#include "Scheduler.h"
+
+// Largest packet (type, payload, and CRC) before encoding
+#define TELEMETRY_MAX_PACKET_SIZE   48
+
+// Largest frame after COBS encoding, including the delimiter
+#define TELEMETRY_MAX_FRAME_SIZE    (TELEMETRY_MAX_PACKET_SIZE + (TELEMETRY_MAX_PACKET_SIZE / 254) + 2)
+
+// Period of the STATUS frame while it is streamed
+#define TELEMETRY_STATUS_PERIOD_MS  1000
+
+// Time to wait for space in the transmit buffer during a log dump
+#define TELEMETRY_DUMP_RETRY_MS     10
+
+/**
+ * @brief Types of frames sent to the host.
+ */
+enum Telemetry_Frame_Types
+{
+    TELEMETRY_FRAME_SAMPLE      = 0x01,
+    TELEMETRY_FRAME_STATE       = 0x02,
+    TELEMETRY_FRAME_STATUS      = 0x03,
+    TELEMETRY_FRAME_ACK         = 0x04,
+    TELEMETRY_FRAME_FILTER      = 0x05,
+    TELEMETRY_FRAME_LOG_RECORD  = 0x06,
+    TELEMETRY_FRAME_PROFILE     = 0x07,
+    TELEMETRY_FRAME_BENCH       = 0x08,
+    TELEMETRY_FRAME_BOOT        = 0x09,
+    TELEMETRY_FRAME_CONFIG      = 0x0A
+};
+
+/**
+ * @brief Commands received from the host.
+ */
+enum Telemetry_Commands
+{
+    TELEMETRY_COMMAND_ARM           = 0x81,
+    TELEMETRY_COMMAND_DISARM        = 0x82,
+    TELEMETRY_COMMAND_SET_FILTER    = 0x83,
+    TELEMETRY_COMMAND_GET_FILTER    = 0x84,
+    TELEMETRY_COMMAND_DUMP_LOG      = 0x85,
+    TELEMETRY_COMMAND_GET_STATUS    = 0x86,
+    TELEMETRY_COMMAND_SET_STREAM    = 0x87,
+    TELEMETRY_COMMAND_GET_PROFILE   = 0x88,
+    TELEMETRY_COMMAND_RESET_PROFILE = 0x89,
+    TELEMETRY_COMMAND_BENCH_START   = 0x8A,
+    TELEMETRY_COMMAND_BENCH_GET     = 0x8B,
+    TELEMETRY_COMMAND_BOOT_GET      = 0x8C,
+    TELEMETRY_COMMAND_SET_CLOCK     = 0x8D,
+    TELEMETRY_COMMAND_GET_CONFIG    = 0x8E,
+    TELEMETRY_COMMAND_SET_CONFIG    = 0x8F
+};
+
+/**
+ * @brief Results reported in an ACK frame.
+ */
+enum Telemetry_Results
+{
+    TELEMETRY_RESULT_OK             = 0,
+    TELEMETRY_RESULT_BAD_LENGTH     = 1,    // The payload does not have the length of the command
+    TELEMETRY_RESULT_BAD_ARGUMENT   = 2,    // An argument is out of range
+    TELEMETRY_RESULT_UNKNOWN        = 3,    // The command is not supported
+    TELEMETRY_RESULT_BUSY           = 4,    // The command could not be queued
+    TELEMETRY_RESULT_REJECTED       = 5     // The security code is wrong or code entry is locked out
+};
+
+/**
+ * @brief Streams selected with the SET_STREAM command.
+ *
+ * State transitions are always sent.
+ */
+enum Telemetry_Streams
+{
+    TELEMETRY_STREAM_SAMPLES    = 0x01,     // Every range sample
+    TELEMETRY_STREAM_STATUS     = 0x02      // A STATUS frame every TELEMETRY_STATUS_PERIOD_MS
+};
+
+/**
+ * @brief Initializes UART0 and registers TASK_TELEMETRY with the scheduler.
+ *
+ * Only the sample stream is enabled, which has no timer and only sends while the sensors
+ * are running. The status stream is enabled by the first valid frame from the host, so
+ * that a board without a host can enter deep sleep. This function must be called after
+ * Scheduler_Init and Ranging_Init.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Telemetry_Init(void);
+
+/**
+ * @brief Selects the streams sent to the host.
+ *
+ * The status stream keeps a periodic scheduler timer running, which prevents the
+ * deep-sleep mode. The host disables it with SET_STREAM to let the board enter deep
+ * sleep while disarmed.
+ *
+ * @param mask The streams to enable (see Telemetry_Streams).
+ *
+ * @return None
+ */
+void Telemetry_Set_Streams(uint8_t mask);
+
+/**
+ * @brief Encodes a packet and queues the frame on UART0.
+ *
+ * @param type The type of the frame (see Telemetry_Frame_Types).
+ *
+ * @param payload A pointer to the payload.
+ *
+ * @param length The length of the payload in bytes (at most TELEMETRY_MAX_PACKET_SIZE - 3).
+ *
+ * @return uint8_t Returns 1 if the frame was queued, or 0 if it was dropped.
+ */
+uint8_t Telemetry_Send(uint8_t type, const uint8_t *payload, uint8_t length);
+
+/**
+ * @brief Returns the number of frames dropped because the transmit buffer was full.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of dropped frames since initialization.
+ */
+uint32_t Telemetry_Get_Dropped_Count(void);
+
+/**
+ * @brief Computes the CRC-16 (CCITT) of a block of bytes.
+ *
+ * @param crc The initial value (0xFFFF for a new block).
+ *
+ * @param data A pointer to the bytes.
+ *
+ * @param length The number of bytes.
+ *
+ * @return uint16_t The CRC-16 of the block.
+ */
+uint16_t Telemetry_CRC16(uint16_t crc, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Event handler of the telemetry task.
+ *
+ * Decodes and executes received commands, sends the periodic STATUS frame,
+ * continues a log dump, and reports the results of a benchmark run.
+ *
+ * @param event A pointer to the event to handle.
+ *
+ * @return None
+ */
+void Telemetry_Task(const Scheduler_Event *event);
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file Timebase.c
+ *
+ * @brief Source code for the Timebase driver.
+ *
+ * This file contains the function definitions for the Timebase driver.
+ * It provides a monotonic 64-bit microsecond clock and non-blocking deadline timers.
+ *
+ * The SysTick timer free-runs at its full 24-bit reload value using the
+ * Peripheral Internal Oscillator (PIOSC) divided by 4 (4 MHz) as the clock source.
+ * Each SysTick count is 0.25 us, and the SysTick interrupt is only used to count
+ * rollovers, which occur every (2^24 / 4 MHz) = 4.194304 seconds.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Timebase.h"
+#include "Profile.h"
+
+// Pending bit of the SysTick exception (PENDSTSET, Bit 26) in the ICSR register
+#define SCB_ICSR_SYSTICK_PENDING 0x04000000
+
+// Number of times the SysTick counter has reloaded since initialization
+static volatile uint32_t systick_rollovers = 0;
+
+void Timebase_Init(void)
+{
+	// Disable the SysTick timer before configuration
+	SysTick->CTRL = 0;
+
+	// Set the SysTick timer reload value to the maximum 24-bit value
+	// Each clock cycle is (1 / 4 MHz) = 0.25 us, so the timer reloads every 4.194304 s
+	SysTick->LOAD = TIMEBASE_SYSTICK_RELOAD;
+
+	// Clear the VAL register by writing any value to it
+	SysTick->VAL = 0;
+
+	// Reset the rollover count
+	systick_rollovers = 0;
+
+	// Enable the SysTick timer and its interrupt
+	// with the Peripheral Internal Oscillator (PIOSC) as the clock source
+	SysTick->CTRL |= 0x03;
+}
+
+uint64_t Timebase_Get_Time_us(void)
+{
+	uint32_t rollovers;
+	uint32_t current_value;
+	uint32_t rollover_pending;
+
+	// Read the rollover count and the counter value until the rollover count is stable
+	// so that a SysTick interrupt between the two reads does not produce a torn value
+	do
+	{
+		rollovers = systick_rollovers;
+		current_value = SysTick->VAL;
+		rollover_pending = SCB->ICSR & SCB_ICSR_SYSTICK_PENDING;
+	} while (rollovers != systick_rollovers);
+
+	// If the counter reloaded but the SysTick interrupt has not run yet (for example,
+	// when called from a higher priority interrupt or with interrupts disabled),
+	// account for the rollover here. A counter value in the upper half means the
+	// VAL register was read after the reload.
+	if (rollover_pending && (current_value > (TIMEBASE_SYSTICK_RELOAD / 2)))
+	{
+		rollovers = rollovers + 1;
+	}
+
+	// The SysTick timer counts down, so the number of elapsed counts in the
+	// current period is (RELOAD - VAL)
+	uint64_t elapsed_ticks = ((uint64_t)rollovers * (TIMEBASE_SYSTICK_RELOAD + 1))
+		+ (TIMEBASE_SYSTICK_RELOAD - current_value);
+
+	return elapsed_ticks / TIMEBASE_TICKS_PER_US;
+}
+
+uint32_t Timebase_Get_Time_ms(void)
+{
+	return (uint32_t)(Timebase_Get_Time_us() / 1000);
+}
+
+void Timer_Start(Timer_Handle *timer, uint32_t timeout_us)
+{
+	timer->deadline_us = Timebase_Get_Time_us() + timeout_us;
+}
+
+uint8_t Timer_Expired(const Timer_Handle *timer)
+{
+	return (Timebase_Get_Time_us() >= timer->deadline_us) ? 1 : 0;
+}
+
+uint32_t Timer_Remaining_us(const Timer_Handle *timer)
+{
+	uint64_t current_time_us = Timebase_Get_Time_us();
+
+	if (current_time_us >= timer->deadline_us)
+	{
+		return 0;
+	}
+
+	return (uint32_t)(timer->deadline_us - current_time_us);
+}
+
+void SysTick_Handler(void)
+{
+	PROFILE_BEGIN();
+
+	// Increment the rollover count to indicate that 2^24 SysTick counts have passed
+	systick_rollovers = systick_rollovers + 1;
+
+	PROFILE_END(PROFILE_PROBE_SYSTICK);
+}
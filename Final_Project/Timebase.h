@@ -0,0 +1,122 @@
+/**
+ * @file Timebase.h
+ *
+ * @brief Header file for the Timebase driver.
+ *
+ * This file contains the function definitions for the Timebase driver.
+ * It provides a monotonic 64-bit microsecond clock and non-blocking deadline timers.
+ *
+ * The SysTick timer free-runs at its full 24-bit reload value using the
+ * Peripheral Internal Oscillator (PIOSC) divided by 4 (4 MHz) as the clock source.
+ * Each SysTick count is 0.25 us, and the SysTick interrupt is only used to count
+ * rollovers, which occur every (2^24 / 4 MHz) = 4.194304 seconds. The current time
+ * is built from the rollover count and the SysTick VAL register, so reading the
+ * clock does not depend on a 1 us interrupt.
+ *
+ * Drivers that need to wait use a Timer_Handle: Timer_Start records a deadline,
+ * and Timer_Expired can be polled from a state machine or a task without blocking.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include "TM4C123GH6PM.h"
+
+// SysTick reload value used for the free-running counter (24-bit maximum)
+#define TIMEBASE_SYSTICK_RELOAD     0x00FFFFFF
+
+// Number of SysTick counts per microsecond (PIOSC / 4 = 4 MHz)
+#define TIMEBASE_TICKS_PER_US       4
+
+/**
+ * @brief Deadline handle used by the non-blocking timer functions.
+ *
+ * A Timer_Handle stores the absolute time (in microseconds) at which it expires.
+ * It does not use any hardware resources, so any number of handles can be active.
+ */
+typedef struct
+{
+	uint64_t deadline_us;
+} Timer_Handle;
+
+/**
+ * @brief Initializes the SysTick timer as a free-running 64-bit microsecond clock.
+ *
+ * This function configures the SysTick timer with its maximum 24-bit reload value
+ * and the PIOSC / 4 clock source. The SysTick interrupt is enabled to count rollovers
+ * every 4.194304 seconds.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timebase_Init(void);
+
+/**
+ * @brief Returns the time elapsed since Timebase_Init was called in microseconds.
+ *
+ * The value is monotonic and does not overflow during the lifetime of the device.
+ * It is safe to call this function from an interrupt service routine or with interrupts disabled.
+ *
+ * @param None
+ *
+ * @return uint64_t The elapsed time in microseconds.
+ */
+uint64_t Timebase_Get_Time_us(void);
+
+/**
+ * @brief Returns the time elapsed since Timebase_Init was called in milliseconds.
+ *
+ * @param None
+ *
+ * @return uint32_t The elapsed time in milliseconds. Wraps after about 49.7 days.
+ */
+uint32_t Timebase_Get_Time_ms(void);
+
+/**
+ * @brief Starts a non-blocking deadline timer.
+ *
+ * This function sets the deadline of the timer to the current time plus the specified timeout.
+ *
+ * @param timer A pointer to the timer handle to start.
+ *
+ * @param timeout_us The timeout in microseconds.
+ *
+ * @return None
+ */
+void Timer_Start(Timer_Handle *timer, uint32_t timeout_us);
+
+/**
+ * @brief Checks if a deadline timer has expired.
+ *
+ * @param timer A pointer to a timer handle that was started with Timer_Start.
+ *
+ * @return uint8_t Returns 1 if the deadline has been reached. Otherwise, it returns 0.
+ */
+uint8_t Timer_Expired(const Timer_Handle *timer);
+
+/**
+ * @brief Returns the time remaining before a deadline timer expires.
+ *
+ * @param timer A pointer to a timer handle that was started with Timer_Start.
+ *
+ * @return uint32_t The remaining time in microseconds, or 0 if the timer has expired.
+ */
+uint32_t Timer_Remaining_us(const Timer_Handle *timer);
+
+/**
+ * @brief The SysTick_Handler function is the interrupt service routine for the SysTick timer.
+ *
+ * This function is called every time the SysTick counter reaches zero and reloads,
+ * which happens every 4.194304 seconds. It increments the rollover count used to
+ * extend the 24-bit SysTick counter to 64 bits.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void SysTick_Handler(void);
+
+#endif
@@ -9,7 +9,13 @@
  * @note Timer 0A has been configured to generate periodic interrupts every 1 ms
  * for the Timers lab.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The prescaler is derived from the system clock (see Clock.h), and it is updated
+ * when the clock profile changes. Timer 0A stays clocked in deep-sleep mode, where the
+ * prescaler is derived from the deep-sleep clock instead (see Power.h).
+ *
+ * @note The interval between two interrupts can be stretched to several ticks while the
+ * system is idle (see Power.h). The user-defined task is then executed once for every
+ * tick of the interval, so it still counts every millisecond.
  * 
  * @note Refer to Table 2-9 (Interrupts) on pages 104 - 106 from the TM4C123G Microcontroller Datasheet
  * to view the Vector Number, Interrupt Request (IRQ) Number, and the Vector Address
@@ -27,14 +33,28 @@
 #include "GPIO.h"
 #include "stdio.h"
 #include "Security.h"
+#include "Profile.h"
+#include "Clock.h"
 
 // Declare pointer to the user-defined task
 void (*Timer_0A_Task)(void);
 
+// Number of 1 ms ticks between two interrupts
+static volatile uint32_t tick_interval = 1;
+
+static void Timer_0A_Run_Ticks(uint32_t tick_count)
+{
+	for (uint32_t i = 0; i < tick_count; i++)
+	{
+		(*Timer_0A_Task)();
+	}
+}
+
 void Timer_0A_Interrupt_Init(void(*task)(void))
 {
 	// Store the user-defined task function for use during interrupt handling
 	Timer_0A_Task = task;
+	tick_interval = 1;
 	
 	// Set the R0 bit (Bit 0) in the RCGCTIMER register
 	// to enable the clock for Timer 0A
@@ -52,14 +72,14 @@ void Timer_0A_Interrupt_Init(void(*task)(void))
 	// 0x2 = Periodic Timer Mode
 	TIMER0->TAMR |= 0x02;
 	
-	// Clear the bits of the TAPSR field (Bits 7 to 0) in the
-	// GPTMTAPR register before setting the prescale value
-	TIMER0->TAPR &= ~0x000000FF;
-	
-	// Set the prescale value to 50 by setting the bits of the
-	// TAPSR field (Bits 7 to 0) in the GPTMTAPR register
-	// New timer clock frequency = (50 MHz / 50) = 1 MHz
-	TIMER0->TAPR = 50;
+	// Set the prescale value in the TAPSR field (Bits 7 to 0) of the GPTMTAPR register
+	// New timer clock frequency = (system clock / (TAPR + 1)) = 1 MHz
+	Timer_0A_Interrupt_Set_Clock(Clock_Get_Hz());
+	if (!Clock_Subscribe(&Timer_0A_Interrupt_Set_Clock))
+	{
+		// The prescaler is only valid for the current profile
+		Clock_Hold_Profile();
+	}
 	
 	// Set the timer interval load value by writing to the
 	// TAILR field (Bits 31 to 0) in the GPTMTAILR register
@@ -88,6 +108,74 @@ void Timer_0A_Interrupt_Init(void(*task)(void))
 	TIMER0->CTL |= 0x01;
 }
 
+void Timer_0A_Interrupt_Set_Interval(uint32_t interval_ms)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	if (interval_ms < 1)
+	{
+		interval_ms = 1;
+	}
+	else if (interval_ms > TIMER_0A_MAX_INTERVAL_MS)
+	{
+		interval_ms = TIMER_0A_MAX_INTERVAL_MS;
+	}
+	
+	// A time-out that has not been handled yet ends the current interval:
+	// execute its ticks now, since the counter has already been reloaded
+	if (TIMER0->RIS & 0x01)
+	{
+		TIMER0->ICR |= 0x01;
+		Timer_0A_Run_Ticks(tick_interval);
+	}
+	
+	// The counter (Bits 15 to 0 of the GPTMTAV register) holds the number of
+	// microseconds left in the current interval, minus one
+	uint32_t count = TIMER0->TAV & 0xFFFF;
+	uint32_t elapsed_ticks = ((tick_interval * 1000) - 1 - count) / 1000;
+	uint32_t next_tick_us = (count + 1) % 1000;
+	
+	if (next_tick_us == 0)
+	{
+		next_tick_us = 1000;
+	}
+	
+	// Execute the ticks that have already elapsed, and keep the phase of the next tick
+	Timer_0A_Run_Ticks(elapsed_ticks);
+	tick_interval = interval_ms;
+	TIMER0->TAILR = (interval_ms * 1000) - 1;
+	TIMER0->TAV = (next_tick_us - 1) + ((interval_ms - 1) * 1000);
+	
+	__set_PRIMASK(primask);
+}
+
+void Timer_0A_Interrupt_Set_Clock(uint32_t timer_clock_hz)
+{
+	// Divide the timer clock down to 1 MHz. The timer counts TAPR + 1 clock cycles
+	// per tick, so the prescale value is one less than the number of cycles per 1 us.
+	TIMER0->TAPR = (timer_clock_hz / 1000000) - 1;
+}
+
+void TIMER0A_Handler(void)
+{
+	PROFILE_BEGIN();
+	
+	// Check if the Timer 0A time-out interrupt has occurred
+	// by reading the TATOMIS bit (Bit 0) in the GPTMMIS register
+	if (TIMER0->MIS & 0x01)
+	{
+		// Execute the user-defined task for every tick of the interval
+		Timer_0A_Run_Ticks(tick_interval);
+		
+		// Acknowledge the Timer 0A interrupt and clear it
+		// by setting the TATOCINT bit (Bit 0) in the GPTMICR register
+		TIMER0->ICR |= 0x01;
+	}
+	
+	PROFILE_END(PROFILE_PROBE_TIMER0A);
+}
+
 ///////////////////////////////////////////////////////////////
 
 
@@ -9,7 +9,8 @@
  * @note Timer 0A has been configured to generate periodic interrupts every 1 ms
  * for the Timers lab.
  *
- * @note This driver assumes that the system clock's frequency is 50 MHz.
+ * @note The prescaler is derived from the current system clock (see Clock.h) and is
+ * updated when the clock profile changes.
  * 
  * @note Refer to Table 2-9 (Interrupts) on pages 104 - 106 from the TM4C123G Microcontroller Datasheet
  * to view the Vector Number, Interrupt Request (IRQ) Number, and the Vector Address
@@ -20,6 +21,9 @@
  
 #include "TM4C123GH6PM.h"
 
+// Longest interval between two interrupts (the 16-bit counter runs at 1 MHz)
+#define TIMER_0A_MAX_INTERVAL_MS 65
+
 // Declare pointer to the user-defined task
 extern void (*Timer_0A_Task)(void);
 
@@ -27,7 +31,7 @@ extern void (*Timer_0A_Task)(void);
  * @brief Initializes the Timer 0A peripheral to generate periodic interrupts.
  *
  * This function initializes the Timer 1A peripheral to generate periodic interrupts for executing a user-defined task.
- * It configures Timer 0A with a 1 ms interval using the 50MHz system clock source.
+ * It configures Timer 0A with a 1 ms interval using the system clock source.
  * The provided task function will be executed whenever Timer 0A generates an interrupt.
  * The priority level is set to 1.
  *
@@ -37,6 +41,32 @@ extern void (*Timer_0A_Task)(void);
  */
 void Timer_0A_Interrupt_Init(void(*task)(void));
 
+/**
+ * @brief Sets the number of 1 ms ticks between two Timer 0A interrupts.
+ *
+ * The ticks of the current interval that have already elapsed are executed first, and
+ * the next tick keeps its phase, so no tick is lost or added. Each interrupt then
+ * executes the user-defined task once for every tick of the interval.
+ *
+ * @param interval_ms The interval in milliseconds (1 to TIMER_0A_MAX_INTERVAL_MS).
+ *
+ * @return None
+ */
+void Timer_0A_Interrupt_Set_Interval(uint32_t interval_ms);
+
+/**
+ * @brief Sets the prescaler for the clock that drives Timer 0A.
+ *
+ * The prescaler divides the timer clock down to 1 MHz. It is set from the system clock
+ * at every profile change, and from the deep-sleep clock while the processor is in
+ * deep-sleep mode (see Power.h), so the tick keeps its rate in every mode.
+ *
+ * @param timer_clock_hz The frequency of the timer clock in Hz (a multiple of 1 MHz).
+ *
+ * @return None
+ */
+void Timer_0A_Interrupt_Set_Clock(uint32_t timer_clock_hz);
+
 /**
  * @brief The interrupt service routine (ISR) for Timer 0A.
  *
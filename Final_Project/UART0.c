@@ -0,0 +1,275 @@
+/**
+ * @file UART0.c
+ *
+ * @brief Source code for the UART0 driver.
+ *
+ * This file contains the function definitions for the UART0 driver.
+ *
+ * @note For more information regarding the UART module, refer to the
+ * Universal Asynchronous Receivers / Transmitters (UARTs) section
+ * of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
+ *
+ * @note The baud rate divisor is derived from the system clock (see Clock.h), and it is
+ * updated when the clock profile changes.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "UART0.h"
+#include "uDMA.h"
+#include "Profile.h"
+#include "Pin_Map.h"
+#include "Clock.h"
+
+// UART0 interrupt bits in the IM, RIS, MIS, and ICR registers
+#define UART0_RX_INTERRUPT              0x010 // RXIM  (Bit 4)
+#define UART0_RX_TIMEOUT_INTERRUPT      0x040 // RTIM  (Bit 6)
+#define UART0_ERROR_INTERRUPTS          0x780 // FEIM, PEIM, BEIM, OEIM (Bits 10 to 7)
+
+// Flag bits in the FR register
+#define UART0_BUSY_BIT_MASK             0x08
+#define UART0_RECEIVE_FIFO_EMPTY_BIT_MASK 0x10
+
+// Error flags (Bits 11 to 8) returned with each byte by the DR register
+#define UART0_DATA_ERROR_BIT_MASK       0xF00
+
+// UART0 has an Interrupt Request (IRQ) number of 5
+#define UART0_IRQ_BIT                   (1 << 5)
+
+// The transmit FIFO requests a burst when it is at most half full (8 free entries),
+// so each arbitration moves 4 bytes
+#define UART0_TX_DMA_CONTROL            (UDMA_CTL_DST_INC_NONE | UDMA_CTL_DST_SIZE_8 | \
+                                         UDMA_CTL_SRC_INC_8 | UDMA_CTL_SRC_SIZE_8 | \
+                                         UDMA_CTL_ARB_SIZE(2) | UDMA_CTL_MODE_BASIC)
+
+// Declare pointer to the user-defined receive task
+void (*UART0_Receive_Task)(void) = 0;
+
+// Transmit buffer: bytes between tx_tail and tx_head are queued
+// tx_head is written by UART0_Write only and tx_tail by UART0_Handler only
+static uint8_t tx_storage[UART0_TX_BUFFER_SIZE];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+
+// Number of bytes moved by the uDMA transfer in progress (0 if the channel is idle)
+static volatile uint16_t tx_dma_length = 0;
+
+// Receive ring buffer
+static uint8_t rx_storage[UART0_RX_BUFFER_SIZE];
+static Ring_Buffer rx_buffer;
+
+// Number of received bytes lost since initialization
+static volatile uint32_t rx_error_count = 0;
+
+// Programs a uDMA transfer for the contiguous block of bytes that starts at tx_tail
+// Must be called with the UART0 interrupt disabled or from UART0_Handler
+static void UART0_Start_DMA(void)
+{
+	uint16_t head = tx_head;
+	uint16_t tail = tx_tail;
+	uint16_t length;
+
+	// A block ends at tx_head or at the end of the transmit buffer
+	length = (head >= tail) ? (head - tail) : (UART0_TX_BUFFER_SIZE - tail);
+
+	if (length > UDMA_MAX_TRANSFER_SIZE)
+	{
+		length = UDMA_MAX_TRANSFER_SIZE;
+	}
+
+	tx_dma_length = length;
+
+	if (length == 0)
+	{
+		return;
+	}
+
+	uDMA_Set_Transfer(UART0_TX_DMA_CHANNEL, 0, &tx_storage[tail + length - 1], &UART0->DR,
+		UART0_TX_DMA_CONTROL | UDMA_CTL_XFER_SIZE(length));
+	uDMA_Enable_Channel(UART0_TX_DMA_CHANNEL);
+}
+
+static void UART0_Clock_Changed(uint32_t system_clock_hz)
+{
+	uint32_t divisor = Clock_Get_UART_Divisor(UART0_BAUD_RATE);
+	uint32_t enabled = UART0->CTL & 0x01;
+	
+	// The divisor can only be changed while UART0 is disabled, after the current byte
+	UART0->CTL &= ~0x01;
+	while (UART0->FR & UART0_BUSY_BIT_MASK);
+	
+	// Write the integer and fractional parts of the divisor, then the LCRH register
+	// to latch them
+	UART0->IBRD = divisor >> 6;
+	UART0->FBRD = divisor & 0x3F;
+	UART0->LCRH = UART0->LCRH;
+	
+	UART0->CTL |= enabled;
+}
+
+void UART0_Init(void)
+{
+	// Enable the clock to UART0 by setting the
+	// R0 bit (Bit 0) in the RCGCUART register
+	SYSCTL->RCGCUART |= 0x01;
+
+	// Enable the clock to the port of the UART0 pins
+	SYSCTL->RCGCGPIO |= PIN_CLOCK(PIN_UART0);
+
+	// Disable the UART0 module before configuration by clearing
+	// the UARTEN bit (Bit 0) in the CTL register
+	UART0->CTL &= ~0x01;
+
+	// Set the baud rate: divisor = system clock / (16 * 115200)
+	// For example, at 80 MHz: 43.4028, IBRD = 43, FBRD = round(0.4028 * 64) = 26
+	uint32_t divisor = Clock_Get_UART_Divisor(UART0_BAUD_RATE);
+	UART0->IBRD = divisor >> 6;
+	UART0->FBRD = divisor & 0x3F;
+
+	// Configure 8 data bits, no parity, one stop bit, and enable the FIFOs
+	UART0->LCRH = 0x60 | 0x10;
+
+	// Trigger the receive interrupt when the receive FIFO is 1/2 full and
+	// the transmit uDMA request when the transmit FIFO is 1/2 full
+	UART0->IFLS = (0x2 << 3) | 0x2;
+
+	// Configure the A0 (U0RX) and A1 (U0TX) pins to use the alternate function
+	PIN_ALTERNATE_INIT(PIN_UART0);
+
+	// Initialize the buffers
+	Ring_Buffer_Init(&rx_buffer, rx_storage, UART0_RX_BUFFER_SIZE);
+	tx_head = 0;
+	tx_tail = 0;
+	tx_dma_length = 0;
+	rx_error_count = 0;
+
+	// Assign uDMA channel 9 to the UART0 transmitter and enable the transmit
+	// uDMA request by setting the TXDMAE bit (Bit 1) in the DMACTL register
+	uDMA_Init();
+	uDMA_Assign_Channel(UART0_TX_DMA_CHANNEL, UART0_TX_DMA_ENCODING);
+	UART0->DMACTL = 0x02;
+
+	// Enable the UART0 module with its transmitter (TXE, Bit 8) and receiver (RXE, Bit 9)
+	UART0->CTL |= 0x301;
+
+	// Clear any pending UART0 interrupts and enable the receive, receive timeout, and
+	// error interrupts. The transmit interrupt is not used; the uDMA completion
+	// interrupt is signaled on the UART0 interrupt.
+	UART0->ICR = 0x7F0;
+	UART0->IM = UART0_RX_INTERRUPT | UART0_RX_TIMEOUT_INTERRUPT | UART0_ERROR_INTERRUPTS;
+
+	// Set the priority level to 3 for the UART0 interrupt
+	// In the Interrupt 4-7 Priority (PRI1) register,
+	// the INTB field (Bits 15 to 13) corresponds to Interrupt Request (IRQ) 5
+	NVIC->IPR[1] = (NVIC->IPR[1] & 0xFFFF00FF) | (3 << 13);
+
+	// Enable IRQ 5 for UART0 by setting Bit 5 in the ISER[0] register
+	NVIC->ISER[0] |= UART0_IRQ_BIT;
+	
+	// Keep the baud rate when the clock profile changes
+	if (!Clock_Subscribe(&UART0_Clock_Changed))
+	{
+		// The baud rate divisor is only valid for the current profile
+		Clock_Hold_Profile();
+	}
+}
+
+void UART0_Set_Receive_Task(void(*task)(void))
+{
+	UART0_Receive_Task = task;
+}
+
+uint8_t UART0_Write(const uint8_t *buffer, uint16_t length)
+{
+	uint16_t head = tx_head;
+
+	if ((length == 0) || (length > UART0_Transmit_Free()))
+	{
+		return 0;
+	}
+
+	for (uint16_t i = 0; i < length; i++)
+	{
+		tx_storage[head] = buffer[i];
+		head = (head + 1) & (UART0_TX_BUFFER_SIZE - 1);
+	}
+
+	// Disable the UART0 interrupt while the queue is updated so that a
+	// completing transfer does not start the next block at the same time
+	NVIC->ICER[0] = UART0_IRQ_BIT;
+
+	tx_head = head;
+
+	if (tx_dma_length == 0)
+	{
+		UART0_Start_DMA();
+	}
+
+	NVIC->ISER[0] = UART0_IRQ_BIT;
+
+	return 1;
+}
+
+uint16_t UART0_Transmit_Free(void)
+{
+	// One byte is kept free to distinguish a full buffer from an empty one
+	return (UART0_TX_BUFFER_SIZE - 1) - ((tx_head - tx_tail) & (UART0_TX_BUFFER_SIZE - 1));
+}
+
+uint8_t UART0_Is_Transmit_Idle(void)
+{
+	return ((tx_head == tx_tail) && ((UART0->FR & UART0_BUSY_BIT_MASK) == 0)) ? 1 : 0;
+}
+
+uint8_t UART0_Read_Byte(uint8_t *data)
+{
+	return Ring_Buffer_Get(&rx_buffer, data);
+}
+
+uint16_t UART0_Available(void)
+{
+	return Ring_Buffer_Count(&rx_buffer);
+}
+
+uint32_t UART0_Get_Error_Count(void)
+{
+	return rx_error_count;
+}
+
+void UART0_Handler(void)
+{
+	PROFILE_BEGIN();
+
+	uint32_t status = UART0->MIS;
+
+	// Release the bytes of the completed uDMA transfer and start the next block
+	if (uDMA_Interrupt_Pending(UART0_TX_DMA_CHANNEL))
+	{
+		tx_tail = (tx_tail + tx_dma_length) & (UART0_TX_BUFFER_SIZE - 1);
+		UART0_Start_DMA();
+	}
+
+	// Move received bytes from the receive FIFO to the receive ring buffer
+	if (status & (UART0_RX_INTERRUPT | UART0_RX_TIMEOUT_INTERRUPT | UART0_ERROR_INTERRUPTS))
+	{
+		UART0->ICR = UART0_RX_INTERRUPT | UART0_RX_TIMEOUT_INTERRUPT | UART0_ERROR_INTERRUPTS;
+
+		while ((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0)
+		{
+			uint32_t data = UART0->DR;
+
+			if ((data & UART0_DATA_ERROR_BIT_MASK) || !Ring_Buffer_Put(&rx_buffer, (uint8_t)data))
+			{
+				rx_error_count++;
+			}
+		}
+
+		if (UART0_Receive_Task != 0)
+		{
+			(*UART0_Receive_Task)();
+		}
+	}
+
+	PROFILE_END(PROFILE_PROBE_UART0);
+}
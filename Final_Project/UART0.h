@@ -0,0 +1,157 @@
+/**
+ * @file UART0.h
+ *
+ * @brief Header file for the UART0 driver.
+ *
+ * This file contains the function definitions for the UART0 driver. UART0 is
+ * connected to the virtual COM port of the debugger (USB) and is used as the
+ * telemetry and command link to a host computer.
+ *
+ * Transmitted bytes are queued in a transmit buffer that is drained by the uDMA
+ * controller (channel 9, encoding 0). The CPU only programs one transfer for each
+ * contiguous block of queued bytes and handles one completion interrupt per block,
+ * so bytes are never copied to the transmit FIFO by the CPU.
+ *
+ * Received bytes are moved from the receive FIFO into a receive ring buffer by
+ * UART0_Handler on the receive and receive timeout interrupts.
+ *
+ * The transmit functions and the receive functions must each be called from only one context.
+ *
+ * @note For more information regarding the UART module, refer to the
+ * Universal Asynchronous Receivers / Transmitters (UARTs) section
+ * of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
+ *
+ * @note The baud rate divisor is derived from the system clock (see Clock.h), and it is
+ * updated when the clock profile changes.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef UART0_H
+#define UART0_H
+
+#include "TM4C123GH6PM.h"
+#include "Ring_Buffer.h"
+
+// Baud rate of the telemetry link
+#define UART0_BAUD_RATE             115200
+
+// Size of the transmit buffer (must be a power of two)
+#define UART0_TX_BUFFER_SIZE        1024
+
+// Size of the receive ring buffer (must be a power of two)
+#define UART0_RX_BUFFER_SIZE        128
+
+// uDMA channel and channel encoding of the UART0 transmit request
+#define UART0_TX_DMA_CHANNEL        9
+#define UART0_TX_DMA_ENCODING       0
+
+// Declare pointer to the user-defined receive task
+extern void (*UART0_Receive_Task)(void);
+
+/**
+ * @brief Initializes UART0 and the uDMA channel of its transmitter.
+ *
+ * This function configures UART0 with the following configuration:
+ *
+ * - Parity: Disabled
+ * - Bit Order: Least Significant Bit (LSB) first
+ * - Character Length: 8 data bits
+ * - Stop Bits: 1
+ * - UART Clock Source: System Clock
+ * - Baud Rate: UART0_BAUD_RATE (115200)
+ *
+ * @note The PA0 (U0RX) and PA1 (U0TX) pins are used for UART communication via USB.
+ *
+ * The priority level of the UART0 interrupt is set to 3, below the system tick,
+ * the sensor, and the US-100 link.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Init(void);
+
+/**
+ * @brief Sets the function executed from UART0_Handler after new bytes have been received.
+ *
+ * @param task A pointer to the user-defined function, or 0 to remove the task.
+ *
+ * @return None
+ */
+void UART0_Set_Receive_Task(void(*task)(void));
+
+/**
+ * @brief Queues a block of bytes for transmission by the uDMA controller.
+ *
+ * The block is queued completely or not at all, so a frame is never cut in the middle.
+ * This function returns immediately.
+ *
+ * @param buffer A pointer to the bytes to transmit.
+ *
+ * @param length The number of bytes to transmit.
+ *
+ * @return uint8_t Returns 1 if the block was queued, or 0 if the transmit buffer does not have enough free space.
+ */
+uint8_t UART0_Write(const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Returns the number of bytes that can be queued with UART0_Write.
+ *
+ * @param None
+ *
+ * @return uint16_t The free space of the transmit buffer in bytes.
+ */
+uint16_t UART0_Transmit_Free(void);
+
+/**
+ * @brief Indicates whether every queued byte has been transmitted.
+ *
+ * @param None
+ *
+ * @return uint8_t Returns 1 if the transmit buffer is empty and the transmitter is idle. Otherwise, it returns 0.
+ */
+uint8_t UART0_Is_Transmit_Idle(void);
+
+/**
+ * @brief Reads one received byte from the receive ring buffer.
+ *
+ * @param data A pointer to the location where the byte is stored.
+ *
+ * @return uint8_t Returns 1 if a byte was read, or 0 if no byte has been received.
+ */
+uint8_t UART0_Read_Byte(uint8_t *data);
+
+/**
+ * @brief Returns the number of received bytes waiting in the receive ring buffer.
+ *
+ * @param None
+ *
+ * @return uint16_t The number of bytes available.
+ */
+uint16_t UART0_Available(void);
+
+/**
+ * @brief Returns the number of bytes lost to receive errors or a full receive ring buffer.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of bytes lost since initialization.
+ */
+uint32_t UART0_Get_Error_Count(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for UART0.
+ *
+ * This function moves received bytes to the receive ring buffer and executes the
+ * user-defined receive task. When the uDMA transfer of the transmitter completes,
+ * it releases the transmitted bytes and starts the transfer of the next block.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Handler(void);
+
+#endif
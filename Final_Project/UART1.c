@@ -10,12 +10,199 @@
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud rate divisor is derived from the system clock (see Clock.h), and it is
+ * updated when the clock profile changes.
  *
  * @author Aaron Nanas
  */
 
 #include "UART1.h"
+#include "uDMA.h"
+#include "Profile.h"
+#include "Pin_Map.h"
+#include "Clock.h"
+
+// UART1 interrupt bits in the IM, RIS, MIS, and ICR registers
+#define UART1_RX_INTERRUPT              0x010 // RXIM  (Bit 4)
+#define UART1_TX_INTERRUPT              0x020 // TXIM  (Bit 5)
+#define UART1_RX_TIMEOUT_INTERRUPT      0x040 // RTIM  (Bit 6)
+#define UART1_ERROR_INTERRUPTS          0x780 // FEIM, PEIM, BEIM, OEIM (Bits 10 to 7)
+
+// UART1 has an Interrupt Request (IRQ) number of 6
+#define UART1_IRQ_BIT                   (1 << 6)
+
+// Size of each half of the receive buffer, filled alternately by the primary
+// and the alternate uDMA control structures
+#define UART1_RX_BLOCK_SIZE             (UART1_RX_BUFFER_SIZE / 2)
+
+// The receive FIFO requests a burst of 2, 4, or 8 bytes at its trigger level,
+// and the uDMA controller moves the same number of bytes per arbitration
+#if (UART1_RX_FIFO_LEVEL < 0) || (UART1_RX_FIFO_LEVEL > 2)
+#error "UART1_RX_FIFO_LEVEL must be 0, 1, or 2"
+#endif
+#define UART1_RX_DMA_CONTROL            (UDMA_CTL_DST_INC_8 | UDMA_CTL_DST_SIZE_8 | \
+                                         UDMA_CTL_SRC_INC_NONE | UDMA_CTL_SRC_SIZE_8 | \
+                                         UDMA_CTL_ARB_SIZE(UART1_RX_FIFO_LEVEL + 1) | UDMA_CTL_MODE_PING_PONG)
+
+// Largest number of status reads while the uDMA controller empties the receive FIFO
+#define UART1_RX_DRAIN_LIMIT            64
+
+// Declare pointer to the user-defined receive task
+void (*UART1_Receive_Task)(void) = 0;
+
+// Receive buffer written by the uDMA controller, and transmit ring buffer
+static uint8_t rx_storage[UART1_RX_BUFFER_SIZE];
+static uint8_t tx_storage[UART1_TX_BUFFER_SIZE];
+static Ring_Buffer tx_buffer;
+
+// Number of bytes written to the receive buffer, published by UART1_Handler,
+// and number of bytes read from it
+static volatile uint32_t rx_write_count = 0;
+static volatile uint32_t rx_read_count = 0;
+
+// Number of halves of the receive buffer filled since initialization,
+// and the half that the uDMA controller fills next
+static uint32_t rx_blocks_completed = 0;
+static uint8_t rx_active_half = 0;
+
+// Number of receive errors since initialization
+static volatile uint32_t rx_error_count = 0;
+
+// Current baud rate, kept when UART1_Init is called again
+static uint32_t baud_rate = UART1_DEFAULT_BAUD_RATE;
+
+// Rates tried by UART1_Auto_Baud after the current rate
+static const uint32_t auto_baud_rates[] = UART1_AUTO_BAUD_RATES;
+
+static void UART1_Start_Transmit(void)
+{
+	// Disable the UART1 interrupt while the transmit FIFO is primed
+	// so that UART1_Handler does not refill it at the same time
+	NVIC->ICER[0] = UART1_IRQ_BIT;
+	
+	uint8_t data;
+	while (((UART1->FR & UART1_TRANSMIT_FIFO_FULL_BIT_MASK) == 0) && Ring_Buffer_Get(&tx_buffer, &data))
+	{
+		UART1->DR = data;
+	}
+	
+	// Let the transmit interrupt send the rest of the data once the FIFO drains
+	if (Ring_Buffer_Count(&tx_buffer) > 0)
+	{
+		UART1->IM |= UART1_TX_INTERRUPT;
+	}
+	
+	NVIC->ISER[0] = UART1_IRQ_BIT;
+}
+
+// Programs the control structure that fills one half of the receive buffer
+static void UART1_Arm_Receive_Block(uint8_t half)
+{
+	uDMA_Set_Transfer(UART1_RX_DMA_CHANNEL, half, &UART1->DR,
+		&rx_storage[(half * UART1_RX_BLOCK_SIZE) + UART1_RX_BLOCK_SIZE - 1],
+		UART1_RX_DMA_CONTROL | UDMA_CTL_XFER_SIZE(UART1_RX_BLOCK_SIZE));
+}
+
+// Re-arms the filled halves of the receive buffer and publishes the number of received bytes
+// Called from UART1_Handler only
+static void UART1_Update_Receive_Count(void)
+{
+	uint32_t control;
+	uint32_t remaining;
+	
+	// A half is filled when its control structure has returned to the stop mode
+	// Every filled half is re-armed in the order in which the uDMA controller fills them
+	while (((control = uDMA_Get_Control(UART1_RX_DMA_CHANNEL, rx_active_half)) & UDMA_CTL_MODE_MASK) == UDMA_CTL_MODE_STOP)
+	{
+		UART1_Arm_Receive_Block(rx_active_half);
+		rx_blocks_completed++;
+		rx_active_half ^= 1;
+	}
+	
+	// The channel is disabled if both halves were filled before this function was called
+	if (!uDMA_Is_Enabled(UART1_RX_DMA_CHANNEL))
+	{
+		uDMA_Enable_Channel(UART1_RX_DMA_CHANNEL);
+	}
+	
+	// The XFERSIZE field (Bits 13 to 4) holds the number of bytes left in the half minus 1
+	remaining = ((control >> 4) & 0x3FF) + 1;
+	rx_write_count = (rx_blocks_completed * UART1_RX_BLOCK_SIZE) + (UART1_RX_BLOCK_SIZE - remaining);
+}
+
+// Returns the number of unread bytes in the receive buffer
+// Bytes that have been overwritten by the uDMA controller before they were read are discarded
+static uint32_t UART1_Receive_Count(void)
+{
+	uint32_t count = rx_write_count - rx_read_count;
+	
+	if (count > UART1_RX_BUFFER_SIZE)
+	{
+		// UART1_Handler also counts errors
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		
+		rx_error_count += count;
+		
+		__set_PRIMASK(primask);
+		
+		rx_read_count += count;
+		count = 0;
+	}
+	
+	return count;
+}
+
+// Programs the divisor of the current baud rate
+static void UART1_Apply_Baud_Rate(void)
+{
+    uint32_t divisor = Clock_Get_UART_Divisor(baud_rate);
+    uint32_t enabled = UART1->CTL & 0x01;
+    
+    // The divisor can only be changed while UART1 is disabled, after the current byte
+    UART1->CTL &= ~0x01;
+    while (UART1->FR & UART1_BUSY_BIT_MASK);
+    
+    // Write the integer and fractional parts of the divisor, then the LCRH register
+    // to latch them
+    UART1->IBRD = divisor >> 6;
+    UART1->FBRD = divisor & 0x3F;
+    UART1->LCRH = UART1->LCRH;
+    
+    UART1->CTL |= enabled;
+}
+
+static void UART1_Clock_Changed(uint32_t system_clock_hz)
+{
+    UART1_Apply_Baud_Rate();
+}
+
+// Sends the probe and returns 1 if exactly reply_length bytes are received without an error
+static uint8_t UART1_Probe(const uint8_t *probe, uint16_t probe_length, uint16_t reply_length, uint32_t response_delay_us)
+{
+	uint8_t reply[UART1_AUTO_BAUD_MAX_REPLY];
+	
+	// Wire time of the probe and the reply (10 bits per byte), the response delay, and the receive timeout
+	uint32_t wire_time_us = (uint32_t)((((uint64_t)probe_length + reply_length) * 10000000) / baud_rate) + 1;
+	uint32_t timeout_us = wire_time_us + response_delay_us + UART1_Get_Receive_Timeout_us();
+	
+	UART1_Flush_Input();
+	uint32_t error_count = rx_error_count;
+	
+	if (UART1_Write_Timeout(probe, probe_length, timeout_us) < probe_length)
+	{
+		return 0;
+	}
+	
+	if (UART1_Read_Timeout(reply, reply_length, timeout_us) < reply_length)
+	{
+		return 0;
+	}
+	
+	// The bytes of a reply are handed over together at the receive timeout, so a longer
+	// reply, such as the bytes of a probe at a wrong rate, has already been received
+	return ((UART1_Available() == 0) && (rx_error_count == error_count)) ? 1 : 0;
+}
 
 void UART1_Init(void)
 {
@@ -23,18 +210,19 @@ void UART1_Init(void)
     // R1 bit (Bit 1) in the RCGCUART register
     SYSCTL->RCGCUART |= 0x02;
     
-    // Enable the clock to Port C by setting the
-    // R2 bit (Bit 2) in the RCGCGPIO register
-    SYSCTL->RCGCGPIO |= 0x04;
+    // Enable the clock to the port of the UART1 pins
+    SYSCTL->RCGCGPIO |= PIN_CLOCK(PIN_UART1);
     
     // Disable the UART1 module before configuration by clearing
     // the UARTEN bit (Bit 0) in the CTL register
     UART1->CTL &= ~0x01;
     
-    // Set the baud rate by writing to the DIVINT field (Bits 15 to 0)
-    // and the DIVFRAC field (Bits 15 to 0) in the IBRD and FBRD registers, respectively.
-    UART1->IBRD = 325; // Integer part
-    UART1->FBRD = 33;  // Fractional part
+    // Set the baud rate by writing to the DIVINT field (Bits 15 to 0) and the DIVFRAC field
+    // (Bits 5 to 0) in the IBRD and FBRD registers: divisor = system clock / (16 * baud rate).
+    // For example, at 80 MHz and 9600 baud: 520.8333, IBRD = 520, FBRD = round(0.8333 * 64) = 53
+    uint32_t divisor = Clock_Get_UART_Divisor(baud_rate);
+    UART1->IBRD = divisor >> 6; // Integer part
+    UART1->FBRD = divisor & 0x3F; // Fractional part
     
     // Configure the data word length to 8 bits
     UART1->LCRH |= 0x60;
@@ -51,31 +239,316 @@ void UART1_Init(void)
     // Enable the UART1 module
     UART1->CTL |= 0x01;
     
-    // Configure the C5 (U1RX) and C7 (U1TX) pins to use the alternate function
-    GPIOC->AFSEL |= 0xA0; // Enable alternate functions for PC5 and PC7
+    // Configure the C5 (U1RX) and C7 (U1TX) pins to use the alternate function.
+    // Only the PMC5 and PMC7 fields of the PCTL register are changed, so the
+    // buzzer (PMC4) keeps its PWM function.
+    PIN_ALTERNATE_INIT(PIN_UART1);
+    
+    // Initialize the receive buffer and the transmit ring buffer
+    Ring_Buffer_Init(&tx_buffer, tx_storage, UART1_TX_BUFFER_SIZE);
+    rx_write_count = 0;
+    rx_read_count = 0;
+    rx_blocks_completed = 0;
+    rx_active_half = 0;
+    rx_error_count = 0;
+    
+    // Set the RXIFLSEL field (Bits 5 to 3) in the IFLS register to UART1_RX_FIFO_LEVEL to request
+    // a receive burst at the trigger level (8 bytes at 1/2 full by default), and clear the TXIFLSEL
+    // field (Bits 2 to 0) to trigger the transmit interrupt when the transmit FIFO is 1/8 full
+    UART1->IFLS = (UART1->IFLS & ~0x3F) | (UART1_RX_FIFO_LEVEL << 3);
+    
+    // Assign uDMA channel 22 to the UART1 receiver in ping-pong mode. The channel only responds
+    // to burst requests, so a frame shorter than a burst stays in the receive FIFO until the
+    // receive timeout interrupt hands it to the uDMA controller.
+    uDMA_Init();
+    uDMA_Assign_Channel(UART1_RX_DMA_CHANNEL, UART1_RX_DMA_ENCODING);
+    UART1_Arm_Receive_Block(0);
+    UART1_Arm_Receive_Block(1);
+    UDMA->USEBURSTSET = 1UL << UART1_RX_DMA_CHANNEL;
+    uDMA_Enable_Channel(UART1_RX_DMA_CHANNEL);
+    
+    // Enable the receive uDMA request by setting the RXDMAE bit (Bit 0) in the DMACTL register
+    UART1->DMACTL = 0x01;
     
-    // Clear the PMC7 and PMC5 fields in the PCTL register before configuration
-    GPIOC->PCTL &= ~0xF00F0000;
+    // Clear any pending UART1 interrupts
+    UART1->ICR = 0x7F0;
     
-    // Configure the C5 pin as U1RX and C7 pin as U1TX
-    GPIOC->PCTL |= 0x20002000;
+    // Enable the receive timeout and error interrupts. The received bytes are moved by
+    // the uDMA controller, so the receive interrupt is not used.
+    // The transmit interrupt is only enabled while there is data to send
+    UART1->IM = UART1_RX_TIMEOUT_INTERRUPT | UART1_ERROR_INTERRUPTS;
     
-    // Enable the digital functionality for the C5 and C7 pins
-    GPIOC->DEN |= 0xA0;
+    // Set the priority level to 2 for the UART1 interrupt
+    // In the Interrupt 4-7 Priority (PRI1) register,
+    // the INTC field (Bits 23 to 21) corresponds to Interrupt Request (IRQ) 6
+    NVIC->IPR[1] = (NVIC->IPR[1] & 0xFF00FFFF) | (2 << 21);
+    
+    // Enable IRQ 6 for UART1 by setting Bit 6 in the ISER[0] register
+    NVIC->ISER[0] |= UART1_IRQ_BIT;
+    
+    // Keep the baud rate when the clock profile changes
+    if (!Clock_Subscribe(&UART1_Clock_Changed))
+    {
+        // The baud rate divisor is only valid for the current profile
+        Clock_Hold_Profile();
+    }
+}
+
+uint8_t UART1_Set_Baud_Rate(uint32_t rate)
+{
+	if ((rate < UART1_MIN_BAUD_RATE) || (rate > UART1_MAX_BAUD_RATE))
+	{
+		return 0;
+	}
+	
+	baud_rate = rate;
+	UART1_Apply_Baud_Rate();
+	
+	return 1;
+}
+
+uint32_t UART1_Get_Baud_Rate(void)
+{
+	return baud_rate;
+}
+
+uint32_t UART1_Get_Receive_Timeout_us(void)
+{
+	return ((32 * 1000000) + baud_rate - 1) / baud_rate;
+}
+
+uint32_t UART1_Auto_Baud(const uint8_t *probe, uint16_t probe_length, uint16_t reply_length, uint32_t response_delay_us)
+{
+	uint32_t initial_rate = baud_rate;
+	
+	if ((reply_length == 0) || (reply_length > UART1_AUTO_BAUD_MAX_REPLY))
+	{
+		return 0;
+	}
+	
+	// Try the current rate first, since the other side usually has not changed
+	if (UART1_Probe(probe, probe_length, reply_length, response_delay_us))
+	{
+		return baud_rate;
+	}
+	
+	for (uint8_t i = 0; i < (sizeof(auto_baud_rates) / sizeof(auto_baud_rates[0])); i++)
+	{
+		if (auto_baud_rates[i] == initial_rate)
+		{
+			continue;
+		}
+		
+		UART1_Set_Baud_Rate(auto_baud_rates[i]);
+		
+		if (UART1_Probe(probe, probe_length, reply_length, response_delay_us))
+		{
+			return baud_rate;
+		}
+	}
+	
+	UART1_Set_Baud_Rate(initial_rate);
+	
+	return 0;
+}
+
+void UART1_Set_Receive_Task(void(*task)(void))
+{
+	UART1_Receive_Task = task;
+}
+
+uint8_t UART1_Read_Byte(uint8_t *data)
+{
+	if (UART1_Receive_Count() == 0)
+	{
+		return 0;
+	}
+	
+	*data = rx_storage[rx_read_count & (UART1_RX_BUFFER_SIZE - 1)];
+	rx_read_count++;
+	
+	return 1;
+}
+
+uint8_t UART1_Write_Byte(uint8_t data)
+{
+	if (!Ring_Buffer_Put(&tx_buffer, data))
+	{
+		return 0;
+	}
+	
+	UART1_Start_Transmit();
+	
+	return 1;
+}
+
+uint16_t UART1_Read(uint8_t *buffer, uint16_t length)
+{
+	uint16_t count = 0;
+	
+	while ((count < length) && UART1_Read_Byte(&buffer[count]))
+	{
+		count++;
+	}
+	
+	return count;
+}
+
+uint16_t UART1_Write(const uint8_t *buffer, uint16_t length)
+{
+	uint16_t count = 0;
+	
+	while ((count < length) && Ring_Buffer_Put(&tx_buffer, buffer[count]))
+	{
+		count++;
+	}
+	
+	if (count > 0)
+	{
+		UART1_Start_Transmit();
+	}
+	
+	return count;
+}
+
+uint16_t UART1_Read_Timeout(uint8_t *buffer, uint16_t length, uint32_t timeout_us)
+{
+	Timer_Handle deadline;
+	uint16_t count = 0;
+	
+	Timer_Start(&deadline, timeout_us);
+	
+	while (count < length)
+	{
+		count += UART1_Read(&buffer[count], length - count);
+		
+		if ((count < length) && Timer_Expired(&deadline))
+		{
+			break;
+		}
+	}
+	
+	return count;
+}
+
+uint16_t UART1_Write_Timeout(const uint8_t *buffer, uint16_t length, uint32_t timeout_us)
+{
+	Timer_Handle deadline;
+	uint16_t count = 0;
+	
+	Timer_Start(&deadline, timeout_us);
+	
+	while (count < length)
+	{
+		count += UART1_Write(&buffer[count], length - count);
+		
+		if ((count < length) && Timer_Expired(&deadline))
+		{
+			break;
+		}
+	}
+	
+	return count;
+}
+
+uint16_t UART1_Available(void)
+{
+	return (uint16_t)UART1_Receive_Count();
+}
+
+void UART1_Flush_Input(void)
+{
+	rx_read_count = rx_write_count;
 }
 
+uint32_t UART1_Get_Error_Count(void)
+{
+	return rx_error_count;
+}
+
+void UART1_Handler(void)
+{
+	PROFILE_BEGIN();
+	
+	uint32_t status = UART1->MIS;
+	
+	uint8_t received = 0;
+	
+	// Count framing, parity, break, and overrun errors
+	// The uDMA controller still stores the data byte of a byte received with an error
+	if (status & UART1_ERROR_INTERRUPTS)
+	{
+		UART1->ICR = UART1_ERROR_INTERRUPTS;
+		UART1->RSR = 0;     // A write to the RSR (ECR) register clears the error flags
+		rx_error_count++;
+	}
+	
+	// The receive line has been idle for 32 bit periods with bytes left in the receive FIFO:
+	// let the uDMA controller move them with single requests, which marks the end of a frame
+	if (status & UART1_RX_TIMEOUT_INTERRUPT)
+	{
+		UART1->ICR = UART1_RX_TIMEOUT_INTERRUPT;
+		
+		UDMA->USEBURSTCLR = 1UL << UART1_RX_DMA_CHANNEL;
+		for (uint32_t i = 0; (i < UART1_RX_DRAIN_LIMIT) && ((UART1->FR & UART1_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0); i++);
+		
+		received = 1;
+	}
+	
+	// A half of the receive buffer has been filled
+	if (uDMA_Interrupt_Pending(UART1_RX_DMA_CHANNEL))
+	{
+		received = 1;
+	}
+	
+	if (received)
+	{
+		UART1_Update_Receive_Count();
+		
+		// Respond to burst requests only again. The uDMA controller also clears this bit
+		// by itself when fewer bytes than a burst are left in a half.
+		UDMA->USEBURSTSET = 1UL << UART1_RX_DMA_CHANNEL;
+		
+		// Execute the user-defined receive task once for the whole batch of bytes
+		if (UART1_Receive_Task != 0)
+		{
+			(*UART1_Receive_Task)();
+		}
+	}
+	
+	// Refill the transmit FIFO from the transmit ring buffer
+	if (status & UART1_TX_INTERRUPT)
+	{
+		UART1->ICR = UART1_TX_INTERRUPT;
+		
+		uint8_t data;
+		while (((UART1->FR & UART1_TRANSMIT_FIFO_FULL_BIT_MASK) == 0) && Ring_Buffer_Get(&tx_buffer, &data))
+		{
+			UART1->DR = data;
+		}
+		
+		// Disable the transmit interrupt when there is no more data to send
+		if (Ring_Buffer_Count(&tx_buffer) == 0)
+		{
+			UART1->IM &= ~UART1_TX_INTERRUPT;
+		}
+	}
+	
+	PROFILE_END(PROFILE_PROBE_UART1);
+}
 
 char UART1_Input_Character(void)
 {
-	while((UART1->FR & UART1_RECEIVE_FIFO_EMPTY_BIT_MASK) != 0);
+	uint8_t data;
+	
+	while (!UART1_Read_Byte(&data));
 	
-	return (char)(UART1->DR & 0xFF);
+	return (char)data;
 }
 
 void UART1_Output_Character(char data)
 {
-	while((UART1->FR & UART1_TRANSMIT_FIFO_FULL_BIT_MASK) != 0);
-	UART1->DR = data;
+	while (!UART1_Write_Byte((uint8_t)data));
 }
 
 uint32_t UART1_Input_String(char *buffer_pointer, uint16_t buffer_size) 
@@ -5,20 +5,76 @@
  *
  * This file contains the function definitions for the UART1 driver.
  *
+ * Received bytes are moved from the receive FIFO into a receive buffer by the uDMA
+ * controller (channel 22, encoding 0) in ping-pong mode: the primary and the alternate
+ * control structures fill the two halves of the buffer in turn, so the CPU never
+ * copies a received byte. The channel only responds to burst requests (8 bytes), so
+ * a frame shorter than a burst stays in the receive FIFO until the line has been idle
+ * for 32 bit periods. The receive timeout interrupt then lets the uDMA controller
+ * move the rest of the frame and executes the receive task once for the whole batch.
+ *
+ * Transmitted bytes are queued in a transmit ring buffer that is drained by the
+ * transmit interrupt. The non-blocking functions return immediately, and the
+ * functions with a timeout give up when their deadline is reached.
+ *
+ * The baud rate can be changed at runtime (UART1_Set_Baud_Rate) or detected by probing the
+ * other side at a list of standard rates (UART1_Auto_Baud). The receive burst size is set
+ * by the receive FIFO trigger level (UART1_RX_FIFO_LEVEL): a larger level lets the uDMA
+ * controller move more bytes per request, and the bytes below a burst are moved after
+ * the receive timeout. The transmit interrupt is requested when the transmit FIFO is
+ * 1/8 full, so each interrupt refills up to 14 bytes.
+ *
+ * The receive functions and the transmit functions must each be called from only one context.
+ *
  * @note For more information regarding the UART module, refer to the
  * Universal Asynchronous Receivers / Transmitters (UARTs) section
  * of the TM4C123GH6PM Microcontroller Datasheet.
  * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
  *
- * @note Assumes that the system clock (50 MHz) is used.
+ * @note The baud rate divisor is derived from the system clock (see Clock.h), and it is
+ * updated when the clock profile changes.
  *
  * @author Aaron Nanas
  */
 
 #include "TM4C123GH6PM.h"
+#include "Ring_Buffer.h"
+#include "Timebase.h"
 
 #define UART1_RECEIVE_FIFO_EMPTY_BIT_MASK 0x10
 #define UART1_TRANSMIT_FIFO_FULL_BIT_MASK 0x20
+#define UART1_BUSY_BIT_MASK 0x08
+
+// Sizes of the receive buffer and the transmit ring buffer (must be powers of two)
+#define UART1_RX_BUFFER_SIZE 64
+#define UART1_TX_BUFFER_SIZE 64
+
+// uDMA channel and channel encoding of the UART1 receive request
+#define UART1_RX_DMA_CHANNEL    22
+#define UART1_RX_DMA_ENCODING   0
+
+// Baud rate after reset (the rate of the US-100 in serial mode)
+#define UART1_DEFAULT_BAUD_RATE 9600
+
+// Range of the baud rate. The upper limit is the fastest rate at the 16 MHz clock profile,
+// so a selected rate is valid at every clock profile (see Clock.h).
+#define UART1_MIN_BAUD_RATE     300
+#define UART1_MAX_BAUD_RATE     1000000
+
+// Rates tried by UART1_Auto_Baud after the current rate, fastest first
+#define UART1_AUTO_BAUD_RATES   {230400, 115200, 57600, 38400, 19200, 9600}
+
+// Longest reply accepted by UART1_Auto_Baud
+#define UART1_AUTO_BAUD_MAX_REPLY   16
+
+// Receive FIFO trigger level (RXIFLSEL field of the IFLS register) that requests a receive burst:
+// 0 = 2 bytes (1/8 full), 1 = 4 bytes (1/4 full), 2 = 8 bytes (1/2 full)
+#ifndef UART1_RX_FIFO_LEVEL
+#define UART1_RX_FIFO_LEVEL     2
+#endif
+
+// Declare pointer to the user-defined receive task
+extern void (*UART1_Receive_Task)(void);
 
 /**
  * @brief Carriage return character
@@ -54,21 +110,206 @@
  * - Bit Order: Least Significant Bit (LSB) first
  * - Character Length: 8 data bits
  * - Stop Bits: 1
- * - UART Clock Source: System Clock (50 MHz)
- * - Baud Rate: 115200
+ * - UART Clock Source: System Clock
+ * - Baud Rate: the current baud rate (UART1_DEFAULT_BAUD_RATE after reset), which is kept
+ *   when the function is called again
  *
  * @note The PC5 (TX) and PC7 (RX) pins are used for UART communication via USB.
  *
+ * The receive uDMA channel, the receive timeout and error interrupts are enabled, and
+ * the transmit interrupt is enabled while the transmit ring buffer holds data. The
+ * priority level of the UART1 interrupt is set to 2.
+ *
  * @return None
  */
 void UART1_Init(void);
 
+/**
+ * @brief Changes the baud rate of UART1.
+ *
+ * The byte that is being transmitted is completed at the previous rate. The bytes left in
+ * the transmit FIFO and the bytes received afterwards use the new rate.
+ *
+ * @param baud_rate The baud rate in bits per second (UART1_MIN_BAUD_RATE to UART1_MAX_BAUD_RATE).
+ *
+ * @return uint8_t Returns 1 if the baud rate is changed, or 0 if it is out of range.
+ */
+uint8_t UART1_Set_Baud_Rate(uint32_t baud_rate);
+
+/**
+ * @brief Returns the baud rate of UART1.
+ *
+ * @param None
+ *
+ * @return uint32_t The baud rate in bits per second.
+ */
+uint32_t UART1_Get_Baud_Rate(void);
+
+/**
+ * @brief Returns the delay from the last received byte to the receive timeout interrupt.
+ *
+ * The receive timeout interrupt is requested after 32 bit periods without a new byte,
+ * which is about 3.3 ms at 9600 baud and 280 us at 115200 baud.
+ *
+ * @param None
+ *
+ * @return uint32_t The delay in microseconds, rounded up.
+ */
+uint32_t UART1_Get_Receive_Timeout_us(void);
+
+/**
+ * @brief Detects the baud rate of the other side by sending a probe at several rates.
+ *
+ * The current rate is tried first, then every rate of UART1_AUTO_BAUD_RATES. At each rate,
+ * the receive buffer is flushed, the probe is sent, and the rate is selected when exactly
+ * reply_length bytes are received without a receive error. At a wrong rate, the other side
+ * usually does not recognize the probe and does not reply, so each rate costs the wire
+ * time of the probe and the reply, the response delay, and the receive timeout.
+ *
+ * This function waits for the replies and must be called before the scheduler is started.
+ *
+ * @param probe A pointer to the bytes of the probe.
+ *
+ * @param probe_length The number of bytes of the probe.
+ *
+ * @param reply_length The number of bytes of the reply (1 to UART1_AUTO_BAUD_MAX_REPLY).
+ *
+ * @param response_delay_us The longest time from the end of the probe to the start of the reply.
+ *
+ * @return uint32_t The detected baud rate, or 0 if no rate was answered (the previous rate is kept).
+ */
+uint32_t UART1_Auto_Baud(const uint8_t *probe, uint16_t probe_length, uint16_t reply_length, uint32_t response_delay_us);
+
+/**
+ * @brief Sets the user-defined task executed when new data is received.
+ *
+ * The task is executed from UART1_Handler after a batch of received bytes has been
+ * stored in the receive buffer. It must be short since it runs in interrupt context.
+ *
+ * @param task A pointer to the user-defined function, or 0 to disable the task.
+ *
+ * @return None
+ */
+void UART1_Set_Receive_Task(void(*task)(void));
+
+/**
+ * @brief Reads one byte from the receive buffer without waiting.
+ *
+ * @param data A pointer to where the received byte is stored.
+ *
+ * @return uint8_t Returns 1 if a byte was read, or 0 if no data is available.
+ */
+uint8_t UART1_Read_Byte(uint8_t *data);
+
+/**
+ * @brief Queues one byte for transmission without waiting.
+ *
+ * @param data The byte to transmit.
+ *
+ * @return uint8_t Returns 1 if the byte was queued, or 0 if the transmit ring buffer is full.
+ */
+uint8_t UART1_Write_Byte(uint8_t data);
+
+/**
+ * @brief Reads up to the specified number of bytes without waiting.
+ *
+ * @param buffer A pointer to the buffer where received bytes are stored.
+ *
+ * @param length The maximum number of bytes to read.
+ *
+ * @return uint16_t The number of bytes read.
+ */
+uint16_t UART1_Read(uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Queues up to the specified number of bytes for transmission without waiting.
+ *
+ * @param buffer A pointer to the bytes to transmit.
+ *
+ * @param length The number of bytes to transmit.
+ *
+ * @return uint16_t The number of bytes queued.
+ */
+uint16_t UART1_Write(const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Reads the specified number of bytes, waiting at most timeout_us.
+ *
+ * @param buffer A pointer to the buffer where received bytes are stored.
+ *
+ * @param length The number of bytes to read.
+ *
+ * @param timeout_us The maximum time to wait in microseconds.
+ *
+ * @return uint16_t The number of bytes read. It is less than length if the deadline was reached.
+ */
+uint16_t UART1_Read_Timeout(uint8_t *buffer, uint16_t length, uint32_t timeout_us);
+
+/**
+ * @brief Queues the specified number of bytes for transmission, waiting at most timeout_us for free space.
+ *
+ * @param buffer A pointer to the bytes to transmit.
+ *
+ * @param length The number of bytes to transmit.
+ *
+ * @param timeout_us The maximum time to wait in microseconds.
+ *
+ * @return uint16_t The number of bytes queued. It is less than length if the deadline was reached.
+ */
+uint16_t UART1_Write_Timeout(const uint8_t *buffer, uint16_t length, uint32_t timeout_us);
+
+/**
+ * @brief Returns the number of received bytes waiting in the receive buffer.
+ *
+ * @param None
+ *
+ * @return uint16_t The number of bytes available.
+ */
+uint16_t UART1_Available(void);
+
+/**
+ * @brief Discards all received bytes waiting in the receive buffer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Flush_Input(void);
+
+/**
+ * @brief Returns the number of receive errors since initialization.
+ *
+ * Framing, parity, break, and overrun errors as well as bytes that were overwritten
+ * before they were read are counted.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of receive errors.
+ */
+uint32_t UART1_Get_Error_Count(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for UART1.
+ *
+ * This function re-arms the filled halves of the receive buffer, hands the bytes left in
+ * the receive FIFO to the uDMA controller on the receive timeout interrupt, and refills
+ * the transmit FIFO from the transmit ring buffer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Handler(void);
+
 /**
  * @brief The UART1_Input_Character function reads a character from the UART data register.
  *
  * This function waits until a character is available in the UART receive buffer
  * from the serial terminal input and returns the received character as a char type.
  *
+ * @note This function waits without a timeout. Use UART1_Read_Timeout when the
+ * other side may not respond.
+ *
  * @param None
  *
  * @return The received character from the serial terminal as a char type.
@@ -78,8 +319,8 @@ char UART1_Input_Character(void);
 /**
  * @brief The UART1_Output_Character function transmits a character via UART to the serial terminal.
  *
- * This function waits until the UART transmit buffer is ready to accept
- * a new character and then writes the specified character in the transmit buffer to the serial terminal.
+ * This function waits until the UART transmit ring buffer is ready to accept
+ * a new character and then queues the specified character for transmission to the serial terminal.
  *
  * @param data The character to be transmitted to the serial terminal.
  *
@@ -0,0 +1,314 @@
+/**
+ * @file US100_Echo.c
+ *
+ * @brief Source code for the US100_Echo driver.
+ *
+ * This file contains the function definitions for the US100_Echo driver.
+ * It operates one or more US-100 Ultrasonic Distance Sensors in trigger/echo (GPIO) mode.
+ * The pins, capture timer, and interrupt of each channel are listed in echo_channels.
+ *
+ * @note The echo width is converted to a distance with the current system clock (see Clock.h).
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "US100_Echo.h"
+#include "Timebase.h"
+#include "Profile.h"
+#include "Pin_Map.h"
+#include "Clock.h"
+
+// Width of the trigger pulse (at least 10 us according to the US-100 datasheet)
+#define US100_TRIGGER_PULSE_US      10
+
+// Value written to the GPIOLOCK register to unlock the GPIOCR register (required for PD7)
+#define GPIO_LOCK_KEY               0x4C4F434B
+
+// Capture timer halves
+#define ECHO_TIMER_A                0
+#define ECHO_TIMER_B                1
+
+/**
+ * @brief Pins and capture timer of one channel.
+ */
+typedef struct
+{
+	GPIOA_Type *trigger_port;
+	volatile uint32_t *trigger_data;    // Masked alias of the trigger pin in the DATA register
+	uint8_t trigger_port_clock;         // Bit of the trigger port in the RCGCGPIO register
+	uint8_t trigger_pin;                // Pin mask of the trigger output
+	GPIOA_Type *echo_port;
+	uint8_t echo_port_clock;            // Bit of the echo port in the RCGCGPIO register
+	uint8_t echo_pin;                   // Pin mask of the capture input
+	uint32_t echo_pctl_mask;            // PCTL field of the capture input
+	uint32_t echo_pctl_value;           // Capture function (PMCn = 7) in the PCTL field
+	WTIMER0_Type *timer;
+	uint8_t timer_clock;            // Bit of the wide timer in the RCGCWTIMER register
+	uint8_t timer_half;             // ECHO_TIMER_A or ECHO_TIMER_B
+	uint8_t irq;                    // Interrupt Request (IRQ) number of the timer half
+} Echo_Channel_Config;
+
+// Pins of a channel from the pin map
+#define ECHO_CHANNEL_PINS(trigger, echo) \
+	PIN_PORT(trigger), &PIN_DATA(trigger), PIN_CLOCK(trigger), PIN_MASK(trigger), \
+	PIN_PORT(echo), PIN_CLOCK(echo), PIN_MASK(echo), PIN_PCTL_MASK(echo), PIN_PCTL_VALUE(echo)
+
+static const Echo_Channel_Config echo_channels[US100_ECHO_CHANNEL_COUNT] =
+{
+	{ ECHO_CHANNEL_PINS(PIN_US100_TRIGGER_0, PIN_US100_ECHO_0), WTIMER0, 0x01, ECHO_TIMER_B, 95 },     // Trigger PC7, echo PC5 (WT0CCP1)
+	{ ECHO_CHANNEL_PINS(PIN_US100_TRIGGER_1, PIN_US100_ECHO_1), WTIMER5, 0x20, ECHO_TIMER_A, 104 },    // Trigger PE2, echo PD6 (WT5CCP0)
+	{ ECHO_CHANNEL_PINS(PIN_US100_TRIGGER_2, PIN_US100_ECHO_2), WTIMER5, 0x20, ECHO_TIMER_B, 105 }     // Trigger PE3, echo PD7 (WT5CCP1)
+};
+
+// States of the echo capture
+enum Echo_Capture_States
+{
+	ECHO_IDLE       = 0,
+	ECHO_WAIT_RISE  = 1,
+	ECHO_WAIT_FALL  = 2
+};
+
+// Declare pointer to the user-defined echo task
+void (*US100_Echo_Task)(uint8_t channel, uint32_t echo_ticks) = 0;
+
+static volatile uint8_t echo_state[US100_ECHO_CHANNEL_COUNT];
+static volatile uint32_t echo_rise_time[US100_ECHO_CHANNEL_COUNT];
+static uint8_t initialized_channels = 0;
+
+// Wide timers (bits of the RCGCWTIMER register) whose configuration register has been written
+static uint8_t configured_timers = 0;
+
+// Timer enable (TnEN), capture event interrupt (CnEIM), and both-edges event (TnEVENT) bits of each timer half
+static uint32_t Echo_Enable_Bit(const Echo_Channel_Config *config)
+{
+	return (config->timer_half == ECHO_TIMER_B) ? 0x100 : 0x01;
+}
+
+static uint32_t Echo_Capture_Event_Bit(const Echo_Channel_Config *config)
+{
+	return (config->timer_half == ECHO_TIMER_B) ? 0x400 : 0x04;
+}
+
+static uint32_t Echo_Both_Edges_Bits(const Echo_Channel_Config *config)
+{
+	return (config->timer_half == ECHO_TIMER_B) ? 0xC00 : 0x0C;
+}
+
+// Selects the split configuration of a wide timer, once for both of its halves
+static void Echo_Timer_Init(const Echo_Channel_Config *config)
+{
+	if (configured_timers & config->timer_clock)
+	{
+		return;
+	}
+
+	// Enable the clock to the wide timer
+	SYSCTL->RCGCWTIMER |= config->timer_clock;
+
+	// The GPTMCFG register is shared by both halves, so both must be disabled
+	// (TAEN, Bit 0 and TBEN, Bit 8) before it is changed
+	config->timer->CTL &= ~(0x01 | 0x100);
+
+	// Set the GPTMCFG field to 0x4 to select the 32-bit
+	// individual (split) configuration of the wide timer
+	config->timer->CFG = 0x04;
+
+	configured_timers |= config->timer_clock;
+}
+
+static void Echo_Channel_Init(const Echo_Channel_Config *config)
+{
+	Echo_Timer_Init(config);
+
+	// Enable the clocks to the GPIO ports
+	SYSCTL->RCGCGPIO |= config->trigger_port_clock | config->echo_port_clock;
+
+	// Configure the trigger pin as a GPIO output
+	config->trigger_port->AFSEL &= ~config->trigger_pin;
+	config->trigger_port->DIR |= config->trigger_pin;
+	config->trigger_port->DEN |= config->trigger_pin;
+	*config->trigger_data = 0;
+
+	// Unlock the echo pin in case it is a locked pin (PD7), then select the
+	// capture input (PMCn = 7)
+	config->echo_port->LOCK = GPIO_LOCK_KEY;
+	config->echo_port->CR |= config->echo_pin;
+	config->echo_port->DIR &= ~config->echo_pin;
+	config->echo_port->AFSEL |= config->echo_pin;
+	config->echo_port->PCTL = (config->echo_port->PCTL & ~config->echo_pctl_mask) | config->echo_pctl_value;
+	config->echo_port->DEN |= config->echo_pin;
+
+	// Disable the timer half while it is configured (the other half keeps capturing)
+	config->timer->CTL &= ~Echo_Enable_Bit(config);
+
+	// Configure the timer half in capture mode (TnMR = 0x3), edge-time mode (TnCMR, Bit 2)
+	// and count up (TnCDIR, Bit 4), and capture both edges (TnEVENT = 0x3)
+	// Count through the full 32-bit range
+	if (config->timer_half == ECHO_TIMER_B)
+	{
+		config->timer->TBMR = 0x03 | 0x04 | 0x10;
+		config->timer->TBILR = 0xFFFFFFFF;
+		config->timer->TBPR = 0;
+	}
+	else
+	{
+		config->timer->TAMR = 0x03 | 0x04 | 0x10;
+		config->timer->TAILR = 0xFFFFFFFF;
+		config->timer->TAPR = 0;
+	}
+
+	config->timer->CTL |= Echo_Both_Edges_Bits(config);
+
+	// Clear and enable the capture event interrupt
+	config->timer->ICR = Echo_Capture_Event_Bit(config);
+	config->timer->IMR |= Echo_Capture_Event_Bit(config);
+
+	// Set the priority level to 2 for the capture interrupt
+	// Each IPR register holds the priority of four IRQs in Bits 7:5, 15:13, 23:21, and 31:29
+	uint32_t priority_shift = ((config->irq % 4) * 8) + 5;
+	NVIC->IPR[config->irq / 4] = (NVIC->IPR[config->irq / 4] & ~(0x7UL << priority_shift)) | (2UL << priority_shift);
+
+	// Enable the IRQ of the timer half
+	NVIC->ISER[config->irq / 32] |= (1UL << (config->irq % 32));
+
+	// Enable the timer half
+	config->timer->CTL |= Echo_Enable_Bit(config);
+}
+
+static void Echo_Channel_Capture(uint8_t channel)
+{
+	const Echo_Channel_Config *config = &echo_channels[channel];
+	uint32_t capture_event = Echo_Capture_Event_Bit(config);
+
+	// Check if a capture event has occurred
+	if (config->timer->MIS & capture_event)
+	{
+		// Acknowledge the capture event interrupt and clear it
+		config->timer->ICR = capture_event;
+
+		// Read the time of the captured edge
+		uint32_t capture_time = (config->timer_half == ECHO_TIMER_B) ? config->timer->TBR : config->timer->TAR;
+
+		if (echo_state[channel] == ECHO_WAIT_RISE)
+		{
+			echo_rise_time[channel] = capture_time;
+			echo_state[channel] = ECHO_WAIT_FALL;
+		}
+		else if (echo_state[channel] == ECHO_WAIT_FALL)
+		{
+			echo_state[channel] = ECHO_IDLE;
+
+			// Execute the user-defined task with the width of the echo pulse
+			// (unsigned subtraction handles a wrap of the counter)
+			if (US100_Echo_Task != 0)
+			{
+				(*US100_Echo_Task)(channel, capture_time - echo_rise_time[channel]);
+			}
+		}
+	}
+}
+
+void US100_Echo_Init(void(*task)(uint8_t, uint32_t), uint8_t channel_mask)
+{
+	// Store the user-defined task function for use during interrupt handling
+	US100_Echo_Task = task;
+
+	for (uint8_t channel = 0; channel < US100_ECHO_CHANNEL_COUNT; channel++)
+	{
+		if (channel_mask & (1 << channel))
+		{
+			echo_state[channel] = ECHO_IDLE;
+			Echo_Channel_Init(&echo_channels[channel]);
+			initialized_channels |= (1 << channel);
+		}
+	}
+}
+
+void US100_Echo_Trigger(uint8_t channel)
+{
+	const Echo_Channel_Config *config;
+	Timer_Handle pulse_timer;
+
+	if ((channel >= US100_ECHO_CHANNEL_COUNT) || !(initialized_channels & (1 << channel)))
+	{
+		return;
+	}
+
+	config = &echo_channels[channel];
+
+	// Wait for the rising edge of the new echo pulse
+	echo_state[channel] = ECHO_WAIT_RISE;
+
+	// Output a 10 us pulse on the trigger pin
+	*config->trigger_data = config->trigger_pin;
+	Timer_Start(&pulse_timer, US100_TRIGGER_PULSE_US);
+	while (!Timer_Expired(&pulse_timer));
+	*config->trigger_data = 0;
+}
+
+void US100_Echo_Disable(void)
+{
+	for (uint8_t channel = 0; channel < US100_ECHO_CHANNEL_COUNT; channel++)
+	{
+		const Echo_Channel_Config *config = &echo_channels[channel];
+
+		if (!(initialized_channels & (1 << channel)))
+		{
+			continue;
+		}
+
+		echo_state[channel] = ECHO_IDLE;
+
+		// Disable the capture event interrupt and the timer half
+		config->timer->IMR &= ~Echo_Capture_Event_Bit(config);
+		config->timer->CTL &= ~Echo_Enable_Bit(config);
+		NVIC->ICER[config->irq / 32] = (1UL << (config->irq % 32));
+
+		// Release the trigger pin
+		*config->trigger_data = 0;
+	}
+
+	// Every half is disabled, so the configuration may be written again at the next initialization
+	initialized_channels = 0;
+	configured_timers = 0;
+}
+
+uint8_t US100_Echo_Done(uint8_t channel)
+{
+	return ((channel >= US100_ECHO_CHANNEL_COUNT) || (echo_state[channel] == ECHO_IDLE)) ? 1 : 0;
+}
+
+uint32_t US100_Echo_Ticks_To_Distance(uint32_t echo_ticks)
+{
+	// distance (0.1 mm) = ticks * (343 m/s / 2) / system clock * 10000
+	//                   = ticks * 1715000 / system clock
+	// For example, at 50 MHz: ticks * 343 / 10000
+	return (uint32_t)(((uint64_t)echo_ticks * 1715000) / Clock_Get_Hz());
+}
+
+void WTIMER0B_Handler(void)
+{
+	PROFILE_BEGIN();
+
+	Echo_Channel_Capture(0);
+
+	PROFILE_END(PROFILE_PROBE_ECHO);
+}
+
+void WTIMER5A_Handler(void)
+{
+	PROFILE_BEGIN();
+
+	Echo_Channel_Capture(1);
+
+	PROFILE_END(PROFILE_PROBE_ECHO);
+}
+
+void WTIMER5B_Handler(void)
+{
+	PROFILE_BEGIN();
+
+	Echo_Channel_Capture(2);
+
+	PROFILE_END(PROFILE_PROBE_ECHO);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file US100_Echo.h
+ *
+ * @brief Header file for the US100_Echo driver.
+ *
+ * This file contains the function definitions for the US100_Echo driver.
+ * It operates one or more US-100 Ultrasonic Distance Sensors in trigger/echo (GPIO) mode,
+ * which is selected by removing the mode jumper on each sensor. Each sensor is one
+ * channel with the following pins:
+ *  - Channel 0: Trigger (PC7) GPIO output, Echo (PC5) WT0CCP1 (Wide Timer 0B capture input)
+ *  - Channel 1: Trigger (PE2) GPIO output, Echo (PD6) WT5CCP0 (Wide Timer 5A capture input)
+ *  - Channel 2: Trigger (PE3) GPIO output, Echo (PD7) WT5CCP1 (Wide Timer 5B capture input)
+ *
+ * The capture timer of each channel is configured in 32-bit edge-time capture mode on
+ * both edges and counts up at the system clock. The timer hardware latches the
+ * time of the rising and falling edges of the echo pulse, so the width is measured with
+ * a resolution of one clock cycle (12.5 ns at 80 MHz) regardless of the interrupt latency. The CPU only handles
+ * one interrupt per edge.
+ *
+ * The channels are listed in a table in US100_Echo.c. A new channel is one table entry
+ * and the interrupt handler of its capture timer.
+ *
+ * @note The serial mode of the US-100 compensates for temperature internally.
+ * In echo mode, the distance is computed with a fixed speed of sound (343 m/s at 20 C).
+ *
+ * @note The pins of channel 0 are shared with UART1. Initializing channel 0 reconfigures
+ * PC5 and PC7; UART1_Init must be called again to return to the serial mode.
+ *
+ * @note The capture timers count system clock cycles, so an echo that is measured while
+ * the clock profile changes (see Clock.h) is converted with the wrong frequency.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef US100_ECHO_H
+#define US100_ECHO_H
+
+#include "TM4C123GH6PM.h"
+
+// Number of channels in the channel table
+#define US100_ECHO_CHANNEL_COUNT    3
+
+// Declare pointer to the user-defined echo task
+extern void (*US100_Echo_Task)(uint8_t channel, uint32_t echo_ticks);
+
+/**
+ * @brief Initializes the trigger pins and the edge-time captures of the selected channels.
+ *
+ * The channels that are not selected are left untouched. The priority level of the
+ * capture timer interrupts is set to 2.
+ *
+ * @param task A pointer to the user-defined function executed from the interrupt
+ *             when the falling edge of an echo pulse has been captured. The channel
+ *             and the width of the echo pulse in timer counts are passed to the function.
+ *
+ * @param channel_mask The channels to initialize (Bit n = channel n).
+ *
+ * @return None
+ */
+void US100_Echo_Init(void(*task)(uint8_t, uint32_t), uint8_t channel_mask);
+
+/**
+ * @brief Sends a 10 us trigger pulse to the US-100 of a channel and arms its echo capture.
+ *
+ * @param channel The channel to trigger.
+ *
+ * @return None
+ */
+void US100_Echo_Trigger(uint8_t channel);
+
+/**
+ * @brief Disables the echo capture interrupts and the trigger pins of every initialized channel.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void US100_Echo_Disable(void);
+
+/**
+ * @brief Indicates whether the last triggered echo pulse of a channel has been measured.
+ *
+ * @param channel The channel.
+ *
+ * @return uint8_t Returns 1 if the falling edge of the echo pulse has been captured. Otherwise, it returns 0.
+ */
+uint8_t US100_Echo_Done(uint8_t channel);
+
+/**
+ * @brief Converts an echo pulse width to a distance.
+ *
+ * The distance is (width * 343 m/s) / 2.
+ *
+ * @param echo_ticks The width of the echo pulse in capture timer counts.
+ *
+ * @return uint32_t The distance in tenths of a millimeter.
+ */
+uint32_t US100_Echo_Ticks_To_Distance(uint32_t echo_ticks);
+
+/**
+ * @brief The interrupt service routine (ISR) for Wide Timer 0B (channel 0).
+ *
+ * This function reads the captured time of each edge of the echo pulse.
+ * On the falling edge, it executes the user-defined task with the width of the pulse.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WTIMER0B_Handler(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for Wide Timer 5A (channel 1).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WTIMER5A_Handler(void);
+
+/**
+ * @brief The interrupt service routine (ISR) for Wide Timer 5B (channel 2).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WTIMER5B_Handler(void);
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file Watchdog.c
+ *
+ * @brief Source code for the Watchdog driver.
+ *
+ * This file contains the function definitions for the Watchdog driver.
+ * The registers of the watchdog are locked between accesses, so a runaway write
+ * cannot disable it.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Watchdog.h"
+#include "Clock.h"
+
+// Value written to the WDTLOCK register to unlock the other registers (any other value locks them)
+#define WATCHDOG_UNLOCK_KEY         0x1ACCE551
+
+// Fields of the Watchdog Control (WDTCTL) register
+#define WATCHDOG_CTL_INTEN          0x01            // Enable the counter and the timeout interrupt (Bit 0)
+#define WATCHDOG_CTL_RESEN          0x02            // Reset the processor at the second timeout (Bit 1)
+
+// STALL bit (Bit 8) of the Watchdog Test (WDTTEST) register: stop counting while a debugger halts the processor
+#define WATCHDOG_TEST_STALL         0x100
+
+// Watchdog Timer 0 has an IRQ of 18
+#define WATCHDOG_IRQ_BIT            (1 << 18)
+
+static void (*watchdog_timeout_task)(void) = 0;
+static uint32_t watchdog_timeout_ms = 0;
+
+// Cycles of the system clock from a feed to the timeout interrupt
+static uint32_t Watchdog_Get_Load(uint32_t system_clock_hz)
+{
+    return (system_clock_hz / 1000) * watchdog_timeout_ms;
+}
+
+static void Watchdog_Clock_Changed(uint32_t system_clock_hz)
+{
+    // Writing the load value also reloads the counter
+    WATCHDOG0->LOCK = WATCHDOG_UNLOCK_KEY;
+    WATCHDOG0->LOAD = Watchdog_Get_Load(system_clock_hz);
+    WATCHDOG0->LOCK = 0;
+}
+
+uint8_t Watchdog_Read_Reset_Cause(void)
+{
+    uint8_t reset_cause = (uint8_t)SYSCTL->RESC;
+
+    // The causes are only cleared by software
+    SYSCTL->RESC = 0;
+
+    return reset_cause;
+}
+
+void Watchdog_Init(uint32_t timeout_ms, void (*timeout_task)(void))
+{
+    watchdog_timeout_task = timeout_task;
+    watchdog_timeout_ms = timeout_ms;
+
+    // Enable the clock to Watchdog Timer 0 by setting the R0 bit (Bit 0) in the RCGCWD register
+    SYSCTL->RCGCWD |= 0x01;
+    while ((SYSCTL->PRWD & 0x01) == 0);
+
+    WATCHDOG0->LOCK = WATCHDOG_UNLOCK_KEY;
+
+    WATCHDOG0->LOAD = Watchdog_Get_Load(Clock_Get_Hz());
+    WATCHDOG0->TEST |= WATCHDOG_TEST_STALL;
+
+    // The reset must be enabled before the counter is started
+    WATCHDOG0->CTL |= WATCHDOG_CTL_RESEN;
+    WATCHDOG0->CTL |= WATCHDOG_CTL_INTEN;
+
+    WATCHDOG0->LOCK = 0;
+
+    if (!Clock_Subscribe(&Watchdog_Clock_Changed))
+    {
+        // The load value is only valid for the current profile
+        Clock_Hold_Profile();
+    }
+
+    // Set the priority level to 0 for the watchdog interrupt, so that the timeout task
+    // runs even when another interrupt handler is stuck
+    // In the Interrupt 16-19 Priority (PRI4) register,
+    // the INTC field (Bits 23 to 21) corresponds to Interrupt Request (IRQ) 18
+    NVIC->IPR[4] &= ~0x00E00000;
+
+    NVIC->ISER[0] = WATCHDOG_IRQ_BIT;
+}
+
+void Watchdog_Feed(void)
+{
+    // Any write to the WDTICR register clears the interrupt and reloads the counter
+    WATCHDOG0->LOCK = WATCHDOG_UNLOCK_KEY;
+    WATCHDOG0->ICR = 0x01;
+    WATCHDOG0->LOCK = 0;
+
+    // Unmask the interrupt again in case the handler ran before this feed
+    NVIC->ISER[0] = WATCHDOG_IRQ_BIT;
+}
+
+void WDT0_Handler(void)
+{
+    // The interrupt stays pending until the next feed, so mask it to run the task only once
+    NVIC->ICER[0] = WATCHDOG_IRQ_BIT;
+
+    if (watchdog_timeout_task != 0)
+    {
+        (*watchdog_timeout_task)();
+    }
+}
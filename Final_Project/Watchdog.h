@@ -0,0 +1,91 @@
+/**
+ * @file Watchdog.h
+ *
+ * @brief Header file for the Watchdog driver.
+ *
+ * This file contains the function definitions for Watchdog Timer 0 of the TM4C123GH6PM.
+ * The watchdog counts down from its load value. The first time it reaches zero, the
+ * timeout interrupt is raised and the counter is reloaded. If the interrupt is still not
+ * cleared the second time it reaches zero, the processor is reset. Watchdog_Feed clears
+ * the interrupt and reloads the counter.
+ *
+ * The timeout task is executed from the timeout interrupt, at the highest priority, so it
+ * can record what the processor was doing before it is reset. Deciding when to feed the
+ * watchdog is left to the caller (see Supervisor.h).
+ *
+ * The watchdog is clocked by the system clock, so its load value is derived from the
+ * clock profile (see Clock.h). It stops while a debugger halts the processor and in
+ * deep-sleep mode (see Power.h).
+ *
+ * @note Refer to Section 11 (Watchdog Timers) of the TM4C123G Microcontroller Datasheet.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include "TM4C123GH6PM.h"
+
+/**
+ * @brief Causes of a reset, as reported in the Reset Cause (RESC) register.
+ */
+enum Watchdog_Reset_Causes
+{
+    WATCHDOG_RESET_EXTERNAL     = 0x01,     // RST pin
+    WATCHDOG_RESET_POWER_ON     = 0x02,     // Power-on reset
+    WATCHDOG_RESET_BROWN_OUT    = 0x04,     // Brown-out reset
+    WATCHDOG_RESET_WATCHDOG_0   = 0x08,     // Watchdog Timer 0 reset
+    WATCHDOG_RESET_SOFTWARE     = 0x10,     // Software reset
+    WATCHDOG_RESET_WATCHDOG_1   = 0x20      // Watchdog Timer 1 reset
+};
+
+/**
+ * @brief Reads the causes of the last reset and clears them.
+ *
+ * The RESC register keeps the causes of every reset since it was last cleared, so it is
+ * cleared here for the next reset to report only its own causes. This function must be
+ * called once, early in main.
+ *
+ * @param None
+ *
+ * @return uint8_t The causes of the last reset (see Watchdog_Reset_Causes).
+ */
+uint8_t Watchdog_Read_Reset_Cause(void);
+
+/**
+ * @brief Starts Watchdog Timer 0 with its reset enabled.
+ *
+ * Once started, the watchdog cannot be stopped until the next reset.
+ *
+ * @param timeout_ms The time from the last feed to the timeout interrupt. The processor
+ *                   is reset timeout_ms after the interrupt if the watchdog is not fed.
+ *
+ * @param timeout_task A pointer to the function executed from the timeout interrupt, or 0.
+ *
+ * @return None
+ */
+void Watchdog_Init(uint32_t timeout_ms, void (*timeout_task)(void));
+
+/**
+ * @brief Clears the timeout interrupt and reloads the counter of the watchdog.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Watchdog_Feed(void);
+
+/**
+ * @brief The interrupt service routine (ISR) of Watchdog Timer 0.
+ *
+ * Executes the timeout task once and leaves the interrupt pending, so the processor
+ * is reset at the next timeout unless the watchdog is fed first.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WDT0_Handler(void);
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * @file Zone.c
+ *
+ * @brief Source code for the Zone module.
+ *
+ * This file contains the zone table, the sensor table, and the function definitions for
+ * the protected zones of the Home Security System.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Zone.h"
+#include "Sensor_Range.h"
+#include "Sensor_Digital.h"
+#include "Config.h"
+
+// Default intrusion detection thresholds (the US-100 reports millimeters)
+#define INTRUSION_THRESHOLD_MM      500  // 50 cm
+#define INTRUSION_HYSTERESIS_MM     100  // The object must move back to 60 cm to end a detection
+#define APPROACH_SPEED_MM_S         400  // An object approaching at 40 cm/s or faster is a hit...
+#define APPROACH_RANGE_MM           1500 // ...once it is closer than 1.5 m
+#define INTRUSION_CONFIRM_COUNT     3    // An intrusion needs 3 hits...
+#define INTRUSION_CONFIRM_WINDOW    5    // ...in the last 5 samples
+
+#define DEFAULT_FILTER_CONFIG(threshold_mm)                     \
+    {                                                           \
+        .enter_distance_mm = (threshold_mm),                    \
+        .exit_distance_mm = (threshold_mm) + INTRUSION_HYSTERESIS_MM, \
+        .approach_speed_mm_s = APPROACH_SPEED_MM_S,             \
+        .approach_range_mm = APPROACH_RANGE_MM,                 \
+        .ema_shift = 2,                                         \
+        .confirm_count = INTRUSION_CONFIRM_COUNT,               \
+        .confirm_window = INTRUSION_CONFIRM_WINDOW              \
+    }
+
+// Time for which a vote counts after the filter of its sensor stops confirming
+#define ZONE_VOTE_WINDOW_MS         5000
+
+// The motion detectors and the contacts are debounced by their drivers (see Sensor_Digital.h), so one hit confirms
+#define BINARY_FILTER_CONFIG                                    \
+    {                                                           \
+        .confirm_count = 1,                                     \
+        .confirm_window = 1                                     \
+    }
+
+// The back door is only reported when its US-100 and its motion detector agree
+#define BACK_DOOR_REQUIRED_VOTES    (ZONE_DIGITAL_SENSORS ? 2 : 1)
+
+// Protected zones
+static const Zone_Config zone_table[] =
+{
+    { "Front Door",  DEFAULT_FILTER_CONFIG(INTRUSION_THRESHOLD_MM), 1, ZONE_VOTE_WINDOW_MS },
+    { "Back Door",   DEFAULT_FILTER_CONFIG(INTRUSION_THRESHOLD_MM), BACK_DOOR_REQUIRED_VOTES, ZONE_VOTE_WINDOW_MS },
+    { "Window",      DEFAULT_FILTER_CONFIG(800), 1, ZONE_VOTE_WINDOW_MS }
+};
+
+// Sensors of the zones: driver, channel, and zone
+// With the UART backend, only the US-100 on channel 0 is measured
+static const Sensor_Config sensor_table[] =
+{
+    { &Sensor_Range_Driver, 0, 0 },
+    { &Sensor_Range_Driver, 1, 1 },
+    { &Sensor_Range_Driver, 2, 2 },
+#if ZONE_DIGITAL_SENSORS
+    { &Sensor_Contact_Driver, 0, 0 },
+    { &Sensor_Motion_Driver, 0, 1 },
+#endif
+};
+
+#define ZONE_COUNT ((uint8_t)(sizeof(zone_table) / sizeof(zone_table[0])))
+
+_Static_assert(ZONE_COUNT <= CONFIG_ZONE_COUNT, "The configuration stores the filter of every zone");
+#define SENSOR_COUNT ((uint8_t)(sizeof(sensor_table) / sizeof(sensor_table[0])))
+
+_Static_assert(ZONE_COUNT <= ZONE_MAX_COUNT, "The zone table has more than ZONE_MAX_COUNT zones");
+_Static_assert(SENSOR_COUNT <= SENSOR_MAX_COUNT, "The sensor table has more than SENSOR_MAX_COUNT sensors");
+
+static const Intrusion_Filter_Config binary_filter_config = BINARY_FILTER_CONFIG;
+
+// Runtime state of the sensors
+static Intrusion_Filter sensor_filters[SENSOR_COUNT];
+static uint8_t sensor_faults[SENSOR_COUNT];
+static uint8_t sensor_voted[SENSOR_COUNT];
+static uint64_t sensor_vote_time_us[SENSOR_COUNT];
+
+// Runtime state of the zones
+static uint8_t zone_enabled[ZONE_COUNT];
+static uint8_t zone_detected[ZONE_COUNT];
+
+// Returns the index of the first distance sensor of a zone, or SENSOR_NONE
+static uint8_t Zone_Find_Range_Sensor(uint8_t zone)
+{
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        if ((sensor_table[sensor].zone == zone) && (sensor_table[sensor].driver->type == SENSOR_TYPE_RANGE))
+        {
+            return sensor;
+        }
+    }
+
+    return SENSOR_NONE;
+}
+
+// Counts the votes of the sensors of a zone and returns the event of the zone
+static uint8_t Zone_Fuse(uint8_t zone, uint64_t timestamp_us)
+{
+    uint64_t window_us = (uint64_t)zone_table[zone].vote_window_ms * 1000;
+    uint8_t votes = 0;
+    uint8_t confirmed = 0;
+
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        if (sensor_table[sensor].zone != zone)
+        {
+            continue;
+        }
+
+        if (Intrusion_Filter_Is_Detected(&sensor_filters[sensor]))
+        {
+            confirmed = 1;
+            votes++;
+        }
+        else if (sensor_voted[sensor] && ((timestamp_us - sensor_vote_time_us[sensor]) <= window_us))
+        {
+            votes++;
+        }
+    }
+
+    if (!zone_detected[zone] && (votes >= zone_table[zone].required_votes))
+    {
+        zone_detected[zone] = 1;
+        return ZONE_EVENT_DETECTED;
+    }
+
+    if (zone_detected[zone] && !confirmed)
+    {
+        // A new intrusion needs new votes
+        zone_detected[zone] = 0;
+
+        for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+        {
+            if (sensor_table[sensor].zone == zone)
+            {
+                sensor_voted[sensor] = 0;
+            }
+        }
+
+        return ZONE_EVENT_CLEARED;
+    }
+
+    return ZONE_EVENT_NONE;
+}
+
+void Zone_Init(void)
+{
+    Intrusion_Filter_Config stored_config;
+
+    Sensor_Init(sensor_table, SENSOR_COUNT);
+
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        zone_enabled[zone] = 0;
+    }
+
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        uint8_t zone = sensor_table[sensor].zone;
+
+        if (sensor_table[sensor].driver->type == SENSOR_TYPE_RANGE)
+        {
+            // The thresholds saved in the configuration replace the defaults of the zone table
+            if (Config_Get_Filter(zone, &stored_config))
+            {
+                Intrusion_Filter_Init(&sensor_filters[sensor], &stored_config);
+            }
+            else
+            {
+                Intrusion_Filter_Init(&sensor_filters[sensor], &zone_table[zone].filter_config);
+            }
+        }
+        else
+        {
+            Intrusion_Filter_Init(&sensor_filters[sensor], &binary_filter_config);
+        }
+
+        if (Sensor_Is_Enabled(sensor))
+        {
+            zone_enabled[zone] = 1;
+        }
+    }
+
+    Zone_Reset();
+}
+
+void Zone_Reset(void)
+{
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        Intrusion_Filter_Reset(&sensor_filters[sensor]);
+        sensor_faults[sensor] = 0;
+        sensor_voted[sensor] = 0;
+    }
+
+    for (uint8_t zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        zone_detected[zone] = 0;
+    }
+}
+
+uint8_t Zone_Update(const Sensor_Sample *sample, uint8_t *zone)
+{
+    uint8_t sensor = sample->sensor;
+    uint8_t zone_index = (sensor < SENSOR_COUNT) ? sensor_table[sensor].zone : ZONE_NONE;
+
+    if (zone_index >= ZONE_COUNT)
+    {
+        *zone = ZONE_NONE;
+        return ZONE_EVENT_NONE;
+    }
+
+    *zone = zone_index;
+
+    // Report a sensor that stopped responding once, instead of feeding its timeouts to the filter
+    if (sample->status == SENSOR_STATUS_TIMEOUT)
+    {
+        if (!sensor_faults[sensor])
+        {
+            sensor_faults[sensor] = 1;
+            return ZONE_EVENT_FAULT;
+        }
+        return ZONE_EVENT_NONE;
+    }
+
+    sensor_faults[sensor] = 0;
+
+    if (Intrusion_Filter_Update(&sensor_filters[sensor], sample) == INTRUSION_FILTER_EVENT_DETECTED)
+    {
+        sensor_voted[sensor] = 1;
+        sensor_vote_time_us[sensor] = sample->timestamp_us;
+    }
+
+    return Zone_Fuse(zone_index, sample->timestamp_us);
+}
+
+uint8_t Zone_Get_Count(void)
+{
+    return ZONE_COUNT;
+}
+
+const char *Zone_Get_Name(uint8_t zone)
+{
+    return (zone < ZONE_COUNT) ? zone_table[zone].name : "Unknown";
+}
+
+uint8_t Zone_Is_Enabled(uint8_t zone)
+{
+    return (zone < ZONE_COUNT) ? zone_enabled[zone] : 0;
+}
+
+uint8_t Zone_Has_Fault(uint8_t zone)
+{
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        if ((sensor_table[sensor].zone == zone) && sensor_faults[sensor])
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint16_t Zone_Get_Distance(uint8_t zone)
+{
+    uint8_t sensor = Zone_Find_Range_Sensor(zone);
+
+    return (sensor != SENSOR_NONE) ? Intrusion_Filter_Get_Distance(&sensor_filters[sensor]) : 0;
+}
+
+void Zone_Set_Filter_Config(uint8_t zone, const Intrusion_Filter_Config *config)
+{
+    for (uint8_t sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        if ((sensor_table[sensor].zone == zone) && (sensor_table[sensor].driver->type == SENSOR_TYPE_RANGE))
+        {
+            Intrusion_Filter_Set_Config(&sensor_filters[sensor], config);
+        }
+    }
+}
+
+void Zone_Get_Filter_Config(uint8_t zone, Intrusion_Filter_Config *config)
+{
+    uint8_t sensor = Zone_Find_Range_Sensor(zone);
+
+    if (sensor != SENSOR_NONE)
+    {
+        *config = sensor_filters[sensor].config;
+    }
+    else if (zone < ZONE_COUNT)
+    {
+        *config = zone_table[zone].filter_config;
+    }
+}
@@ -0,0 +1,169 @@
+/**
+ * @file Zone.h
+ *
+ * @brief Header file for the Zone module.
+ *
+ * This file contains the function definitions for the protected zones of the Home
+ * Security System. Each zone is an entry point watched by one or more sensors (see
+ * Sensor.h), and each sensor has its own intrusion filter. The distance sensors of a
+ * zone use the thresholds of the zone.
+ *
+ * The zones and the sensors are listed in two tables in Zone.c. Adding a zone is one
+ * entry with its name, filter configuration, and fusion rule, and adding a sensor is one
+ * entry with its driver, channel, and zone. A sensor whose channel is not supported by
+ * its driver (for example, a US-100 channel that the ranging backend cannot measure)
+ * is disabled, and a zone without an enabled sensor is not monitored.
+ *
+ * Fusion: the confirmed detection of a sensor filter is a vote for its zone. A vote
+ * counts while the filter still confirms the intrusion and for the vote window of the
+ * zone afterwards, so that a motion detector and a distance sensor that trigger a few
+ * seconds apart still agree. An intrusion is reported when the number of sensors of the
+ * zone that vote reaches the required votes of the zone, and it ends when none of the
+ * filters confirms it anymore. The votes are then cleared.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef ZONE_H
+#define ZONE_H
+
+#include "TM4C123GH6PM.h"
+#include "Sensor.h"
+#include "Intrusion_Filter.h"
+
+// Largest number of zones
+#define ZONE_MAX_COUNT      4
+
+// Set to 1 to add the PIR motion detector and the reed switch (see Sensor_Digital.h)
+// to the sensor table. A disconnected reed switch reads as an open door.
+#ifndef ZONE_DIGITAL_SENSORS
+#define ZONE_DIGITAL_SENSORS 0
+#endif
+
+// Returned instead of a zone index when no zone applies
+#define ZONE_NONE           0xFF
+
+/**
+ * @brief Events reported by Zone_Update.
+ */
+enum Zone_Events
+{
+    ZONE_EVENT_NONE     = 0,    // Nothing changed
+    ZONE_EVENT_DETECTED = 1,    // An intrusion has just been confirmed in the zone
+    ZONE_EVENT_CLEARED  = 2,    // A confirmed intrusion in the zone has just ended
+    ZONE_EVENT_FAULT    = 3     // A sensor of the zone has just stopped replying
+};
+
+/**
+ * @brief Static description of one zone.
+ */
+typedef struct
+{
+    const char *name;                       // Name shown on the LCD (at most 16 characters)
+    Intrusion_Filter_Config filter_config;  // Default thresholds of the distance sensors of the zone
+    uint8_t required_votes;                 // Number of sensors that must vote for an intrusion (at least 1)
+    uint16_t vote_window_ms;                // Time for which a vote counts after its filter stops confirming
+} Zone_Config;
+
+/**
+ * @brief Initializes the sensor table and the filters of the sensors.
+ *
+ * The ranging backend must be selected before this function is called. The sensors are
+ * started and stopped with SIGNAL_SENSOR_START and SIGNAL_SENSOR_STOP (see Sensor_Task).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Zone_Init(void);
+
+/**
+ * @brief Clears the filter history, the votes, and the sensor faults of every zone.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Zone_Reset(void);
+
+/**
+ * @brief Feeds a sensor sample to the filter of its sensor and to the fusion of its zone.
+ *
+ * @param sample A pointer to the new sample.
+ *
+ * @param zone A pointer to where the index of the zone is stored (ZONE_NONE if the sensor has no zone).
+ *
+ * @return uint8_t The event caused by the sample (see Zone_Events).
+ */
+uint8_t Zone_Update(const Sensor_Sample *sample, uint8_t *zone);
+
+/**
+ * @brief Returns the number of zones in the zone table.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of zones.
+ */
+uint8_t Zone_Get_Count(void);
+
+/**
+ * @brief Returns the name of a zone.
+ *
+ * @param zone The index of the zone.
+ *
+ * @return const char* The name of the zone, or "Unknown" if the index is out of range.
+ */
+const char *Zone_Get_Name(uint8_t zone);
+
+/**
+ * @brief Indicates whether a zone is monitored.
+ *
+ * @param zone The index of the zone.
+ *
+ * @return uint8_t Returns 1 if a sensor of the zone is enabled. Otherwise, it returns 0.
+ */
+uint8_t Zone_Is_Enabled(uint8_t zone);
+
+/**
+ * @brief Indicates whether a sensor of a zone failed to reply to its last trigger.
+ *
+ * @param zone The index of the zone.
+ *
+ * @return uint8_t Returns 1 if a sensor did not reply. Otherwise, it returns 0.
+ */
+uint8_t Zone_Has_Fault(uint8_t zone);
+
+/**
+ * @brief Returns the filtered distance of the first distance sensor of a zone.
+ *
+ * @param zone The index of the zone.
+ *
+ * @return uint16_t The filtered distance in millimeters, or 0 if no valid sample was received.
+ */
+uint16_t Zone_Get_Distance(uint8_t zone);
+
+/**
+ * @brief Changes the thresholds of the filters of the distance sensors of a zone.
+ *
+ * The new thresholds apply to the next range sample of the zone.
+ *
+ * @param zone The index of the zone.
+ *
+ * @param config A pointer to the new filter configuration (distances in millimeters).
+ *
+ * @return None
+ */
+void Zone_Set_Filter_Config(uint8_t zone, const Intrusion_Filter_Config *config);
+
+/**
+ * @brief Copies the current thresholds of the filter of a zone.
+ *
+ * @param zone The index of the zone.
+ *
+ * @param config A pointer to where the filter configuration is copied.
+ *
+ * @return None
+ */
+void Zone_Get_Filter_Config(uint8_t zone, Intrusion_Filter_Config *config);
+
+#endif
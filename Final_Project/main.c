@@ -18,95 +18,137 @@
  */
 
 #include "TM4C123GH6PM.h"
+#include "Clock.h"
 #include "Buzzer.h"
-#include "SysTick_Delay.h"
-#include "EduBase_LCD.h"
+#include "LED_Pattern.h"
+#include "Timebase.h"
+#include "LCD_Framebuffer.h"
 #include "Timer_0A_Interrupt.h"
 #include "GPIO.h"
-#include "stdio.h"
 #include "Security.h"
 #include "UART1.h"
-
-// Global state
-static uint8_t system_armed = 0; // 0 = Disarmed, 1 = Armed
-static uint8_t alert_active = 0; // 0 = No alert, 1 = Alert triggered
-
-void Menu_Controller(uint8_t edubase_button_status);
-void Display_Status(const char *message);
+#include "Scheduler.h"
+#include "Power.h"
+#include "Keypad.h"
+#include "Code_Entry.h"
+#include "Event_Log.h"
+#include "Telemetry.h"
+#include "Profile.h"
+#include "Benchmark.h"
+#include "Watchdog.h"
+#include "Supervisor.h"
+#include "Config.h"
+
+void System_Tick(void);
+void Menu_Task(const Scheduler_Event *event);
+void Menu_Controller(const Keypad_Event *button_event);
 
 int main(void)
 {
+    uint8_t reset_cause;
+
     // Initializes system peripherals
-    SysTick_Delay_Init();       // Initialize SysTick timer for delays
-    EduBase_LCD_Init();         // Initialize the 16x2 LCD on the EduBase board
+    Clock_Init(CLOCK_DEFAULT_PROFILE); // Run the system clock from the PLL before the drivers derive their divisors
+    Timebase_Init();            // Initialize the free-running SysTick timebase
+    Profile_Init();             // Start the DWT cycle counter for the profiling probes
+
+    // Stage 1: the alarm path and the sensor path, so that the system can be armed as soon as possible
     EduBase_LEDs_Init();        // Initialize the LEDs on the EduBase board
-    EduBase_Button_Init();      // Configure buttons with interrupts
+    LED_Pattern_Init();         // Play LED patterns on the EduBase LEDs and the RGB LED from Timer 0A
     Buzzer_Init();              // Initialize the buzzer
     UART1_Init();               // Initialize UART1 for US-100 sensor communication
-
-    SysTick_Delay1ms(100);      // Allow peripherals to stabilize
+    Scheduler_Init();
+    reset_cause = Watchdog_Read_Reset_Cause();
+    Event_Log_Init(reset_cause); // Record the reset in the EEPROM event log
+    Supervisor_Init(reset_cause); // Start the watchdog and read the state saved before the reset
+    Config_Init();              // Load the runtime configuration from the EEPROM
+    Security_Init();            // Register the security tasks, bring up the ranging engine, and resume the saved state
+
+    // Use Timer 0A as the 1 ms system tick
+    Timer_0A_Interrupt_Init(&System_Tick);
+    Benchmark_Mark_Boot(BENCHMARK_BOOT_PROTECTED);
+
+    // Stage 2: the user interface. The LCD powers up in the background from Timer 1A
+    // while the rest of the system starts, and the menu is shown once it is ready.
+    LCD_Framebuffer_Init();     // Initialize the 16x2 LCD and send its updates in the background
+    EduBase_Button_Init();      // Initialize the buttons on the EduBase board
+    Scheduler_Add_Task(TASK_MENU, Menu_Task);
+    Keypad_Init(TASK_MENU);     // Report debounced button events to the menu task
+    Code_Entry_Init();          // Collect the security code from the button events
+    Telemetry_Init();           // Stream telemetry and accept commands on UART0 (USB)
+    Benchmark_Init();           // Run detection latency trials on request from the telemetry link
 
     // Display the initial menu on the LCD
     Display_Main_Menu();
 
-    EduBase_LEDs_Output(EDUBASE_LED_ALL_OFF); // Turn off all LEDs initially
+    // Sleep between events once every peripheral has been initialized
+    Power_Init();
+    Benchmark_Mark_Boot(BENCHMARK_BOOT_RUNNING);
 
-    while (1)
-    {
-        // Get button status and handle menu interactions
-        uint8_t edubase_button_status = Get_EduBase_Button_Status();
-			
-        Menu_Controller(edubase_button_status);
+    // Dispatch events to the tasks forever
+    Scheduler_Run();
+}
+
+// Executed every 1 ms from the Timer 0A interrupt
+void System_Tick(void)
+{
+    Scheduler_Tick();
+    Buzzer_Sequencer_Tick();
+    LED_Pattern_Tick();
+    Keypad_Tick();
+    Supervisor_Tick();
+}
+
+// Forwards menu selections to the security task
+void Menu_Task(const Scheduler_Event *event)
+{
+    Keypad_Event button_event;
 
-        SysTick_Delay1ms(10); // Add a small delay for stability
+    switch (event->signal)
+    {
+        case SIGNAL_BUTTON_EVENT:
+            // Handle every button event received since the last signal
+            while (Keypad_Get_Event(&button_event))
+            {
+                Menu_Controller(&button_event);
+            }
+            break;
+
+        default:
+            break;
     }
 }
 
 // Used for selecting different options displayed on the LCD
-void Menu_Controller(uint8_t button_status)
+void Menu_Controller(const Keypad_Event *button_event)
 {
-    static uint8_t last_button_status = 0; // Store the last button status
-
-    // Only update if the button status has changed
-    if (button_status != last_button_status) 
-			{
-        last_button_status = button_status; // Update the last button status
-
-        switch (button_status)
-        {
-            case 0x08: // SW2 pressed
-                if (!system_armed) {
-                    system_armed = 1;             // Arm the system
-                    Display_Status("System Armed"); // Display armed message
-                    System_Armed();               // Start scanning immediately after arming
-                } else {
-                    Display_Status("Already Armed"); // Display already armed message
-                }
-                Display_Main_Menu(); // Return to the main menu
-                break;
-
-            case 0x04: // SW3 pressed
-                if (system_armed) {
-                    system_armed = 0;               // Disarm the system
-                    Display_Status("System Disarmed"); // Display disarmed message
-                } else {
-                    Display_Status("Already Disarmed"); // Display already disarmed message
-                }
-                Display_Main_Menu(); // Return to the main menu
-                break;
-
-            case 0x01: // SW5 pressed
-                Intruder_Alert(); // Trigger the intruder alert
-                break;
-
-            case 0x02: // SW4 pressed
-                EduBase_LCD_Clear_Display(); // Clear the LCD
-                Display_Main_Menu();         // Redisplay the main menu
-                SysTick_Delay1ms(20);        // Short debounce delay
-                break;
-
-            default:
-                break;
-        }
+    // Button presses are the digits of the security code
+    if (button_event->type == KEYPAD_EVENT_PRESS)
+    {
+        Code_Entry_Handle_Button(button_event);
+        return;
+    }
+
+    // Only act on a button that is held down
+    if (button_event->type != KEYPAD_EVENT_LONG_PRESS)
+    {
+        return;
+    }
+
+    // Discard the code being entered, including the digit added when the held button was pressed
+    Code_Entry_Cancel();
+
+    switch (button_event->button)
+    {
+        case KEYPAD_SW5: // SW5 held
+            Scheduler_Post(TASK_SECURITY, SIGNAL_PANIC_REQUEST, 0);  // Trigger the intruder alert
+            break;
+
+        case KEYPAD_SW4: // SW4 held
+            Scheduler_Post(TASK_DISPLAY, SIGNAL_DISPLAY_MENU, 0);    // Redisplay the main menu
+            break;
+
+        default:
+            break;
     }
 }
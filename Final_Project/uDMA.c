@@ -0,0 +1,101 @@
+/**
+ * @file uDMA.c
+ *
+ * @brief Source code for the uDMA driver.
+ *
+ * This file contains the function definitions for the Micro Direct Memory Access
+ * (uDMA) controller.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "uDMA.h"
+
+// Channel control table: 32 primary structures followed by 32 alternate structures
+// The table must be aligned on a 1024-byte boundary
+static uDMA_Control_Structure control_table[UDMA_CHANNEL_COUNT * 2] __attribute__((aligned(1024)));
+
+static uint8_t udma_initialized = 0;
+
+void uDMA_Init(void)
+{
+	if (udma_initialized)
+	{
+		return;
+	}
+	
+	// Enable the clock to the uDMA controller by setting the
+	// R0 bit (Bit 0) in the RCGCDMA register
+	SYSCTL->RCGCDMA |= 0x01;
+	while ((SYSCTL->PRDMA & 0x01) == 0);
+	
+	// Enable the controller by setting the MASTEN bit (Bit 0) in the DMACFG register
+	UDMA->CFG = 0x01;
+	
+	// Set the base address of the channel control table
+	UDMA->CTLBASE = (uint32_t)control_table;
+	
+	udma_initialized = 1;
+}
+
+void uDMA_Assign_Channel(uint8_t channel, uint8_t encoding)
+{
+	volatile uint32_t *channel_map = &UDMA->CHMAP0 + (channel / 8);
+	uint32_t shift = (channel % 8) * 4;
+	uint32_t channel_bit = 1UL << channel;
+	
+	uDMA_Disable_Channel(channel);
+	
+	// Select the peripheral of the channel in the DMACHMAPn register
+	*channel_map = (*channel_map & ~(0xFUL << shift)) | ((uint32_t)encoding << shift);
+	
+	// Use the primary control structure, default priority, single and burst requests,
+	// and allow the peripheral to request transfers
+	UDMA->ALTCLR = channel_bit;
+	UDMA->PRIOCLR = channel_bit;
+	UDMA->USEBURSTCLR = channel_bit;
+	UDMA->REQMASKCLR = channel_bit;
+}
+
+void uDMA_Set_Transfer(uint8_t channel, uint8_t alternate, volatile const void *source_end, volatile void *destination_end, uint32_t control)
+{
+	uDMA_Control_Structure *structure = &control_table[channel + (alternate ? UDMA_CHANNEL_COUNT : 0)];
+	
+	structure->source_end = source_end;
+	structure->destination_end = destination_end;
+	structure->control = control;
+}
+
+uint32_t uDMA_Get_Control(uint8_t channel, uint8_t alternate)
+{
+	return control_table[channel + (alternate ? UDMA_CHANNEL_COUNT : 0)].control;
+}
+
+void uDMA_Enable_Channel(uint8_t channel)
+{
+	UDMA->ENASET = 1UL << channel;
+}
+
+void uDMA_Disable_Channel(uint8_t channel)
+{
+	UDMA->ENACLR = 1UL << channel;
+}
+
+uint8_t uDMA_Is_Enabled(uint8_t channel)
+{
+	return (UDMA->ENASET & (1UL << channel)) ? 1 : 0;
+}
+
+uint8_t uDMA_Interrupt_Pending(uint8_t channel)
+{
+	uint32_t channel_bit = 1UL << channel;
+	
+	if (UDMA->CHIS & channel_bit)
+	{
+		// Clear the completion interrupt by writing 1 to its bit in the DMACHIS register
+		UDMA->CHIS = channel_bit;
+		return 1;
+	}
+	
+	return 0;
+}
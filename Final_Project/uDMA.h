@@ -0,0 +1,163 @@
+/**
+ * @file uDMA.h
+ *
+ * @brief Header file for the uDMA driver.
+ *
+ * This file contains the function definitions for the Micro Direct Memory Access
+ * (uDMA) controller. The driver owns the channel control table, which holds a
+ * primary and an alternate control structure for each of the 32 channels, and
+ * provides functions to assign, program, enable, and disable channels.
+ *
+ * The completion interrupt of a peripheral channel is signaled on the interrupt of
+ * the peripheral itself, so each peripheral handler checks uDMA_Interrupt_Pending
+ * for its channels.
+ *
+ * Channels in use:
+ *  - Channel 9 (encoding 0): UART0 TX
+ *  - Channel 22 (encoding 0): UART1 RX
+ *
+ * @note For more information regarding the uDMA controller, refer to the
+ * Micro Direct Memory Access (uDMA) section of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/gpn/TM4C123GH6PM
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef UDMA_H
+#define UDMA_H
+
+#include "TM4C123GH6PM.h"
+
+// Number of uDMA channels
+#define UDMA_CHANNEL_COUNT          32
+
+// Largest number of items in one transfer
+#define UDMA_MAX_TRANSFER_SIZE      1024
+
+// Fields of the channel control word (DMACHCTL)
+#define UDMA_CTL_DST_INC_8          (0x0UL << 30)
+#define UDMA_CTL_DST_INC_16         (0x1UL << 30)
+#define UDMA_CTL_DST_INC_32         (0x2UL << 30)
+#define UDMA_CTL_DST_INC_NONE       (0x3UL << 30)
+#define UDMA_CTL_DST_SIZE_8         (0x0UL << 28)
+#define UDMA_CTL_DST_SIZE_16        (0x1UL << 28)
+#define UDMA_CTL_DST_SIZE_32        (0x2UL << 28)
+#define UDMA_CTL_SRC_INC_8          (0x0UL << 26)
+#define UDMA_CTL_SRC_INC_16         (0x1UL << 26)
+#define UDMA_CTL_SRC_INC_32         (0x2UL << 26)
+#define UDMA_CTL_SRC_INC_NONE       (0x3UL << 26)
+#define UDMA_CTL_SRC_SIZE_8         (0x0UL << 24)
+#define UDMA_CTL_SRC_SIZE_16        (0x1UL << 24)
+#define UDMA_CTL_SRC_SIZE_32        (0x2UL << 24)
+#define UDMA_CTL_ARB_SIZE(items)    ((uint32_t)(items) << 14)   // 2^items transfers per arbitration
+#define UDMA_CTL_XFER_SIZE(items)   ((uint32_t)((items) - 1) << 4)
+#define UDMA_CTL_MODE_STOP          0x0
+#define UDMA_CTL_MODE_BASIC         0x1
+#define UDMA_CTL_MODE_AUTO          0x2
+#define UDMA_CTL_MODE_PING_PONG     0x3
+#define UDMA_CTL_MODE_MASK          0x7
+
+// Control structure of a channel (primary or alternate)
+typedef struct
+{
+	volatile const void *source_end;        // Address of the last source item
+	volatile void *destination_end;         // Address of the last destination item
+	volatile uint32_t control;              // Channel control word
+	uint32_t unused;
+} uDMA_Control_Structure;
+
+/**
+ * @brief Enables the uDMA controller and sets the base address of the channel control table.
+ *
+ * This function can be called by every driver that uses the uDMA controller.
+ * Only the first call initializes the controller.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void uDMA_Init(void);
+
+/**
+ * @brief Assigns a peripheral to a channel and sets the channel to its default attributes.
+ *
+ * The channel uses the primary control structure, default priority, single and burst
+ * requests, and is disabled.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @param encoding The channel encoding (0 to 4) that selects the peripheral.
+ *
+ * @return None
+ */
+void uDMA_Assign_Channel(uint8_t channel, uint8_t encoding);
+
+/**
+ * @brief Programs the primary or alternate control structure of a channel.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @param alternate 0 selects the primary control structure, 1 selects the alternate one.
+ *
+ * @param source_end The address of the last source item.
+ *
+ * @param destination_end The address of the last destination item.
+ *
+ * @param control The channel control word (UDMA_CTL_* fields).
+ *
+ * @return None
+ */
+void uDMA_Set_Transfer(uint8_t channel, uint8_t alternate, volatile const void *source_end, volatile void *destination_end, uint32_t control);
+
+/**
+ * @brief Returns the control word of a control structure.
+ *
+ * The mode field reads UDMA_CTL_MODE_STOP once the transfer of the structure has completed.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @param alternate 0 selects the primary control structure, 1 selects the alternate one.
+ *
+ * @return uint32_t The channel control word.
+ */
+uint32_t uDMA_Get_Control(uint8_t channel, uint8_t alternate);
+
+/**
+ * @brief Enables a channel.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @return None
+ */
+void uDMA_Enable_Channel(uint8_t channel);
+
+/**
+ * @brief Disables a channel.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @return None
+ */
+void uDMA_Disable_Channel(uint8_t channel);
+
+/**
+ * @brief Indicates whether a channel is enabled.
+ *
+ * The controller disables a channel when its transfer has completed.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @return uint8_t Returns 1 if the channel is enabled. Otherwise, it returns 0.
+ */
+uint8_t uDMA_Is_Enabled(uint8_t channel);
+
+/**
+ * @brief Checks and clears the completion interrupt of a channel.
+ *
+ * @param channel The channel number (0 to 31).
+ *
+ * @return uint8_t Returns 1 if the channel completed a transfer since the last call. Otherwise, it returns 0.
+ */
+uint8_t uDMA_Interrupt_Pending(uint8_t channel);
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file Sim.h
+ *
+ * @brief Header file for the simulated peripherals of the host build.
+ *
+ * The host build links the application modules of the Home Security System
+ * (Security, System_State, Zone, Intrusion_Filter, Sensor, Ranging, Scheduler, Supervisor,
+ * Config, Code_Entry, Keypad, Event_Log, Benchmark, Ring_Buffer) against simulated drivers. The driver
+ * headers of Final_Project are the hardware abstraction layer: the application
+ * modules only use the functions declared there, and this directory provides a
+ * host implementation of each of them:
+ *
+ *  - Timebase, SysTick_Delay, Timer_0A_Interrupt: a virtual clock (Sim_Clock.c)
+ *  - UART1: a simulated US-100 in serial mode that replies with the distances of a
+ *    recorded trace, with the wire and receive timeout delays of the real link (Sim_UART1.c)
+ *  - GPIO, Buzzer, LCD_Framebuffer, EEPROM, EduBase_Button_Interrupt, US100_Echo, Watchdog:
+ *    peripherals whose outputs are recorded instead of driven (Sim_Peripherals.c)
+ *
+ * Virtual time only advances between task dispatches, so every task runs in zero
+ * virtual time. The simulation therefore measures the timing of the event flow
+ * (tick granularity, timers, sensor and link delays), not the execution time of
+ * the code; use the Profile module on the board for that.
+ *
+ * The echo backend of the ranging engine is not simulated.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+// Returned by Sim_Trace_Distance when the sensor does not reply
+#define SIM_TRACE_NO_REPLY      0xFFFF
+
+// Largest number of points in a trace
+#define SIM_TRACE_MAX_POINTS    65536
+
+/**
+ * @brief Sets the virtual time without delivering any event.
+ *
+ * @param time_us The new time in microseconds (must not be in the past).
+ *
+ * @return None
+ */
+void Sim_Clock_Set_us(uint64_t time_us);
+
+/**
+ * @brief Advances the virtual time and delivers the events that are due on the way.
+ *
+ * The 1 ms tick (the Timer 0A task) is delivered at every millisecond boundary,
+ * and the replies of the simulated sensor at their arrival time.
+ *
+ * @param time_us The time to advance to in microseconds.
+ *
+ * @return None
+ */
+void Sim_Clock_Advance_To(uint64_t time_us);
+
+/**
+ * @brief Returns the time of the next event delivered by Sim_Clock_Advance_To.
+ *
+ * @param None
+ *
+ * @return uint64_t The time of the next tick or sensor reply in microseconds.
+ */
+uint64_t Sim_Clock_Next_Event_us(void);
+
+/**
+ * @brief Loads a distance trace.
+ *
+ * Each line of the file holds a time in milliseconds and a distance in millimeters,
+ * separated by a comma or spaces. The distance holds until the next point. A distance
+ * of -1 means that the sensor does not reply. Empty lines and lines that start with
+ * '#' are ignored. The points must be in increasing order of time.
+ *
+ * @param path The path of the trace file.
+ *
+ * @return uint8_t Returns 1 if the trace was loaded. Otherwise, it returns 0.
+ */
+uint8_t Sim_Trace_Load(const char *path);
+
+/**
+ * @brief Returns the distance of the trace at a given time.
+ *
+ * @param time_us The time in microseconds.
+ *
+ * @return uint16_t The distance in millimeters, or SIM_TRACE_NO_REPLY.
+ */
+uint16_t Sim_Trace_Distance(uint64_t time_us);
+
+/**
+ * @brief Returns the time of the last point of the trace.
+ *
+ * @param None
+ *
+ * @return uint64_t The time of the last point in microseconds, or 0 if no trace is loaded.
+ */
+uint64_t Sim_Trace_Duration_us(void);
+
+/**
+ * @brief Selects the function that gives the distance seen by the simulated US-100.
+ *
+ * By default, the distance comes from the loaded trace.
+ *
+ * @param source A pointer to the function.
+ *
+ * @return None
+ */
+void Sim_UART1_Set_Distance_Source(uint16_t (*source)(uint64_t time_us));
+
+/**
+ * @brief Returns the arrival time of the pending reply of the simulated US-100.
+ *
+ * @param None
+ *
+ * @return uint64_t The time at which the receive task runs, or UINT64_MAX if no reply is pending.
+ */
+uint64_t Sim_UART1_Next_Event_us(void);
+
+/**
+ * @brief Delivers the pending reply of the simulated US-100 and runs the receive task.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Sim_UART1_Deliver(void);
+
+/**
+ * @brief Returns the number of trigger commands received by the simulated US-100.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of triggers.
+ */
+uint32_t Sim_UART1_Get_Trigger_Count(void);
+
+/**
+ * @brief Sets whether the LCD and actuator outputs are printed.
+ *
+ * @param verbose 1 to print every change of the LCD, LEDs, and buzzer.
+ *
+ * @return None
+ */
+void Sim_Peripherals_Set_Verbose(uint8_t verbose);
+
+/**
+ * @brief Returns the number of times the buzzer or the EduBase LEDs were turned on.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of actuator outputs.
+ */
+uint32_t Sim_Peripherals_Get_Actuator_Count(void);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file Sim_Clock.c
+ *
+ * @brief Virtual clock of the simulation build.
+ *
+ * This file implements the Timebase, SysTick_Delay, and Timer_0A_Interrupt driver
+ * interfaces on a virtual microsecond clock.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include "Sim.h"
+#include "Timebase.h"
+#include "SysTick_Delay.h"
+#include "Timer_0A_Interrupt.h"
+
+// Executed at every millisecond boundary, as the Timer 0A interrupt on the board
+void (*Timer_0A_Task)(void) = 0;
+
+static uint64_t sim_time_us = 0;
+
+void Sim_Clock_Set_us(uint64_t time_us)
+{
+    if (time_us > sim_time_us)
+    {
+        sim_time_us = time_us;
+    }
+}
+
+uint64_t Sim_Clock_Next_Event_us(void)
+{
+    uint64_t next_tick_us = ((sim_time_us / 1000) + 1) * 1000;
+    uint64_t next_reply_us = Sim_UART1_Next_Event_us();
+
+    return (next_reply_us < next_tick_us) ? next_reply_us : next_tick_us;
+}
+
+void Sim_Clock_Advance_To(uint64_t time_us)
+{
+    while (1)
+    {
+        uint64_t next_event_us = Sim_Clock_Next_Event_us();
+
+        if (next_event_us > time_us)
+        {
+            break;
+        }
+
+        sim_time_us = next_event_us;
+
+        if (Sim_UART1_Next_Event_us() == sim_time_us)
+        {
+            Sim_UART1_Deliver();
+        }
+
+        if (((sim_time_us % 1000) == 0) && (Timer_0A_Task != 0))
+        {
+            (*Timer_0A_Task)();
+        }
+    }
+
+    Sim_Clock_Set_us(time_us);
+}
+
+void Timebase_Init(void)
+{
+    sim_time_us = 0;
+}
+
+uint64_t Timebase_Get_Time_us(void)
+{
+    return sim_time_us;
+}
+
+uint32_t Timebase_Get_Time_ms(void)
+{
+    return (uint32_t)(sim_time_us / 1000);
+}
+
+void Timer_Start(Timer_Handle *timer, uint32_t timeout_us)
+{
+    timer->deadline_us = sim_time_us + timeout_us;
+}
+
+uint8_t Timer_Expired(const Timer_Handle *timer)
+{
+    return (sim_time_us >= timer->deadline_us) ? 1 : 0;
+}
+
+uint32_t Timer_Remaining_us(const Timer_Handle *timer)
+{
+    return (sim_time_us >= timer->deadline_us) ? 0 : (uint32_t)(timer->deadline_us - sim_time_us);
+}
+
+void SysTick_Handler(void)
+{
+}
+
+void SysTick_Delay_Init(void)
+{
+}
+
+// A busy wait on the board: the events that are due during the wait are still delivered
+void SysTick_Delay1us(uint32_t delay_in_us)
+{
+    Sim_Clock_Advance_To(sim_time_us + delay_in_us);
+}
+
+void SysTick_Delay1ms(uint32_t delay_in_ms)
+{
+    Sim_Clock_Advance_To(sim_time_us + ((uint64_t)delay_in_ms * 1000));
+}
+
+uint32_t SysTick_GetCurrentValue(void)
+{
+    // The SysTick timer counts down from its reload value at 4 MHz
+    return TIMEBASE_SYSTICK_RELOAD - (uint32_t)((sim_time_us * TIMEBASE_TICKS_PER_US) & TIMEBASE_SYSTICK_RELOAD);
+}
+
+void Timer_0A_Interrupt_Init(void(*task)(void))
+{
+    Timer_0A_Task = task;
+}
+
+void TIMER0A_Handler(void)
+{
+    if (Timer_0A_Task != 0)
+    {
+        (*Timer_0A_Task)();
+    }
+}
@@ -0,0 +1,353 @@
+/**
+ * @file Sim_Main.c
+ *
+ * @brief Main source code for the host simulation of the Home Security System.
+ *
+ * The application modules are initialized as in main.c, on top of the simulated
+ * drivers, and the scheduler runs on the virtual clock instead of waiting for
+ * interrupts. Two modes are supported:
+ *
+ *  - Trace replay: the simulated US-100 replies with the distances of a recorded trace.
+ *    The system is armed at --arm-at, and every state transition is printed.
+ *  - Benchmark: the trials of the Benchmark module run on the script backend of the
+ *    ranging engine, and the latency of each interval is printed.
+ *
+ * Both modes print the virtual time, the host time, and the throughput of the run.
+ *
+ * Usage: security_sim [options] [trace]
+ *   --arm-at <ms>               Time at which the system is armed (default 0)
+ *   --duration <ms>             Virtual time to simulate (default: end of the trace + 15 s)
+ *   --rearm                     Arm the system again every time it is disarmed
+ *   --expect-intrusions <n>     Exit with status 1 unless exactly n intrusions are detected
+ *   --benchmark <trials>        Run the latency benchmark instead of a trace
+ *   --verbose                   Print the LCD, LED, and buzzer outputs
+ *   --quiet                     Do not print the state transitions
+ *
+ * @author Adrian Solorzano
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Sim.h"
+#include "Timebase.h"
+#include "Timer_0A_Interrupt.h"
+#include "GPIO.h"
+#include "Buzzer.h"
+#include "LED_Pattern.h"
+#include "LCD_Framebuffer.h"
+#include "UART1.h"
+#include "Scheduler.h"
+#include "Security.h"
+#include "System_State.h"
+#include "Keypad.h"
+#include "Code_Entry.h"
+#include "Event_Log.h"
+#include "Benchmark.h"
+#include "Supervisor.h"
+#include "Config.h"
+
+// Virtual time simulated after the end of the trace, so that the last events can complete
+#define SIM_TRACE_TAIL_MS           15000
+
+// Longest virtual time of a benchmark run per trial
+#define SIM_BENCHMARK_TRIAL_MS      (Config_Get(CONFIG_PARAM_EXIT_DELAY_MS) + BENCHMARK_SETTLE_MS + (3 * BENCHMARK_STATE_TIMEOUT_MS))
+
+// Reset cause reported to the event log (power-on reset)
+#define SIM_RESET_CAUSE             0x02
+
+static const char *const interval_names[BENCHMARK_INTERVAL_COUNT] =
+{
+    [BENCHMARK_INTERVAL_SENSOR] = "sensor",
+    [BENCHMARK_INTERVAL_FILTER] = "filter",
+    [BENCHMARK_INTERVAL_STATE]  = "state",
+    [BENCHMARK_INTERVAL_OUTPUT] = "output",
+    [BENCHMARK_INTERVAL_TOTAL]  = "total"
+};
+
+static const char *const boot_stage_names[BENCHMARK_BOOT_STAGE_COUNT] =
+{
+    [BENCHMARK_BOOT_PROTECTED]  = "protected",
+    [BENCHMARK_BOOT_RUNNING]    = "running",
+    [BENCHMARK_BOOT_LCD_READY]  = "lcd",
+    [BENCHMARK_BOOT_ARMED]      = "armed"
+};
+
+static uint8_t quiet_output = 0;
+static uint8_t rearm_enabled = 0;
+static uint32_t intrusion_count = 0;
+static uint32_t dispatch_count = 0;
+static uint8_t benchmark_done = 0;
+
+// Executed every 1 ms by the virtual clock, as System_Tick in main.c
+static void Sim_System_Tick(void)
+{
+    Scheduler_Tick();
+    Buzzer_Sequencer_Tick();
+    LED_Pattern_Tick();
+    Keypad_Tick();
+    Supervisor_Tick();
+}
+
+// Receives the end of a benchmark run (no button is pressed in the simulation)
+static void Sim_Menu_Task(const Scheduler_Event *event)
+{
+    if (event->signal == SIGNAL_BENCH_DONE)
+    {
+        benchmark_done = 1;
+    }
+}
+
+static void Sim_State_Changed(uint8_t previous_state, uint8_t next_state)
+{
+    uint64_t time_us = Timebase_Get_Time_us();
+
+    if ((previous_state == SYSTEM_STATE_ARMED) && (next_state == SYSTEM_STATE_ENTRY_DELAY))
+    {
+        intrusion_count++;
+    }
+
+    if (!quiet_output)
+    {
+        printf("[%6u.%06u s] %s -> %s\n", (unsigned)(time_us / 1000000), (unsigned)(time_us % 1000000),
+            System_State_Get_Name(previous_state), System_State_Get_Name(next_state));
+    }
+
+    if (rearm_enabled && (next_state == SYSTEM_STATE_DISARMED) && !Benchmark_Is_Running())
+    {
+        Scheduler_Post(TASK_SECURITY, SIGNAL_ARM_REQUEST, 0);
+    }
+}
+
+// Dispatches every queued event, then lets the virtual time run to the next event
+static void Sim_Run_Until(uint64_t end_us)
+{
+    while (1)
+    {
+        uint64_t next_event_us;
+
+        while (Scheduler_Run_Once())
+        {
+            dispatch_count++;
+        }
+
+        if (benchmark_done)
+        {
+            break;
+        }
+
+        next_event_us = Sim_Clock_Next_Event_us();
+
+        if (next_event_us > end_us)
+        {
+            Sim_Clock_Set_us(end_us);
+            break;
+        }
+
+        Sim_Clock_Advance_To(next_event_us);
+    }
+}
+
+static double Sim_Host_Time_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+static void Sim_Init(void)
+{
+    // Initializes the simulated peripherals in the boot order of main.c
+    Timebase_Init();
+
+    // Stage 1: the alarm path and the sensor path
+    EduBase_LEDs_Init();
+    LED_Pattern_Init();
+    Buzzer_Init();
+    UART1_Init();
+    Scheduler_Init();
+    Event_Log_Init(SIM_RESET_CAUSE);
+    Supervisor_Init(SIM_RESET_CAUSE);
+    Config_Init();
+    Security_Init();
+    Timer_0A_Interrupt_Init(&Sim_System_Tick);
+    Benchmark_Mark_Boot(BENCHMARK_BOOT_PROTECTED);
+
+    // Stage 2: the user interface
+    LCD_Framebuffer_Init();
+    Scheduler_Add_Task(TASK_MENU, Sim_Menu_Task);
+    Keypad_Init(TASK_MENU);
+    Code_Entry_Init();
+    Benchmark_Init();
+    System_State_Add_Observer(&Sim_State_Changed);
+
+    Display_Main_Menu();
+    Benchmark_Mark_Boot(BENCHMARK_BOOT_RUNNING);
+}
+
+static void Sim_Print_Benchmark(void)
+{
+    Benchmark_Stats stats;
+
+    printf("\n%-8s %6s %10s %10s %10s   histogram (<64 us, x4 per bin)\n", "interval", "trials", "min ms", "mean ms", "max ms");
+
+    for (uint8_t interval = 0; interval < BENCHMARK_INTERVAL_COUNT; interval++)
+    {
+        Benchmark_Get_Stats(interval, &stats);
+
+        printf("%-8s %6u %10.3f %10.3f %10.3f  ", interval_names[interval], (unsigned)stats.count,
+            stats.min_us / 1000.0, stats.mean_us / 1000.0, stats.max_us / 1000.0);
+
+        for (uint8_t bin = 0; bin < BENCHMARK_HISTOGRAM_BINS; bin++)
+        {
+            printf(" %4u", (unsigned)stats.histogram[bin]);
+        }
+
+        printf("\n");
+    }
+
+    printf("failed trials: %u\n", (unsigned)Benchmark_Get_Failure_Count());
+
+    printf("\nboot stage times (ms since reset):");
+
+    for (uint8_t stage = 0; stage < BENCHMARK_BOOT_STAGE_COUNT; stage++)
+    {
+        printf(" %s %.3f", boot_stage_names[stage], Benchmark_Get_Boot_Time_us(stage) / 1000.0);
+    }
+
+    printf("\n");
+}
+
+static void Sim_Usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--arm-at ms] [--duration ms] [--rearm] [--expect-intrusions n]\n"
+        "       [--benchmark trials] [--verbose] [--quiet] [trace]\n", program);
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL;
+    uint64_t arm_at_us = 0;
+    uint64_t duration_us = 0;
+    long expected_intrusions = -1;
+    long benchmark_trials = 0;
+    double start_s;
+    double host_s;
+    uint64_t virtual_us;
+    int status = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--arm-at") == 0) && ((i + 1) < argc))
+        {
+            arm_at_us = strtoull(argv[++i], NULL, 10) * 1000;
+        }
+        else if ((strcmp(argv[i], "--duration") == 0) && ((i + 1) < argc))
+        {
+            duration_us = strtoull(argv[++i], NULL, 10) * 1000;
+        }
+        else if (strcmp(argv[i], "--rearm") == 0)
+        {
+            rearm_enabled = 1;
+        }
+        else if ((strcmp(argv[i], "--expect-intrusions") == 0) && ((i + 1) < argc))
+        {
+            expected_intrusions = strtol(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "--benchmark") == 0) && ((i + 1) < argc))
+        {
+            benchmark_trials = strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--verbose") == 0)
+        {
+            Sim_Peripherals_Set_Verbose(1);
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            quiet_output = 1;
+        }
+        else if ((argv[i][0] != '-') && (trace_path == NULL))
+        {
+            trace_path = argv[i];
+        }
+        else
+        {
+            Sim_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if ((trace_path == NULL) && (benchmark_trials <= 0))
+    {
+        Sim_Usage(argv[0]);
+        return 2;
+    }
+
+    if ((trace_path != NULL) && !Sim_Trace_Load(trace_path))
+    {
+        fprintf(stderr, "%s: cannot load the trace %s\n", argv[0], trace_path);
+        return 2;
+    }
+
+    if ((benchmark_trials < 0) || (benchmark_trials > 255))
+    {
+        fprintf(stderr, "%s: the number of trials must be between 1 and 255\n", argv[0]);
+        return 2;
+    }
+
+    Sim_Init();
+    start_s = Sim_Host_Time_s();
+
+    if (benchmark_trials > 0)
+    {
+        // Let the start-up events run before the first trial
+        Sim_Run_Until(Timebase_Get_Time_us() + 1000);
+        Benchmark_Start((uint8_t)benchmark_trials, TASK_MENU);
+        Sim_Run_Until(Timebase_Get_Time_us() + ((uint64_t)benchmark_trials * SIM_BENCHMARK_TRIAL_MS * 1000));
+    }
+    else
+    {
+        if (duration_us == 0)
+        {
+            duration_us = Sim_Trace_Duration_us() + ((uint64_t)SIM_TRACE_TAIL_MS * 1000);
+        }
+
+        Sim_Run_Until((arm_at_us < duration_us) ? arm_at_us : duration_us);
+        Scheduler_Post(TASK_SECURITY, SIGNAL_ARM_REQUEST, 0);
+        Sim_Run_Until(duration_us);
+    }
+
+    host_s = Sim_Host_Time_s() - start_s;
+    virtual_us = Timebase_Get_Time_us();
+
+    if (benchmark_trials > 0)
+    {
+        Sim_Print_Benchmark();
+
+        if (!benchmark_done)
+        {
+            printf("the benchmark did not finish\n");
+            status = 1;
+        }
+    }
+
+    printf("\nvirtual time: %.3f s, host time: %.3f s, speedup: %.0fx\n", virtual_us / 1e6, host_s,
+        (host_s > 0) ? ((virtual_us / 1e6) / host_s) : 0.0);
+    printf("samples: %u (%u timeouts, %.0f per host second), events: %u (%.0f per host second)\n",
+        (unsigned)Ranging_Get_Sample_Count(), (unsigned)Ranging_Get_Timeout_Count(),
+        (host_s > 0) ? (Ranging_Get_Sample_Count() / host_s) : 0.0,
+        (unsigned)dispatch_count, (host_s > 0) ? (dispatch_count / host_s) : 0.0);
+    printf("intrusions: %u, actuator outputs: %u, log records: %u\n", (unsigned)intrusion_count,
+        (unsigned)Sim_Peripherals_Get_Actuator_Count(), (unsigned)Event_Log_Get_Count());
+
+    if ((expected_intrusions >= 0) && (intrusion_count != (uint32_t)expected_intrusions))
+    {
+        printf("expected %ld intrusions\n", expected_intrusions);
+        status = 1;
+    }
+
+    return status;
+}
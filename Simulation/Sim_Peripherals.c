@@ -0,0 +1,432 @@
+/**
+ * @file Sim_Peripherals.c
+ *
+ * @brief Simulated output peripherals and storage of the simulation build.
+ *
+ * This file implements the GPIO (including the RGB LED PWM), Buzzer, LCD_Framebuffer, EEPROM,
+ * EduBase_Button_Interrupt, US100_Echo, and Watchdog driver interfaces for the simulation build.
+ * The outputs are recorded, and printed with their virtual time in verbose mode.
+ * The EEPROM is kept in memory and starts erased. No button is ever pressed. The watchdog
+ * never resets the simulation, since virtual time only advances between task dispatches.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include <stdio.h>
+#include "Sim.h"
+#include "Timebase.h"
+#include "GPIO.h"
+#include "Buzzer.h"
+#include "LCD_Framebuffer.h"
+#include "EEPROM.h"
+#include "EduBase_Button_Interrupt.h"
+#include "US100_Echo.h"
+#include "Watchdog.h"
+#include "Benchmark.h"
+
+// Constant definitions for the user LED (RGB) colors
+const uint8_t RGB_LED_OFF       = 0x00;
+const uint8_t RGB_LED_RED       = 0x02;
+const uint8_t RGB_LED_BLUE      = 0x04;
+const uint8_t RGB_LED_GREEN     = 0x08;
+
+// Constant definitions for the EduBase board LEDs
+const uint8_t EDUBASE_LED_ALL_OFF = 0x00;
+const uint8_t EDUBASE_LED_ALL_ON  = 0x0F;
+
+// Constants for the buzzer state
+const uint8_t BUZZER_OFF        = 0x00;
+const uint8_t BUZZER_ON         = 0x10;
+
+void (*EduBase_Button_Task)(uint8_t edubase_button_status) = 0;
+void (*US100_Echo_Task)(uint8_t channel, uint32_t echo_ticks) = 0;
+
+static uint8_t verbose_output = 0;
+static uint32_t actuator_count = 0;
+
+static uint8_t rgb_led_value = 0;
+static uint8_t edubase_led_value = 0;
+static uint8_t buzzer_playing = 0;
+
+static char framebuffer[LCD_FRAMEBUFFER_ROWS][LCD_FRAMEBUFFER_COLUMNS + 1];
+
+static uint32_t eeprom_words[EEPROM_WORD_COUNT];
+
+static void Sim_Print_Time(void)
+{
+    uint64_t time_us = Timebase_Get_Time_us();
+
+    printf("[%6u.%06u s] ", (unsigned)(time_us / 1000000), (unsigned)(time_us % 1000000));
+}
+
+static void Sim_LCD_Changed(void)
+{
+    if (verbose_output)
+    {
+        Sim_Print_Time();
+        printf("LCD |%s|%s|\n", framebuffer[0], framebuffer[1]);
+    }
+}
+
+void Sim_Peripherals_Set_Verbose(uint8_t verbose)
+{
+    verbose_output = verbose;
+}
+
+uint32_t Sim_Peripherals_Get_Actuator_Count(void)
+{
+    return actuator_count;
+}
+
+void RGB_LED_Init(void)
+{
+    rgb_led_value = RGB_LED_OFF;
+}
+
+void RGB_LED_Output(uint8_t led_value)
+{
+    rgb_led_value = led_value;
+}
+
+uint8_t RGB_LED_Status(void)
+{
+    return rgb_led_value;
+}
+
+void RGB_LED_PWM_Init(void)
+{
+    rgb_led_value = RGB_LED_OFF;
+}
+
+// Only color changes are printed, since a ramp changes the brightness every 1 ms
+void RGB_LED_PWM_Output(uint8_t led_value, uint8_t brightness)
+{
+    uint8_t color = (brightness > 0) ? (led_value & 0x0E) : RGB_LED_OFF;
+
+    if (color == rgb_led_value)
+    {
+        return;
+    }
+
+    rgb_led_value = color;
+
+    if (verbose_output)
+    {
+        Sim_Print_Time();
+        printf("RGB LED 0x%X\n", color);
+    }
+}
+
+void EduBase_LEDs_Init(void)
+{
+    edubase_led_value = EDUBASE_LED_ALL_OFF;
+}
+
+void EduBase_LEDs_Output(uint8_t led_value)
+{
+    if (led_value == edubase_led_value)
+    {
+        return;
+    }
+
+    if ((edubase_led_value == EDUBASE_LED_ALL_OFF) && (led_value != EDUBASE_LED_ALL_OFF))
+    {
+        actuator_count++;
+    }
+
+    edubase_led_value = led_value;
+
+    if (verbose_output)
+    {
+        Sim_Print_Time();
+        printf("LEDs 0x%X\n", led_value);
+    }
+}
+
+void EduBase_Button_Init(void)
+{
+}
+
+uint8_t Get_EduBase_Button_Status(void)
+{
+    return 0;
+}
+
+void Buzzer_Init(void)
+{
+    buzzer_playing = 0;
+}
+
+void Buzzer_Output(uint8_t buzzer_value)
+{
+}
+
+void Buzzer_Set_Note(uint8_t note)
+{
+}
+
+void Buzzer_Play_Pattern(const Buzzer_Step *steps, uint8_t step_count, uint8_t repeat_count)
+{
+    actuator_count++;
+    buzzer_playing = 1;
+
+    if (verbose_output)
+    {
+        Sim_Print_Time();
+        printf("Buzzer pattern of %u steps, %u repeats\n", step_count, repeat_count);
+    }
+}
+
+void Buzzer_Stop(void)
+{
+    buzzer_playing = 0;
+}
+
+uint8_t Buzzer_Is_Playing(void)
+{
+    return buzzer_playing;
+}
+
+void Buzzer_Sequencer_Tick(void)
+{
+}
+
+void LCD_Framebuffer_Init(void)
+{
+    // The simulated LCD is ready immediately
+    LCD_Framebuffer_Clear();
+    Benchmark_Mark_Boot(BENCHMARK_BOOT_LCD_READY);
+}
+
+void LCD_Framebuffer_Clear(void)
+{
+    for (uint8_t row = 0; row < LCD_FRAMEBUFFER_ROWS; row++)
+    {
+        for (uint8_t col = 0; col < LCD_FRAMEBUFFER_COLUMNS; col++)
+        {
+            framebuffer[row][col] = ' ';
+        }
+
+        framebuffer[row][LCD_FRAMEBUFFER_COLUMNS] = '\0';
+    }
+}
+
+void LCD_Framebuffer_Write_Char(uint8_t col, uint8_t row, char character)
+{
+    if ((col < LCD_FRAMEBUFFER_COLUMNS) && (row < LCD_FRAMEBUFFER_ROWS))
+    {
+        framebuffer[row][col] = character;
+    }
+}
+
+uint8_t LCD_Framebuffer_Write_String(uint8_t col, uint8_t row, const char *string)
+{
+    if (row >= LCD_FRAMEBUFFER_ROWS)
+    {
+        return col;
+    }
+
+    while ((col < LCD_FRAMEBUFFER_COLUMNS) && (*string != '\0'))
+    {
+        framebuffer[row][col] = *string;
+        string++;
+        col++;
+    }
+
+    return col;
+}
+
+void LCD_Framebuffer_Write_Line(uint8_t row, const char *string)
+{
+    uint8_t col = LCD_Framebuffer_Write_String(0, row, string);
+
+    if (row >= LCD_FRAMEBUFFER_ROWS)
+    {
+        return;
+    }
+
+    for (; col < LCD_FRAMEBUFFER_COLUMNS; col++)
+    {
+        framebuffer[row][col] = ' ';
+    }
+
+    // The status messages write the first line and then the second one
+    if (row == (LCD_FRAMEBUFFER_ROWS - 1))
+    {
+        Sim_LCD_Changed();
+    }
+}
+
+uint8_t LCD_Framebuffer_Write_Integer(uint8_t col, uint8_t row, int32_t value)
+{
+    return LCD_Framebuffer_Write_Padded(col, row, value, 0, ' ');
+}
+
+uint8_t LCD_Framebuffer_Write_Padded(uint8_t col, uint8_t row, int32_t value, uint8_t width, char pad)
+{
+    char text[LCD_FORMAT_BUFFER_SIZE];
+
+    LCD_Format_Integer(text, value, width, pad);
+
+    return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+uint8_t LCD_Framebuffer_Write_Distance(uint8_t col, uint8_t row, uint16_t distance_mm, uint8_t unit)
+{
+    char text[LCD_FORMAT_BUFFER_SIZE];
+
+    LCD_Format_Distance(text, distance_mm, unit);
+
+    return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+uint8_t LCD_Framebuffer_Write_Time(uint8_t col, uint8_t row, uint32_t seconds)
+{
+    char text[LCD_FORMAT_BUFFER_SIZE];
+
+    LCD_Format_Time(text, seconds);
+
+    return LCD_Framebuffer_Write_String(col, row, text);
+}
+
+void LCD_Framebuffer_Invalidate(void)
+{
+}
+
+uint8_t LCD_Framebuffer_Is_Ready(void)
+{
+    return 1;
+}
+
+uint8_t LCD_Framebuffer_Is_Idle(void)
+{
+    return 1;
+}
+
+void TIMER1A_Handler(void)
+{
+}
+
+uint8_t EEPROM_Init(void)
+{
+    static uint8_t erased = 0;
+
+    // The contents are kept across a simulated reset
+    if (!erased)
+    {
+        for (uint16_t i = 0; i < EEPROM_WORD_COUNT; i++)
+        {
+            eeprom_words[i] = EEPROM_ERASED_WORD;
+        }
+
+        erased = 1;
+    }
+
+    return 1;
+}
+
+uint8_t EEPROM_Is_Ready(void)
+{
+    return 1;
+}
+
+uint8_t EEPROM_Is_Busy(void)
+{
+    return 0;
+}
+
+uint32_t EEPROM_Read_Word(uint16_t address)
+{
+    return (address < EEPROM_WORD_COUNT) ? eeprom_words[address] : EEPROM_ERASED_WORD;
+}
+
+uint8_t EEPROM_Write_Start(uint16_t address, uint32_t data)
+{
+    if (address >= EEPROM_WORD_COUNT)
+    {
+        return 0;
+    }
+
+    eeprom_words[address] = data;
+
+    return 1;
+}
+
+uint8_t EEPROM_Get_Write_Result(uint16_t address, uint32_t data)
+{
+    return (EEPROM_Read_Word(address) == data) ? EEPROM_WRITE_DONE : EEPROM_WRITE_FAILED;
+}
+
+uint8_t EEPROM_Write_Word(uint16_t address, uint32_t data)
+{
+    return EEPROM_Write_Start(address, data);
+}
+
+void EduBase_Button_Interrupt_Init(void(*task)(uint8_t))
+{
+    EduBase_Button_Task = task;
+}
+
+void EduBase_Button_Interrupt_Enable(uint8_t button_mask)
+{
+}
+
+void EduBase_Button_Interrupt_Disable(uint8_t button_mask)
+{
+}
+
+void GPIOD_Handler(void)
+{
+}
+
+void US100_Echo_Init(void(*task)(uint8_t, uint32_t), uint8_t channel_mask)
+{
+    US100_Echo_Task = task;
+}
+
+void US100_Echo_Trigger(uint8_t channel)
+{
+}
+
+void US100_Echo_Disable(void)
+{
+}
+
+uint8_t US100_Echo_Done(uint8_t channel)
+{
+    return 1;
+}
+
+uint32_t US100_Echo_Ticks_To_Distance(uint32_t echo_ticks)
+{
+    return (uint32_t)(((uint64_t)echo_ticks * 343) / 10000);
+}
+
+void WTIMER0B_Handler(void)
+{
+}
+
+void WTIMER5A_Handler(void)
+{
+}
+
+void WTIMER5B_Handler(void)
+{
+}
+
+uint8_t Watchdog_Read_Reset_Cause(void)
+{
+    return WATCHDOG_RESET_POWER_ON;
+}
+
+void Watchdog_Init(uint32_t timeout_ms, void (*timeout_task)(void))
+{
+}
+
+void Watchdog_Feed(void)
+{
+}
+
+void WDT0_Handler(void)
+{
+}
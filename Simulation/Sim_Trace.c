@@ -0,0 +1,125 @@
+/**
+ * @file Sim_Trace.c
+ *
+ * @brief Distance traces replayed by the simulated US-100.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Sim.h"
+
+/**
+ * @brief One point of a trace.
+ */
+typedef struct
+{
+    uint64_t time_us;
+    uint16_t distance_mm;
+} Sim_Trace_Point;
+
+static Sim_Trace_Point trace_points[SIM_TRACE_MAX_POINTS];
+static uint32_t trace_length = 0;
+
+uint8_t Sim_Trace_Load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[128];
+
+    if (file == NULL)
+    {
+        return 0;
+    }
+
+    trace_length = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *cursor = line;
+        char *end;
+        double time_ms;
+        long distance_mm;
+
+        while ((*cursor == ' ') || (*cursor == '\t'))
+        {
+            cursor++;
+        }
+
+        if ((*cursor == '#') || (*cursor == '\r') || (*cursor == '\n') || (*cursor == '\0'))
+        {
+            continue;
+        }
+
+        time_ms = strtod(cursor, &end);
+
+        if ((end == cursor) || (time_ms < 0))
+        {
+            fclose(file);
+            return 0;
+        }
+
+        cursor = end;
+        while ((*cursor == ',') || (*cursor == ' ') || (*cursor == '\t'))
+        {
+            cursor++;
+        }
+
+        distance_mm = strtol(cursor, &end, 10);
+
+        if ((end == cursor) || (distance_mm < -1) || (distance_mm >= SIM_TRACE_NO_REPLY) || (trace_length >= SIM_TRACE_MAX_POINTS))
+        {
+            fclose(file);
+            return 0;
+        }
+
+        trace_points[trace_length].time_us = (uint64_t)(time_ms * 1000.0);
+        trace_points[trace_length].distance_mm = (distance_mm < 0) ? SIM_TRACE_NO_REPLY : (uint16_t)distance_mm;
+
+        if ((trace_length > 0) && (trace_points[trace_length].time_us < trace_points[trace_length - 1].time_us))
+        {
+            fclose(file);
+            return 0;
+        }
+
+        trace_length++;
+    }
+
+    fclose(file);
+
+    return (trace_length > 0) ? 1 : 0;
+}
+
+uint16_t Sim_Trace_Distance(uint64_t time_us)
+{
+    uint32_t low = 0;
+    uint32_t high = trace_length;
+
+    // Without a trace, the sensor sees nothing in range
+    if ((trace_length == 0) || (time_us < trace_points[0].time_us))
+    {
+        return 0;
+    }
+
+    // Find the last point at or before the given time
+    while ((high - low) > 1)
+    {
+        uint32_t middle = low + ((high - low) / 2);
+
+        if (trace_points[middle].time_us <= time_us)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return trace_points[low].distance_mm;
+}
+
+uint64_t Sim_Trace_Duration_us(void)
+{
+    return (trace_length > 0) ? trace_points[trace_length - 1].time_us : 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file Sim_UART1.c
+ *
+ * @brief Simulated UART1 link to the US-100 Ultrasonic Distance Sensor.
+ *
+ * This file implements the UART1 driver interface for the simulation build. The other
+ * end of the link is a simulated US-100 in serial mode: every "read distance" command
+ * (0x55) is answered with the two bytes of the distance seen at the time of the command,
+ * at the time a real sensor would deliver them:
+ *
+ *     command (1 byte) + round trip of the burst + reply (2 bytes) + receive timeout
+ *
+ * at 9600 baud (about 1.04 ms per byte). The receive task then runs, as it does from
+ * the receive timeout interrupt of the real driver. The simulated sensor only listens
+ * at 9600 baud, which UART1_Auto_Baud selects without spending virtual time.
+ *
+ * @author Adrian Solorzano
+ */
+
+#include <stddef.h>
+#include "Sim.h"
+#include "UART1.h"
+
+// Baud rate of the simulated US-100
+#define SIM_US100_BAUD_RATE         9600
+
+// "Read distance" command of the US-100
+#define SIM_US100_READ_DISTANCE     0x55
+
+// Round trip of the burst: 2 * distance / (343 m/s), about 5.83 us per millimeter
+#define SIM_US100_ECHO_TIME_US(distance_mm)  (((uint64_t)(distance_mm) * 2000) / 343)
+
+// Declare pointer to the user-defined receive task
+void (*UART1_Receive_Task)(void) = 0;
+
+static uint8_t rx_storage[UART1_RX_BUFFER_SIZE];
+static Ring_Buffer rx_buffer;
+static uint32_t rx_error_count = 0;
+static uint32_t baud_rate = UART1_DEFAULT_BAUD_RATE;
+
+// Reply of the simulated sensor that has not been delivered yet
+static uint64_t reply_time_us = UINT64_MAX;
+static uint16_t reply_distance_mm = 0;
+static uint32_t trigger_count = 0;
+
+static uint16_t (*distance_source)(uint64_t time_us) = &Sim_Trace_Distance;
+
+void Sim_UART1_Set_Distance_Source(uint16_t (*source)(uint64_t time_us))
+{
+    distance_source = (source != 0) ? source : &Sim_Trace_Distance;
+}
+
+uint64_t Sim_UART1_Next_Event_us(void)
+{
+    return reply_time_us;
+}
+
+void Sim_UART1_Deliver(void)
+{
+    if (reply_time_us == UINT64_MAX)
+    {
+        return;
+    }
+
+    reply_time_us = UINT64_MAX;
+
+    if (!Ring_Buffer_Put(&rx_buffer, (uint8_t)(reply_distance_mm >> 8))
+        || !Ring_Buffer_Put(&rx_buffer, (uint8_t)reply_distance_mm))
+    {
+        rx_error_count++;
+    }
+
+    if (UART1_Receive_Task != 0)
+    {
+        (*UART1_Receive_Task)();
+    }
+}
+
+uint32_t Sim_UART1_Get_Trigger_Count(void)
+{
+    return trigger_count;
+}
+
+void UART1_Init(void)
+{
+    Ring_Buffer_Init(&rx_buffer, rx_storage, UART1_RX_BUFFER_SIZE);
+    rx_error_count = 0;
+    reply_time_us = UINT64_MAX;
+}
+
+uint8_t UART1_Set_Baud_Rate(uint32_t rate)
+{
+    if ((rate < UART1_MIN_BAUD_RATE) || (rate > UART1_MAX_BAUD_RATE))
+    {
+        return 0;
+    }
+
+    baud_rate = rate;
+    return 1;
+}
+
+uint32_t UART1_Get_Baud_Rate(void)
+{
+    return baud_rate;
+}
+
+uint32_t UART1_Get_Receive_Timeout_us(void)
+{
+    return ((32 * 1000000) + baud_rate - 1) / baud_rate;
+}
+
+uint32_t UART1_Auto_Baud(const uint8_t *probe, uint16_t probe_length, uint16_t reply_length, uint32_t response_delay_us)
+{
+    if ((reply_length == 0) || (reply_length > UART1_AUTO_BAUD_MAX_REPLY))
+    {
+        return 0;
+    }
+
+    baud_rate = SIM_US100_BAUD_RATE;
+    return baud_rate;
+}
+
+void UART1_Set_Receive_Task(void(*task)(void))
+{
+    UART1_Receive_Task = task;
+}
+
+uint8_t UART1_Read_Byte(uint8_t *data)
+{
+    return Ring_Buffer_Get(&rx_buffer, data);
+}
+
+uint8_t UART1_Write_Byte(uint8_t data)
+{
+    uint16_t distance_mm;
+
+    if (data != SIM_US100_READ_DISTANCE)
+    {
+        return 1;
+    }
+
+    // The sensor does not recognize a command sent at another baud rate
+    if (baud_rate != SIM_US100_BAUD_RATE)
+    {
+        return 1;
+    }
+
+    trigger_count++;
+    distance_mm = (*distance_source)(Timebase_Get_Time_us());
+
+    // A sensor that does not reply, and a command sent while a reply is on the wire, are lost
+    if ((distance_mm == SIM_TRACE_NO_REPLY) || (reply_time_us != UINT64_MAX))
+    {
+        return 1;
+    }
+
+    // Time of one byte (10 bits), rounded up
+    uint32_t byte_time_us = (10000000 + baud_rate - 1) / baud_rate;
+
+    reply_distance_mm = distance_mm;
+    reply_time_us = Timebase_Get_Time_us() + byte_time_us + SIM_US100_ECHO_TIME_US(distance_mm)
+        + (2 * byte_time_us) + UART1_Get_Receive_Timeout_us();
+
+    return 1;
+}
+
+uint16_t UART1_Read(uint8_t *buffer, uint16_t length)
+{
+    uint16_t count = 0;
+
+    while ((count < length) && Ring_Buffer_Get(&rx_buffer, &buffer[count]))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+uint16_t UART1_Write(const uint8_t *buffer, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        UART1_Write_Byte(buffer[i]);
+    }
+
+    return length;
+}
+
+uint16_t UART1_Read_Timeout(uint8_t *buffer, uint16_t length, uint32_t timeout_us)
+{
+    uint64_t deadline_us = Timebase_Get_Time_us() + timeout_us;
+
+    // Let the virtual time run until the bytes arrive or the deadline is reached
+    while ((UART1_Available() < length) && (Sim_UART1_Next_Event_us() <= deadline_us))
+    {
+        Sim_Clock_Advance_To(Sim_UART1_Next_Event_us());
+    }
+
+    if (UART1_Available() < length)
+    {
+        Sim_Clock_Advance_To(deadline_us);
+    }
+
+    return UART1_Read(buffer, length);
+}
+
+uint16_t UART1_Write_Timeout(const uint8_t *buffer, uint16_t length, uint32_t timeout_us)
+{
+    return UART1_Write(buffer, length);
+}
+
+uint16_t UART1_Available(void)
+{
+    return Ring_Buffer_Count(&rx_buffer);
+}
+
+void UART1_Flush_Input(void)
+{
+    Ring_Buffer_Flush(&rx_buffer);
+}
+
+uint32_t UART1_Get_Error_Count(void)
+{
+    return rx_error_count;
+}
+
+void UART1_Handler(void)
+{
+}
+
+// The simulated sensor never sends text, so the terminal functions do not wait
+char UART1_Input_Character(void)
+{
+    uint8_t data = UART1_CR;
+
+    UART1_Read_Byte(&data);
+
+    return (char)data;
+}
+
+void UART1_Output_Character(char data)
+{
+    UART1_Write_Byte((uint8_t)data);
+}
+
+uint32_t UART1_Input_String(char *buffer_pointer, uint16_t buffer_size)
+{
+    if (buffer_size > 0)
+    {
+        buffer_pointer[0] = '\0';
+    }
+
+    return 0;
+}
+
+void UART1_Output_String(char *pt)
+{
+    while (*pt != '\0')
+    {
+        UART1_Output_Character(*pt);
+        pt++;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host replacement of the device header for the simulation build.
+ *
+ * The application modules only include the device header for the fixed-width
+ * integer types and the Cortex-M4 intrinsics used around their critical sections.
+ * This header provides both for the host, and nothing else: it does not declare
+ * any peripheral register block, so a module that accesses a register directly
+ * does not compile in the simulation build and must go through a driver instead.
+ *
+ * The simulation is single-threaded and "interrupts" are only delivered between
+ * task dispatches, so masking interrupts does nothing.
+ *
+ * @author Adrian Solorzano
+ */
+
+#ifndef TM4C123GH6PM_H
+#define TM4C123GH6PM_H
+
+#include <stdint.h>
+
+static inline void __disable_irq(void)
+{
+}
+
+static inline void __enable_irq(void)
+{
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    (void)primask;
+}
+
+static inline void __DSB(void)
+{
+}
+
+static inline void __WFI(void)
+{
+}
+
+// Count of the leading zero bits (32 for a value of 0, as on the Cortex-M4)
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (value == 0) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+#endif